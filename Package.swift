@@ -26,7 +26,11 @@ let package = Package(
                  targets: [
                     "OktaOidc",
                     "OktaOidc_AppAuth"
-                 ])
+                 ]),
+        .executable(name: "Benchmarks",
+                    targets: [
+                        "Benchmarks"
+                    ])
     ],
     targets: [
         .target(name: "OktaOidc_AppAuth",
@@ -42,6 +46,12 @@ let package = Package(
                 resources: [
                     .process("Common/Resources")
                 ]),
+        .target(name: "BenchmarkSupport"),
+        .target(name: "Benchmarks",
+                dependencies: [
+                    "OktaOidc_AppAuth",
+                    "BenchmarkSupport"
+                ]),
     ] + [
         .target(name: "TestCommon",
                 dependencies: [
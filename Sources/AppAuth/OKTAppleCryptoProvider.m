@@ -0,0 +1,49 @@
+/*! @file OKTAppleCryptoProvider.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTAppleCryptoProvider.h"
+
+#import <CommonCrypto/CommonDigest.h>
+#import <CommonCrypto/CommonHMAC.h>
+#import <Security/SecRandom.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@implementation OKTAppleCryptoProvider
+
+- (BOOL)getRandomBytes:(void *)bytes length:(size_t)length {
+  return SecRandomCopyBytes(kSecRandomDefault, length, bytes) == errSecSuccess;
+}
+
+- (NSData *)SHA256DigestOfData:(NSData *)data {
+  NSMutableData *digest = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+  CC_SHA256(data.bytes, (CC_LONG)data.length, digest.mutableBytes);
+  return digest;
+}
+
+- (NSData *)HMACSHA256OfData:(NSData *)data key:(NSData *)key {
+  NSMutableData *mac = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+  CCHmac(kCCHmacAlgSHA256, key.bytes, key.length, data.bytes, data.length, mac.mutableBytes);
+  return mac;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -22,16 +22,22 @@
 
 #import "OKTAuthStateChangeDelegate.h"
 #import "OKTAuthStateErrorDelegate.h"
+#import "OKTAuthStateSharedStorage.h"
 #import "OKTAuthorizationRequest.h"
 #import "OKTAuthorizationResponse.h"
 #import "OKTAuthorizationService.h"
+#import "OKTCircuitBreaker.h"
+#import "OKTCrossProcessRefreshLock.h"
 #import "OKTDefines.h"
 #import "OKTError.h"
 #import "OKTErrorUtilities.h"
+#import "OKTMetricsRegistry.h"
 #import "OKTRegistrationResponse.h"
 #import "OKTTokenRequest.h"
+#import "OKTTokenRefreshCoordinator.h"
 #import "OKTTokenResponse.h"
 #import "OKTTokenUtilities.h"
+#import "OKTTracing.h"
 #import "OKTDefaultTokenValidator.h"
 
 /*! @brief Key used to encode the @c refreshToken property for @c NSSecureCoding.
@@ -58,6 +64,10 @@ static NSString *const kLastTokenResponseKey = @"lastTokenResponse";
  */
 static NSString *const kAuthorizationErrorKey = @"authorizationError";
 
+/*! @brief Key used to encode the @c compactsResponses property for @c NSSecureCoding.
+ */
+static NSString *const kCompactsResponsesKey = @"compactsResponses";
+
 /*! @brief The exception thrown when a developer tries to create a refresh request from an
         authorization request with no authorization code.
  */
@@ -124,6 +134,10 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   /*! @brief If YES, tokens will be refreshed on the next API call regardless of expiry.
    */
   BOOL _needsTokenRefresh;
+
+  /*! @brief If YES, @c lastAuthorizationResponse is already a compact copy.
+   */
+  BOOL _authorizationResponseCompacted;
 }
 
 #pragma mark - Convenience initializers
@@ -135,11 +149,13 @@ static const NSUInteger kExpiryTimeTolerance = 60;
                                     validator:(id<OKTTokenValidator> _Nonnull)validator
                                      callback:(OKTAuthStateAuthorizationCallback)callback {
   // presents the authorization request
+  id<OKTTraceSpan> authorizationSpan = [OKTTracing beginSpanWithName:OKTTraceSpanAuthorization];
   id<OKTExternalUserAgentSession> authFlowSession = [OKTAuthorizationService
       presentAuthorizationRequest:authorizationRequest
                 externalUserAgent:externalUserAgent
                          callback:^(OKTAuthorizationResponse *_Nullable authorizationResponse,
                                     NSError *_Nullable authorizationError) {
+                           [authorizationSpan endWithError:authorizationError];
                            // inspects response and processes further if needed (e.g. authorization
                            // code exchange)
                            if (authorizationResponse) {
@@ -288,6 +304,9 @@ static const NSUInteger kExpiryTimeTolerance = 60;
     _scope = [aDecoder decodeObjectOfClass:[NSString class] forKey:kScopeKey];
     _refreshToken = [aDecoder decodeObjectOfClass:[NSString class] forKey:kRefreshTokenKey];
     _needsTokenRefresh = [aDecoder decodeBoolForKey:kNeedsTokenRefreshKey];
+    // Compacted responses are archived compact.
+    _compactsResponses = [aDecoder decodeBoolForKey:kCompactsResponsesKey];
+    _authorizationResponseCompacted = _compactsResponses && _lastTokenResponse;
   }
   return self;
 }
@@ -304,6 +323,7 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   [aCoder encodeObject:_scope forKey:kScopeKey];
   [aCoder encodeObject:_refreshToken forKey:kRefreshTokenKey];
   [aCoder encodeBool:_needsTokenRefresh forKey:kNeedsTokenRefreshKey];
+  [aCoder encodeBool:_compactsResponses forKey:kCompactsResponsesKey];
 }
 
 #pragma mark - Private convenience getters
@@ -346,6 +366,31 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   return !self.authorizationError && (self.accessToken || self.idToken || self.refreshToken);
 }
 
+#pragma mark - Compacting
+
+- (void)setCompactsResponses:(BOOL)compactsResponses {
+  _compactsResponses = compactsResponses;
+  if (compactsResponses) {
+    [self compactResponses];
+  }
+}
+
+/*! @brief Replaces the last responses with their compact copies.
+    @discussion The authorization response is kept whole until a token response arrives, since
+        the code exchange needs its code and PKCE verifier. It is compacted once; token responses
+        are compacted as they replace each other.
+ */
+- (void)compactResponses {
+  if (!_lastTokenResponse) {
+    return;
+  }
+  if (!_authorizationResponseCompacted) {
+    _lastAuthorizationResponse = [_lastAuthorizationResponse compactCopy];
+    _authorizationResponseCompacted = YES;
+  }
+  _lastTokenResponse = [_lastTokenResponse compactCopy];
+}
+
 #pragma mark - Updating the state
 
 - (void)updateWithRegistrationResponse:(OKTRegistrationResponse *)registrationResponse {
@@ -370,6 +415,7 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   }
 
   _lastAuthorizationResponse = authorizationResponse;
+  _authorizationResponseCompacted = NO;
 
   // clears the last token response and refresh token as these now relate to an old authorization
   // that is no longer relevant
@@ -421,6 +467,10 @@ static const NSUInteger kExpiryTimeTolerance = 60;
     _refreshToken = tokenResponse.refreshToken;
   }
 
+  if (_compactsResponses) {
+    [self compactResponses];
+  }
+
   [self didChangeState];
 }
 
@@ -488,6 +538,7 @@ static const NSUInteger kExpiryTimeTolerance = 60;
 
   if ([self isTokenFresh]) {
     // access token is valid within tolerance levels, perform action
+    [[OKTMetricsRegistry sharedRegistry] incrementCounter:OKTMetricTokenCacheHits];
     dispatch_async(dispatchQueue, ^{
       action(self.accessToken, self.idToken, nil);
     });
@@ -507,6 +558,7 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   }
 
   // access token is expired, first refresh the token, then perform action
+  [[OKTMetricsRegistry sharedRegistry] incrementCounter:OKTMetricTokenCacheMisses];
   NSAssert(_pendingActionsSyncObject, @"_pendingActionsSyncObject cannot be nil", @"");
   OKTAuthStatePendingAction* pendingAction =
       [[OKTAuthStatePendingAction alloc] initWithAction:action andDispatchQueue:dispatchQueue];
@@ -514,6 +566,7 @@ static const NSUInteger kExpiryTimeTolerance = 60;
     // if a token is already in the process of being refreshed, adds to pending actions
     if (_pendingActions) {
       [_pendingActions addObject:pendingAction];
+      [[OKTMetricsRegistry sharedRegistry] incrementCounter:OKTMetricCoalescedRefreshWaiters];
       return;
     }
 
@@ -521,15 +574,60 @@ static const NSUInteger kExpiryTimeTolerance = 60;
     _pendingActions = [NSMutableArray arrayWithObject:pendingAction];
   }
   
-  // refresh the tokens
+  OKTCrossProcessRefreshLock *refreshLock = _crossProcessRefreshLock;
+  if (!refreshLock) {
+    [self refreshTokensWithAdditionalParameters:additionalParameters completion:nil];
+    return;
+  }
+
+  // waits for other processes off the main queue, then continues on the main queue like a
+  // refresh without the lock does
+  dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    NSError *lockError;
+    BOOL locked = [refreshLock lockWithError:&lockError];
+    if (!locked) {
+      // refreshing without coordination is preferred over failing the pending actions
+      NSLog(@"OKTAuthState: unable to acquire the cross-process refresh lock: %@", lockError);
+    }
+    dispatch_async(dispatch_get_main_queue(), ^{
+      if (locked && [self adoptTokensFromSharedStorage] && [self isTokenFresh]) {
+        [refreshLock unlock];
+        [self performPendingActionsWithError:nil];
+        return;
+      }
+
+      [self refreshTokensWithAdditionalParameters:additionalParameters
+                                       completion:^(BOOL refreshed) {
+        if (locked) {
+          if (refreshed) {
+            [self->_sharedStorage storeAuthState:self];
+          }
+          [refreshLock unlock];
+        }
+      }];
+    });
+  });
+}
+
+/*! @brief Refreshes the tokens and then performs the pending actions.
+    @param completion Called on the main queue after the state was updated and before the pending
+        actions are performed, with whether new tokens were received.
+ */
+- (void)refreshTokensWithAdditionalParameters:
+    (nullable NSDictionary<NSString *, NSString *> *)additionalParameters
+                                   completion:(nullable void (^)(BOOL refreshed))completion {
+  id<OKTTraceSpan> span = [OKTTracing beginSpanWithName:OKTTraceSpanTokenRefresh];
   OKTTokenRequest *tokenRefreshRequest =
       [self tokenRefreshRequestWithAdditionalParameters:additionalParameters];
-  [OKTAuthorizationService performTokenRequest:tokenRefreshRequest
-                 originalAuthorizationResponse:_lastAuthorizationResponse
-                                      delegate:_delegate
-                                     validator:_validator
-                                      callback:^(OKTTokenResponse *_Nullable response,
-                                                 NSError *_Nullable error) {
+  // other instances holding the same refresh token join the same request, which the coordinator
+  // counts and times once
+  [[OKTTokenRefreshCoordinator sharedCoordinator]
+      performTokenRefreshRequest:tokenRefreshRequest
+   originalAuthorizationResponse:_lastAuthorizationResponse
+                        delegate:_delegate
+                       validator:_validator
+                        callback:^(OKTTokenResponse *_Nullable response,
+                                   NSError *_Nullable error) {
     // update OKTAuthState based on response
     if (response) {
       self->_needsTokenRefresh = NO;
@@ -545,21 +643,62 @@ static const NSUInteger kExpiryTimeTolerance = 60;
         }
       }
     }
-
-    // nil the pending queue and process everything that was queued up
-    NSArray *actionsToProcess;
-    @synchronized(self->_pendingActionsSyncObject) {
-      actionsToProcess = self->_pendingActions;
-      self->_pendingActions = nil;
+    if (completion) {
+      completion(response != nil);
     }
-    for (OKTAuthStatePendingAction* actionToProcess in actionsToProcess) {
-      dispatch_async(actionToProcess.dispatchQueue, ^{
-        actionToProcess.action(self.accessToken, self.idToken, error);
-      });
+    [span endWithError:error];
+
+    // while the authorization server is shedding load, keeps using the current access token if it
+    // has not actually expired yet
+    NSError *actionError = error;
+    if ([OKTCircuitBreaker isCircuitBreakerOpenError:error] && [self isAccessTokenUnexpired]) {
+      actionError = nil;
     }
+    [self performPendingActionsWithError:actionError];
   }];
 }
 
+/*! @brief Nils the pending queue and performs everything that was queued up.
+ */
+- (void)performPendingActionsWithError:(nullable NSError *)error {
+  NSArray *actionsToProcess;
+  @synchronized(_pendingActionsSyncObject) {
+    actionsToProcess = _pendingActions;
+    _pendingActions = nil;
+  }
+  for (OKTAuthStatePendingAction* actionToProcess in actionsToProcess) {
+    dispatch_async(actionToProcess.dispatchQueue, ^{
+      actionToProcess.action(self.accessToken, self.idToken, error);
+    });
+  }
+}
+
+/*! @brief Adopts the tokens of the state in @c sharedStorage if another process refreshed them.
+    @return YES if tokens were adopted.
+ */
+- (BOOL)adoptTokensFromSharedStorage {
+  OKTAuthState *storedState = [_sharedStorage storedAuthStateForAuthState:self];
+  OKTTokenResponse *storedTokenResponse = storedState.lastTokenResponse;
+  if (!storedTokenResponse || !storedState.isAuthorized) {
+    return NO;
+  }
+  BOOL sameAccessToken = storedState.accessToken == self.accessToken ||
+      [storedState.accessToken isEqualToString:self.accessToken];
+  BOOL sameRefreshToken = storedState.refreshToken == self.refreshToken ||
+      [storedState.refreshToken isEqualToString:self.refreshToken];
+  if (sameAccessToken && sameRefreshToken) {
+    return NO;
+  }
+
+  _needsTokenRefresh = NO;
+  [self updateWithTokenResponse:storedTokenResponse error:nil];
+  if (storedState.refreshToken) {
+    // the stored token response may predate the refresh token the stored state holds
+    _refreshToken = [storedState.refreshToken copy];
+  }
+  return YES;
+}
+
 #pragma mark -
 
 /*! @fn isTokenFresh
@@ -581,6 +720,20 @@ static const NSUInteger kExpiryTimeTolerance = 60;
   return tokenFresh;
 }
 
+/*! @fn isAccessTokenUnexpired
+    @brief Determines whether the current access token can still be used, ignoring the refresh
+        tolerance and forced refreshes.
+ */
+- (BOOL)isAccessTokenUnexpired {
+  if (!self.accessToken) {
+    return NO;
+  }
+  if (!self.accessTokenExpirationDate) {
+    return YES;
+  }
+  return [self.accessTokenExpirationDate timeIntervalSinceNow] > 0;
+}
+
 @end
 
 
@@ -0,0 +1,215 @@
+/*! @file OKTAuthorizationMaterialPool.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTAuthorizationMaterialPool.h"
+
+#import "OKTAuthorizationRequest.h"
+#import "OKTCryptoProvider.h"
+#import "OKTDefines.h"
+#import "OKTTokenUtilities.h"
+
+/*! @brief Number of random bytes of each value, the sizes @c OKTAuthorizationRequest uses for the
+        code verifier and state.
+ */
+static const NSUInteger kRandomBytesPerValue = 32;
+
+/*! @brief Number of random bytes of one tuple: code verifier, state and nonce.
+ */
+static const NSUInteger kRandomBytesPerMaterial = 3 * kRandomBytesPerValue;
+
+/*! @brief Default number of tuples kept ready.
+ */
+static const NSUInteger kDefaultCapacity = 4;
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface OKTAuthorizationMaterial ()
+
+/*! @brief Creates the material from @c kRandomBytesPerMaterial random bytes.
+ */
+- (instancetype)initWithRandomBytes:(const uint8_t *)bytes NS_DESIGNATED_INITIALIZER;
+
+@end
+
+@implementation OKTAuthorizationMaterial
+
+- (instancetype)init OKT_UNAVAILABLE_USE_INITIALIZER(@selector(generateMaterial))
+
+- (instancetype)initWithRandomBytes:(const uint8_t *)bytes {
+  self = [super init];
+  if (self) {
+    _codeVerifier = [OKTTokenUtilities
+        encodeBase64urlNoPadding:[NSData dataWithBytes:bytes length:kRandomBytesPerValue]];
+    _codeChallenge = [OKTAuthorizationRequest codeChallengeS256ForVerifier:_codeVerifier];
+    _state = [OKTTokenUtilities
+        encodeBase64urlNoPadding:[NSData dataWithBytes:bytes + kRandomBytesPerValue
+                                                length:kRandomBytesPerValue]];
+    _nonce = [OKTTokenUtilities
+        encodeBase64urlNoPadding:[NSData dataWithBytes:bytes + 2 * kRandomBytesPerValue
+                                                length:kRandomBytesPerValue]];
+  }
+  return self;
+}
+
++ (nullable instancetype)generateMaterial {
+  uint8_t bytes[kRandomBytesPerMaterial];
+  if (![[OKTCrypto provider] getRandomBytes:bytes length:sizeof(bytes)]) {
+    return nil;
+  }
+  OKTAuthorizationMaterial *material = [[self alloc] initWithRandomBytes:bytes];
+  memset(bytes, 0, sizeof(bytes));
+  return material;
+}
+
+#pragma mark - NSObject overrides
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, state: \"%@\">",
+                                    NSStringFromClass([self class]),
+                                    (void *)self,
+                                    [OKTTokenUtilities redact:_state]];
+}
+
+@end
+
+@implementation OKTAuthorizationMaterialPool {
+  /*! @brief The tuples ready to be handed out. Guarded by @c self.
+   */
+  NSMutableArray<OKTAuthorizationMaterial *> *_materials;
+
+  /*! @brief Whether a refill is queued or running. Guarded by @c self.
+   */
+  BOOL _refillScheduled;
+
+  /*! @brief The serial queue generating tuples.
+   */
+  dispatch_queue_t _refillQueue;
+}
+
+@synthesize capacity = _capacity;
+
++ (instancetype)sharedPool {
+  static OKTAuthorizationMaterialPool *sharedPool;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedPool = [[self alloc] init];
+  });
+  return sharedPool;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _capacity = kDefaultCapacity;
+    _materials = [NSMutableArray arrayWithCapacity:kDefaultCapacity];
+    dispatch_queue_attr_t attributes =
+        dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0);
+    _refillQueue = dispatch_queue_create("com.okta.appauth.authorization-material", attributes);
+  }
+  return self;
+}
+
+- (NSUInteger)capacity {
+  @synchronized(self) {
+    return _capacity;
+  }
+}
+
+- (void)setCapacity:(NSUInteger)capacity {
+  @synchronized(self) {
+    _capacity = capacity;
+    if (_materials.count > capacity) {
+      [_materials removeObjectsInRange:NSMakeRange(capacity, _materials.count - capacity)];
+    }
+  }
+}
+
+- (NSUInteger)availableCount {
+  @synchronized(self) {
+    return _materials.count;
+  }
+}
+
+- (void)prewarm {
+  [self scheduleRefill];
+}
+
+- (nullable OKTAuthorizationMaterial *)takeMaterial {
+  OKTAuthorizationMaterial *material;
+  @synchronized(self) {
+    material = _materials.firstObject;
+    if (material) {
+      [_materials removeObjectAtIndex:0];
+    }
+  }
+  [self scheduleRefill];
+  return material ?: [OKTAuthorizationMaterial generateMaterial];
+}
+
+#pragma mark -
+
+- (void)scheduleRefill {
+  @synchronized(self) {
+    if (_refillScheduled || _materials.count >= _capacity) {
+      return;
+    }
+    _refillScheduled = YES;
+  }
+  dispatch_async(_refillQueue, ^{
+    [self refill];
+  });
+}
+
+/*! @brief Generates the missing tuples from one bulk random read.
+ */
+- (void)refill {
+  NSUInteger missingCount;
+  @synchronized(self) {
+    missingCount = _capacity > _materials.count ? _capacity - _materials.count : 0;
+  }
+
+  NSMutableArray<OKTAuthorizationMaterial *> *materials =
+      [NSMutableArray arrayWithCapacity:missingCount];
+  if (missingCount > 0) {
+    NSMutableData *randomData = [NSMutableData dataWithLength:missingCount * kRandomBytesPerMaterial];
+    if ([[OKTCrypto provider] getRandomBytes:randomData.mutableBytes length:randomData.length]) {
+      const uint8_t *bytes = randomData.bytes;
+      for (NSUInteger i = 0; i < missingCount; i++) {
+        [materials addObject:[[OKTAuthorizationMaterial alloc]
+                                 initWithRandomBytes:bytes + i * kRandomBytesPerMaterial]];
+      }
+    }
+    [randomData resetBytesInRange:NSMakeRange(0, randomData.length)];
+  }
+
+  @synchronized(self) {
+    for (OKTAuthorizationMaterial *material in materials) {
+      if (_materials.count >= _capacity) {
+        break;
+      }
+      [_materials addObject:material];
+    }
+    _refillScheduled = NO;
+  }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
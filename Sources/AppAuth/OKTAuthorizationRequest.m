@@ -20,6 +20,7 @@
 
 #import "OKTAuthorizationRequest.h"
 
+#import "OKTAuthorizationMaterialPool.h"
 #import "OKTDefines.h"
 #import "OKTScopeUtilities.h"
 #import "OKTServiceConfiguration.h"
@@ -170,9 +171,8 @@ NSString *const OKTOAuthorizationRequestCodeChallengeMethodS256 = @"S256";
             responseType:(NSString *)responseType
     additionalParameters:(nullable NSDictionary<NSString *, NSString *> *)additionalParameters {
 
-  // generates PKCE code verifier and challenge
-  NSString *codeVerifier = [[self class] generateCodeVerifier];
-  NSString *codeChallenge = [[self class] codeChallengeS256ForVerifier:codeVerifier];
+  // takes a pre-generated PKCE code verifier and challenge, state and nonce
+  OKTAuthorizationMaterial *material = [[OKTAuthorizationMaterialPool sharedPool] takeMaterial];
 
   return [self initWithConfiguration:configuration
                             clientId:clientID
@@ -180,10 +180,10 @@ NSString *const OKTOAuthorizationRequestCodeChallengeMethodS256 = @"S256";
                                scope:[OKTScopeUtilities scopesWithArray:scopes]
                          redirectURL:redirectURL
                         responseType:responseType
-                               state:[[self class] generateState]
-                               nonce:[[self class] generateState]
-                        codeVerifier:codeVerifier
-                       codeChallenge:codeChallenge
+                               state:material.state
+                               nonce:material.nonce
+                        codeVerifier:material.codeVerifier
+                       codeChallenge:material.codeChallenge
                  codeChallengeMethod:OKTOAuthorizationRequestCodeChallengeMethodS256
                 additionalParameters:additionalParameters];
 }
@@ -214,6 +214,24 @@ NSString *const OKTOAuthorizationRequestCodeChallengeMethodS256 = @"S256";
   return self;
 }
 
+#pragma mark - Compacting
+
+- (instancetype)compactCopy {
+  return [[[self class] alloc]
+      initWithConfiguration:[OKTServiceConfiguration sharedConfigurationForConfiguration:_configuration]
+                   clientId:_clientID
+               clientSecret:_clientSecret
+                      scope:_scope
+                redirectURL:_redirectURL
+               responseType:_responseType
+                      state:nil
+                      nonce:nil
+               codeVerifier:nil
+              codeChallenge:nil
+        codeChallengeMethod:nil
+       additionalParameters:nil];
+}
+
 #pragma mark - NSSecureCoding
 
 + (BOOL)supportsSecureCoding {
@@ -139,6 +139,20 @@ static NSString *const kTokenExchangeRequestException =
   return self;
 }
 
+#pragma mark - Compacting
+
+- (instancetype)compactCopy {
+  OKTAuthorizationResponse *response =
+      [[[self class] alloc] initWithRequest:[_request compactCopy] parameters:@{ }];
+  response->_accessToken = _accessToken;
+  response->_accessTokenExpirationDate = _accessTokenExpirationDate;
+  response->_tokenType = _tokenType;
+  response->_idToken = _idToken;
+  response->_scope = _scope;
+  response->_additionalParameters = nil;
+  return response;
+}
+
 #pragma mark - NSSecureCoding
 
 + (BOOL)supportsSecureCoding {
@@ -22,6 +22,7 @@
 
 #import "OKTAuthorizationRequest.h"
 #import "OKTAuthorizationResponse.h"
+#import "OKTCircuitBreaker.h"
 #import "OKTDefines.h"
 #import "OKTEndSessionRequest.h"
 #import "OKTEndSessionResponse.h"
@@ -29,12 +30,15 @@
 #import "OKTExternalUserAgent.h"
 #import "OKTExternalUserAgentSession.h"
 #import "OKTIDToken.h"
+#import "OKTNetworkMetrics.h"
 #import "OKTRegistrationRequest.h"
 #import "OKTRegistrationResponse.h"
+#import "OKTRetryPolicy.h"
 #import "OKTServiceConfiguration.h"
 #import "OKTServiceDiscovery.h"
 #import "OKTTokenRequest.h"
 #import "OKTTokenResponse.h"
+#import "OKTTracing.h"
 #import "OKTURLQueryComponent.h"
 #import "OKTURLSessionProvider.h"
 #import "OKTDefaultTokenValidator.h"
@@ -133,25 +137,26 @@ NS_ASSUME_NONNULL_BEGIN
   }
 
   OKTURLQueryComponent *query = [[OKTURLQueryComponent alloc] initWithURL:URL];
+  NSDictionary<NSString *, NSObject<NSCopying> *> *parameters = query.dictionaryValue;
 
   NSError *error;
   OKTAuthorizationResponse *response = nil;
 
   // checks for an OAuth error response as per RFC6749 Section 4.1.2.1
-  if (query.dictionaryValue[OKTOAuthErrorFieldError]) {
+  if (parameters[OKTOAuthErrorFieldError]) {
     error = [OKTErrorUtilities OAuthErrorWithDomain:OKTOAuthAuthorizationErrorDomain
-                                      OAuthResponse:query.dictionaryValue
+                                      OAuthResponse:parameters
                                     underlyingError:nil];
   }
 
   // no error, should be a valid OAuth 2.0 response
   if (!error) {
     response = [[OKTAuthorizationResponse alloc] initWithRequest:_request
-                                                      parameters:query.dictionaryValue];
+                                                      parameters:parameters];
       
     // verifies that the state in the response matches the state in the request, or both are nil
     if (!OKTIsEqualIncludingNil(_request.state, response.state)) {
-      NSMutableDictionary *userInfo = [query.dictionaryValue mutableCopy];
+      NSMutableDictionary *userInfo = [parameters mutableCopy];
       userInfo[NSLocalizedDescriptionKey] =
         [NSString stringWithFormat:@"State mismatch, expecting %@ but got %@ in authorization "
                                    "response %@",
@@ -428,16 +433,141 @@ NS_ASSUME_NONNULL_BEGIN
                              callback:callback];
 }
 
+/*! @brief Validates the ID token of a token response.
+    @param tokenResponse A token response that includes an ID token.
+    @param authorizationResponse The original authorization response, used to validate the nonce.
+    @param validator Validates the ID token dates.
+    @return The validation error, or nil if the ID token is valid.
+ */
++ (nullable NSError *)validateIDTokenOfTokenResponse:(OKTTokenResponse *)tokenResponse
+                       originalAuthorizationResponse:
+                           (nullable OKTAuthorizationResponse *)authorizationResponse
+                                           validator:(id<OKTTokenValidator>)validator {
+  // Validates the ID Token following the rules
+  // in OpenID Connect Core Section 3.1.3.7 for features that AppAuth directly supports
+  // (which excludes rules #1, #4, #5, #7, #8, #12, and #13). Regarding rule #6, ID Tokens
+  // received by this class are received via direct communication between the Client and the Token
+  // Endpoint, thus we are exercising the option to rely only on the TLS validation. AppAuth
+  // has a zero dependencies policy, and verifying the JWT signature would add a dependency.
+  // Users of the library are welcome to perform the JWT signature verification themselves should
+  // they wish.
+  OKTIDToken *idToken = [[OKTIDToken alloc] initWithIDTokenString:tokenResponse.idToken];
+  if (!idToken) {
+    NSError *invalidIDToken =
+      [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenParsingError
+                       underlyingError:nil
+                           description:@"ID Token parsing failed"];
+    return invalidIDToken;
+  }
+  
+  // OpenID Connect Core Section 3.1.3.7. rule #1
+  // Not supported: AppAuth does not support JWT encryption.
+
+  // OpenID Connect Core Section 3.1.3.7. rule #2
+  // Validates that the issuer in the ID Token matches that of the discovery document.
+  NSURL *issuer = tokenResponse.request.configuration.issuer;
+  if (issuer && ![idToken.issuer isEqual:issuer]) {
+    NSError *invalidIDToken =
+      [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenFailedValidationError
+                       underlyingError:nil
+                           description:@"Issuer mismatch"];
+    return invalidIDToken;
+  }
+
+  // OpenID Connect Core Section 3.1.3.7. rule #3 & Section 2 azp Claim
+  // Validates that the aud (audience) Claim contains the client ID, or that the azp
+  // (authorized party) Claim matches the client ID.
+  NSString *clientID = tokenResponse.request.clientID;
+  if (![idToken.audience containsObject:clientID] &&
+      ![idToken.claims[@"azp"] isEqualToString:clientID]) {
+    NSError *invalidIDToken =
+      [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenFailedValidationError
+                       underlyingError:nil
+                           description:@"Audience mismatch"];
+    return invalidIDToken;
+  }
+  
+  // OpenID Connect Core Section 3.1.3.7. rules #4 & #5
+  // Not supported.
+
+  // OpenID Connect Core Section 3.1.3.7. rule #6
+  // As noted above, AppAuth only supports the code flow which results in direct communication
+  // of the ID Token from the Token Endpoint to the Client, and we are exercising the option to
+  // use TSL server validation instead of checking the token signature. Users may additionally
+  // check the token signature should they wish.
+
+  // OpenID Connect Core Section 3.1.3.7. rules #7 & #8
+  // Not applicable. See rule #6.
+  
+  NSAssert(validator != nil, @"Validator parameter is missed. Default will be used.");
+  id<OKTTokenValidator> tokenValidator = validator ?: [OKTDefaultTokenValidator new];
+
+  if ([tokenValidator isDateExpired:idToken.expiresAt token:OKTTokenTypeId]) {
+    NSError *invalidIDToken =
+    [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenFailedValidationError
+                     underlyingError:nil
+                         description:@"ID Token expired"];
+    return invalidIDToken;
+  }
+    
+  if (![tokenValidator isIssuedAtDateValid:idToken.issuedAt token:OKTTokenTypeId]) {
+      NSString *message =
+      [NSString stringWithFormat:@"Issued at time is invalid corresponding to the current time"];
+      NSError *invalidIDToken =
+      [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenFailedValidationError
+                       underlyingError:nil
+                           description:message];
+      return invalidIDToken;
+  }
+
+  // Only relevant for the authorization_code response type
+  if ([tokenResponse.request.grantType isEqual:OKTGrantTypeAuthorizationCode]) {
+    // OpenID Connect Core Section 3.1.3.7. rule #11
+    // Validates the nonce.
+    NSString *nonce = authorizationResponse.request.nonce;
+    if (nonce && ![idToken.nonce isEqual:nonce]) {
+      NSError *invalidIDToken =
+      [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenFailedValidationError
+                       underlyingError:nil
+                           description:@"Nonce mismatch"];
+      return invalidIDToken;
+    }
+  }
+  
+  // OpenID Connect Core Section 3.1.3.7. rules #12
+  // ACR is not directly supported by AppAuth.
+
+  // OpenID Connect Core Section 3.1.3.7. rules #12
+  // max_age is not directly supported by AppAuth.
+
+  return nil;
+}
+
 + (void)performTokenRequest:(OKTTokenRequest *)request
 originalAuthorizationResponse:(OKTAuthorizationResponse *_Nullable)authorizationResponse
                    delegate:(id<OktaNetworkRequestCustomizationDelegate> _Nullable)delegate
                   validator:(id<OKTTokenValidator> _Nonnull)validator
                    callback:(OKTTokenCallback)callback {
+  id<OKTTraceSpan> span = [OKTTracing beginSpanWithName:OKTTraceSpanTokenRequest];
+  if (span) {
+    [span setAttribute:request.grantType forKey:@"grant_type"];
+    OKTTokenCallback tracedCallback = callback;
+    callback = ^(OKTTokenResponse *_Nullable tokenResponse, NSError *_Nullable error) {
+      [span endWithError:error];
+      tracedCallback(tokenResponse, error);
+    };
+  }
 
   NSURLRequest *URLRequest = [request URLRequest];
   if ([delegate respondsToSelector:@selector(customizableURLRequest:)]) {
     URLRequest = [delegate customizableURLRequest:URLRequest];
   }
+  NSString *operation = [request.grantType isEqualToString:OKTGrantTypeRefreshToken]
+      ? OKTNetworkOperationTokenRefresh
+      : OKTNetworkOperationTokenExchange;
+  URLRequest = [[OKTNetworkMetricsCollector sharedCollector] request:URLRequest
+                                                 taggedWithOperation:operation
+                                                            delegate:delegate];
   AppAuthRequestTrace(@"Token Request: %@\nHeaders:%@\nHTTPBody: %@",
                       URLRequest.URL,
                       URLRequest.allHTTPHeaderFields,
@@ -445,11 +575,22 @@ originalAuthorizationResponse:(OKTAuthorizationResponse *_Nullable)authorization
                                             encoding:NSUTF8StringEncoding]);
 
   NSURLSession *session = [OKTURLSessionProvider session];
-  [[session dataTaskWithRequest:URLRequest
-              completionHandler:^(NSData *_Nullable data,
-                                  NSURLResponse *_Nullable response,
-                                  NSError *_Nullable error) {
+  // Token requests are not idempotent: the authorization server may rotate the refresh token or
+  // consume the authorization code, so they are only retried when they were not processed.
+  [[OKTRetryPolicy sharedPolicy] performDataTaskWithRequest:URLRequest
+                                                   session:session
+                                                idempotent:NO
+                                         completionHandler:^(NSData *_Nullable data,
+                                                             NSURLResponse *_Nullable response,
+                                                             NSError *_Nullable error) {
     [delegate didReceiveResponse:response];
+    if ([OKTCircuitBreaker isCircuitBreakerOpenError:error]) {
+      // The request was not sent, so there is no network error to wrap.
+      dispatch_async(dispatch_get_main_queue(), ^{
+        callback(nil, error);
+      });
+      return;
+    }
     if (error) {
       // A network error or server error occurred.
       NSString *errorDescription =
@@ -543,128 +684,27 @@ originalAuthorizationResponse:(OKTAuthorizationResponse *_Nullable)authorization
       return;
     }
 
-    // If an ID Token is included in the response, validates the ID Token following the rules
-    // in OpenID Connect Core Section 3.1.3.7 for features that AppAuth directly supports
-    // (which excludes rules #1, #4, #5, #7, #8, #12, and #13). Regarding rule #6, ID Tokens
-    // received by this class are received via direct communication between the Client and the Token
-    // Endpoint, thus we are exercising the option to rely only on the TLS validation. AppAuth
-    // has a zero dependencies policy, and verifying the JWT signature would add a dependency.
-    // Users of the library are welcome to perform the JWT signature verification themselves should
-    // they wish.
+    // If an ID Token is included in the response, validates it.
     if (tokenResponse.idToken) {
-      OKTIDToken *idToken = [[OKTIDToken alloc] initWithIDTokenString:tokenResponse.idToken];
-      if (!idToken) {
-        NSError *invalidIDToken =
-          [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenParsingError
-                           underlyingError:nil
-                               description:@"ID Token parsing failed"];
+      id<OKTTraceSpan> validationSpan =
+          [OKTTracing beginSpanWithName:OKTTraceSpanIDTokenValidation];
+      NSError *invalidIDToken = [self validateIDTokenOfTokenResponse:tokenResponse
+                                       originalAuthorizationResponse:authorizationResponse
+                                                           validator:validator];
+      [validationSpan endWithError:invalidIDToken];
+      if (invalidIDToken) {
         dispatch_async(dispatch_get_main_queue(), ^{
           callback(nil, invalidIDToken);
         });
         return;
       }
-      
-      // OpenID Connect Core Section 3.1.3.7. rule #1
-      // Not supported: AppAuth does not support JWT encryption.
-
-      // OpenID Connect Core Section 3.1.3.7. rule #2
-      // Validates that the issuer in the ID Token matches that of the discovery document.
-      NSURL *issuer = tokenResponse.request.configuration.issuer;
-      if (issuer && ![idToken.issuer isEqual:issuer]) {
-        NSError *invalidIDToken =
-          [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenFailedValidationError
-                           underlyingError:nil
-                               description:@"Issuer mismatch"];
-        dispatch_async(dispatch_get_main_queue(), ^{
-          callback(nil, invalidIDToken);
-        });
-        return;
-      }
-
-      // OpenID Connect Core Section 3.1.3.7. rule #3 & Section 2 azp Claim
-      // Validates that the aud (audience) Claim contains the client ID, or that the azp
-      // (authorized party) Claim matches the client ID.
-      NSString *clientID = tokenResponse.request.clientID;
-      if (![idToken.audience containsObject:clientID] &&
-          ![idToken.claims[@"azp"] isEqualToString:clientID]) {
-        NSError *invalidIDToken =
-          [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenFailedValidationError
-                           underlyingError:nil
-                               description:@"Audience mismatch"];
-        dispatch_async(dispatch_get_main_queue(), ^{
-          callback(nil, invalidIDToken);
-        });
-        return;
-      }
-      
-      // OpenID Connect Core Section 3.1.3.7. rules #4 & #5
-      // Not supported.
-
-      // OpenID Connect Core Section 3.1.3.7. rule #6
-      // As noted above, AppAuth only supports the code flow which results in direct communication
-      // of the ID Token from the Token Endpoint to the Client, and we are exercising the option to
-      // use TSL server validation instead of checking the token signature. Users may additionally
-      // check the token signature should they wish.
-
-      // OpenID Connect Core Section 3.1.3.7. rules #7 & #8
-      // Not applicable. See rule #6.
-      
-      NSAssert(validator != nil, @"Validator parameter is missed. Default will be used.");
-      id<OKTTokenValidator> tokenValidator = validator ?: [OKTDefaultTokenValidator new];
-
-      if ([tokenValidator isDateExpired:idToken.expiresAt token:OKTTokenTypeId]) {
-        NSError *invalidIDToken =
-        [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenFailedValidationError
-                         underlyingError:nil
-                             description:@"ID Token expired"];
-        dispatch_async(dispatch_get_main_queue(), ^{
-          callback(nil, invalidIDToken);
-        });
-        return;
-      }
-        
-      if (![tokenValidator isIssuedAtDateValid:idToken.issuedAt token:OKTTokenTypeId]) {
-          NSString *message =
-          [NSString stringWithFormat:@"Issued at time is invalid corresponding to the current time"];
-          NSError *invalidIDToken =
-          [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenFailedValidationError
-                           underlyingError:nil
-                               description:message];
-          dispatch_async(dispatch_get_main_queue(), ^{
-              callback(nil, invalidIDToken);
-          });
-          return;
-      }
-
-      // Only relevant for the authorization_code response type
-      if ([tokenResponse.request.grantType isEqual:OKTGrantTypeAuthorizationCode]) {
-        // OpenID Connect Core Section 3.1.3.7. rule #11
-        // Validates the nonce.
-        NSString *nonce = authorizationResponse.request.nonce;
-        if (nonce && ![idToken.nonce isEqual:nonce]) {
-          NSError *invalidIDToken =
-          [OKTErrorUtilities errorWithCode:OKTErrorCodeIDTokenFailedValidationError
-                           underlyingError:nil
-                               description:@"Nonce mismatch"];
-          dispatch_async(dispatch_get_main_queue(), ^{
-            callback(nil, invalidIDToken);
-          });
-          return;
-        }
-      }
-      
-      // OpenID Connect Core Section 3.1.3.7. rules #12
-      // ACR is not directly supported by AppAuth.
-
-      // OpenID Connect Core Section 3.1.3.7. rules #12
-      // max_age is not directly supported by AppAuth.
     }
 
     // Success
     dispatch_async(dispatch_get_main_queue(), ^{
       callback(tokenResponse, nil);
     });
-  }] resume];
+  }];
 }
 
 
@@ -688,6 +728,9 @@ originalAuthorizationResponse:(OKTAuthorizationResponse *_Nullable)authorization
   if ([delegate respondsToSelector:@selector(customizableURLRequest:)]) {
     URLRequest = [delegate customizableURLRequest:URLRequest];
   }
+  URLRequest = [[OKTNetworkMetricsCollector sharedCollector] request:URLRequest
+                                                 taggedWithOperation:OKTNetworkOperationRegistration
+                                                            delegate:delegate];
   NSURLSession *session = [OKTURLSessionProvider session];
   [[session dataTaskWithRequest:URLRequest
               completionHandler:^(NSData *_Nullable data,
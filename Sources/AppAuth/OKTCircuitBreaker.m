@@ -0,0 +1,260 @@
+/*! @file OKTCircuitBreaker.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTCircuitBreaker.h"
+
+#import "OKTDefines.h"
+#import "OKTError.h"
+#import "OKTErrorUtilities.h"
+
+/*! @brief Settings used for new breakers, or nil when circuit breaking is disabled.
+ */
+static OKTCircuitBreaker *__nullable gTemplate;
+
+/*! @brief Shared breakers keyed by origin. Guarded by @c OKTCircuitBreaker class object.
+ */
+static NSMutableDictionary<NSString *, OKTCircuitBreaker *> *__nullable gCircuitBreakers;
+
+static __weak id<OKTCircuitBreakerDelegate> gDelegate;
+
+NS_ASSUME_NONNULL_BEGIN
+
+@implementation OKTCircuitBreaker {
+  /*! @brief Number of consecutive failures recorded while closed.
+   */
+  NSUInteger _consecutiveFailures;
+
+  /*! @brief When the breaker last opened.
+   */
+  NSDate *_openedDate;
+
+  /*! @brief Whether the half-open probe has been handed out.
+   */
+  BOOL _probeInFlight;
+}
+
+- (instancetype)init
+    OKT_UNAVAILABLE_USE_INITIALIZER(
+        @selector(initWithOrigin:failureThreshold:latencyThreshold:cooldown:)
+    )
+
+- (instancetype)initWithOrigin:(NSString *)origin
+              failureThreshold:(NSUInteger)failureThreshold
+              latencyThreshold:(NSTimeInterval)latencyThreshold
+                      cooldown:(NSTimeInterval)cooldown {
+  self = [super init];
+  if (self) {
+    _origin = [origin copy];
+    _failureThreshold = MAX(failureThreshold, 1);
+    _latencyThreshold = MAX(latencyThreshold, 0);
+    _cooldown = MAX(cooldown, 0);
+    _state = OKTCircuitBreakerStateClosed;
+  }
+  return self;
+}
+
+#pragma mark - Registry
+
++ (void)enableWithFailureThreshold:(NSUInteger)failureThreshold
+                  latencyThreshold:(NSTimeInterval)latencyThreshold
+                          cooldown:(NSTimeInterval)cooldown {
+  @synchronized(self) {
+    gTemplate = [[OKTCircuitBreaker alloc] initWithOrigin:@""
+                                         failureThreshold:failureThreshold
+                                         latencyThreshold:latencyThreshold
+                                                 cooldown:cooldown];
+    gCircuitBreakers = [NSMutableDictionary dictionary];
+  }
+}
+
++ (void)disable {
+  @synchronized(self) {
+    gTemplate = nil;
+    gCircuitBreakers = nil;
+  }
+}
+
++ (BOOL)isEnabled {
+  @synchronized(self) {
+    return gTemplate != nil;
+  }
+}
+
++ (nullable NSString *)originForURL:(NSURL *)URL {
+  NSString *host = URL.host.lowercaseString;
+  if (host.length == 0) {
+    return nil;
+  }
+  NSString *scheme = URL.scheme.lowercaseString ?: @"https";
+  NSNumber *port = URL.port ?: ([scheme isEqualToString:@"http"] ? @80 : @443);
+  return [NSString stringWithFormat:@"%@://%@:%@", scheme, host, port];
+}
+
++ (nullable OKTCircuitBreaker *)circuitBreakerForURL:(NSURL *)URL {
+  @synchronized(self) {
+    if (!gTemplate) {
+      return nil;
+    }
+    NSString *origin = [self originForURL:URL];
+    if (!origin) {
+      return nil;
+    }
+    OKTCircuitBreaker *circuitBreaker = gCircuitBreakers[origin];
+    if (!circuitBreaker) {
+      circuitBreaker = [[OKTCircuitBreaker alloc] initWithOrigin:origin
+                                                failureThreshold:gTemplate.failureThreshold
+                                                latencyThreshold:gTemplate.latencyThreshold
+                                                        cooldown:gTemplate.cooldown];
+      gCircuitBreakers[origin] = circuitBreaker;
+    }
+    return circuitBreaker;
+  }
+}
+
++ (nullable id<OKTCircuitBreakerDelegate>)delegate {
+  return gDelegate;
+}
+
++ (void)setDelegate:(nullable id<OKTCircuitBreakerDelegate>)delegate {
+  gDelegate = delegate;
+}
+
+#pragma mark - State
+
+- (OKTCircuitBreakerState)state {
+  @synchronized(self) {
+    return _state;
+  }
+}
+
+- (BOOL)allowRequest {
+  OKTCircuitBreakerState previousState;
+  OKTCircuitBreakerState newState;
+  BOOL allowed = NO;
+  @synchronized(self) {
+    previousState = _state;
+    switch (_state) {
+      case OKTCircuitBreakerStateClosed:
+        allowed = YES;
+        break;
+      case OKTCircuitBreakerStateOpen:
+        allowed = -[_openedDate timeIntervalSinceNow] >= _cooldown;
+        if (allowed) {
+          _state = OKTCircuitBreakerStateHalfOpen;
+          _probeInFlight = YES;
+        }
+        break;
+      case OKTCircuitBreakerStateHalfOpen:
+        allowed = !_probeInFlight;
+        _probeInFlight = YES;
+        break;
+    }
+    newState = _state;
+  }
+  [self notifyTransitionFromState:previousState toState:newState];
+  return allowed;
+}
+
+- (void)recordResultWithError:(nullable NSError *)error
+                     response:(nullable NSURLResponse *)response
+                      latency:(NSTimeInterval)latency {
+  if ([error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorCancelled) {
+    // Cancellation says nothing about the server, but frees the probe slot.
+    @synchronized(self) {
+      _probeInFlight = NO;
+    }
+    return;
+  }
+
+  BOOL failed = error != nil;
+  if ([response isKindOfClass:[NSHTTPURLResponse class]]) {
+    NSInteger statusCode = ((NSHTTPURLResponse *)response).statusCode;
+    failed = failed || statusCode >= 500 || statusCode == 429;
+  }
+  if (_latencyThreshold > 0 && latency > _latencyThreshold) {
+    failed = YES;
+  }
+
+  OKTCircuitBreakerState previousState;
+  OKTCircuitBreakerState newState;
+  @synchronized(self) {
+    previousState = _state;
+    if (_state == OKTCircuitBreakerStateOpen) {
+      // Late results of requests sent before the breaker opened don't affect the cooldown.
+    } else if (!failed) {
+      _consecutiveFailures = 0;
+      _state = OKTCircuitBreakerStateClosed;
+    } else if (_state == OKTCircuitBreakerStateHalfOpen
+               || ++_consecutiveFailures >= _failureThreshold) {
+      _consecutiveFailures = 0;
+      _openedDate = [NSDate date];
+      _state = OKTCircuitBreakerStateOpen;
+    }
+    _probeInFlight = NO;
+    newState = _state;
+  }
+  [self notifyTransitionFromState:previousState toState:newState];
+}
+
+- (void)notifyTransitionFromState:(OKTCircuitBreakerState)fromState
+                          toState:(OKTCircuitBreakerState)toState {
+  if (fromState == toState) {
+    return;
+  }
+  AppAuthRequestTrace(@"Circuit breaker for %@ changed from %d to %d",
+                      _origin, (int)fromState, (int)toState);
+  id<OKTCircuitBreakerDelegate> delegate = gDelegate;
+  if (!delegate) {
+    return;
+  }
+  dispatch_async(dispatch_get_main_queue(), ^{
+    [delegate circuitBreaker:self didChangeFromState:fromState toState:toState];
+  });
+}
+
+#pragma mark - Errors
+
++ (BOOL)isCircuitBreakerOpenError:(nullable NSError *)error {
+  return [error.domain isEqualToString:OKTGeneralErrorDomain]
+      && error.code == OKTErrorCodeCircuitBreakerOpen;
+}
+
++ (NSError *)circuitBreakerOpenErrorForURL:(NSURL *)URL {
+  NSString *description =
+      [NSString stringWithFormat:@"Request to '%@' was not sent because the authorization server "
+                                  "is failing. Try again later.", URL];
+  return [OKTErrorUtilities errorWithCode:OKTErrorCodeCircuitBreakerOpen
+                          underlyingError:nil
+                              description:description];
+}
+
+#pragma mark - NSObject overrides
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, origin: %@, state: %d>",
+                                    NSStringFromClass([self class]),
+                                    (void *)self,
+                                    _origin,
+                                    (int)self.state];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,118 @@
+/*! @file OKTCrossProcessRefreshLock.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTCrossProcessRefreshLock.h"
+
+#import "OKTDefines.h"
+#import "OKTFileLock.h"
+
+#include <errno.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@implementation OKTCrossProcessRefreshLock {
+  /*! @brief Serializes callers sharing this instance, since @c flock(2) does not exclude a file
+          descriptor from itself.
+   */
+  dispatch_semaphore_t _semaphore;
+
+  /*! @brief The descriptor of the locked file, or -1 when the lock is not held. Guarded by
+          @c self.
+   */
+  int _fileDescriptor;
+}
+
+- (instancetype)init OKT_UNAVAILABLE_USE_INITIALIZER(@selector(initWithLockFileURL:))
+
+- (instancetype)initWithLockFileURL:(NSURL *)lockFileURL {
+  self = [super init];
+  if (self) {
+    _lockFileURL = [lockFileURL copy];
+    // created with zero and signalled, so that deallocating the lock while held does not trap
+    _semaphore = dispatch_semaphore_create(0);
+    dispatch_semaphore_signal(_semaphore);
+    _fileDescriptor = -1;
+  }
+  return self;
+}
+
+- (void)dealloc {
+  OKTFileLockRelease(_fileDescriptor);
+}
+
+- (BOOL)isLocked {
+  @synchronized(self) {
+    return _fileDescriptor >= 0;
+  }
+}
+
+- (BOOL)lockWithError:(NSError **_Nullable)error {
+  dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_FOREVER);
+  return [self lockBlocking:YES error:error];
+}
+
+- (BOOL)tryLock {
+  if (dispatch_semaphore_wait(_semaphore, DISPATCH_TIME_NOW) != 0) {
+    return NO;
+  }
+  return [self lockBlocking:NO error:NULL];
+}
+
+- (void)unlock {
+  @synchronized(self) {
+    if (_fileDescriptor < 0) {
+      return;
+    }
+    OKTFileLockRelease(_fileDescriptor);
+    _fileDescriptor = -1;
+  }
+  dispatch_semaphore_signal(_semaphore);
+}
+
+#pragma mark -
+
+/*! @brief Opens the lock file and locks it. Must be called after taking @c _semaphore, which is
+        released again on failure.
+ */
+- (BOOL)lockBlocking:(BOOL)blocking error:(NSError **_Nullable)error {
+  int fileDescriptor = OKTFileLockAcquire(_lockFileURL.fileSystemRepresentation, blocking);
+  if (fileDescriptor < 0) {
+    return [self failWithErrno:errno error:error];
+  }
+
+  @synchronized(self) {
+    _fileDescriptor = fileDescriptor;
+  }
+  return YES;
+}
+
+- (BOOL)failWithErrno:(int)code error:(NSError **_Nullable)error {
+  dispatch_semaphore_signal(_semaphore);
+  if (error) {
+    *error = [NSError errorWithDomain:NSPOSIXErrorDomain
+                                 code:code
+                             userInfo:@{ NSFilePathErrorKey : _lockFileURL.path ?: @"" }];
+  }
+  return NO;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,49 @@
+/*! @file OKTCryptoProvider.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTCryptoProvider.h"
+
+#import "OKTAppleCryptoProvider.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+static id<OKTCryptoProvider> __nullable gCryptoProvider;
+
+@implementation OKTCrypto
+
++ (id<OKTCryptoProvider>)provider {
+  @synchronized(self) {
+    if (!gCryptoProvider) {
+      gCryptoProvider = [[OKTAppleCryptoProvider alloc] init];
+    }
+    return gCryptoProvider;
+  }
+}
+
++ (void)setProvider:(id<OKTCryptoProvider>)provider {
+  NSAssert(provider, @"Parameter: |provider| must be non-nil.");
+  @synchronized(self) {
+    gCryptoProvider = provider;
+  }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -16,6 +16,22 @@ int const kOKTAuthorizationSessionIATMaxSkew = 600;
 
 @implementation OKTDefaultTokenValidator
 
+// The default validator has no state, so its instances are interchangeable. Subclasses compare by
+// identity.
+- (BOOL)isEqual:(id)object {
+    if ([self class] == [OKTDefaultTokenValidator class]) {
+        return [object class] == [OKTDefaultTokenValidator class];
+    }
+    return [super isEqual:object];
+}
+
+- (NSUInteger)hash {
+    if ([self class] == [OKTDefaultTokenValidator class]) {
+        return [[OKTDefaultTokenValidator class] hash];
+    }
+    return [super hash];
+}
+
 - (BOOL)isDateExpired:(nullable NSDate *)expiresAtDate token:(OKTTokenType)tokenType {
     if (!expiresAtDate) {
         return YES;
@@ -55,7 +55,11 @@ static NSUInteger const kStateSizeBytes = 32;
 static NSString *const OKTMissingEndSessionEndpointMessage =
 @"The service configuration is missing an end_session_endpoint.";
 
-@implementation OKTEndSessionRequest
+@implementation OKTEndSessionRequest {
+  /*! @brief The end session request URL, built on first use. Guarded by @c self.
+   */
+  NSURL *_endSessionRequestURL;
+}
 
 - (instancetype)init
     OKT_UNAVAILABLE_USE_INITIALIZER(
@@ -165,6 +169,18 @@ static NSString *const OKTMissingEndSessionEndpointMessage =
 #pragma mark -
 
 - (NSURL *)endSessionRequestURL {
+  // The request is immutable, so the URL is built once.
+  @synchronized(self) {
+    if (!_endSessionRequestURL) {
+      _endSessionRequestURL = [self buildEndSessionRequestURL];
+    }
+    return _endSessionRequestURL;
+  }
+}
+
+/*! @brief Constructs the end session request URL from the request parameters.
+ */
+- (NSURL *)buildEndSessionRequestURL {
   OKTURLQueryComponent *query = [[OKTURLQueryComponent alloc] init];
 
   // Add any additional parameters the client has specified.
@@ -0,0 +1,54 @@
+/*! @file OKTFileLock.c
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#include "OKTFileLock.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int OKTFileLockAcquire(const char *path, bool blocking) {
+  int fileDescriptor = open(path, O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+  if (fileDescriptor < 0) {
+    return -1;
+  }
+
+  int result;
+  do {
+    result = flock(fileDescriptor, blocking ? LOCK_EX : LOCK_EX | LOCK_NB);
+  } while (result != 0 && errno == EINTR);
+  if (result != 0) {
+    int lockErrno = errno;
+    close(fileDescriptor);
+    errno = lockErrno;
+    return -1;
+  }
+  return fileDescriptor;
+}
+
+void OKTFileLockRelease(int fileDescriptor) {
+  if (fileDescriptor < 0) {
+    return;
+  }
+  flock(fileDescriptor, LOCK_UN);
+  close(fileDescriptor);
+}
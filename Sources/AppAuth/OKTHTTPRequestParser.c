@@ -0,0 +1,491 @@
+/*! @file OKTHTTPRequestParser.c
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#include "OKTHTTPRequestParser.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+  kStateRequestLine = 0,
+  kStateHeaderLine,
+  kStateBody,
+  kStateChunkSize,
+  kStateChunkExtension,
+  kStateChunkData,
+  kStateChunkDataEnd,
+  kStateTrailer,
+  kStateComplete,
+  kStateError,
+};
+
+static int OKTIsTokenCharacter(char c) {
+  if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+    return 1;
+  }
+  return c != '\0' && strchr("!#$%&'*+-.^_`|~", c) != NULL;
+}
+
+static int OKTIsWhitespace(char c) {
+  return c == ' ' || c == '\t';
+}
+
+static char OKTLowercase(char c) {
+  return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+static int OKTEqualsIgnoringCase(const char *string, size_t length, const char *literal) {
+  size_t literalLength = strlen(literal);
+  if (length != literalLength) {
+    return 0;
+  }
+  for (size_t i = 0; i < length; i++) {
+    if (OKTLowercase(string[i]) != OKTLowercase(literal[i])) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static int OKTHexValue(uint8_t c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+static void OKTFail(OKTHTTPRequestParser *parser, OKTHTTPParseError error) {
+  parser->state = kStateError;
+  parser->error = error;
+}
+
+/*! @brief Grows a buffer to hold at least @c required bytes.
+    @return 0 if the allocation failed.
+ */
+static int OKTReserve(void **buffer, size_t *capacity, size_t required, size_t initialCapacity) {
+  if (required <= *capacity) {
+    return 1;
+  }
+  size_t newCapacity = *capacity ? *capacity : initialCapacity;
+  while (newCapacity < required) {
+    newCapacity *= 2;
+  }
+  void *newBuffer = realloc(*buffer, newCapacity);
+  if (!newBuffer) {
+    return 0;
+  }
+  *buffer = newBuffer;
+  *capacity = newCapacity;
+  return 1;
+}
+
+void OKTHTTPRequestParserInit(OKTHTTPRequestParser *parser,
+                              size_t maxHeaderLength,
+                              size_t maxBodyLength) {
+  memset(parser, 0, sizeof(*parser));
+  parser->maxHeaderLength = maxHeaderLength ? maxHeaderLength : OKT_HTTP_DEFAULT_MAX_HEADER_LENGTH;
+  parser->maxBodyLength = maxBodyLength ? maxBodyLength : OKT_HTTP_DEFAULT_MAX_BODY_LENGTH;
+}
+
+void OKTHTTPRequestParserDestroy(OKTHTTPRequestParser *parser) {
+  free(parser->head);
+  free(parser->body);
+  OKTHTTPRequestParserInit(parser, parser->maxHeaderLength, parser->maxBodyLength);
+}
+
+void OKTHTTPRequestParserReset(OKTHTTPRequestParser *parser) {
+  parser->error = OKTHTTPParseErrorNone;
+  parser->headLength = 0;
+  parser->methodLength = 0;
+  parser->targetOffset = 0;
+  parser->targetLength = 0;
+  parser->versionOffset = 0;
+  parser->versionLength = 0;
+  parser->fieldCount = 0;
+  parser->bodyLength = 0;
+  parser->state = kStateRequestLine;
+  parser->lineStart = 0;
+  parser->lineLength = 0;
+  parser->remaining = 0;
+  parser->chunkSizeDigits = 0;
+  parser->expectsLineFeed = 0;
+}
+
+const char *OKTHTTPRequestParserHeaderValue(const OKTHTTPRequestParser *parser,
+                                            const char *name,
+                                            size_t *valueLength) {
+  for (size_t i = 0; i < parser->fieldCount; i++) {
+    const OKTHTTPHeaderField *field = &parser->fields[i];
+    if (OKTEqualsIgnoringCase(parser->head + field->nameOffset, field->nameLength, name)) {
+      if (valueLength) {
+        *valueLength = field->valueLength;
+      }
+      return parser->head + field->valueOffset;
+    }
+  }
+  return NULL;
+}
+
+/*! @brief Parses "method SP request-target SP HTTP-version" at the start of @c head.
+ */
+static void OKTParseRequestLine(OKTHTTPRequestParser *parser, size_t lineEnd) {
+  const char *line = parser->head;
+  size_t position = 0;
+  while (position < lineEnd && OKTIsTokenCharacter(line[position])) {
+    position++;
+  }
+  if (position == 0 || position == lineEnd || line[position] != ' ') {
+    OKTFail(parser, OKTHTTPParseErrorMalformedRequestLine);
+    return;
+  }
+  parser->methodLength = position;
+
+  parser->targetOffset = ++position;
+  while (position < lineEnd && line[position] != ' ') {
+    position++;
+  }
+  parser->targetLength = position - parser->targetOffset;
+  if (parser->targetLength == 0 || position == lineEnd) {
+    OKTFail(parser, OKTHTTPParseErrorMalformedRequestLine);
+    return;
+  }
+
+  parser->versionOffset = ++position;
+  parser->versionLength = lineEnd - position;
+  if (parser->versionLength < 8 || memcmp(line + position, "HTTP/", 5) != 0 ||
+      memchr(line + position, ' ', parser->versionLength) != NULL) {
+    OKTFail(parser, OKTHTTPParseErrorMalformedRequestLine);
+    return;
+  }
+  parser->state = kStateHeaderLine;
+}
+
+/*! @brief Indexes the "name: value" line starting at @c lineStart.
+ */
+static void OKTParseHeaderLine(OKTHTTPRequestParser *parser, size_t lineEnd) {
+  const char *head = parser->head;
+  size_t position = parser->lineStart;
+  while (position < lineEnd && OKTIsTokenCharacter(head[position])) {
+    position++;
+  }
+  // rejects obsolete line folding and whitespace before the colon
+  if (position == parser->lineStart || position == lineEnd || head[position] != ':') {
+    OKTFail(parser, OKTHTTPParseErrorMalformedHeader);
+    return;
+  }
+  if (parser->fieldCount == OKT_HTTP_MAX_HEADER_FIELDS) {
+    OKTFail(parser, OKTHTTPParseErrorTooManyHeaders);
+    return;
+  }
+
+  OKTHTTPHeaderField *field = &parser->fields[parser->fieldCount++];
+  field->nameOffset = parser->lineStart;
+  field->nameLength = position - parser->lineStart;
+  position++;
+  while (position < lineEnd && OKTIsWhitespace(head[position])) {
+    position++;
+  }
+  size_t valueEnd = lineEnd;
+  while (valueEnd > position && OKTIsWhitespace(head[valueEnd - 1])) {
+    valueEnd--;
+  }
+  field->valueOffset = position;
+  field->valueLength = valueEnd - position;
+}
+
+/*! @brief Chooses how the body is framed once the header fields are complete.
+ */
+static void OKTBeginBody(OKTHTTPRequestParser *parser) {
+  size_t transferEncodingLength = 0;
+  const char *transferEncoding =
+      OKTHTTPRequestParserHeaderValue(parser, "Transfer-Encoding", &transferEncodingLength);
+
+  int hasContentLength = 0;
+  uint64_t contentLength = 0;
+  for (size_t i = 0; i < parser->fieldCount; i++) {
+    const OKTHTTPHeaderField *field = &parser->fields[i];
+    if (!OKTEqualsIgnoringCase(parser->head + field->nameOffset, field->nameLength,
+                               "Content-Length")) {
+      continue;
+    }
+    uint64_t value = 0;
+    const char *digits = parser->head + field->valueOffset;
+    for (size_t j = 0; j < field->valueLength; j++) {
+      if (digits[j] < '0' || digits[j] > '9' || value > (UINT64_MAX - 9) / 10) {
+        OKTFail(parser, OKTHTTPParseErrorInvalidContentLength);
+        return;
+      }
+      value = value * 10 + (uint64_t)(digits[j] - '0');
+    }
+    if (field->valueLength == 0 || (hasContentLength && value != contentLength)) {
+      OKTFail(parser, OKTHTTPParseErrorInvalidContentLength);
+      return;
+    }
+    hasContentLength = 1;
+    contentLength = value;
+  }
+
+  if (transferEncoding) {
+    // a request with both framings is rejected rather than guessed at
+    if (hasContentLength) {
+      OKTFail(parser, OKTHTTPParseErrorInvalidContentLength);
+      return;
+    }
+    if (!OKTEqualsIgnoringCase(transferEncoding, transferEncodingLength, "chunked")) {
+      OKTFail(parser, OKTHTTPParseErrorUnsupportedTransferEncoding);
+      return;
+    }
+    parser->state = kStateChunkSize;
+    parser->lineLength = 0;
+    parser->remaining = 0;
+    parser->chunkSizeDigits = 0;
+    parser->expectsLineFeed = 0;
+    return;
+  }
+
+  if (contentLength > parser->maxBodyLength) {
+    OKTFail(parser, OKTHTTPParseErrorBodyTooLarge);
+    return;
+  }
+  if (contentLength == 0) {
+    parser->state = kStateComplete;
+    return;
+  }
+  if (!OKTReserve((void **)&parser->body, &parser->bodyCapacity, (size_t)contentLength, 256)) {
+    OKTFail(parser, OKTHTTPParseErrorOutOfMemory);
+    return;
+  }
+  parser->remaining = contentLength;
+  parser->state = kStateBody;
+}
+
+/*! @brief Handles the end of a request or header line held in @c head.
+ */
+static void OKTEndHeadLine(OKTHTTPRequestParser *parser) {
+  size_t lineEnd = parser->headLength;
+  if (lineEnd > parser->lineStart && parser->head[lineEnd - 1] == '\r') {
+    lineEnd--;
+  }
+  parser->headLength = lineEnd;
+
+  if (parser->state == kStateRequestLine) {
+    if (lineEnd == 0) {
+      // ignores empty lines before the request line (RFC 7230 section 3.5)
+      return;
+    }
+    OKTParseRequestLine(parser, lineEnd);
+  } else if (lineEnd == parser->lineStart) {
+    OKTBeginBody(parser);
+  } else {
+    OKTParseHeaderLine(parser, lineEnd);
+  }
+  parser->lineStart = parser->headLength;
+}
+
+/*! @brief Copies request line and header bytes into @c head up to the end of the current line.
+    @return The number of bytes consumed.
+ */
+static size_t OKTConsumeHead(OKTHTTPRequestParser *parser, const uint8_t *bytes, size_t length) {
+  const uint8_t *newline = memchr(bytes, '\n', length);
+  size_t segmentLength = newline ? (size_t)(newline - bytes) : length;
+  if (parser->headLength + segmentLength > parser->maxHeaderLength) {
+    OKTFail(parser, OKTHTTPParseErrorHeaderTooLarge);
+    return 0;
+  }
+  if (!OKTReserve((void **)&parser->head, &parser->headCapacity,
+                  parser->headLength + segmentLength, 512)) {
+    OKTFail(parser, OKTHTTPParseErrorOutOfMemory);
+    return 0;
+  }
+  memcpy(parser->head + parser->headLength, bytes, segmentLength);
+  parser->headLength += segmentLength;
+  if (!newline) {
+    return length;
+  }
+  OKTEndHeadLine(parser);
+  return segmentLength + 1;
+}
+
+/*! @brief Copies body bytes, bounded by the remaining length of the body or chunk.
+ */
+static size_t OKTConsumeBody(OKTHTTPRequestParser *parser, const uint8_t *bytes, size_t length) {
+  size_t count = parser->remaining < length ? (size_t)parser->remaining : length;
+  memcpy(parser->body + parser->bodyLength, bytes, count);
+  parser->bodyLength += count;
+  parser->remaining -= count;
+  if (parser->remaining == 0) {
+    parser->state = parser->state == kStateBody ? kStateComplete : kStateChunkDataEnd;
+  }
+  return count;
+}
+
+/*! @brief Counts a byte of chunk metadata or trailer against @c maxHeaderLength.
+ */
+static int OKTCountMetadataByte(OKTHTTPRequestParser *parser) {
+  if (++parser->lineLength > parser->maxHeaderLength) {
+    OKTFail(parser, OKTHTTPParseErrorHeaderTooLarge);
+    return 0;
+  }
+  return 1;
+}
+
+/*! @brief Handles the end of a chunk size line.
+ */
+static void OKTEndChunkSize(OKTHTTPRequestParser *parser) {
+  if (parser->chunkSizeDigits == 0) {
+    OKTFail(parser, OKTHTTPParseErrorMalformedChunk);
+    return;
+  }
+  parser->lineLength = 0;
+  if (parser->remaining == 0) {
+    parser->state = kStateTrailer;
+    return;
+  }
+  if (parser->remaining > parser->maxBodyLength - parser->bodyLength) {
+    OKTFail(parser, OKTHTTPParseErrorBodyTooLarge);
+    return;
+  }
+  if (!OKTReserve((void **)&parser->body, &parser->bodyCapacity,
+                  parser->bodyLength + (size_t)parser->remaining, 256)) {
+    OKTFail(parser, OKTHTTPParseErrorOutOfMemory);
+    return;
+  }
+  parser->state = kStateChunkData;
+}
+
+/*! @brief Consumes one byte of chunk framing: sizes, extensions, chunk terminators and trailers.
+ */
+static void OKTConsumeChunkFramingByte(OKTHTTPRequestParser *parser, uint8_t byte) {
+  // a CR must be followed by LF; a bare CR is rejected rather than skipped, so that "1\r0\n" is
+  // not read as the size 0x10
+  if (parser->expectsLineFeed) {
+    parser->expectsLineFeed = 0;
+    if (byte != '\n') {
+      OKTFail(parser, OKTHTTPParseErrorMalformedChunk);
+      return;
+    }
+  } else if (byte == '\r') {
+    parser->expectsLineFeed = 1;
+    return;
+  }
+
+  switch (parser->state) {
+    case kStateChunkSize: {
+      int value = OKTHexValue(byte);
+      if (value >= 0) {
+        if (parser->chunkSizeDigits == 15) {
+          OKTFail(parser, OKTHTTPParseErrorMalformedChunk);
+          return;
+        }
+        parser->remaining = parser->remaining * 16 + (uint64_t)value;
+        parser->chunkSizeDigits++;
+        OKTCountMetadataByte(parser);
+      } else if (byte == '\n') {
+        OKTEndChunkSize(parser);
+      } else if (byte == ';' || byte == ' ' || byte == '\t') {
+        parser->state = kStateChunkExtension;
+        OKTCountMetadataByte(parser);
+      } else {
+        OKTFail(parser, OKTHTTPParseErrorMalformedChunk);
+      }
+      return;
+    }
+    case kStateChunkExtension:
+      // chunk extensions are ignored
+      if (byte == '\n') {
+        OKTEndChunkSize(parser);
+      } else {
+        OKTCountMetadataByte(parser);
+      }
+      return;
+    case kStateChunkDataEnd:
+      if (byte == '\n') {
+        parser->state = kStateChunkSize;
+        parser->remaining = 0;
+        parser->chunkSizeDigits = 0;
+      } else {
+        OKTFail(parser, OKTHTTPParseErrorMalformedChunk);
+      }
+      return;
+    case kStateTrailer:
+      // trailer fields are ignored; an empty line ends the request
+      if (byte == '\n') {
+        if (parser->lineLength == 0) {
+          parser->state = kStateComplete;
+        }
+        parser->lineLength = 0;
+      } else {
+        OKTCountMetadataByte(parser);
+      }
+      return;
+    default:
+      return;
+  }
+}
+
+OKTHTTPParsePhase OKTHTTPRequestParserPhase(const OKTHTTPRequestParser *parser) {
+  switch (parser->state) {
+    case kStateRequestLine:
+      return parser->headLength == 0 ? OKTHTTPParsePhaseIdle : OKTHTTPParsePhaseHeader;
+    case kStateHeaderLine:
+      return OKTHTTPParsePhaseHeader;
+    case kStateComplete:
+    case kStateError:
+      return OKTHTTPParsePhaseIdle;
+    default:
+      return OKTHTTPParsePhaseBody;
+  }
+}
+
+size_t OKTHTTPRequestParserExecute(OKTHTTPRequestParser *parser,
+                                   const void *bytes,
+                                   size_t length,
+                                   OKTHTTPParseStatus *status) {
+  const uint8_t *input = bytes;
+  size_t consumed = 0;
+  while (consumed < length && parser->state != kStateComplete && parser->state != kStateError) {
+    switch (parser->state) {
+      case kStateRequestLine:
+      case kStateHeaderLine:
+        consumed += OKTConsumeHead(parser, input + consumed, length - consumed);
+        break;
+      case kStateBody:
+      case kStateChunkData:
+        consumed += OKTConsumeBody(parser, input + consumed, length - consumed);
+        break;
+      default:
+        OKTConsumeChunkFramingByte(parser, input[consumed++]);
+        break;
+    }
+  }
+
+  if (status) {
+    *status = parser->state == kStateComplete ? OKTHTTPParseStatusComplete
+        : parser->state == kStateError        ? OKTHTTPParseStatusError
+                                              : OKTHTTPParseStatusIncomplete;
+  }
+  return consumed;
+}
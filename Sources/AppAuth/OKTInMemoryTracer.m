@@ -0,0 +1,182 @@
+/*! @file OKTInMemoryTracer.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTInMemoryTracer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface OKTInMemoryTracer ()
+
+/*! @brief Records that @c span ended.
+ */
+- (void)spanDidEnd:(OKTRecordedSpan *)span;
+
+@end
+
+@implementation OKTRecordedSpan {
+  /*! @brief The tracer notified when the span ends.
+   */
+  __weak OKTInMemoryTracer *_tracer;
+
+  /*! @brief The attributes. Guarded by @c self.
+   */
+  NSMutableDictionary<NSString *, NSString *> *_attributes;
+
+  /*! @brief @c CFAbsoluteTimeGetCurrent() when the span started.
+   */
+  CFAbsoluteTime _startTime;
+
+  /*! @brief @c CFAbsoluteTimeGetCurrent() when the span ended, or 0. Guarded by @c self.
+   */
+  CFAbsoluteTime _endTime;
+}
+
+@synthesize error = _error;
+
+- (instancetype)initWithName:(NSString *)name tracer:(OKTInMemoryTracer *)tracer {
+  self = [super init];
+  if (self) {
+    _name = [name copy];
+    _tracer = tracer;
+    _attributes = [NSMutableDictionary dictionary];
+    _startTime = CFAbsoluteTimeGetCurrent();
+  }
+  return self;
+}
+
+- (NSDictionary<NSString *, NSString *> *)attributes {
+  @synchronized(self) {
+    return [_attributes copy];
+  }
+}
+
+- (nullable NSError *)error {
+  @synchronized(self) {
+    return _error;
+  }
+}
+
+- (BOOL)isEnded {
+  @synchronized(self) {
+    return _endTime != 0;
+  }
+}
+
+- (NSTimeInterval)duration {
+  @synchronized(self) {
+    return _endTime != 0 ? _endTime - _startTime : 0;
+  }
+}
+
+- (void)setAttribute:(NSString *)value forKey:(NSString *)key {
+  @synchronized(self) {
+    _attributes[key] = [value copy];
+  }
+}
+
+- (void)endWithError:(nullable NSError *)error {
+  @synchronized(self) {
+    NSAssert(_endTime == 0, @"Span %@ ended twice.", _name);
+    if (_endTime != 0) {
+      return;
+    }
+    _endTime = CFAbsoluteTimeGetCurrent();
+    _error = error;
+  }
+  [_tracer spanDidEnd:self];
+}
+
+#pragma mark - NSObject overrides
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, name: %@, attributes: %@, error: %@>",
+                                    NSStringFromClass([self class]),
+                                    (void *)self,
+                                    _name,
+                                    self.attributes,
+                                    self.error];
+}
+
+@end
+
+@implementation OKTInMemoryTracer {
+  /*! @brief All spans in start order. Guarded by @c self.
+   */
+  NSMutableArray<OKTRecordedSpan *> *_spans;
+
+  /*! @brief Names of the ended spans in end order. Guarded by @c self.
+   */
+  NSMutableArray<NSString *> *_endedSpanNames;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _spans = [NSMutableArray array];
+    _endedSpanNames = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (NSArray<OKTRecordedSpan *> *)spans {
+  @synchronized(self) {
+    return [_spans copy];
+  }
+}
+
+- (NSArray<NSString *> *)endedSpanNames {
+  @synchronized(self) {
+    return [_endedSpanNames copy];
+  }
+}
+
+- (NSArray<OKTRecordedSpan *> *)spansNamed:(NSString *)name {
+  NSPredicate *predicate = [NSPredicate predicateWithFormat:@"name == %@", name];
+  return [self.spans filteredArrayUsingPredicate:predicate];
+}
+
+- (void)reset {
+  @synchronized(self) {
+    [_spans removeAllObjects];
+    [_endedSpanNames removeAllObjects];
+  }
+}
+
+- (void)spanDidEnd:(OKTRecordedSpan *)span {
+  @synchronized(self) {
+    if ([_spans indexOfObjectIdenticalTo:span] != NSNotFound) {
+      [_endedSpanNames addObject:span.name];
+    }
+  }
+}
+
+#pragma mark - OKTTracer
+
+- (id<OKTTraceSpan>)beginSpanWithName:(NSString *)name {
+  OKTRecordedSpan *span = [[OKTRecordedSpan alloc] initWithName:name tracer:self];
+  @synchronized(self) {
+    [_spans addObject:span];
+  }
+  return span;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,155 @@
+/*! @file OKTLatencyHistogram.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTLatencyHistogram.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief Each power of two range is split into 2^kSubBucketBits linear buckets.
+ */
+static const int kSubBucketBits = 5;
+
+static const uint64_t kSubBucketCount = 1ull << kSubBucketBits;
+
+/*! @brief The largest trackable latency in microseconds, about 71 minutes.
+ */
+static const uint64_t kMaxTrackableValue = (1ull << 32) - 1;
+
+/*! @brief The number of buckets needed to reach @c kMaxTrackableValue.
+ */
+static const NSUInteger kBucketCount = (32 - kSubBucketBits + 1) * kSubBucketCount;
+
+/*! @brief The bucket of a value. Values below 2 * kSubBucketCount get a bucket each; above that,
+        every power of two range shares kSubBucketCount buckets.
+ */
+static NSUInteger OKTBucketIndexOfValue(uint64_t value) {
+  if (value < kSubBucketCount) {
+    return (NSUInteger)value;
+  }
+  int shift = (63 - __builtin_clzll(value)) - kSubBucketBits;
+  return (NSUInteger)(shift * kSubBucketCount + (value >> shift));
+}
+
+/*! @brief The highest value recorded in a bucket.
+ */
+static uint64_t OKTHighestValueOfBucket(NSUInteger index) {
+  if (index < 2 * kSubBucketCount) {
+    return index;
+  }
+  NSUInteger shift = index / kSubBucketCount - 1;
+  uint64_t subBucket = index - shift * kSubBucketCount;
+  return ((subBucket + 1) << shift) - 1;
+}
+
+@implementation OKTLatencyHistogram {
+  /*! @brief The number of values recorded in each of the @c kBucketCount buckets.
+   */
+  uint64_t *_counts;
+
+  uint64_t _minimumValue;
+
+  uint64_t _maximumValue;
+
+  uint64_t _sumValue;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _counts = calloc(kBucketCount, sizeof(uint64_t));
+  }
+  return self;
+}
+
+- (void)dealloc {
+  free(_counts);
+}
+
+- (id)copyWithZone:(nullable NSZone *)zone {
+  OKTLatencyHistogram *copy = [[[self class] allocWithZone:zone] init];
+  memcpy(copy->_counts, _counts, kBucketCount * sizeof(uint64_t));
+  copy->_count = _count;
+  copy->_minimumValue = _minimumValue;
+  copy->_maximumValue = _maximumValue;
+  copy->_sumValue = _sumValue;
+  return copy;
+}
+
+- (void)recordLatency:(NSTimeInterval)latency {
+  uint64_t value = 0;
+  if (latency > 0) {
+    double microseconds = round(latency * 1e6);
+    value = microseconds < kMaxTrackableValue ? (uint64_t)microseconds : kMaxTrackableValue;
+  }
+
+  _counts[OKTBucketIndexOfValue(value)]++;
+  if (_count == 0 || value < _minimumValue) {
+    _minimumValue = value;
+  }
+  _maximumValue = MAX(_maximumValue, value);
+  _sumValue += value;
+  _count++;
+}
+
+- (NSTimeInterval)minimum {
+  return _minimumValue / 1e6;
+}
+
+- (NSTimeInterval)maximum {
+  return _maximumValue / 1e6;
+}
+
+- (NSTimeInterval)sum {
+  return _sumValue / 1e6;
+}
+
+- (NSTimeInterval)mean {
+  return _count ? _sumValue / 1e6 / _count : 0;
+}
+
+- (NSTimeInterval)latencyAtPercentile:(double)percentile {
+  if (_count == 0) {
+    return 0;
+  }
+  double fraction = MIN(MAX(percentile, 0), 100) / 100;
+  uint64_t rank = MAX((uint64_t)1, (uint64_t)ceil(fraction * _count));
+  uint64_t cumulativeCount = 0;
+  for (NSUInteger index = 0; index < kBucketCount; index++) {
+    cumulativeCount += _counts[index];
+    if (cumulativeCount >= rank) {
+      return MIN(OKTHighestValueOfBucket(index), _maximumValue) / 1e6;
+    }
+  }
+  return self.maximum;
+}
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, count: %lu, p50: %.6f, p99: %.6f, max: %.6f>",
+                                    NSStringFromClass([self class]),
+                                    (void *)self,
+                                    (unsigned long)_count,
+                                    [self latencyAtPercentile:50],
+                                    [self latencyAtPercentile:99],
+                                    self.maximum];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
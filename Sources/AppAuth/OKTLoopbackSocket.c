@@ -0,0 +1,238 @@
+/*! @file OKTLoopbackSocket.c
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#include "OKTLoopbackSocket.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <unistd.h>
+
+/*! @brief Makes a socket non-blocking and close-on-exec, and stops writes to it from raising
+        @c SIGPIPE where the platform allows it per socket.
+ */
+static int OKTLoopbackSocketConfigure(int socket) {
+  int flags = fcntl(socket, F_GETFL);
+  if (flags < 0 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) < 0) {
+    return -1;
+  }
+  if (fcntl(socket, F_SETFD, FD_CLOEXEC) < 0) {
+    return -1;
+  }
+#ifdef SO_NOSIGPIPE
+  int yes = 1;
+  if (setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes)) < 0) {
+    return -1;
+  }
+#endif
+  return 0;
+}
+
+/*! @brief Closes the socket, preserving @c errno.
+ */
+static int OKTLoopbackSocketFail(int socket) {
+  int error = errno;
+  close(socket);
+  errno = error;
+  return -1;
+}
+
+int OKTLoopbackSocketListen(int family, uint16_t *port) {
+  struct sockaddr_storage address;
+  socklen_t addressLength;
+  memset(&address, 0, sizeof(address));
+  if (family == AF_INET) {
+    struct sockaddr_in *address4 = (struct sockaddr_in *)&address;
+    addressLength = sizeof(*address4);
+#ifdef __APPLE__
+    address4->sin_len = sizeof(*address4);
+#endif
+    address4->sin_family = AF_INET;
+    address4->sin_port = htons(*port);
+    address4->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  } else if (family == AF_INET6) {
+    struct sockaddr_in6 *address6 = (struct sockaddr_in6 *)&address;
+    addressLength = sizeof(*address6);
+#ifdef __APPLE__
+    address6->sin6_len = sizeof(*address6);
+#endif
+    address6->sin6_family = AF_INET6;
+    address6->sin6_port = htons(*port);
+    address6->sin6_addr = in6addr_loopback;
+  } else {
+    errno = EAFNOSUPPORT;
+    return -1;
+  }
+
+  int listener = socket(family, SOCK_STREAM, IPPROTO_TCP);
+  if (listener < 0) {
+    return -1;
+  }
+  int yes = 1;
+  if (OKTLoopbackSocketConfigure(listener) < 0 ||
+      setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) < 0) {
+    return OKTLoopbackSocketFail(listener);
+  }
+  // Keeps the IPv6 listener from also claiming the IPv4 port.
+  if (family == AF_INET6 &&
+      setsockopt(listener, IPPROTO_IPV6, IPV6_V6ONLY, &yes, sizeof(yes)) < 0) {
+    return OKTLoopbackSocketFail(listener);
+  }
+  if (bind(listener, (struct sockaddr *)&address, addressLength) < 0 ||
+      listen(listener, OKT_LOOPBACK_LISTEN_BACKLOG) < 0 ||
+      getsockname(listener, (struct sockaddr *)&address, &addressLength) < 0) {
+    return OKTLoopbackSocketFail(listener);
+  }
+
+  *port = ntohs(family == AF_INET ? ((struct sockaddr_in *)&address)->sin_port
+                                  : ((struct sockaddr_in6 *)&address)->sin6_port);
+  return listener;
+}
+
+/*! @brief The number of times a port chosen by the system for IPv4 is retried when it is in use
+        for IPv6.
+ */
+#define OKT_LOOPBACK_SYSTEM_PORT_ATTEMPTS 8
+
+/*! @brief Binds both families to one port.
+    @return 0, or -1 with @c errno set. @c EADDRINUSE means the port is in use for either family.
+ */
+static int OKTLoopbackSocketListenOnPort(int listeners[2], uint16_t *port) {
+  uint16_t boundPort = *port;
+  listeners[0] = OKTLoopbackSocketListen(AF_INET, &boundPort);
+  if (listeners[0] < 0) {
+    if (errno == EADDRINUSE) {
+      return -1;
+    }
+    boundPort = *port;
+  }
+  int ipv4Error = errno;
+
+  listeners[1] = OKTLoopbackSocketListen(AF_INET6, &boundPort);
+  if (listeners[1] < 0) {
+    if (errno == EADDRINUSE) {
+      if (0 <= listeners[0]) {
+        OKTLoopbackSocketFail(listeners[0]);
+        listeners[0] = -1;
+      }
+      return -1;
+    }
+    if (listeners[0] < 0) {
+      errno = ipv4Error;
+      return -1;
+    }
+  }
+  *port = boundPort;
+  return 0;
+}
+
+int OKTLoopbackSocketListenDualStack(int listeners[2],
+                                     uint16_t *port,
+                                     uint16_t fallbackPort,
+                                     uint16_t fallbackCount) {
+  listeners[0] = listeners[1] = -1;
+  if (*port == 0) {
+    for (int attempt = 0; attempt < OKT_LOOPBACK_SYSTEM_PORT_ATTEMPTS; attempt++) {
+      uint16_t boundPort = 0;
+      if (OKTLoopbackSocketListenOnPort(listeners, &boundPort) == 0) {
+        *port = boundPort;
+        return 0;
+      }
+      if (errno != EADDRINUSE) {
+        return -1;
+      }
+    }
+    return -1;
+  }
+
+  uint16_t boundPort = *port;
+  if (OKTLoopbackSocketListenOnPort(listeners, &boundPort) == 0) {
+    *port = boundPort;
+    return 0;
+  }
+  if (errno != EADDRINUSE) {
+    return -1;
+  }
+  for (uint32_t candidate = fallbackPort;
+       fallbackPort != 0 && candidate < (uint32_t)fallbackPort + fallbackCount &&
+           candidate <= UINT16_MAX;
+       candidate++) {
+    if (candidate == *port) {
+      continue;
+    }
+    boundPort = (uint16_t)candidate;
+    if (OKTLoopbackSocketListenOnPort(listeners, &boundPort) == 0) {
+      *port = boundPort;
+      return 0;
+    }
+    if (errno != EADDRINUSE) {
+      return -1;
+    }
+  }
+  errno = EADDRINUSE;
+  return -1;
+}
+
+int OKTLoopbackSocketAccept(int listener,
+                            struct sockaddr_storage *address,
+                            socklen_t *addressLength) {
+  int connection;
+  do {
+    *addressLength = sizeof(*address);
+    connection = accept(listener, (struct sockaddr *)address, addressLength);
+  } while (connection < 0 && errno == EINTR);
+  if (connection < 0) {
+    return -1;
+  }
+  if (OKTLoopbackSocketConfigure(connection) < 0) {
+    return OKTLoopbackSocketFail(connection);
+  }
+  // Responses are small and written at once; sends them without waiting for more bytes.
+  int yes = 1;
+  setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+  return connection;
+}
+
+ssize_t OKTLoopbackSocketRead(int socket, void *buffer, size_t length) {
+  ssize_t amount;
+  do {
+    amount = read(socket, buffer, length);
+  } while (amount < 0 && errno == EINTR);
+  return amount;
+}
+
+ssize_t OKTLoopbackSocketWrite(int socket, const struct iovec *buffers, int bufferCount) {
+  struct msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = (struct iovec *)buffers;
+  message.msg_iovlen = bufferCount;
+#ifdef MSG_NOSIGNAL
+  int flags = MSG_NOSIGNAL;
+#else
+  int flags = 0;
+#endif
+  ssize_t amount;
+  do {
+    amount = sendmsg(socket, &message, flags);
+  } while (amount < 0 && errno == EINTR);
+  return amount;
+}
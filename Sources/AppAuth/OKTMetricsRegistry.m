@@ -0,0 +1,165 @@
+/*! @file OKTMetricsRegistry.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTMetricsRegistry.h"
+
+#import "OKTLatencyHistogram.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+NSString *const OKTMetricTokenRefreshes = @"token_refreshes";
+
+NSString *const OKTMetricTokenRefreshFailures = @"token_refresh_failures";
+
+NSString *const OKTMetricCoalescedRefreshWaiters = @"coalesced_refresh_waiters";
+
+NSString *const OKTMetricTokenCacheHits = @"token_cache_hits";
+
+NSString *const OKTMetricTokenCacheMisses = @"token_cache_misses";
+
+NSString *const OKTMetricKeychainReads = @"keychain_reads";
+
+NSString *const OKTMetricKeychainWrites = @"keychain_writes";
+
+NSString *const OKTMetricOperationTokenRefresh = @"token_refresh";
+
+NSString *const OKTMetricOperationKeychainRead = @"keychain_read";
+
+NSString *const OKTMetricOperationKeychainWrite = @"keychain_write";
+
+/*! @brief The quantiles exported by @c textRepresentation.
+ */
+static const double kExportedQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+@implementation OKTMetricsSnapshot
+
+- (instancetype)initWithCounters:(NSDictionary<NSString *, NSNumber *> *)counters
+                       latencies:(NSDictionary<NSString *, OKTLatencyHistogram *> *)latencies {
+  self = [super init];
+  if (self) {
+    _counters = [counters copy];
+    _latencies = [latencies copy];
+  }
+  return self;
+}
+
+- (NSUInteger)valueOfCounter:(NSString *)name {
+  return _counters[name].unsignedIntegerValue;
+}
+
+- (NSString *)textRepresentation {
+  NSMutableString *text = [NSMutableString string];
+  for (NSString *name in [_counters.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+    NSString *metric = [NSString stringWithFormat:@"okta_oidc_%@_total", name];
+    [text appendFormat:@"# TYPE %@ counter\n%@ %@\n", metric, metric, _counters[name]];
+  }
+
+  if (_latencies.count == 0) {
+    return text;
+  }
+  [text appendString:@"# TYPE okta_oidc_latency_seconds summary\n"];
+  for (NSString *operation in [_latencies.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+    OKTLatencyHistogram *histogram = _latencies[operation];
+    for (size_t i = 0; i < sizeof(kExportedQuantiles) / sizeof(kExportedQuantiles[0]); i++) {
+      [text appendFormat:@"okta_oidc_latency_seconds{operation=\"%@\",quantile=\"%g\"} %.6f\n",
+                         operation,
+                         kExportedQuantiles[i],
+                         [histogram latencyAtPercentile:kExportedQuantiles[i] * 100]];
+    }
+    [text appendFormat:@"okta_oidc_latency_seconds_sum{operation=\"%@\"} %.6f\n",
+                       operation,
+                       histogram.sum];
+    [text appendFormat:@"okta_oidc_latency_seconds_count{operation=\"%@\"} %lu\n",
+                       operation,
+                       (unsigned long)histogram.count];
+  }
+  return text;
+}
+
+@end
+
+@implementation OKTMetricsRegistry {
+  /*! @brief The counter values. Guarded by @c self.
+   */
+  NSMutableDictionary<NSString *, NSNumber *> *_counters;
+
+  /*! @brief The histogram of each operation. Guarded by @c self.
+   */
+  NSMutableDictionary<NSString *, OKTLatencyHistogram *> *_latencies;
+}
+
++ (instancetype)sharedRegistry {
+  static OKTMetricsRegistry *sharedRegistry;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedRegistry = [[self alloc] init];
+  });
+  return sharedRegistry;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _counters = [NSMutableDictionary dictionary];
+    _latencies = [NSMutableDictionary dictionary];
+  }
+  return self;
+}
+
+- (void)incrementCounter:(NSString *)name {
+  @synchronized(self) {
+    _counters[name] = @(_counters[name].unsignedIntegerValue + 1);
+  }
+}
+
+- (void)recordLatency:(NSTimeInterval)latency forOperation:(NSString *)operation {
+  @synchronized(self) {
+    OKTLatencyHistogram *histogram = _latencies[operation];
+    if (!histogram) {
+      histogram = [[OKTLatencyHistogram alloc] init];
+      _latencies[operation] = histogram;
+    }
+    [histogram recordLatency:latency];
+  }
+}
+
+- (OKTMetricsSnapshot *)snapshot {
+  @synchronized(self) {
+    NSMutableDictionary<NSString *, OKTLatencyHistogram *> *latencies =
+        [NSMutableDictionary dictionaryWithCapacity:_latencies.count];
+    [_latencies enumerateKeysAndObjectsUsingBlock:^(NSString *operation,
+                                                    OKTLatencyHistogram *histogram,
+                                                    BOOL *stop) {
+      latencies[operation] = [histogram copy];
+    }];
+    return [[OKTMetricsSnapshot alloc] initWithCounters:_counters latencies:latencies];
+  }
+}
+
+- (void)reset {
+  @synchronized(self) {
+    [_counters removeAllObjects];
+    [_latencies removeAllObjects];
+  }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
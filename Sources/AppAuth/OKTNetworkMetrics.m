@@ -0,0 +1,213 @@
+/*! @file OKTNetworkMetrics.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTNetworkMetrics.h"
+
+#import "OktaNetworkRequestCustomizationDelegate.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+NSString *const OKTNetworkOperationDiscovery = @"discovery";
+
+NSString *const OKTNetworkOperationTokenExchange = @"token_exchange";
+
+NSString *const OKTNetworkOperationTokenRefresh = @"refresh";
+
+NSString *const OKTNetworkOperationRevoke = @"revoke";
+
+NSString *const OKTNetworkOperationIntrospect = @"introspect";
+
+NSString *const OKTNetworkOperationUserInfo = @"userinfo";
+
+NSString *const OKTNetworkOperationSessionTokenAuthorization = @"session_token_authorization";
+
+NSString *const OKTNetworkOperationRegistration = @"registration";
+
+NSString *const OKTNetworkOperationOther = @"other";
+
+/*! @brief The @c NSURLProtocol property holding the operation of a request.
+ */
+static NSString *const kOperationPropertyKey = @"com.okta.oidc.metrics.operation";
+
+/*! @brief The @c NSURLProtocol property holding the identifier of the metrics delegate.
+ */
+static NSString *const kDelegatePropertyKey = @"com.okta.oidc.metrics.delegate";
+
+/*! @brief The interval between two dates, or 0 if either is missing.
+ */
+static NSTimeInterval OKTIntervalBetween(NSDate *_Nullable start, NSDate *_Nullable end) {
+  return start && end ? MAX(0, [end timeIntervalSinceDate:start]) : 0;
+}
+
+@implementation OKTNetworkMetrics
+
+- (instancetype)initWithTaskMetrics:(NSURLSessionTaskMetrics *)taskMetrics
+                               task:(nullable NSURLSessionTask *)task
+                          operation:(NSString *)operation {
+  self = [super init];
+  if (self) {
+    _operation = [operation copy];
+    _totalDuration = taskMetrics.taskInterval.duration;
+    _redirectCount = taskMetrics.redirectCount;
+    _requestBodyBytes = task.countOfBytesSent;
+    _responseBodyBytes = task.countOfBytesReceived;
+
+    NSURLSessionTaskTransactionMetrics *transaction = taskMetrics.transactionMetrics.lastObject;
+    _URL = transaction.request.URL ?: task.originalRequest.URL;
+    if ([transaction.response isKindOfClass:[NSHTTPURLResponse class]]) {
+      _statusCode = ((NSHTTPURLResponse *)transaction.response).statusCode;
+    }
+    _domainLookupDuration =
+        OKTIntervalBetween(transaction.domainLookupStartDate, transaction.domainLookupEndDate);
+    _connectDuration = OKTIntervalBetween(transaction.connectStartDate, transaction.connectEndDate);
+    _secureConnectionDuration = OKTIntervalBetween(transaction.secureConnectionStartDate,
+                                                   transaction.secureConnectionEndDate);
+    _timeToFirstByte = OKTIntervalBetween(transaction.requestStartDate,
+                                          transaction.responseStartDate);
+    _transferDuration = OKTIntervalBetween(transaction.responseStartDate,
+                                           transaction.responseEndDate);
+    _reusedConnection = transaction.reusedConnection;
+    _networkProtocolName = [transaction.networkProtocolName copy];
+  }
+  return self;
+}
+
+#pragma mark - NSObject overrides
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, operation: %@, URL: %@, status: %ld, "
+                                     "total: %.3fs, TTFB: %.3fs, reused: %@, protocol: %@>",
+                                    NSStringFromClass([self class]),
+                                    (void *)self,
+                                    _operation,
+                                    _URL,
+                                    (long)_statusCode,
+                                    _totalDuration,
+                                    _timeToFirstByte,
+                                    _reusedConnection ? @"YES" : @"NO",
+                                    _networkProtocolName];
+}
+
+@end
+
+@implementation OKTNetworkMetricsCollector {
+  /*! @brief Identifiers of the delegates requests were tagged with. Guarded by @c self.
+   */
+  NSMapTable<id<OktaNetworkRequestCustomizationDelegate>, NSString *> *_identifiersByDelegate;
+
+  /*! @brief The delegates by identifier. Guarded by @c self.
+   */
+  NSMapTable<NSString *, id<OktaNetworkRequestCustomizationDelegate>> *_delegatesByIdentifier;
+
+  /*! @brief The number of identifiers assigned so far. Guarded by @c self.
+   */
+  NSUInteger _identifierCount;
+}
+
++ (instancetype)sharedCollector {
+  static OKTNetworkMetricsCollector *sharedCollector;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedCollector = [[self alloc] init];
+  });
+  return sharedCollector;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    // One entry per delegate rather than per request, so the tables stay small for long-lived
+    // delegates.
+    _identifiersByDelegate = [NSMapTable weakToStrongObjectsMapTable];
+    _delegatesByIdentifier = [NSMapTable strongToWeakObjectsMapTable];
+  }
+  return self;
+}
+
++ (nullable NSString *)operationOfRequest:(NSURLRequest *)request {
+  return [NSURLProtocol propertyForKey:kOperationPropertyKey inRequest:request];
+}
+
+- (NSURLRequest *)request:(NSURLRequest *)request
+      taggedWithOperation:(nullable NSString *)operation
+                 delegate:(nullable id<OktaNetworkRequestCustomizationDelegate>)delegate {
+  NSString *delegateIdentifier;
+  if ([delegate respondsToSelector:@selector(didCollectMetrics:)]) {
+    delegateIdentifier = [self identifierForDelegate:delegate];
+  }
+  if (!operation && !delegateIdentifier) {
+    return request;
+  }
+
+  NSMutableURLRequest *taggedRequest = [request mutableCopy];
+  if (operation) {
+    [NSURLProtocol setProperty:operation forKey:kOperationPropertyKey inRequest:taggedRequest];
+  }
+  if (delegateIdentifier) {
+    [NSURLProtocol setProperty:delegateIdentifier
+                        forKey:kDelegatePropertyKey
+                     inRequest:taggedRequest];
+  }
+  return [taggedRequest copy];
+}
+
+- (void)collectMetrics:(NSURLSessionTaskMetrics *)metrics forTask:(NSURLSessionTask *)task {
+  NSURLRequest *request = task.originalRequest;
+  if (!request) {
+    return;
+  }
+  NSString *delegateIdentifier =
+      [NSURLProtocol propertyForKey:kDelegatePropertyKey inRequest:request];
+  if (!delegateIdentifier) {
+    return;
+  }
+  id<OktaNetworkRequestCustomizationDelegate> delegate;
+  @synchronized(self) {
+    delegate = [_delegatesByIdentifier objectForKey:delegateIdentifier];
+  }
+  if (!delegate) {
+    return;
+  }
+
+  NSString *operation = [[self class] operationOfRequest:request] ?: OKTNetworkOperationOther;
+  [delegate didCollectMetrics:[[OKTNetworkMetrics alloc] initWithTaskMetrics:metrics
+                                                                        task:task
+                                                                   operation:operation]];
+}
+
+#pragma mark -
+
+/*! @brief Returns the identifier of @c delegate, assigning one on first use.
+ */
+- (NSString *)identifierForDelegate:(id<OktaNetworkRequestCustomizationDelegate>)delegate {
+  @synchronized(self) {
+    NSString *identifier = [_identifiersByDelegate objectForKey:delegate];
+    if (!identifier) {
+      identifier = [NSString stringWithFormat:@"%lu", (unsigned long)++_identifierCount];
+      [_identifiersByDelegate setObject:identifier forKey:delegate];
+      [_delegatesByIdentifier setObject:delegate forKey:identifier];
+    }
+    return identifier;
+  }
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,301 @@
+/*! @file OKTPortableCrypto.c
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#if !defined(__APPLE__) && !defined(_DEFAULT_SOURCE)
+// exposes getentropy and O_CLOEXEC when building with a strict C standard on Linux
+#define _DEFAULT_SOURCE
+#endif
+
+#include "OKTPortableCrypto.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <sys/random.h>
+#endif
+
+// SHA-256
+
+static const uint32_t kSHA256RoundConstants[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define OKT_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static inline uint32_t OKTLoadBigEndian32(const uint8_t *bytes) {
+  return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 |
+         (uint32_t)bytes[3];
+}
+
+static inline void OKTStoreBigEndian32(uint8_t *bytes, uint32_t value) {
+  bytes[0] = (uint8_t)(value >> 24);
+  bytes[1] = (uint8_t)(value >> 16);
+  bytes[2] = (uint8_t)(value >> 8);
+  bytes[3] = (uint8_t)value;
+}
+
+/*! @brief Compresses one 64-byte block into @c state.
+ */
+static void OKTSHA256Transform(uint32_t state[8], const uint8_t block[64]) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; i++) {
+    w[i] = OKTLoadBigEndian32(block + 4 * i);
+  }
+  for (int i = 16; i < 64; i++) {
+    uint32_t s0 = OKT_ROTR(w[i - 15], 7) ^ OKT_ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 = OKT_ROTR(w[i - 2], 17) ^ OKT_ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+  uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+  for (int i = 0; i < 64; i++) {
+    uint32_t s1 = OKT_ROTR(e, 6) ^ OKT_ROTR(e, 11) ^ OKT_ROTR(e, 25);
+    uint32_t choice = (e & f) ^ (~e & g);
+    uint32_t t1 = h + s1 + choice + kSHA256RoundConstants[i] + w[i];
+    uint32_t s0 = OKT_ROTR(a, 2) ^ OKT_ROTR(a, 13) ^ OKT_ROTR(a, 22);
+    uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+    uint32_t t2 = s0 + majority;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+void OKTSHA256Init(OKTSHA256Context *context) {
+  static const uint32_t initialState[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+  };
+  memcpy(context->state, initialState, sizeof(initialState));
+  context->length = 0;
+  context->blockLength = 0;
+}
+
+void OKTSHA256Update(OKTSHA256Context *context, const void *data, size_t length) {
+  const uint8_t *bytes = data;
+  context->length += length;
+
+  if (context->blockLength > 0) {
+    size_t copyLength = 64 - context->blockLength;
+    if (copyLength > length) {
+      copyLength = length;
+    }
+    memcpy(context->block + context->blockLength, bytes, copyLength);
+    context->blockLength += copyLength;
+    bytes += copyLength;
+    length -= copyLength;
+    if (context->blockLength < 64) {
+      return;
+    }
+    OKTSHA256Transform(context->state, context->block);
+    context->blockLength = 0;
+  }
+
+  // compresses whole blocks straight from the input
+  while (length >= 64) {
+    OKTSHA256Transform(context->state, bytes);
+    bytes += 64;
+    length -= 64;
+  }
+  memcpy(context->block, bytes, length);
+  context->blockLength = length;
+}
+
+void OKTSHA256Final(OKTSHA256Context *context, uint8_t digest[OKT_SHA256_DIGEST_LENGTH]) {
+  uint64_t bitLength = context->length * 8;
+  context->block[context->blockLength++] = 0x80;
+  if (context->blockLength > 56) {
+    memset(context->block + context->blockLength, 0, 64 - context->blockLength);
+    OKTSHA256Transform(context->state, context->block);
+    context->blockLength = 0;
+  }
+  memset(context->block + context->blockLength, 0, 56 - context->blockLength);
+  for (int i = 0; i < 8; i++) {
+    context->block[63 - i] = (uint8_t)(bitLength >> (8 * i));
+  }
+  OKTSHA256Transform(context->state, context->block);
+
+  for (int i = 0; i < 8; i++) {
+    OKTStoreBigEndian32(digest + 4 * i, context->state[i]);
+  }
+  memset(context, 0, sizeof(*context));
+}
+
+void OKTSHA256(const void *data, size_t length, uint8_t digest[OKT_SHA256_DIGEST_LENGTH]) {
+  OKTSHA256Context context;
+  OKTSHA256Init(&context);
+  OKTSHA256Update(&context, data, length);
+  OKTSHA256Final(&context, digest);
+}
+
+void OKTHMACSHA256(const void *key,
+                   size_t keyLength,
+                   const void *data,
+                   size_t length,
+                   uint8_t mac[OKT_SHA256_DIGEST_LENGTH]) {
+  uint8_t keyBlock[64] = {0};
+  if (keyLength > sizeof(keyBlock)) {
+    OKTSHA256(key, keyLength, keyBlock);
+  } else if (keyLength > 0) {
+    memcpy(keyBlock, key, keyLength);
+  }
+
+  uint8_t pad[64];
+  uint8_t innerDigest[OKT_SHA256_DIGEST_LENGTH];
+  OKTSHA256Context context;
+
+  for (int i = 0; i < 64; i++) {
+    pad[i] = keyBlock[i] ^ 0x36;
+  }
+  OKTSHA256Init(&context);
+  OKTSHA256Update(&context, pad, sizeof(pad));
+  OKTSHA256Update(&context, data, length);
+  OKTSHA256Final(&context, innerDigest);
+
+  for (int i = 0; i < 64; i++) {
+    pad[i] = keyBlock[i] ^ 0x5c;
+  }
+  OKTSHA256Init(&context);
+  OKTSHA256Update(&context, pad, sizeof(pad));
+  OKTSHA256Update(&context, innerDigest, sizeof(innerDigest));
+  OKTSHA256Final(&context, mac);
+
+  memset(keyBlock, 0, sizeof(keyBlock));
+  memset(pad, 0, sizeof(pad));
+  memset(innerDigest, 0, sizeof(innerDigest));
+}
+
+// Random bytes
+
+/*! @brief Size of the buffer small requests are served from.
+ */
+#define OKT_RANDOM_BUFFER_SIZE 4096
+
+/*! @brief Requests larger than this read the system CSPRNG directly.
+ */
+#define OKT_RANDOM_MAX_BUFFERED_REQUEST 256
+
+/*! @brief Largest request @c getentropy accepts.
+ */
+#define OKT_GETENTROPY_MAX 256
+
+static pthread_mutex_t gRandomMutex = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t gRandomBuffer[OKT_RANDOM_BUFFER_SIZE];
+static size_t gRandomBufferPosition = OKT_RANDOM_BUFFER_SIZE;
+static pid_t gRandomBufferPid;
+
+/*! @brief Reads /dev/urandom, for systems without @c getentropy.
+ */
+static int OKTReadDevURandom(uint8_t *bytes, size_t length) {
+  int fileDescriptor;
+  do {
+    fileDescriptor = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+  } while (fileDescriptor < 0 && errno == EINTR);
+  if (fileDescriptor < 0) {
+    return errno;
+  }
+  while (length > 0) {
+    ssize_t result = read(fileDescriptor, bytes, length);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      int error = result < 0 ? errno : EIO;
+      close(fileDescriptor);
+      return error;
+    }
+    bytes += result;
+    length -= (size_t)result;
+  }
+  close(fileDescriptor);
+  return 0;
+}
+
+/*! @brief Reads the system CSPRNG.
+ */
+static int OKTSystemRandomBytes(uint8_t *bytes, size_t length) {
+  while (length > 0) {
+    size_t chunkLength = length < OKT_GETENTROPY_MAX ? length : OKT_GETENTROPY_MAX;
+    if (getentropy(bytes, chunkLength) != 0) {
+      return errno == ENOSYS ? OKTReadDevURandom(bytes, length) : errno;
+    }
+    bytes += chunkLength;
+    length -= chunkLength;
+  }
+  return 0;
+}
+
+int OKTBufferedRandomBytes(void *bytes, size_t length) {
+  if (length > OKT_RANDOM_MAX_BUFFERED_REQUEST) {
+    return OKTSystemRandomBytes(bytes, length);
+  }
+
+  pthread_mutex_lock(&gRandomMutex);
+  pid_t pid = getpid();
+  if (pid != gRandomBufferPid) {
+    // a forked child must not reuse bytes the parent may also hand out
+    memset(gRandomBuffer, 0, sizeof(gRandomBuffer));
+    gRandomBufferPosition = OKT_RANDOM_BUFFER_SIZE;
+    gRandomBufferPid = pid;
+  }
+  if (OKT_RANDOM_BUFFER_SIZE - gRandomBufferPosition < length) {
+    int error = OKTSystemRandomBytes(gRandomBuffer, sizeof(gRandomBuffer));
+    if (error != 0) {
+      pthread_mutex_unlock(&gRandomMutex);
+      return error;
+    }
+    gRandomBufferPosition = 0;
+  }
+  memcpy(bytes, gRandomBuffer + gRandomBufferPosition, length);
+  memset(gRandomBuffer + gRandomBufferPosition, 0, length);
+  gRandomBufferPosition += length;
+  pthread_mutex_unlock(&gRandomMutex);
+  return 0;
+}
+
+void OKTBufferedRandomReset(void) {
+  pthread_mutex_lock(&gRandomMutex);
+  memset(gRandomBuffer, 0, sizeof(gRandomBuffer));
+  gRandomBufferPosition = OKT_RANDOM_BUFFER_SIZE;
+  pthread_mutex_unlock(&gRandomMutex);
+}
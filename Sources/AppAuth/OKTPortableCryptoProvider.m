@@ -0,0 +1,47 @@
+/*! @file OKTPortableCryptoProvider.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTPortableCryptoProvider.h"
+
+#import "OKTPortableCrypto.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@implementation OKTPortableCryptoProvider
+
+- (BOOL)getRandomBytes:(void *)bytes length:(size_t)length {
+  return OKTBufferedRandomBytes(bytes, length) == 0;
+}
+
+- (NSData *)SHA256DigestOfData:(NSData *)data {
+  NSMutableData *digest = [NSMutableData dataWithLength:OKT_SHA256_DIGEST_LENGTH];
+  OKTSHA256(data.bytes, data.length, digest.mutableBytes);
+  return digest;
+}
+
+- (NSData *)HMACSHA256OfData:(NSData *)data key:(NSData *)key {
+  NSMutableData *mac = [NSMutableData dataWithLength:OKT_SHA256_DIGEST_LENGTH];
+  OKTHMACSHA256(key.bytes, key.length, data.bytes, data.length, mac.mutableBytes);
+  return mac;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
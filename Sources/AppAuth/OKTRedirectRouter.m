@@ -0,0 +1,226 @@
+/*! @file OKTRedirectRouter.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTRedirectRouter.h"
+
+#import "OKTErrorUtilities.h"
+#import "OKTExternalUserAgentSession.h"
+#import "OKTURLEncodingUtilities.h"
+
+/*! @brief Name of the redirect parameter that flows are keyed by.
+ */
+static NSString *const kStateParameter = @"state";
+
+/*! @brief Default value of @c OKTRedirectRouter.flowTimeout.
+ */
+static const NSTimeInterval kDefaultFlowTimeout = 10 * 60;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief A registered flow and the time it is evicted at.
+ */
+@interface OKTRedirectRouterEntry : NSObject
+
+@property(nonatomic, strong) id<OKTExternalUserAgentSession> flow;
+
+/*! @brief Eviction time, relative to the reference date.
+ */
+@property(nonatomic) NSTimeInterval deadline;
+
+@end
+
+@implementation OKTRedirectRouterEntry
+@end
+
+@implementation OKTRedirectRouter {
+  /*! @brief Registered flows by state. Guarded by @c self.
+   */
+  NSMutableDictionary<NSString *, OKTRedirectRouterEntry *> *_entries;
+
+  /*! @brief Fires at @c _nextEviction. Created with the first registration.
+   */
+  dispatch_source_t _evictionTimer;
+
+  /*! @brief The earliest deadline the timer is set for, or @c DBL_MAX while it is idle. Guarded by
+          @c self.
+   */
+  NSTimeInterval _nextEviction;
+}
+
+@synthesize flowTimeout = _flowTimeout;
+
++ (instancetype)sharedRouter {
+  static OKTRedirectRouter *sharedRouter;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedRouter = [[self alloc] init];
+  });
+  return sharedRouter;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _entries = [NSMutableDictionary dictionary];
+    _flowTimeout = kDefaultFlowTimeout;
+    _nextEviction = DBL_MAX;
+  }
+  return self;
+}
+
+- (void)dealloc {
+  if (_evictionTimer) {
+    dispatch_source_cancel(_evictionTimer);
+  }
+}
+
+- (NSUInteger)flowCount {
+  @synchronized(self) {
+    return _entries.count;
+  }
+}
+
+- (BOOL)registerFlow:(id<OKTExternalUserAgentSession>)flow forState:(NSString *)state {
+  OKTRedirectRouterEntry *entry = [[OKTRedirectRouterEntry alloc] init];
+  entry.flow = flow;
+  entry.deadline = [NSDate timeIntervalSinceReferenceDate] + self.flowTimeout;
+  @synchronized(self) {
+    if (_entries[state]) {
+      return NO;
+    }
+    _entries[state] = entry;
+    if (entry.deadline < _nextEviction) {
+      [self scheduleEvictionAt:entry.deadline];
+    }
+  }
+  return YES;
+}
+
+- (void)unregisterFlowForState:(NSString *)state {
+  @synchronized(self) {
+    [_entries removeObjectForKey:state];
+  }
+}
+
+- (BOOL)resumeExternalUserAgentFlowWithURL:(NSURL *)URL {
+  NSString *state = [[self class] stateOfURL:URL];
+  if (!state) {
+    return NO;
+  }
+  id<OKTExternalUserAgentSession> flow;
+  @synchronized(self) {
+    flow = _entries[state].flow;
+  }
+  // The flow rejects URLs that do not match its redirect URL, and stays registered.
+  if (!flow || ![flow resumeExternalUserAgentFlowWithURL:URL]) {
+    return NO;
+  }
+  @synchronized(self) {
+    if (_entries[state].flow == flow) {
+      [_entries removeObjectForKey:state];
+    }
+  }
+  return YES;
+}
+
+/*! @brief Returns the @c state parameter of the query, or of the fragment if the query has none.
+ */
++ (nullable NSString *)stateOfURL:(NSURL *)URL {
+  __block NSString *state = nil;
+  void (^findState)(NSString *, NSString *) = ^(NSString *name, NSString *value) {
+    if (!state && [name isEqualToString:kStateParameter]) {
+      state = value;
+    }
+  };
+  if (URL.query) {
+    [OKTURLEncodingUtilities enumerateParametersInQuery:URL.query usingBlock:findState];
+  }
+  if (!state && URL.fragment) {
+    [OKTURLEncodingUtilities enumerateParametersInQuery:URL.fragment usingBlock:findState];
+  }
+  return state;
+}
+
+#pragma mark - Eviction
+
+/*! @brief Sets the timer to fire at the deadline. Must be called while synchronized on @c self.
+ */
+- (void)scheduleEvictionAt:(NSTimeInterval)deadline {
+  if (!_evictionTimer) {
+    dispatch_queue_t queue =
+        dispatch_queue_create("com.okta.appauth.redirectrouter", DISPATCH_QUEUE_SERIAL);
+    _evictionTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+    __weak OKTRedirectRouter *weakSelf = self;
+    dispatch_source_set_event_handler(_evictionTimer, ^{
+      [weakSelf evictExpiredFlows];
+    });
+    dispatch_resume(_evictionTimer);
+  }
+  _nextEviction = deadline;
+  NSTimeInterval delay = MAX(deadline - [NSDate timeIntervalSinceReferenceDate], 0);
+  dispatch_source_set_timer(_evictionTimer,
+                            dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                            DISPATCH_TIME_FOREVER,
+                            (uint64_t)(0.1 * NSEC_PER_SEC));
+}
+
+/*! @brief Removes the flows past their deadline, fails them on the main queue, and sets the timer
+        for the next deadline.
+ */
+- (void)evictExpiredFlows {
+  NSMutableArray<id<OKTExternalUserAgentSession>> *expiredFlows = [NSMutableArray array];
+  @synchronized(self) {
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    NSTimeInterval nextEviction = DBL_MAX;
+    NSMutableArray<NSString *> *expiredStates = [NSMutableArray array];
+    for (NSString *state in _entries) {
+      OKTRedirectRouterEntry *entry = _entries[state];
+      if (entry.deadline <= now) {
+        [expiredStates addObject:state];
+        [expiredFlows addObject:entry.flow];
+      } else {
+        nextEviction = MIN(nextEviction, entry.deadline);
+      }
+    }
+    [_entries removeObjectsForKeys:expiredStates];
+    _nextEviction = DBL_MAX;
+    if (nextEviction < DBL_MAX) {
+      [self scheduleEvictionAt:nextEviction];
+    }
+  }
+  if (expiredFlows.count == 0) {
+    return;
+  }
+
+  NSError *error =
+      [OKTErrorUtilities errorWithCode:OKTErrorCodeProgramCanceledAuthorizationFlow
+                       underlyingError:nil
+                           description:@"The authorization flow expired before a redirect was "
+                                        "received."];
+  dispatch_async(dispatch_get_main_queue(), ^{
+    for (id<OKTExternalUserAgentSession> flow in expiredFlows) {
+      [flow failExternalUserAgentFlowWithError:error];
+    }
+  });
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -53,7 +53,15 @@ static NSString *const kSubjectTypeKey = @"subject_type";
  */
 static NSString *const kAdditionalParametersKey = @"additionalParameters";
 
-@implementation OKTRegistrationRequest
+@implementation OKTRegistrationRequest {
+  /*! @brief The serialized request body, built on first use. Guarded by @c self.
+   */
+  NSData *_JSONData;
+
+  /*! @brief The registration request, built on first use. Guarded by @c self.
+   */
+  NSURLRequest *_URLRequest;
+}
 
 #pragma mark - Initializers
 
@@ -174,13 +182,12 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
 #pragma mark - NSObject overrides
 
 - (NSString *)description {
-  NSURLRequest *request = [self URLRequest];
-  NSString *requestBody = [[NSString alloc] initWithData:request.HTTPBody
+  NSString *requestBody = [[NSString alloc] initWithData:[self JSONString]
                                                 encoding:NSUTF8StringEncoding];
   return [NSString stringWithFormat:@"<%@: %p, request: <URL: %@, HTTPBody: %@>>",
                                     NSStringFromClass([self class]),
                                     (void *)self,
-                                    request.URL,
+                                    _configuration.registrationEndpoint,
                                     requestBody];
 }
 
@@ -191,6 +198,12 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
   static NSString *const kHTTPContentTypeHeaderValue = @"application/json";
   static NSString *const kHTTPAuthorizationHeaderKey = @"Authorization";
 
+  @synchronized(self) {
+    if (_URLRequest) {
+      return _URLRequest;
+    }
+  }
+
   NSData *postBody = [self JSONString];
   if (!postBody) {
     return nil;
@@ -206,10 +219,29 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
     [URLRequest setValue:value forHTTPHeaderField:kHTTPAuthorizationHeaderKey];
   }
   URLRequest.HTTPBody = postBody;
-  return URLRequest;
+
+  // The request is immutable, so the built request is shared by every later call.
+  @synchronized(self) {
+    if (!_URLRequest) {
+      _URLRequest = [URLRequest copy];
+    }
+    return _URLRequest;
+  }
 }
 
 - (NSData *)JSONString {
+  @synchronized(self) {
+    if (!_JSONData) {
+      _JSONData = [self serializeJSON];
+    }
+    return _JSONData;
+  }
+}
+
+/*! @brief Serializes the registration parameters to JSON.
+    @return The JSON data, or nil if the parameters cannot be serialized.
+ */
+- (NSData *)serializeJSON {
   // Dictionary with several kay/value pairs and the above array of arrays
   NSMutableDictionary *dict = [[NSMutableDictionary alloc] init];
   NSMutableArray<NSString *> *redirectURIStrings =
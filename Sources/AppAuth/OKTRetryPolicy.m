@@ -0,0 +1,310 @@
+/*! @file OKTRetryPolicy.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTRetryPolicy.h"
+
+#import "OKTCircuitBreaker.h"
+#import "OKTDefines.h"
+
+/*! @brief The name of the header used by servers to request a delay before the next attempt.
+    @see https://tools.ietf.org/html/rfc7231#section-7.1.3
+ */
+static NSString *const kRetryAfterHeader = @"Retry-After";
+
+/*! @brief The format of an IMF-fixdate, the preferred HTTP-date format.
+    @see https://tools.ietf.org/html/rfc7231#section-7.1.1.1
+ */
+static NSString *const kHTTPDateFormat = @"EEE, dd MMM yyyy HH:mm:ss zzz";
+
+static OKTRetryPolicy *__nullable gSharedPolicy;
+
+NS_ASSUME_NONNULL_BEGIN
+
+@implementation OKTRetryPolicy
+
+- (instancetype)init
+    OKT_UNAVAILABLE_USE_INITIALIZER(
+        @selector(initWithMaximumAttempts:baseDelay:maximumDelay:deadline:)
+    )
+
+- (instancetype)initWithMaximumAttempts:(NSUInteger)maximumAttempts
+                              baseDelay:(NSTimeInterval)baseDelay
+                           maximumDelay:(NSTimeInterval)maximumDelay
+                               deadline:(NSTimeInterval)deadline {
+  self = [super init];
+  if (self) {
+    _maximumAttempts = MAX(maximumAttempts, 1);
+    _baseDelay = MAX(baseDelay, 0);
+    _maximumDelay = MAX(maximumDelay, _baseDelay);
+    _deadline = MAX(deadline, 0);
+  }
+  return self;
+}
+
++ (instancetype)noRetryPolicy {
+  return [[self alloc] initWithMaximumAttempts:1 baseDelay:0 maximumDelay:0 deadline:0];
+}
+
++ (instancetype)defaultRetryPolicy {
+  return [[self alloc] initWithMaximumAttempts:3 baseDelay:0.5 maximumDelay:8 deadline:30];
+}
+
++ (OKTRetryPolicy *)sharedPolicy {
+  @synchronized(self) {
+    if (!gSharedPolicy) {
+      gSharedPolicy = [OKTRetryPolicy noRetryPolicy];
+    }
+    return gSharedPolicy;
+  }
+}
+
++ (void)setSharedPolicy:(OKTRetryPolicy *)policy {
+  NSAssert(policy, @"Parameter: |policy| must be non-nil.");
+  @synchronized(self) {
+    gSharedPolicy = [policy copy];
+  }
+}
+
+#pragma mark - NSCopying
+
+- (instancetype)copyWithZone:(nullable NSZone *)zone {
+  // The object is immutable.
+  return self;
+}
+
+#pragma mark - NSObject overrides
+
+- (NSString *)description {
+  return [NSString stringWithFormat:@"<%@: %p, maximumAttempts: %lu, baseDelay: %.3f, "
+                                     "maximumDelay: %.3f, deadline: %.3f>",
+                                    NSStringFromClass([self class]),
+                                    (void *)self,
+                                    (unsigned long)_maximumAttempts,
+                                    _baseDelay,
+                                    _maximumDelay,
+                                    _deadline];
+}
+
+#pragma mark - Classification
+
++ (BOOL)isIdempotentRequest:(NSURLRequest *)request {
+  NSString *method = request.HTTPMethod.uppercaseString ?: @"GET";
+  static NSSet<NSString *> *idempotentMethods;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    idempotentMethods =
+        [NSSet setWithObjects:@"GET", @"HEAD", @"OPTIONS", @"PUT", @"DELETE", @"TRACE", nil];
+  });
+  return [idempotentMethods containsObject:method];
+}
+
+/*! @brief Returns YES if the error means the request never reached the server.
+ */
++ (BOOL)isErrorBeforeRequestWasSent:(NSError *)error {
+  if (![error.domain isEqualToString:NSURLErrorDomain]) {
+    return NO;
+  }
+  switch (error.code) {
+    case NSURLErrorCannotFindHost:
+    case NSURLErrorCannotConnectToHost:
+    case NSURLErrorDNSLookupFailed:
+    case NSURLErrorNotConnectedToInternet:
+    case NSURLErrorInternationalRoamingOff:
+    case NSURLErrorDataNotAllowed:
+    case NSURLErrorSecureConnectionFailed:
+      return YES;
+    default:
+      return NO;
+  }
+}
+
+/*! @brief Returns YES if the error is transient, but the request may have reached the server.
+ */
++ (BOOL)isErrorAfterRequestWasSent:(NSError *)error {
+  if (![error.domain isEqualToString:NSURLErrorDomain]) {
+    return NO;
+  }
+  switch (error.code) {
+    case NSURLErrorTimedOut:
+    case NSURLErrorNetworkConnectionLost:
+    case NSURLErrorBadServerResponse:
+      return YES;
+    default:
+      return NO;
+  }
+}
+
++ (NSTimeInterval)retryAfterIntervalForResponse:(nullable NSHTTPURLResponse *)response {
+  NSString *value = nil;
+  for (NSString *field in response.allHeaderFields) {
+    if ([field caseInsensitiveCompare:kRetryAfterHeader] == NSOrderedSame) {
+      value = [response.allHeaderFields[field] description];
+      break;
+    }
+  }
+  value = [value stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+  if (value.length == 0) {
+    return -1;
+  }
+
+  NSScanner *scanner = [NSScanner scannerWithString:value];
+  long long seconds = 0;
+  if ([scanner scanLongLong:&seconds] && scanner.isAtEnd) {
+    return seconds >= 0 ? (NSTimeInterval)seconds : -1;
+  }
+
+  static NSDateFormatter *formatter;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    formatter = [[NSDateFormatter alloc] init];
+    formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    formatter.timeZone = [NSTimeZone timeZoneForSecondsFromGMT:0];
+    formatter.dateFormat = kHTTPDateFormat;
+  });
+  NSDate *date;
+  @synchronized(formatter) {
+    date = [formatter dateFromString:value];
+  }
+  if (!date) {
+    return -1;
+  }
+  return MAX([date timeIntervalSinceNow], 0);
+}
+
+- (BOOL)shouldRetryWithError:(nullable NSError *)error
+                    response:(nullable NSURLResponse *)response
+                  idempotent:(BOOL)idempotent {
+  if (error) {
+    if ([[self class] isErrorBeforeRequestWasSent:error]) {
+      return YES;
+    }
+    return idempotent && [[self class] isErrorAfterRequestWasSent:error];
+  }
+
+  if (![response isKindOfClass:[NSHTTPURLResponse class]]) {
+    return NO;
+  }
+  NSInteger statusCode = ((NSHTTPURLResponse *)response).statusCode;
+  switch (statusCode) {
+    // The server explicitly declined to process the request.
+    case 429:
+    case 503:
+      return YES;
+    case 500:
+    case 502:
+    case 504:
+      return idempotent;
+    default:
+      return NO;
+  }
+}
+
+#pragma mark - Delays
+
+- (NSTimeInterval)delayAfterPreviousDelay:(NSTimeInterval)previousDelay {
+  NSTimeInterval upperBound = MAX(previousDelay, _baseDelay) * 3;
+  double fraction = (double)arc4random() / (double)UINT32_MAX;
+  NSTimeInterval delay = _baseDelay + fraction * (upperBound - _baseDelay);
+  return MIN(delay, _maximumDelay);
+}
+
+#pragma mark - Execution
+
+- (void)performDataTaskWithRequest:(NSURLRequest *)request
+                           session:(NSURLSession *)session
+                        idempotent:(BOOL)idempotent
+                 completionHandler:(OKTRetryPolicyCompletion)completionHandler {
+  [self performAttempt:1
+               request:request
+               session:session
+            idempotent:idempotent
+             startDate:[NSDate date]
+         previousDelay:0
+     completionHandler:completionHandler];
+}
+
+- (void)performAttempt:(NSUInteger)attempt
+               request:(NSURLRequest *)request
+               session:(NSURLSession *)session
+            idempotent:(BOOL)idempotent
+             startDate:(NSDate *)startDate
+         previousDelay:(NSTimeInterval)previousDelay
+     completionHandler:(OKTRetryPolicyCompletion)completionHandler {
+  OKTCircuitBreaker *circuitBreaker =
+      request.URL ? [OKTCircuitBreaker circuitBreakerForURL:request.URL] : nil;
+  if (circuitBreaker && ![circuitBreaker allowRequest]) {
+    // Completes asynchronously, as a data task would, so that callers see the same threading
+    // whether or not the breaker is open.
+    NSError *error = [OKTCircuitBreaker circuitBreakerOpenErrorForURL:request.URL];
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+      completionHandler(nil, nil, error);
+    });
+    return;
+  }
+
+  NSDate *attemptDate = [NSDate date];
+  [[session dataTaskWithRequest:request
+              completionHandler:^(NSData *_Nullable data,
+                                  NSURLResponse *_Nullable response,
+                                  NSError *_Nullable error) {
+    [circuitBreaker recordResultWithError:error
+                                 response:response
+                                  latency:-[attemptDate timeIntervalSinceNow]];
+    if (attempt >= self->_maximumAttempts
+        || ![self shouldRetryWithError:error response:response idempotent:idempotent]) {
+      completionHandler(data, response, error);
+      return;
+    }
+
+    NSTimeInterval delay = [self delayAfterPreviousDelay:previousDelay];
+    NSTimeInterval retryAfter = error ? -1 : [[self class]
+        retryAfterIntervalForResponse:(NSHTTPURLResponse *)response];
+    if (retryAfter >= 0) {
+      delay = retryAfter;
+    }
+    // A server asking to wait longer than the policy allows is answered with its response rather
+    // than by blocking the caller for as long as the deadline permits.
+    NSTimeInterval elapsed = -[startDate timeIntervalSinceNow];
+    if (retryAfter > self->_maximumDelay || elapsed + delay > self->_deadline) {
+      completionHandler(data, response, error);
+      return;
+    }
+
+    AppAuthRequestTrace(@"Retrying request to %@ in %.3fs (attempt %lu of %lu)",
+                        request.URL,
+                        delay,
+                        (unsigned long)attempt + 1,
+                        (unsigned long)self->_maximumAttempts);
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                   dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+      [self performAttempt:attempt + 1
+                   request:request
+                   session:session
+                idempotent:idempotent
+                 startDate:startDate
+             previousDelay:delay
+         completionHandler:completionHandler];
+    });
+  }] resume];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
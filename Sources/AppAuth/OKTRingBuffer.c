@@ -0,0 +1,81 @@
+/*! @file OKTRingBuffer.c
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#include "OKTRingBuffer.h"
+
+#include <stdlib.h>
+
+void OKTRingBufferInit(OKTRingBuffer *buffer, size_t capacity) {
+  buffer->bytes = NULL;
+  buffer->capacity = capacity;
+  buffer->start = 0;
+  buffer->length = 0;
+}
+
+void OKTRingBufferRelease(OKTRingBuffer *buffer) {
+  free(buffer->bytes);
+  OKTRingBufferInit(buffer, buffer->capacity);
+}
+
+/*! @brief Describes @c length bytes starting at @c offset, wrapping around the end of the storage.
+ */
+static int OKTRingBufferRegions(const OKTRingBuffer *buffer,
+                                size_t offset,
+                                size_t length,
+                                struct iovec regions[2]) {
+  if (length == 0) {
+    return 0;
+  }
+  size_t head = buffer->capacity - offset;
+  regions[0].iov_base = buffer->bytes + offset;
+  if (length <= head) {
+    regions[0].iov_len = length;
+    return 1;
+  }
+  regions[0].iov_len = head;
+  regions[1].iov_base = buffer->bytes;
+  regions[1].iov_len = length - head;
+  return 2;
+}
+
+int OKTRingBufferWritableRegions(OKTRingBuffer *buffer, struct iovec regions[2]) {
+  if (!buffer->bytes) {
+    buffer->bytes = malloc(buffer->capacity);
+    if (!buffer->bytes) {
+      return 0;
+    }
+  }
+  size_t end = (buffer->start + buffer->length) % buffer->capacity;
+  return OKTRingBufferRegions(buffer, end, buffer->capacity - buffer->length, regions);
+}
+
+void OKTRingBufferCommit(OKTRingBuffer *buffer, size_t length) {
+  buffer->length += length;
+}
+
+int OKTRingBufferReadableRegions(const OKTRingBuffer *buffer, struct iovec regions[2]) {
+  return OKTRingBufferRegions(buffer, buffer->start, buffer->length, regions);
+}
+
+void OKTRingBufferConsume(OKTRingBuffer *buffer, size_t length) {
+  buffer->length -= length;
+  // Restarts an emptied buffer at the front, so that the free space is one contiguous region.
+  buffer->start = buffer->length == 0 ? 0 : (buffer->start + length) % buffer->capacity;
+}
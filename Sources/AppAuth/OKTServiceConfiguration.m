@@ -50,6 +50,12 @@ static NSString *const kDiscoveryDocumentKey = @"discoveryDocument";
 
 NS_ASSUME_NONNULL_BEGIN
 
+/*! @brief Whether two optional objects are both nil or equal.
+ */
+static BOOL OKTObjectsEqual(id _Nullable a, id _Nullable b) {
+  return a == b || [a isEqual:b];
+}
+
 @interface OKTServiceConfiguration ()
 
 - (instancetype)initWithAuthorizationEndpoint:(NSURL *)authorizationEndpoint
@@ -60,6 +66,8 @@ NS_ASSUME_NONNULL_BEGIN
                             discoveryDocument:(nullable OKTServiceDiscovery *)discoveryDocument
                             NS_DESIGNATED_INITIALIZER;
 
+- (BOOL)isEquivalentToConfiguration:(OKTServiceConfiguration *)configuration;
+
 @end
 
 @implementation OKTServiceConfiguration
@@ -155,6 +163,40 @@ NS_ASSUME_NONNULL_BEGIN
                            discoveryDocument:discoveryDocument];
 }
 
+#pragma mark - Sharing
+
++ (OKTServiceConfiguration *)sharedConfigurationForConfiguration:
+    (OKTServiceConfiguration *)configuration {
+  static NSMapTable<NSString *, OKTServiceConfiguration *> *sharedConfigurations;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedConfigurations = [NSMapTable strongToWeakObjectsMapTable];
+  });
+
+  NSString *key = (configuration.issuer ?: configuration.tokenEndpoint).absoluteString;
+  @synchronized(sharedConfigurations) {
+    OKTServiceConfiguration *sharedConfiguration = [sharedConfigurations objectForKey:key];
+    if (sharedConfiguration == configuration
+        || [sharedConfiguration isEquivalentToConfiguration:configuration]) {
+      return sharedConfiguration;
+    }
+    [sharedConfigurations setObject:configuration forKey:key];
+    return configuration;
+  }
+}
+
+/*! @brief Whether the configuration has the same endpoints and discovery document as another.
+ */
+- (BOOL)isEquivalentToConfiguration:(OKTServiceConfiguration *)configuration {
+  return [_authorizationEndpoint isEqual:configuration.authorizationEndpoint]
+      && [_tokenEndpoint isEqual:configuration.tokenEndpoint]
+      && OKTObjectsEqual(_issuer, configuration.issuer)
+      && OKTObjectsEqual(_registrationEndpoint, configuration.registrationEndpoint)
+      && OKTObjectsEqual(_endSessionEndpoint, configuration.endSessionEndpoint)
+      && OKTObjectsEqual(_discoveryDocument.discoveryDictionary,
+                         configuration.discoveryDocument.discoveryDictionary);
+}
+
 #pragma mark - NSCopying
 
 - (instancetype)copyWithZone:(nullable NSZone *)zone {
@@ -190,12 +232,14 @@ NS_ASSUME_NONNULL_BEGIN
   OKTServiceDiscovery *discoveryDocument = [aDecoder decodeObjectOfClass:[OKTServiceDiscovery class]
                                                                   forKey:kDiscoveryDocumentKey];
 
-  return [self initWithAuthorizationEndpoint:authorizationEndpoint
+  self = [self initWithAuthorizationEndpoint:authorizationEndpoint
                                tokenEndpoint:tokenEndpoint
                                       issuer:issuer
                         registrationEndpoint:registrationEndpoint
                           endSessionEndpoint:endSessionEndpoint
                            discoveryDocument:discoveryDocument];
+  // Restored sessions of the same issuer share one configuration instead of a copy each.
+  return self ? [[self class] sharedConfigurationForConfiguration:self] : nil;
 }
 
 - (void)encodeWithCoder:(NSCoder *)aCoder {
@@ -0,0 +1,231 @@
+/*! @file OKTTokenRefreshCoordinator.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTTokenRefreshCoordinator.h"
+
+#import "OKTMetricsRegistry.h"
+#import "OKTTokenRequest.h"
+#import "OKTTokenUtilities.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief A refresh request in flight and the callers waiting for it.
+    @discussion It is also the network delegate of the request: the request is customized by the
+        delegate of the caller that started it, and the response and metrics are reported to the
+        delegates of every caller. All properties are guarded by @c self.
+ */
+@interface OKTPendingTokenRefresh : NSObject <OktaNetworkRequestCustomizationDelegate>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+- (instancetype)initWithDelegate:(nullable id<OktaNetworkRequestCustomizationDelegate>)delegate
+    NS_DESIGNATED_INITIALIZER;
+
+/*! @brief Adds a joining caller.
+ */
+- (void)addCallback:(OKTTokenCallback)callback
+           delegate:(nullable id<OktaNetworkRequestCustomizationDelegate>)delegate;
+
+/*! @brief The callbacks of every caller, in the order they were added.
+ */
+- (NSArray<OKTTokenCallback> *)callbacks;
+
+@end
+
+@implementation OKTPendingTokenRefresh {
+  /*! @brief The delegate of the caller that started the request.
+   */
+  __weak id<OktaNetworkRequestCustomizationDelegate> _requestDelegate;
+  NSMutableArray<OKTTokenCallback> *_callbacks;
+  /*! @brief The distinct delegates of every caller, compared by identity and held weakly.
+   */
+  NSHashTable<id<OktaNetworkRequestCustomizationDelegate>> *_delegates;
+}
+
+- (instancetype)initWithDelegate:(nullable id<OktaNetworkRequestCustomizationDelegate>)delegate {
+  self = [super init];
+  if (self) {
+    _requestDelegate = delegate;
+    _callbacks = [NSMutableArray array];
+    _delegates = [NSHashTable hashTableWithOptions:NSPointerFunctionsWeakMemory
+                                                   | NSPointerFunctionsObjectPointerPersonality];
+    if (delegate) {
+      [_delegates addObject:delegate];
+    }
+  }
+  return self;
+}
+
+- (void)addCallback:(OKTTokenCallback)callback
+           delegate:(nullable id<OktaNetworkRequestCustomizationDelegate>)delegate {
+  @synchronized(self) {
+    [_callbacks addObject:[callback copy]];
+    if (delegate) {
+      [_delegates addObject:delegate];
+    }
+  }
+}
+
+- (NSArray<OKTTokenCallback> *)callbacks {
+  @synchronized(self) {
+    return [_callbacks copy];
+  }
+}
+
+- (NSArray<id<OktaNetworkRequestCustomizationDelegate>> *)delegates {
+  @synchronized(self) {
+    return _delegates.allObjects;
+  }
+}
+
+#pragma mark - OktaNetworkRequestCustomizationDelegate
+
+- (nullable NSURLRequest *)customizableURLRequest:(nullable NSURLRequest *)request {
+  id<OktaNetworkRequestCustomizationDelegate> delegate = _requestDelegate;
+  if ([delegate respondsToSelector:@selector(customizableURLRequest:)]) {
+    return [delegate customizableURLRequest:request];
+  }
+  return request;
+}
+
+- (void)didReceiveResponse:(nullable NSURLResponse *)response {
+  for (id<OktaNetworkRequestCustomizationDelegate> delegate in [self delegates]) {
+    [delegate didReceiveResponse:response];
+  }
+}
+
+- (void)didCollectMetrics:(OKTNetworkMetrics *)metrics {
+  for (id<OktaNetworkRequestCustomizationDelegate> delegate in [self delegates]) {
+    if ([delegate respondsToSelector:@selector(didCollectMetrics:)]) {
+      [delegate didCollectMetrics:metrics];
+    }
+  }
+}
+
+@end
+
+@implementation OKTTokenRefreshCoordinator {
+  /*! @brief The refreshes in flight, keyed by the refresh token hash, the validator and the
+          additional parameters of their request. Guarded by @c self.
+   */
+  NSMutableDictionary<NSArray *, OKTPendingTokenRefresh *> *_pendingRefreshes;
+}
+
++ (instancetype)sharedCoordinator {
+  static OKTTokenRefreshCoordinator *sharedCoordinator;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedCoordinator = [[self alloc] init];
+  });
+  return sharedCoordinator;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _pendingRefreshes = [NSMutableDictionary dictionary];
+  }
+  return self;
+}
+
+- (NSUInteger)inFlightRefreshCount {
+  @synchronized(self) {
+    return _pendingRefreshes.count;
+  }
+}
+
+- (void)performTokenRefreshRequest:(OKTTokenRequest *)request
+     originalAuthorizationResponse:(nullable OKTAuthorizationResponse *)authorizationResponse
+                          delegate:(nullable id<OktaNetworkRequestCustomizationDelegate>)delegate
+                         validator:(id<OKTTokenValidator>)validator
+                          callback:(OKTTokenCallback)callback {
+  if (!request.refreshToken) {
+    [[self class] performMeasuredTokenRequest:request
+                originalAuthorizationResponse:authorizationResponse
+                                     delegate:delegate
+                                    validator:validator
+                                     callback:callback];
+    return;
+  }
+
+  // The hash avoids keeping another copy of the refresh token in memory. Requests that would be
+  // validated or sent differently are not merged.
+  NSString *tokenHash =
+      [OKTTokenUtilities encodeBase64urlNoPadding:[OKTTokenUtilities sha256:request.refreshToken]];
+  NSArray *key = @[ tokenHash, validator, request.additionalParameters ?: @{} ];
+  OKTPendingTokenRefresh *pendingRefresh;
+  @synchronized(self) {
+    pendingRefresh = _pendingRefreshes[key];
+    if (pendingRefresh) {
+      [pendingRefresh addCallback:callback delegate:delegate];
+      [[OKTMetricsRegistry sharedRegistry] incrementCounter:OKTMetricCoalescedRefreshWaiters];
+      return;
+    }
+    pendingRefresh = [[OKTPendingTokenRefresh alloc] initWithDelegate:delegate];
+    [pendingRefresh addCallback:callback delegate:nil];
+    _pendingRefreshes[key] = pendingRefresh;
+  }
+
+  // The callback keeps the pending refresh, which the metrics collector only references weakly,
+  // alive until the request completes.
+  [[self class] performMeasuredTokenRequest:request
+              originalAuthorizationResponse:authorizationResponse
+                                   delegate:pendingRefresh
+                                  validator:validator
+                                   callback:^(OKTTokenResponse *_Nullable tokenResponse,
+                                              NSError *_Nullable error) {
+    @synchronized(self) {
+      [self->_pendingRefreshes removeObjectForKey:key];
+    }
+    for (OKTTokenCallback pendingCallback in [pendingRefresh callbacks]) {
+      pendingCallback(tokenResponse, error);
+    }
+  }];
+}
+
+/*! @brief Sends a refresh request, counting it, its latency and its failure in the shared metrics
+        registry. Callers that join the request are counted as waiters instead.
+ */
++ (void)performMeasuredTokenRequest:(OKTTokenRequest *)request
+      originalAuthorizationResponse:(nullable OKTAuthorizationResponse *)authorizationResponse
+                           delegate:(nullable id<OktaNetworkRequestCustomizationDelegate>)delegate
+                          validator:(id<OKTTokenValidator>)validator
+                           callback:(OKTTokenCallback)callback {
+  OKTMetricsRegistry *metrics = [OKTMetricsRegistry sharedRegistry];
+  [metrics incrementCounter:OKTMetricTokenRefreshes];
+  CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+  [OKTAuthorizationService performTokenRequest:request
+                 originalAuthorizationResponse:authorizationResponse
+                                      delegate:delegate
+                                     validator:validator
+                                      callback:^(OKTTokenResponse *_Nullable tokenResponse,
+                                                 NSError *_Nullable error) {
+    [metrics recordLatency:CFAbsoluteTimeGetCurrent() - startTime
+              forOperation:OKTMetricOperationTokenRefresh];
+    if (error) {
+      [metrics incrementCounter:OKTMetricTokenRefreshFailures];
+    }
+    callback(tokenResponse, error);
+  }];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -70,7 +70,16 @@ static NSString *const kCodeVerifierKey = @"code_verifier";
  */
 static NSString *const kAdditionalParametersKey = @"additionalParameters";
 
-@implementation OKTTokenRequest
+@implementation OKTTokenRequest {
+  /*! @brief The encoded request body, built on first use. Guarded by @c self.
+   */
+  NSData *_HTTPBody;
+
+  /*! @brief The value of the Basic Authorization header, built together with @c _HTTPBody. Nil
+          when the request has no client secret. Guarded by @c self.
+   */
+  NSString *_authorizationHeaderValue;
+}
 
 - (instancetype)init
     OKT_UNAVAILABLE_USE_INITIALIZER(
@@ -155,6 +164,22 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
   return self;
 }
 
+#pragma mark - Compacting
+
+- (instancetype)compactCopy {
+  return [[[self class] alloc]
+      initWithConfiguration:[OKTServiceConfiguration sharedConfigurationForConfiguration:_configuration]
+                  grantType:_grantType
+          authorizationCode:nil
+                redirectURL:_redirectURL
+                   clientID:_clientID
+               clientSecret:_clientSecret
+                      scope:_scope
+               refreshToken:nil
+               codeVerifier:nil
+       additionalParameters:nil];
+}
+
 #pragma mark - NSSecureCoding
 
 + (BOOL)supportsSecureCoding {
@@ -209,13 +234,12 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
 #pragma mark - NSObject overrides
 
 - (NSString *)description {
-  NSURLRequest *request = self.URLRequest;
   NSString *requestBody =
-      [[NSString alloc] initWithData:request.HTTPBody encoding:NSUTF8StringEncoding];
+      [[NSString alloc] initWithData:[self HTTPBody] encoding:NSUTF8StringEncoding];
   return [NSString stringWithFormat:@"<%@: %p, request: <URL: %@, HTTPBody: %@>>",
                                     NSStringFromClass([self class]),
                                     (void *)self,
-                                    request.URL,
+                                    [self tokenRequestURL],
                                     requestBody];
 }
 
@@ -263,48 +287,68 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
   return query;
 }
 
+/*! @brief Encodes the request body and the client credentials once; the request is immutable, so
+        both are reused by every later call.
+    @return The "application/x-www-form-urlencoded" request body.
+ */
+- (NSData *)HTTPBody {
+  @synchronized(self) {
+    if (_HTTPBody) {
+      return _HTTPBody;
+    }
+
+    OKTURLQueryComponent *bodyParameters = [self tokenRequestBody];
+    if (_clientSecret) {
+      // The client id and secret are encoded using the "application/x-www-form-urlencoded"
+      // encoding algorithm per RFC 6749 Section 2.3.1.
+      // https://tools.ietf.org/html/rfc6749#section-2.3.1
+      NSString *encodedClientID = [OKTTokenUtilities formUrlEncode:_clientID];
+      NSString *encodedClientSecret = [OKTTokenUtilities formUrlEncode:_clientSecret];
+
+      // Credentials that cannot be encoded are not sent, so the server rejects the client rather
+      // than authenticating a mangled one.
+      if (encodedClientID && encodedClientSecret) {
+        NSString *credentials =
+            [NSString stringWithFormat:@"%@:%@", encodedClientID, encodedClientSecret];
+        NSData *plainData = [credentials dataUsingEncoding:NSUTF8StringEncoding];
+        NSString *basicAuth = [plainData base64EncodedStringWithOptions:kNilOptions];
+
+        _authorizationHeaderValue = [NSString stringWithFormat:@"Basic %@", basicAuth];
+      }
+    } else  {
+      [bodyParameters addParameter:kClientIDKey value:_clientID];
+    }
+
+    NSString *bodyString = [bodyParameters URLEncodedParameters];
+    _HTTPBody = [bodyString dataUsingEncoding:NSUTF8StringEncoding];
+    return _HTTPBody;
+  }
+}
+
 - (NSURLRequest *)URLRequest {
   static NSString *const kHTTPPost = @"POST";
   static NSString *const kHTTPContentTypeHeaderKey = @"Content-Type";
   static NSString *const kHTTPContentTypeHeaderValue =
       @"application/x-www-form-urlencoded; charset=UTF-8";
+  static NSString *const kHTTPAuthorizationHeaderKey = @"Authorization";
+
+  NSData *body = [self HTTPBody];
+  NSString *authorizationHeaderValue;
+  @synchronized(self) {
+    authorizationHeaderValue = _authorizationHeaderValue;
+  }
 
+  // Only the request object itself is assembled on each call, so that a User-Agent set after the
+  // request was created is still honored.
   NSURL *tokenRequestURL = [self tokenRequestURL];
   NSMutableURLRequest *URLRequest = [[NSURLRequest requestWithURL:tokenRequestURL] mutableCopy];
   URLRequest.HTTPMethod = kHTTPPost;
   [URLRequest setValue:kHTTPContentTypeHeaderValue forHTTPHeaderField:kHTTPContentTypeHeaderKey];
   [URLRequest setValue:OktaUserAgent.userAgentHeaderValue forHTTPHeaderField:OktaUserAgent.userAgentHeaderKey];
-
-  OKTURLQueryComponent *bodyParameters = [self tokenRequestBody];
-  NSMutableDictionary *httpHeaders = [[NSMutableDictionary alloc] init];
-
-  if (_clientSecret) {
-    // The client id and secret are encoded using the "application/x-www-form-urlencoded" 
-    // encoding algorithm per RFC 6749 Section 2.3.1.
-    // https://tools.ietf.org/html/rfc6749#section-2.3.1
-    NSString *encodedClientID = [OKTTokenUtilities formUrlEncode:_clientID];
-    NSString *encodedClientSecret = [OKTTokenUtilities formUrlEncode:_clientSecret];
-    
-    NSString *credentials =
-        [NSString stringWithFormat:@"%@:%@", encodedClientID, encodedClientSecret];
-    NSData *plainData = [credentials dataUsingEncoding:NSUTF8StringEncoding];
-    NSString *basicAuth = [plainData base64EncodedStringWithOptions:kNilOptions];
-
-    NSString *authValue = [NSString stringWithFormat:@"Basic %@", basicAuth];
-    [httpHeaders setObject:authValue forKey:@"Authorization"];
-  } else  {
-    [bodyParameters addParameter:kClientIDKey value:_clientID];
+  if (authorizationHeaderValue) {
+    [URLRequest setValue:authorizationHeaderValue forHTTPHeaderField:kHTTPAuthorizationHeaderKey];
   }
-
-  // Constructs request with the body string and headers.
-  NSString *bodyString = [bodyParameters URLEncodedParameters];
-  NSData *body = [bodyString dataUsingEncoding:NSUTF8StringEncoding];
   URLRequest.HTTPBody = body;
-
-  for (id header in httpHeaders) {
-    [URLRequest setValue:httpHeaders[header] forHTTPHeaderField:header];
-  }
-
   return URLRequest;
 }
 
@@ -118,6 +118,22 @@ static NSString *const kAdditionalParametersKey = @"additionalParameters";
   return self;
 }
 
+#pragma mark - Compacting
+
+- (instancetype)compactCopy {
+  // The expiration date is copied rather than converted from expires_in again.
+  OKTTokenResponse *response =
+      [[[self class] alloc] initWithRequest:[_request compactCopy] parameters:@{ }];
+  response->_accessToken = _accessToken;
+  response->_accessTokenExpirationDate = _accessTokenExpirationDate;
+  response->_tokenType = _tokenType;
+  response->_idToken = _idToken;
+  response->_refreshToken = _refreshToken;
+  response->_scope = _scope;
+  response->_additionalParameters = nil;
+  return response;
+}
+
 #pragma mark - NSSecureCoding
 
 + (BOOL)supportsSecureCoding {
@@ -20,13 +20,8 @@
 
 #import "OKTTokenUtilities.h"
 
-#import <CommonCrypto/CommonDigest.h>
-
-/*! @brief String representing the set of characters that are allowed as is for the
-        application/x-www-form-urlencoded encoding algorithm.
- */
-static NSString *const kFormUrlEncodedAllowedCharacters =
-    @" *-._0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+#import "OKTCryptoProvider.h"
+#import "OKTURLEncodingUtilities.h"
 
 @implementation OKTTokenUtilities
 
@@ -42,8 +37,7 @@ static NSString *const kFormUrlEncodedAllowedCharacters =
 
 + (nullable NSString *)randomURLSafeStringWithSize:(NSUInteger)size {
   NSMutableData *randomData = [NSMutableData dataWithLength:size];
-  int result = SecRandomCopyBytes(kSecRandomDefault, randomData.length, randomData.mutableBytes);
-  if (result != 0) {
+  if (![[OKTCrypto provider] getRandomBytes:randomData.mutableBytes length:randomData.length]) {
     return nil;
   }
   return [[self class] encodeBase64urlNoPadding:randomData];
@@ -51,9 +45,7 @@ static NSString *const kFormUrlEncodedAllowedCharacters =
 
 + (NSData *)sha256:(NSString *)inputString {
   NSData *verifierData = [inputString dataUsingEncoding:NSUTF8StringEncoding];
-  NSMutableData *sha256Verifier = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
-  CC_SHA256(verifierData.bytes, (CC_LONG)verifierData.length, sha256Verifier.mutableBytes);
-  return sha256Verifier;
+  return [[OKTCrypto provider] SHA256DigestOfData:verifierData];
 }
 
 + (NSString *)redact:(NSString *)inputString {
@@ -71,7 +63,7 @@ static NSString *const kFormUrlEncodedAllowedCharacters =
   }
 }
 
-+ (NSString*)formUrlEncode:(NSString*)inputString {
++ (nullable NSString*)formUrlEncode:(NSString*)inputString {
   // https://www.w3.org/TR/html5/sec-forms.html#application-x-www-form-urlencoded-encoding-algorithm
   // Following the spec from the above link, application/x-www-form-urlencoded percent encode all
   // the characters except *-._A-Za-z0-9
@@ -79,13 +71,7 @@ static NSString *const kFormUrlEncodedAllowedCharacters =
   if (inputString.length == 0) {
     return inputString;
   }
-  NSCharacterSet *allowedCharacters =
-      [NSCharacterSet characterSetWithCharactersInString:kFormUrlEncodedAllowedCharacters];
-  // Percent encode all characters not present in the provided set.
-  NSString *encodedString =
-      [inputString stringByAddingPercentEncodingWithAllowedCharacters:allowedCharacters];
-  // Replace occurences of space by '+' character
-  return [encodedString stringByReplacingOccurrencesOfString:@" " withString:@"+"];
+  return [OKTURLEncodingUtilities encodeString:inputString mode:OKTURLEncodingModeForm];
 }
 
 @end
@@ -0,0 +1,79 @@
+/*! @file OKTTracing.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTTracing.h"
+
+#import <stdatomic.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+NSString *const OKTTraceSpanDiscovery = @"discovery";
+
+NSString *const OKTTraceSpanBrowserSignIn = @"browser_sign_in";
+
+NSString *const OKTTraceSpanAuthorization = @"authorization";
+
+NSString *const OKTTraceSpanSessionTokenSignIn = @"session_token_sign_in";
+
+NSString *const OKTTraceSpanSessionTokenAuthorization = @"session_token_authorization";
+
+NSString *const OKTTraceSpanTokenRequest = @"token_request";
+
+NSString *const OKTTraceSpanIDTokenValidation = @"id_token_validation";
+
+NSString *const OKTTraceSpanTokenRefresh = @"token_refresh";
+
+NSString *const OKTTraceSpanPersistence = @"persistence";
+
+NSString *const OKTTraceSpanEndpointRequest = @"endpoint_request";
+
+/*! @brief The installed tracer. Guarded by the @c OKTTracing class.
+ */
+static id<OKTTracer> _Nullable gTracer;
+
+/*! @brief Whether @c gTracer is set; read without taking the lock.
+ */
+static atomic_bool gTracingEnabled;
+
+@implementation OKTTracing
+
++ (nullable id<OKTTracer>)tracer {
+  if (!atomic_load_explicit(&gTracingEnabled, memory_order_acquire)) {
+    return nil;
+  }
+  @synchronized(self) {
+    return gTracer;
+  }
+}
+
++ (void)setTracer:(nullable id<OKTTracer>)tracer {
+  @synchronized(self) {
+    gTracer = tracer;
+    atomic_store_explicit(&gTracingEnabled, tracer != nil, memory_order_release);
+  }
+}
+
++ (nullable id<OKTTraceSpan>)beginSpanWithName:(NSString *)name {
+  return [[self tracer] beginSpanWithName:name];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
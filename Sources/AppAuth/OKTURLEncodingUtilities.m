@@ -0,0 +1,234 @@
+/*! @file OKTURLEncodingUtilities.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import "OKTURLEncodingUtilities.h"
+
+/*! @brief Size of the stack buffer used for strings short enough not to need a heap allocation.
+ */
+static const NSUInteger kStackBufferSize = 256;
+
+/*! @brief Flags of @c gCharacterClasses.
+ */
+enum {
+  kQueryValueAllowed = 1 << 0,
+  kFormAllowed = 1 << 1,
+};
+
+/*! @brief The characters each @c OKTURLEncodingMode keeps, indexed by byte.
+ */
+static uint8_t gCharacterClasses[256];
+
+static const char kHexDigits[] = "0123456789ABCDEF";
+
+static void OKTInitializeCharacterClasses(void) {
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    // NSCharacterSet.URLQueryAllowedCharacterSet without "=&+"
+    const char *queryValueAllowed = "!$'()*,-./:;?@_~";
+    const char *formAllowed = "*-._";
+    for (int c = 0; c < 256; c++) {
+      if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+        gCharacterClasses[c] = kQueryValueAllowed | kFormAllowed;
+      }
+    }
+    for (const char *c = queryValueAllowed; *c; c++) {
+      gCharacterClasses[(uint8_t)*c] |= kQueryValueAllowed;
+    }
+    for (const char *c = formAllowed; *c; c++) {
+      gCharacterClasses[(uint8_t)*c] |= kFormAllowed;
+    }
+  });
+}
+
+/*! @brief Returns the value of a hex digit, or -1.
+ */
+static inline int OKTHexValue(uint8_t c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+/*! @brief Copies the UTF-8 bytes of @c string to @c buffer, which must hold at least
+        @c maximumLengthOfBytesUsingEncoding: bytes.
+    @return NO if @c string is not valid Unicode.
+ */
+static BOOL OKTGetUTF8Bytes(NSString *string,
+                            uint8_t *buffer,
+                            NSUInteger capacity,
+                            NSUInteger *length) {
+  NSRange remainingRange = NSMakeRange(0, 0);
+  *length = 0;
+  [string getBytes:buffer
+         maxLength:capacity
+        usedLength:length
+          encoding:NSUTF8StringEncoding
+           options:0
+             range:NSMakeRange(0, string.length)
+    remainingRange:&remainingRange];
+  return remainingRange.length == 0;
+}
+
+/*! @brief Decodes @c length bytes at @c bytes in place.
+    @return The decoded length.
+ */
+static NSUInteger OKTDecodeFormBytes(uint8_t *bytes, NSUInteger length) {
+  NSUInteger read = 0;
+  NSUInteger write = 0;
+  while (read < length) {
+    uint8_t c = bytes[read++];
+    if (c == '+') {
+      c = ' ';
+    } else if (c == '%' && read + 2 <= length) {
+      int high = OKTHexValue(bytes[read]);
+      int low = OKTHexValue(bytes[read + 1]);
+      if (high >= 0 && low >= 0) {
+        c = (uint8_t)(high << 4 | low);
+        read += 2;
+      }
+    }
+    bytes[write++] = c;
+  }
+  return write;
+}
+
+@implementation OKTURLEncodingUtilities
+
++ (nullable NSString *)encodeString:(NSString *)string mode:(OKTURLEncodingMode)mode {
+  if (string.length == 0) {
+    return @"";
+  }
+  NSMutableData *data = [NSMutableData data];
+  if (![self appendEncodedString:string mode:mode toData:data]) {
+    return nil;
+  }
+  return [[NSString alloc] initWithData:data encoding:NSASCIIStringEncoding];
+}
+
++ (BOOL)appendEncodedString:(NSString *)string
+                       mode:(OKTURLEncodingMode)mode
+                     toData:(NSMutableData *)data {
+  OKTInitializeCharacterClasses();
+  NSUInteger capacity = [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+  if (capacity == 0) {
+    return YES;
+  }
+
+  // Reserves room for the worst case, where every byte becomes "%XX", and copies the input to the
+  // last third of it. Encoding from the front never overwrites input that has not been read yet.
+  NSUInteger start = data.length;
+  data.length = start + 3 * capacity;
+  uint8_t *output = (uint8_t *)data.mutableBytes + start;
+  uint8_t *input = output + 2 * capacity;
+  NSUInteger inputLength;
+  if (!OKTGetUTF8Bytes(string, input, capacity, &inputLength)) {
+    data.length = start;
+    return NO;
+  }
+
+  uint8_t allowed = mode == OKTURLEncodingModeForm ? kFormAllowed : kQueryValueAllowed;
+  BOOL spaceAsPlus = mode == OKTURLEncodingModeForm;
+  NSUInteger write = 0;
+  for (NSUInteger read = 0; read < inputLength; read++) {
+    uint8_t c = input[read];
+    if (gCharacterClasses[c] & allowed) {
+      output[write++] = c;
+    } else if (c == ' ' && spaceAsPlus) {
+      output[write++] = '+';
+    } else {
+      output[write++] = '%';
+      output[write++] = kHexDigits[c >> 4];
+      output[write++] = kHexDigits[c & 0xF];
+    }
+  }
+  data.length = start + write;
+  return YES;
+}
+
++ (nullable NSString *)decodeFormString:(NSString *)string {
+  NSUInteger capacity = [string maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+  uint8_t stackBuffer[kStackBufferSize];
+  uint8_t *buffer = capacity <= kStackBufferSize ? stackBuffer : malloc(capacity);
+  if (!buffer) {
+    return nil;
+  }
+
+  NSString *decoded;
+  NSUInteger length;
+  if (OKTGetUTF8Bytes(string, buffer, capacity, &length)) {
+    length = OKTDecodeFormBytes(buffer, length);
+    decoded = [[NSString alloc] initWithBytes:buffer length:length encoding:NSUTF8StringEncoding];
+  }
+  if (buffer != stackBuffer) {
+    free(buffer);
+  }
+  return decoded;
+}
+
++ (void)enumerateParametersInQuery:(NSString *)query
+                        usingBlock:(void (^)(NSString *name, NSString *value))block {
+  NSUInteger capacity = [query maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+  if (capacity == 0) {
+    return;
+  }
+  uint8_t stackBuffer[kStackBufferSize];
+  uint8_t *buffer = capacity <= kStackBufferSize ? stackBuffer : malloc(capacity);
+  if (!buffer) {
+    return;
+  }
+
+  NSUInteger length;
+  if (OKTGetUTF8Bytes(query, buffer, capacity, &length)) {
+    NSUInteger partStart = 0;
+    while (partStart < length) {
+      uint8_t *part = buffer + partStart;
+      uint8_t *partEnd = memchr(part, '&', length - partStart) ?: buffer + length;
+      uint8_t *equals = memchr(part, '=', (size_t)(partEnd - part));
+      partStart = (NSUInteger)(partEnd - buffer) + 1;
+      if (!equals) {
+        continue;
+      }
+
+      // decoding only shrinks the bytes, so name and value are decoded where they are
+      NSUInteger nameLength = OKTDecodeFormBytes(part, (NSUInteger)(equals - part));
+      NSUInteger valueLength = OKTDecodeFormBytes(equals + 1, (NSUInteger)(partEnd - equals - 1));
+      NSString *name = [[NSString alloc] initWithBytes:part
+                                                length:nameLength
+                                              encoding:NSUTF8StringEncoding];
+      NSString *value = [[NSString alloc] initWithBytes:equals + 1
+                                                 length:valueLength
+                                               encoding:NSUTF8StringEncoding];
+      if (name && value) {
+        block(name, value);
+      }
+    }
+  }
+  if (buffer != stackBuffer) {
+    free(buffer);
+  }
+}
+
+@end
@@ -20,6 +20,8 @@
 
 #import "OKTURLQueryComponent.h"
 
+#import "OKTURLEncodingUtilities.h"
+
 BOOL gOKTURLQueryComponentForceIOS7Handling = NO;
 
 /*! @brief String representing the set of characters that are valid for the URL query
@@ -29,15 +31,36 @@ BOOL gOKTURLQueryComponentForceIOS7Handling = NO;
 static NSString *const kQueryStringParamAdditionalDisallowedCharacters = @"=&+";
 
 @implementation OKTURLQueryComponent {
-  /*! @brief A dictionary of parameter names and values representing the contents of the query.
+  /*! @brief The parameter names in insertion order. The value added with each name is at the same
+          index of @c _values.
+   */
+  NSMutableArray<NSString *> *_names;
+
+  /*! @brief The parameter values in insertion order.
+   */
+  NSMutableArray<NSString *> *_values;
+
+  /*! @brief The values of each parameter, built on first lookup and dropped when a parameter is
+          added. The lookup caches are guarded by @c self, so that a query component can be read
+          from several threads.
+   */
+  NSDictionary<NSString *, NSArray<NSString *> *> *_valuesByName;
+
+  /*! @brief The distinct parameter names in order of first insertion, cached with
+          @c _valuesByName.
    */
-  NSMutableDictionary<NSString *, NSMutableArray<NSString *> *> *_parameters;
+  NSArray<NSString *> *_distinctNames;
+
+  /*! @brief The cached result of @c dictionaryValue.
+   */
+  NSDictionary<NSString *, NSObject<NSCopying> *> *_dictionaryValue;
 }
 
 - (nullable instancetype)init {
   self = [super init];
   if (self) {
-    _parameters = [NSMutableDictionary dictionary];
+    _names = [NSMutableArray array];
+    _values = [NSMutableArray array];
   }
   return self;
 }
@@ -45,99 +68,100 @@ static NSString *const kQueryStringParamAdditionalDisallowedCharacters = @"=&+";
 - (nullable instancetype)initWithURL:(NSURL *)URL {
   self = [self init];
   if (self) {
-    if (@available(iOS 8.0, macOS 10.10, *)) {
-      // If NSURLQueryItem is available, use it for deconstructing the new URL. (iOS 8+)
-      if (!gOKTURLQueryComponentForceIOS7Handling) {
-        NSURLComponents *components =
-            [NSURLComponents componentsWithURL:URL resolvingAgainstBaseURL:NO];
-        // As OAuth uses application/x-www-form-urlencoded encoding, interprets '+' as a space
-        // in addition to regular percent decoding. https://url.spec.whatwg.org/#urlencoded-parsing
-        components.percentEncodedQuery =
-            [components.percentEncodedQuery stringByReplacingOccurrencesOfString:@"+"
-                                                                      withString:@"%20"];
-        // NB. @c queryItems are already percent decoded
-        NSArray<NSURLQueryItem *> *queryItems = components.queryItems;
-        for (NSURLQueryItem *queryItem in queryItems) {
-          [self addParameter:queryItem.name value:queryItem.value];
-        }
-        return self;
-      }
-    }
-    
-    // Fallback for iOS 7
-    NSString *query = URL.query;
     // As OAuth uses application/x-www-form-urlencoded encoding, interprets '+' as a space
     // in addition to regular percent decoding. https://url.spec.whatwg.org/#urlencoded-parsing
-    query = [query stringByReplacingOccurrencesOfString:@"+" withString:@"%20"];
-
-    NSArray<NSString *> *queryParts = [query componentsSeparatedByString:@"&"];
-    for (NSString *queryPart in queryParts) {
-      NSRange equalsRange = [queryPart rangeOfString:@"="];
-      if (equalsRange.location == NSNotFound) {
-        continue;
-      }
-      NSString *name = [queryPart substringToIndex:equalsRange.location];
-      name = name.stringByRemovingPercentEncoding;
-      NSString *value = [queryPart substringFromIndex:equalsRange.location + equalsRange.length];
-      value = value.stringByRemovingPercentEncoding;
-      [self addParameter:name value:value];
+    NSString *query = URL.query;
+    if (query) {
+      [OKTURLEncodingUtilities enumerateParametersInQuery:query
+                                               usingBlock:^(NSString *name, NSString *value) {
+        [self addParameter:name value:value];
+      }];
     }
-    return self;
   }
   return self;
 }
 
 - (NSArray<NSString *> *)parameters {
-  return _parameters.allKeys;
+  @synchronized(self) {
+    [self buildValuesByNameIfNeeded];
+    return _distinctNames;
+  }
 }
 
 - (NSDictionary<NSString *, NSObject<NSCopying> *> *)dictionaryValue {
-  // This method will flatten arrays in our @c _parameters' values if only one value exists.
-  NSMutableDictionary<NSString *, NSObject<NSCopying> *> *values = [NSMutableDictionary dictionary];
-  for (NSString *parameter in _parameters.allKeys) {
-    NSArray<NSString *> *value = _parameters[parameter];
-    if (value.count == 1) {
-      values[parameter] = [value.firstObject copy];
-    } else {
-      values[parameter] = [value copy];
+  @synchronized(self) {
+    if (_dictionaryValue) {
+      return _dictionaryValue;
+    }
+    // This method will flatten arrays in our @c _valuesByName if only one value exists.
+    [self buildValuesByNameIfNeeded];
+    NSMutableDictionary<NSString *, NSObject<NSCopying> *> *values =
+        [NSMutableDictionary dictionaryWithCapacity:_valuesByName.count];
+    for (NSString *parameter in _distinctNames) {
+      NSArray<NSString *> *value = _valuesByName[parameter];
+      values[parameter] = value.count == 1 ? value.firstObject : value;
     }
+    _dictionaryValue = [values copy];
+    return _dictionaryValue;
   }
-  return values;
 }
 
 - (NSArray<NSString *> *)valuesForParameter:(NSString *)parameter {
-  return _parameters[parameter];
+  @synchronized(self) {
+    [self buildValuesByNameIfNeeded];
+    return _valuesByName[parameter];
+  }
 }
 
 - (void)addParameter:(NSString *)parameter value:(NSString *)value {
-  NSMutableArray<NSString *> *parameterValues = _parameters[parameter];
-  if (!parameterValues) {
-    parameterValues = [NSMutableArray array];
-    _parameters[parameter] = parameterValues;
+  @synchronized(self) {
+    [_names addObject:[parameter copy]];
+    [_values addObject:[value copy]];
+    _valuesByName = nil;
+    _distinctNames = nil;
+    _dictionaryValue = nil;
   }
-  [parameterValues addObject:value];
 }
 
 - (void)addParameters:(NSDictionary<NSString *, NSString *> *)parameters {
-  for (NSString *parameterName in parameters.allKeys) {
+  // sorts the names so that the serialized parameters do not depend on dictionary ordering
+  NSArray<NSString *> *parameterNames =
+      [parameters.allKeys sortedArrayUsingSelector:@selector(compare:)];
+  for (NSString *parameterName in parameterNames) {
     [self addParameter:parameterName value:parameters[parameterName]];
   }
 }
 
-/*! @brief Builds a query items array that can be set to @c NSURLComponents.queryItems
-    @discussion The parameter names and values are NOT URL encoded.
-    @return An array of unencoded @c NSURLQueryItem objects.
+/*! @brief Groups the values by parameter name, unless the cached grouping is still valid.
+    @discussion Must be called while synchronized on @c self. The cached arrays are immutable, so
+        they can be handed out as they are.
  */
-- (NSMutableArray<NSURLQueryItem *> *)queryItems NS_AVAILABLE(10.10, 8.0) {
-  NSMutableArray<NSURLQueryItem *> *queryParameters = [NSMutableArray array];
-  for (NSString *parameterName in _parameters.allKeys) {
-    NSArray<NSString *> *values = _parameters[parameterName];
-    for (NSString *value in values) {
-      NSURLQueryItem *item = [NSURLQueryItem queryItemWithName:parameterName value:value];
-      [queryParameters addObject:item];
+- (void)buildValuesByNameIfNeeded {
+  if (_valuesByName) {
+    return;
+  }
+  NSMutableDictionary<NSString *, NSMutableArray<NSString *> *> *mutableValuesByName =
+      [NSMutableDictionary dictionaryWithCapacity:_names.count];
+  NSMutableArray<NSString *> *distinctNames = [NSMutableArray arrayWithCapacity:_names.count];
+  for (NSUInteger i = 0; i < _names.count; i++) {
+    NSString *name = _names[i];
+    NSMutableArray<NSString *> *parameterValues = mutableValuesByName[name];
+    if (!parameterValues) {
+      parameterValues = [NSMutableArray arrayWithCapacity:1];
+      mutableValuesByName[name] = parameterValues;
+      [distinctNames addObject:name];
     }
+    [parameterValues addObject:_values[i]];
   }
-  return queryParameters;
+  NSMutableDictionary<NSString *, NSArray<NSString *> *> *valuesByName =
+      [NSMutableDictionary dictionaryWithCapacity:distinctNames.count];
+  [mutableValuesByName enumerateKeysAndObjectsUsingBlock:^(NSString *name,
+                                                           NSMutableArray<NSString *> *values,
+                                                           BOOL *stop) {
+    valuesByName[name] = [values copy];
+  }];
+  _valuesByName = [valuesByName copy];
+  _distinctNames = [distinctNames copy];
 }
 
 + (NSMutableCharacterSet *)URLParamValueAllowedCharacters {
@@ -149,52 +173,37 @@ static NSString *const kQueryStringParamAdditionalDisallowedCharacters = @"=&+";
   return allowedParamCharacters;
 }
 
-/*! @brief Builds a query string that can be set to @c NSURLComponents.percentEncodedQuery
-    @discussion This string is percent encoded, and shouldn't be used with
-        @c NSURLComponents.query.
-    @return An percentage encoded query string.
- */
-- (NSString *)percentEncodedQueryString {
-  NSMutableArray<NSString *> *parameterizedValues = [NSMutableArray array];
-
-  // Starts with the standard URL-allowed character set.
-  NSMutableCharacterSet *allowedParamCharacters = [[self class] URLParamValueAllowedCharacters];
-
-  for (NSString *parameterName in _parameters.allKeys) {
-    NSString *encodedParameterName =
-        [parameterName stringByAddingPercentEncodingWithAllowedCharacters:allowedParamCharacters];
-
-    NSArray<NSString *> *values = _parameters[parameterName];
-    for (NSString *value in values) {
-      NSString *encodedValue =
-          [value stringByAddingPercentEncodingWithAllowedCharacters:allowedParamCharacters];
-      NSString *parameterizedValue =
-          [NSString stringWithFormat:@"%@=%@", encodedParameterName, encodedValue];
-      [parameterizedValues addObject:parameterizedValue];
-    }
-  }
-
-  NSString *queryString = [parameterizedValues componentsJoinedByString:@"&"];
-  return queryString;
-}
-
 - (NSString *)URLEncodedParameters {
-  // If NSURLQueryItem is available, uses it for constructing the encoded parameters. (iOS 8+)
-  if (@available(iOS 8.0, macOS 10.10, *)) {
-    if (!gOKTURLQueryComponentForceIOS7Handling) {
-      NSURLComponents *components = [[NSURLComponents alloc] init];
-      components.queryItems = [self queryItems];
-      NSString *encodedQuery = components.percentEncodedQuery;
-      // NSURLComponents.percentEncodedQuery creates a validly escaped URL query component, but
-      // doesn't encode the '+' leading to potential ambiguity with application/x-www-form-urlencoded
-      // encoding. Percent encodes '+' to avoid this ambiguity.
-      encodedQuery = [encodedQuery stringByReplacingOccurrencesOfString:@"+" withString:@"%2B"];
-      return encodedQuery;
+  // Encodes everything into one buffer, in insertion order. Unlike
+  // NSURLComponents.percentEncodedQuery, the encoder also percent encodes '+', avoiding ambiguity
+  // with application/x-www-form-urlencoded encoding.
+  // Parameters whose name or value is not valid Unicode cannot be encoded and are left out.
+  NSArray<NSString *> *names;
+  NSArray<NSString *> *values;
+  @synchronized(self) {
+    names = [_names copy];
+    values = [_values copy];
+  }
+  NSMutableData *encodedQuery = [NSMutableData data];
+  for (NSUInteger i = 0; i < names.count; i++) {
+    NSUInteger pairStart = encodedQuery.length;
+    if (pairStart > 0) {
+      [encodedQuery appendBytes:"&" length:1];
+    }
+    BOOL encoded = [OKTURLEncodingUtilities appendEncodedString:names[i]
+                                                           mode:OKTURLEncodingModeQueryValue
+                                                         toData:encodedQuery];
+    if (encoded) {
+      [encodedQuery appendBytes:"=" length:1];
+      encoded = [OKTURLEncodingUtilities appendEncodedString:values[i]
+                                                        mode:OKTURLEncodingModeQueryValue
+                                                      toData:encodedQuery];
+    }
+    if (!encoded) {
+      encodedQuery.length = pairStart;
     }
   }
-
-  // else, falls back to building query string manually (iOS 7)
-  return [self percentEncodedQueryString];
+  return [[NSString alloc] initWithData:encodedQuery encoding:NSASCIIStringEncoding];
 }
 
 - (NSURL *)URLByReplacingQueryInURL:(NSURL *)URL {
@@ -215,7 +224,7 @@ static NSString *const kQueryStringParamAdditionalDisallowedCharacters = @"=&+";
   return [NSString stringWithFormat:@"<%@: %p, parameters: %@>",
                                     NSStringFromClass([self class]),
                                     (void *)self,
-                                    _parameters];
+                                    self.dictionaryValue];
 }
 
 @end
@@ -17,8 +17,13 @@
 
 static NSString *userAgentValue = nil;
 
+// The default value only depends on the device, so it is computed once. Guarded by the class.
+static NSString *defaultUserAgentValue = nil;
+
 +(void)setUserAgentValue:(NSString*)value {
-    userAgentValue = value;
+    @synchronized(self) {
+        userAgentValue = [value copy];
+    }
 }
 
 +(NSString*)userAgentVersion {
@@ -30,27 +35,34 @@ static NSString *userAgentValue = nil;
 }
 
 +(NSString*)userAgentHeaderValue {
+    @synchronized(self) {
+        if (userAgentValue.length > 0) {
+            return userAgentValue;
+        }
+        if (!defaultUserAgentValue) {
+            defaultUserAgentValue = [self defaultUserAgentHeaderValue];
+        }
+        return defaultUserAgentValue;
+    }
+}
 
-    if (userAgentValue.length > 0) {
-        return userAgentValue;
-    } else {
-        NSString *bundleVersion = [self.class userAgentVersion];
-        NSString *systemVersion = [[NSProcessInfo processInfo] operatingSystemVersionString];
-        struct utsname deviceInfo;
-        uname(&deviceInfo);
-        NSString *deviceModel = [NSString stringWithUTF8String:deviceInfo.machine];
-        NSString *osName = @"iOS";
++(NSString*)defaultUserAgentHeaderValue {
+    NSString *bundleVersion = [self.class userAgentVersion];
+    NSString *systemVersion = [[NSProcessInfo processInfo] operatingSystemVersionString];
+    struct utsname deviceInfo;
+    uname(&deviceInfo);
+    NSString *deviceModel = [NSString stringWithUTF8String:deviceInfo.machine];
+    NSString *osName = @"iOS";
 #ifdef __MAC_OS_X_VERSION_MIN_REQUIRE
-        osName = @"macOS";
+    osName = @"macOS";
 #endif
 
-        NSString *formattedString = [NSString stringWithFormat:@"okta-oidc-ios/%@ %@/%@ Device/%@",
-                                     bundleVersion.length > 0 ? bundleVersion : @"",
-                                     osName,
-                                     systemVersion,
-                                     deviceModel];
-        return formattedString;
-    }
+    NSString *formattedString = [NSString stringWithFormat:@"okta-oidc-ios/%@ %@/%@ Device/%@",
+                                 bundleVersion.length > 0 ? bundleVersion : @"",
+                                 osName,
+                                 systemVersion,
+                                 deviceModel];
+    return formattedString;
 }
 
 @end
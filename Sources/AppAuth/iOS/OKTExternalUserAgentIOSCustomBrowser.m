@@ -29,7 +29,7 @@
 #import "OKTAuthorizationRequest.h"
 #import "OKTAuthorizationService.h"
 #import "OKTErrorUtilities.h"
-#import "OKTURLQueryComponent.h"
+#import "OKTURLEncodingUtilities.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -103,9 +103,11 @@ NS_ASSUME_NONNULL_BEGIN
 + (OKTCustomBrowserURLTransformation)URLTransformationSchemeConcatPrefix:(NSString *)URLprefix {
   OKTCustomBrowserURLTransformation transform = ^NSURL *(NSURL *requestURL) {
     NSString *requestURLString = [requestURL absoluteString];
-    NSMutableCharacterSet *allowedParamCharacters =
-        [OKTURLQueryComponent URLParamValueAllowedCharacters];
-    NSString *encodedUrl = [requestURLString stringByAddingPercentEncodingWithAllowedCharacters:allowedParamCharacters];
+    NSString *encodedUrl = [OKTURLEncodingUtilities encodeString:requestURLString
+                                                            mode:OKTURLEncodingModeQueryValue];
+    if (!encodedUrl) {
+      return nil;
+    }
     NSString *newURL = [NSString stringWithFormat:@"%@%@", URLprefix, encodedUrl];
     return [NSURL URLWithString:newURL];
   };
@@ -154,6 +156,9 @@ NS_ASSUME_NONNULL_BEGIN
   // Transforms the request URL and opens it.
   NSURL *requestURL = [request externalUserAgentRequestURL];
   requestURL = _URLTransformation(requestURL);
+  if (!requestURL) {
+    return NO;
+  }
     
   __block BOOL openedInBrowser = NO;
   
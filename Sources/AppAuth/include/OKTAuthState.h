@@ -22,11 +22,13 @@
 @class OKTAuthorizationRequest;
 @class OKTAuthorizationResponse;
 @class OKTAuthState;
+@class OKTCrossProcessRefreshLock;
 @class OKTRegistrationResponse;
 @class OKTTokenResponse;
 @class OKTTokenRequest;
 @protocol OKTAuthStateChangeDelegate;
 @protocol OKTAuthStateErrorDelegate;
+@protocol OKTAuthStateSharedStorage;
 @protocol OKTExternalUserAgent;
 @protocol OKTExternalUserAgentSession;
 @protocol OktaNetworkRequestCustomizationDelegate;
@@ -130,6 +132,29 @@ typedef void (^OKTAuthStateAuthorizationCallback)(OKTAuthState *_Nullable authSt
  */
 @property(nonatomic, weak, nullable) id<OKTAuthStateErrorDelegate> errorDelegate;
 
+/*! @brief Lock taken around token refreshes to coordinate with other processes sharing the stored
+        session.
+    @discussion When set, a refresh first acquires the lock and re-reads @c sharedStorage. If
+        another process already refreshed the tokens, they are adopted instead of refreshing the
+        possibly rotated refresh token again. Otherwise the refreshed state is written to
+        @c sharedStorage before the lock is released. Not archived.
+ */
+@property(nonatomic, strong, nullable) OKTCrossProcessRefreshLock *crossProcessRefreshLock;
+
+/*! @brief The storage shared with other processes, used together with
+        @c crossProcessRefreshLock.
+ */
+@property(nonatomic, weak, nullable) id<OKTAuthStateSharedStorage> sharedStorage;
+
+/*! @brief Whether the state keeps compact copies of its responses once tokens are exchanged.
+    @discussion The compact copies drop what refreshing tokens no longer needs: the authorization
+        code, state, nonce, PKCE values and the additional parameters of the requests and
+        responses. They refer to the shared configuration of the issuer instead of their own copy
+        of the discovery document. Setting it to YES compacts the current responses, and later
+        token responses are compacted as they are received. Archived. Defaults to NO.
+ */
+@property(nonatomic) BOOL compactsResponses;
+
 /*! @brief Convenience method to create a @c OKTAuthState by presenting an authorization request
         and performing the authorization code exchange in the case of code flow requests. For
         the hybrid flow, the caller should validate the id_token and c_hash, then perform the token
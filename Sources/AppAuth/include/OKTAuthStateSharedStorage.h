@@ -0,0 +1,50 @@
+/*! @file OKTAuthStateSharedStorage.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OKTAuthState;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @protocol OKTAuthStateSharedStorage
+    @brief Storage of an @c OKTAuthState that is shared with other processes, such as app
+        extensions.
+    @discussion Used together with @c OKTAuthState.crossProcessRefreshLock. Both methods are called
+        on the main queue while the lock is held.
+ */
+@protocol OKTAuthStateSharedStorage <NSObject>
+
+/*! @brief Returns the auth state currently persisted in the shared storage.
+    @param authState The @c OKTAuthState about to refresh its tokens.
+    @discussion If another process refreshed the tokens in the meantime, @c authState adopts the
+        tokens of the returned state instead of refreshing them again.
+ */
+- (nullable OKTAuthState *)storedAuthStateForAuthState:(OKTAuthState *)authState
+    NS_SWIFT_NAME(storedAuthState(for:));
+
+/*! @brief Persists the auth state after a successful refresh, before other processes may refresh.
+    @param authState The refreshed @c OKTAuthState.
+ */
+- (void)storeAuthState:(OKTAuthState *)authState NS_SWIFT_NAME(storeAuthState(_:));
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,90 @@
+/*! @file OKTAuthorizationMaterialPool.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief The single-use random values of one authorization request.
+ */
+@interface OKTAuthorizationMaterial : NSObject
+
+/*! @brief The PKCE code verifier.
+    @see https://tools.ietf.org/html/rfc7636#section-4.1
+ */
+@property(nonatomic, readonly) NSString *codeVerifier;
+
+/*! @brief The S256 code challenge of @c codeVerifier.
+    @see https://tools.ietf.org/html/rfc7636#section-4.2
+ */
+@property(nonatomic, readonly) NSString *codeChallenge;
+
+/*! @brief The OAuth state.
+ */
+@property(nonatomic, readonly) NSString *state;
+
+/*! @brief The OpenID Connect nonce.
+ */
+@property(nonatomic, readonly) NSString *nonce;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief Generates fresh material synchronously, like @c OKTAuthorizationRequest.generateState
+        and @c OKTAuthorizationRequest.generateCodeVerifier.
+    @return The material, or nil if the random source failed.
+ */
++ (nullable instancetype)generateMaterial;
+
+@end
+
+/*! @brief A small pool of pre-generated @c OKTAuthorizationMaterial, refilled in the background.
+    @discussion Generating a verifier, its challenge, a state and a nonce takes several random reads
+        and a SHA-256 hash. The pool does that work off the login path, filling several tuples from
+        one bulk random read. Each tuple is handed out exactly once and is never persisted.
+ */
+@interface OKTAuthorizationMaterialPool : NSObject
+
+/*! @brief The process-wide pool.
+ */
++ (instancetype)sharedPool NS_SWIFT_NAME(shared());
+
+/*! @brief The number of tuples kept ready. Defaults to 4. Setting 0 disables pooling and discards
+        the pooled tuples.
+ */
+@property(nonatomic) NSUInteger capacity;
+
+/*! @brief The number of tuples currently ready.
+ */
+@property(nonatomic, readonly) NSUInteger availableCount;
+
+/*! @brief Starts filling the pool in the background, so that the first login does not generate
+        its material synchronously.
+ */
+- (void)prewarm;
+
+/*! @brief Removes a tuple from the pool and schedules a refill. Generates the tuple synchronously
+        if the pool is empty.
+    @return The material, or nil if the random source failed.
+ */
+- (nullable OKTAuthorizationMaterial *)takeMaterial;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -247,6 +247,13 @@ extern NSString *const OKTOAuthorizationRequestCodeChallengeMethodS256;
  */
 + (nullable NSString *)codeChallengeS256ForVerifier:(nullable NSString *)codeVerifier;
 
+/*! @brief Returns a copy without the values only needed until the authorization code is
+        exchanged: the state, nonce, PKCE values and additional parameters.
+    @discussion The copy refers to the shared configuration of the issuer, see
+        @c OKTServiceConfiguration.sharedConfigurationForConfiguration:.
+ */
+- (instancetype)compactCopy;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -125,6 +125,12 @@ NS_ASSUME_NONNULL_BEGIN
 - (nullable OKTTokenRequest *)tokenExchangeRequestWithAdditionalParameters:
     (nullable NSDictionary<NSString *, NSString *> *)additionalParameters;
 
+/*! @brief Returns a copy without the authorization code, state and additional parameters, made
+        from the compact copy of the request.
+    @discussion The copy can no longer create a token exchange request.
+ */
+- (instancetype)compactCopy;
+
 @end
 
 NS_ASSUME_NONNULL_END
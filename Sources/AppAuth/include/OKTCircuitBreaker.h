@@ -0,0 +1,165 @@
+/*! @file OKTCircuitBreaker.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OKTCircuitBreaker;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief The states of an @c OKTCircuitBreaker.
+ */
+typedef NS_ENUM(NSInteger, OKTCircuitBreakerState) {
+  /*! @brief Requests are sent normally.
+   */
+  OKTCircuitBreakerStateClosed = 0,
+
+  /*! @brief Requests fail immediately until the cooldown elapses.
+   */
+  OKTCircuitBreakerStateOpen = 1,
+
+  /*! @brief A single probe request is allowed to find out whether the server recovered.
+   */
+  OKTCircuitBreakerStateHalfOpen = 2,
+};
+
+/*! @protocol OKTCircuitBreakerDelegate
+    @brief Receives the state transitions of the circuit breakers. Called on the main queue.
+ */
+@protocol OKTCircuitBreakerDelegate <NSObject>
+
+/*! @brief Called when a circuit breaker changes state.
+    @param circuitBreaker The circuit breaker, identified by its @c origin.
+    @param fromState The previous state.
+    @param toState The new state.
+ */
+- (void)circuitBreaker:(OKTCircuitBreaker *)circuitBreaker
+    didChangeFromState:(OKTCircuitBreakerState)fromState
+               toState:(OKTCircuitBreakerState)toState;
+
+@end
+
+/*! @brief Tracks the health of one authorization server and stops requests to it while it is
+        failing.
+    @discussion The breaker opens after @c failureThreshold consecutive failures. Network errors,
+        HTTP 5xx and 429 responses count as failures, as do successful responses slower than
+        @c latencyThreshold. While open, requests fail with @c ::OKTErrorCodeCircuitBreakerOpen
+        without touching the network. After @c cooldown the breaker lets a single probe through;
+        its outcome closes or re-opens the breaker.
+
+        Circuit breaking is disabled until @c enableWithFailureThreshold:latencyThreshold:cooldown:
+        is called. Breakers are shared by all requests to the same origin (scheme, host and port),
+        which covers the token, introspection, revocation and userinfo endpoints of an issuer.
+ */
+@interface OKTCircuitBreaker : NSObject
+
+/*! @brief The origin of the authorization server, e.g. "https://example.okta.com:443".
+ */
+@property(nonatomic, readonly) NSString *origin;
+
+/*! @brief The number of consecutive failures that opens the breaker.
+ */
+@property(nonatomic, readonly) NSUInteger failureThreshold;
+
+/*! @brief Responses slower than this many seconds are counted as failures. 0 disables the check.
+ */
+@property(nonatomic, readonly) NSTimeInterval latencyThreshold;
+
+/*! @brief The number of seconds the breaker stays open before allowing a probe.
+ */
+@property(nonatomic, readonly) NSTimeInterval cooldown;
+
+/*! @brief The current state.
+ */
+@property(nonatomic, readonly) OKTCircuitBreakerState state;
+
+/*! @internal
+    @brief Unavailable. Please use @c initWithOrigin:failureThreshold:latencyThreshold:cooldown:.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief Creates a closed circuit breaker.
+    @param origin The origin of the authorization server.
+    @param failureThreshold The number of consecutive failures that opens the breaker.
+    @param latencyThreshold Responses slower than this are counted as failures; 0 disables it.
+    @param cooldown The number of seconds the breaker stays open before allowing a probe.
+ */
+- (instancetype)initWithOrigin:(NSString *)origin
+              failureThreshold:(NSUInteger)failureThreshold
+              latencyThreshold:(NSTimeInterval)latencyThreshold
+                      cooldown:(NSTimeInterval)cooldown NS_DESIGNATED_INITIALIZER;
+
+/*! @brief Enables circuit breaking for all authorization servers, discarding existing breakers.
+    @param failureThreshold The number of consecutive failures that opens a breaker.
+    @param latencyThreshold Responses slower than this are counted as failures; 0 disables it.
+    @param cooldown The number of seconds a breaker stays open before allowing a probe.
+ */
++ (void)enableWithFailureThreshold:(NSUInteger)failureThreshold
+                  latencyThreshold:(NSTimeInterval)latencyThreshold
+                          cooldown:(NSTimeInterval)cooldown
+    NS_SWIFT_NAME(enable(failureThreshold:latencyThreshold:cooldown:));
+
+/*! @brief Disables circuit breaking and discards existing breakers.
+ */
++ (void)disable;
+
+/*! @brief Returns YES if circuit breaking is enabled.
+ */
++ (BOOL)isEnabled;
+
+/*! @brief Returns the shared breaker for the origin of a URL.
+    @param URL Any URL of the authorization server.
+    @return The breaker, or nil if circuit breaking is disabled or the URL has no host.
+ */
++ (nullable OKTCircuitBreaker *)circuitBreakerForURL:(NSURL *)URL
+    NS_SWIFT_NAME(circuitBreaker(for:));
+
+/*! @brief The delegate notified of state transitions of all shared breakers.
+ */
+@property(class, nonatomic, weak, nullable) id<OKTCircuitBreakerDelegate> delegate;
+
+/*! @brief Returns YES if a request may be sent now. In the half-open state only the first caller
+        is allowed through until its outcome is recorded.
+ */
+- (BOOL)allowRequest;
+
+/*! @brief Records the outcome of a request that was allowed by @c allowRequest.
+    @param error The transport error, if any.
+    @param response The response, if any.
+    @param latency The duration of the request, in seconds.
+ */
+- (void)recordResultWithError:(nullable NSError *)error
+                     response:(nullable NSURLResponse *)response
+                      latency:(NSTimeInterval)latency
+    NS_SWIFT_NAME(recordResult(error:response:latency:));
+
+/*! @brief Returns YES if the error was produced by an open circuit breaker.
+ */
++ (BOOL)isCircuitBreakerOpenError:(nullable NSError *)error
+    NS_SWIFT_NAME(isCircuitBreakerOpenError(_:));
+
+/*! @brief Creates the error returned for requests rejected by an open breaker.
+    @param URL The URL of the rejected request.
+ */
++ (NSError *)circuitBreakerOpenErrorForURL:(NSURL *)URL;
+
+@end
+
+NS_ASSUME_NONNULL_END
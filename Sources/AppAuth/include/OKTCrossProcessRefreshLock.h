@@ -0,0 +1,68 @@
+/*! @file OKTCrossProcessRefreshLock.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief An advisory lock on a file, used to serialize token refreshes between processes that
+        share the same stored session.
+    @discussion The lock uses @c flock(2), so it only coordinates processes that agree to take it,
+        and it is released by the system if the holding process exits. Every call to
+        @c lockWithError: opens its own file descriptor, so two instances using the same file
+        exclude each other exactly like two processes do. Callers using the same instance are
+        serialized as well. Place the lock file in a directory all processes can write to, such as
+        an app group container. The locking itself is done by the plain C @c OKTFileLockAcquire.
+ */
+@interface OKTCrossProcessRefreshLock : NSObject
+
+/*! @brief The URL of the lock file.
+ */
+@property(nonatomic, readonly) NSURL *lockFileURL;
+
+/*! @brief Whether this instance currently holds the lock.
+ */
+@property(nonatomic, readonly) BOOL isLocked;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief Creates a lock on the given file. The file is created when the lock is first taken.
+    @param lockFileURL A file URL.
+ */
+- (instancetype)initWithLockFileURL:(NSURL *)lockFileURL NS_DESIGNATED_INITIALIZER;
+
+/*! @brief Blocks until the lock is acquired. Must not be called on the main queue.
+    @param error The POSIX error if the lock file could not be opened or locked.
+    @return YES if the lock was acquired.
+ */
+- (BOOL)lockWithError:(NSError **_Nullable)error;
+
+/*! @brief Acquires the lock only if no other process or instance holds it.
+    @return YES if the lock was acquired.
+ */
+- (BOOL)tryLock;
+
+/*! @brief Releases the lock. Does nothing if the lock is not held.
+ */
+- (void)unlock;
+
+@end
+
+NS_ASSUME_NONNULL_END
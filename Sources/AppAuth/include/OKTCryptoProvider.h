@@ -0,0 +1,70 @@
+/*! @file OKTCryptoProvider.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @protocol OKTCryptoProvider
+    @brief The cryptographic primitives used by AppAuth.
+    @discussion Implementations must be thread safe. @c OKTAppleCryptoProvider is used by default;
+        @c OKTPortableCryptoProvider has no dependency on Apple frameworks.
+ */
+@protocol OKTCryptoProvider <NSObject>
+
+/*! @brief Fills @c bytes with cryptographically secure random bytes.
+    @param bytes The buffer to fill.
+    @param length The number of bytes.
+    @return NO if the random source failed.
+ */
+- (BOOL)getRandomBytes:(void *)bytes length:(size_t)length NS_SWIFT_NAME(getRandomBytes(_:length:));
+
+/*! @brief Computes the SHA-256 digest of @c data.
+ */
+- (NSData *)SHA256DigestOfData:(NSData *)data NS_SWIFT_NAME(sha256Digest(of:));
+
+/*! @brief Computes the HMAC-SHA-256 of @c data.
+ */
+- (NSData *)HMACSHA256OfData:(NSData *)data key:(NSData *)key
+    NS_SWIFT_NAME(hmacSHA256(of:key:));
+
+@end
+
+/*! @brief Holds the @c OKTCryptoProvider used by AppAuth.
+ */
+@interface OKTCrypto : NSObject
+
+/*! @internal
+    @brief Unavailable. This class should not be initialized.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief The current provider; an @c OKTAppleCryptoProvider unless replaced.
+ */
++ (id<OKTCryptoProvider>)provider;
+
+/*! @brief Replaces the provider used by AppAuth.
+    @param provider The provider to use from now on.
+ */
++ (void)setProvider:(id<OKTCryptoProvider>)provider;
+
+@end
+
+NS_ASSUME_NONNULL_END
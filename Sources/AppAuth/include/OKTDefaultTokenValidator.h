@@ -18,6 +18,9 @@
  */
 extern int const kOKTAuthorizationSessionIATMaxSkew;
 
+/*! @brief Validates token dates against the device clock.
+    @discussion Instances of this class are equal to each other, since they have no state.
+ */
 @interface OKTDefaultTokenValidator : NSObject <OKTTokenValidator>
 
 @end
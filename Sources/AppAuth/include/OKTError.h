@@ -153,6 +153,11 @@ typedef NS_ENUM(NSInteger, OKTErrorCode) {
   /*! @brief The ID Token did not pass validation (e.g. issuer, audience checks).
    */
   OKTErrorCodeIDTokenFailedValidationError = -15,
+
+  /*! @brief The request was not sent because the circuit breaker for the authorization server is
+          open.
+   */
+  OKTErrorCodeCircuitBreakerOpen = -16,
 };
 
 /*! @brief Enum of all possible OAuth error codes as defined by RFC6749
@@ -78,6 +78,7 @@ typedef NSURL *_Nullable (^OKTCustomBrowserURLTransformation)(NSURL *_Nullable r
 
 /*! @brief Creates a @c OKTCustomBrowserURLTransformation with the URL prefix method used by
         iOS browsers like Firefox.
+    @discussion The transformation returns nil if the request URL cannot be percent encoded.
  */
 + (OKTCustomBrowserURLTransformation) URLTransformationSchemeConcatPrefix:(NSString*)URLprefix;
 
@@ -0,0 +1,50 @@
+/*! @file OKTFileLock.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#ifndef OKTFileLock_h
+#define OKTFileLock_h
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Opens a file, creating it if needed, and takes an exclusive advisory @c flock(2) lock on
+        it.
+    @param path The path of the lock file.
+    @param blocking Whether to wait while another descriptor holds the lock.
+    @return The descriptor holding the lock, or -1 with @c errno set. @c EWOULDBLOCK means the lock
+        is held elsewhere and @c blocking is false.
+    @discussion Every call opens its own descriptor, so two calls in one process exclude each other
+        like two processes do. The descriptor is not inherited across @c exec, and the system
+        releases the lock if the holding process exits. Plain C so that it builds on any platform.
+ */
+int OKTFileLockAcquire(const char *path, bool blocking);
+
+/*! @brief Releases the lock and closes its descriptor. Does nothing for a negative descriptor.
+ */
+void OKTFileLockRelease(int fileDescriptor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OKTFileLock_h */
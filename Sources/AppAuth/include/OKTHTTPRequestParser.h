@@ -0,0 +1,176 @@
+/*! @file OKTHTTPRequestParser.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#ifndef OKTHTTPRequestParser_h
+#define OKTHTTPRequestParser_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief The most header fields a request may have.
+ */
+#define OKT_HTTP_MAX_HEADER_FIELDS 64
+
+/*! @brief The default bound on the request line and header fields, in bytes.
+ */
+#define OKT_HTTP_DEFAULT_MAX_HEADER_LENGTH (16 * 1024)
+
+/*! @brief The default bound on the request body, in bytes.
+ */
+#define OKT_HTTP_DEFAULT_MAX_BODY_LENGTH (64 * 1024)
+
+typedef enum {
+  /*! @brief All bytes were consumed and the request is not complete yet.
+   */
+  OKTHTTPParseStatusIncomplete = 0,
+  /*! @brief A request was parsed. Bytes after it were not consumed.
+   */
+  OKTHTTPParseStatusComplete,
+  /*! @brief The request is malformed or exceeds a limit; see @c OKTHTTPRequestParser.error.
+   */
+  OKTHTTPParseStatusError,
+} OKTHTTPParseStatus;
+
+typedef enum {
+  OKTHTTPParseErrorNone = 0,
+  OKTHTTPParseErrorMalformedRequestLine,
+  OKTHTTPParseErrorMalformedHeader,
+  OKTHTTPParseErrorHeaderTooLarge,
+  OKTHTTPParseErrorTooManyHeaders,
+  OKTHTTPParseErrorInvalidContentLength,
+  OKTHTTPParseErrorUnsupportedTransferEncoding,
+  OKTHTTPParseErrorMalformedChunk,
+  OKTHTTPParseErrorBodyTooLarge,
+  OKTHTTPParseErrorOutOfMemory,
+} OKTHTTPParseError;
+
+/*! @brief The part of a request a parser is waiting for.
+ */
+typedef enum {
+  /*! @brief No byte of a request was consumed yet, or the request is complete or failed.
+   */
+  OKTHTTPParsePhaseIdle = 0,
+  /*! @brief The request line and header fields are being received.
+   */
+  OKTHTTPParsePhaseHeader,
+  /*! @brief The body is being received.
+   */
+  OKTHTTPParsePhaseBody,
+} OKTHTTPParsePhase;
+
+/*! @brief A header field, as offsets into @c OKTHTTPRequestParser.head.
+ */
+typedef struct {
+  size_t nameOffset;
+  size_t nameLength;
+  size_t valueOffset;
+  size_t valueLength;
+} OKTHTTPHeaderField;
+
+/*! @brief An incremental HTTP/1.1 request parser.
+    @discussion Bytes are fed as they arrive and each byte is examined once: the request line and
+        header fields are copied into @c head and indexed in place, and the body is copied into
+        @c body, decoding the chunked transfer coding if used. Parsing stops at the end of a
+        request, so pipelined requests are parsed by feeding the unconsumed bytes again after
+        @c OKTHTTPRequestParserReset. Plain C so that it builds on any platform; not thread safe.
+
+        Fields are read only after @c OKTHTTPParseStatusComplete; strings are not NUL-terminated.
+ */
+typedef struct {
+  OKTHTTPParseError error;
+  size_t maxHeaderLength;
+  size_t maxBodyLength;
+
+  /*! @brief The request line and header fields without line terminators.
+   */
+  char *head;
+  size_t headLength;
+  size_t headCapacity;
+
+  size_t methodLength;
+  size_t targetOffset;
+  size_t targetLength;
+  size_t versionOffset;
+  size_t versionLength;
+  OKTHTTPHeaderField fields[OKT_HTTP_MAX_HEADER_FIELDS];
+  size_t fieldCount;
+
+  uint8_t *body;
+  size_t bodyLength;
+  size_t bodyCapacity;
+
+  /*! @internal Parser state. */
+  int state;
+  size_t lineStart;
+  size_t lineLength;
+  uint64_t remaining;
+  int chunkSizeDigits;
+  int expectsLineFeed;
+} OKTHTTPRequestParser;
+
+/*! @brief Prepares a parser.
+    @param maxHeaderLength The bound on the request line and header fields, and on the chunk
+        metadata and trailer of a chunked body. 0 selects @c OKT_HTTP_DEFAULT_MAX_HEADER_LENGTH.
+    @param maxBodyLength The bound on the decoded body. 0 selects
+        @c OKT_HTTP_DEFAULT_MAX_BODY_LENGTH.
+ */
+void OKTHTTPRequestParserInit(OKTHTTPRequestParser *parser,
+                              size_t maxHeaderLength,
+                              size_t maxBodyLength);
+
+/*! @brief Releases the buffers of a parser.
+ */
+void OKTHTTPRequestParserDestroy(OKTHTTPRequestParser *parser);
+
+/*! @brief Clears the parsed request so that the next one can be parsed, keeping the buffers.
+ */
+void OKTHTTPRequestParserReset(OKTHTTPRequestParser *parser);
+
+/*! @brief Consumes bytes of the request.
+    @param status Set to the state of the request after the consumed bytes.
+    @return The number of bytes consumed. Less than @c length only when the request completed
+        before the end of the bytes, or on error.
+ */
+size_t OKTHTTPRequestParserExecute(OKTHTTPRequestParser *parser,
+                                   const void *bytes,
+                                   size_t length,
+                                   OKTHTTPParseStatus *status);
+
+/*! @brief Returns the part of the request the parser is waiting for, so that callers can bound
+        the time each part may take.
+ */
+OKTHTTPParsePhase OKTHTTPRequestParserPhase(const OKTHTTPRequestParser *parser);
+
+/*! @brief Finds a header field by case-insensitive name.
+    @return The first value of the field, or NULL if the request has no such field.
+ */
+const char *OKTHTTPRequestParserHeaderValue(const OKTHTTPRequestParser *parser,
+                                            const char *name,
+                                            size_t *valueLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OKTHTTPRequestParser_h */
@@ -0,0 +1,80 @@
+/*! @file OKTInMemoryTracer.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "OKTTracing.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief A span recorded by @c OKTInMemoryTracer.
+ */
+@interface OKTRecordedSpan : NSObject <OKTTraceSpan>
+
+/*! @internal
+    @brief Unavailable. Spans are created by @c OKTInMemoryTracer.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief The span name.
+ */
+@property(nonatomic, readonly) NSString *name;
+
+/*! @brief A snapshot of the attributes set so far.
+ */
+@property(nonatomic, readonly) NSDictionary<NSString *, NSString *> *attributes;
+
+/*! @brief The error the span ended with.
+ */
+@property(nonatomic, readonly, nullable) NSError *error;
+
+/*! @brief Whether the span has ended.
+ */
+@property(nonatomic, readonly, getter=isEnded) BOOL ended;
+
+/*! @brief The time between the start and the end of the span, or 0 while it is open.
+ */
+@property(nonatomic, readonly) NSTimeInterval duration;
+
+@end
+
+/*! @brief A tracer that keeps every span in memory, for tests and debugging.
+ */
+@interface OKTInMemoryTracer : NSObject <OKTTracer>
+
+/*! @brief All spans in the order they were started.
+ */
+@property(nonatomic, readonly) NSArray<OKTRecordedSpan *> *spans;
+
+/*! @brief The names of the ended spans in the order they ended.
+ */
+@property(nonatomic, readonly) NSArray<NSString *> *endedSpanNames;
+
+/*! @brief The spans with the given name, in the order they were started.
+ */
+- (NSArray<OKTRecordedSpan *> *)spansNamed:(NSString *)name NS_SWIFT_NAME(spans(named:));
+
+/*! @brief Discards the recorded spans.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
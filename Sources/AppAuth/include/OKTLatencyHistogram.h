@@ -0,0 +1,69 @@
+/*! @file OKTLatencyHistogram.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief A log-linear latency histogram in the style of HdrHistogram.
+    @discussion Latencies are recorded in microseconds from 1µs to about 71 minutes, in buckets
+        whose width is at most 1/32 of their lower bound, so percentiles are within about 3% of the
+        recorded values. Larger latencies are recorded as the maximum. Recording is constant time
+        and the histogram uses a fixed 7 KB, however many values it holds.
+
+        Histograms are not thread safe. @c OKTMetricsRegistry guards the ones it owns and hands
+        out copies.
+ */
+@interface OKTLatencyHistogram : NSObject <NSCopying>
+
+/*! @brief The number of recorded latencies.
+ */
+@property(nonatomic, readonly) NSUInteger count;
+
+/*! @brief The smallest recorded latency, or 0 if none were recorded.
+ */
+@property(nonatomic, readonly) NSTimeInterval minimum;
+
+/*! @brief The largest recorded latency, or 0 if none were recorded.
+ */
+@property(nonatomic, readonly) NSTimeInterval maximum;
+
+/*! @brief The sum of the recorded latencies.
+ */
+@property(nonatomic, readonly) NSTimeInterval sum;
+
+/*! @brief The mean of the recorded latencies, or 0 if none were recorded.
+ */
+@property(nonatomic, readonly) NSTimeInterval mean;
+
+/*! @brief Records a latency. Negative latencies are recorded as 0.
+ */
+- (void)recordLatency:(NSTimeInterval)latency NS_SWIFT_NAME(record(_:));
+
+/*! @brief The latency at or below which the given percentage of the recorded latencies fall.
+    @param percentile A percentage between 0 and 100.
+    @return The highest latency of the bucket holding the percentile, at most @c maximum, or 0 if
+        none were recorded.
+ */
+- (NSTimeInterval)latencyAtPercentile:(double)percentile NS_SWIFT_NAME(latency(atPercentile:));
+
+@end
+
+NS_ASSUME_NONNULL_END
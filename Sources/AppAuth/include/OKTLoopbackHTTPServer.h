@@ -40,13 +40,17 @@ typedef enum {
 
 @protocol TCPServerDelegate <NSObject>
 
+// Called on the server queue. The delegate owns the connected socket
+// and must close it.
 - (void)TCPServer:(TCPServer *)server
     didReceiveConnectionFromAddress:(NSData *)addr
-                        inputStream:(NSInputStream *)istr
-                       outputStream:(NSOutputStream *)ostr;
+                             socket:(int)fd;
 
 @end
 
+// The listening sockets are serviced by dispatch sources on the server
+// queue, so the server does not depend on the run loop of the thread
+// that starts it and can be used from headless processes.
 @interface TCPServer : NSObject {
 @private
     __weak id<TCPServerDelegate> delegate;
@@ -54,11 +58,17 @@ typedef enum {
     NSString *name;
     NSString *type;
     uint16_t port;
-    CFSocketRef ipv4socket;
-    CFSocketRef ipv6socket;
+    NSRange fallbackPorts;
+    dispatch_queue_t queue;
+    dispatch_source_t ipv4source;
+    dispatch_source_t ipv6source;
     NSNetService *netService;
 }
 
+// The serial queue on which the sockets of the server and of its
+// connections are serviced.
+- (dispatch_queue_t)queue;
+
 - (id)delegate;
 - (void)setDelegate:(id)value;
 
@@ -74,16 +84,21 @@ typedef enum {
 - (uint16_t)port;
 - (void)setPort:(uint16_t)value;
 
+// Ports tried in order when the port set with -setPort: is in use, so a
+// fixed redirect port held by another process does not fail the start;
+// empty by default. -port returns the port bound once started.
+- (NSRange)fallbackPorts;
+- (void)setFallbackPorts:(NSRange)value;
+
 - (BOOL)start:(NSError **)error;
 - (BOOL)stop;
 
 - (BOOL)hasIPv4Socket;
 - (BOOL)hasIPv6Socket;
 
-// called when a new connection comes in; by default, informs the delegate
-- (void)handleNewConnectionFromAddress:(NSData *)addr
-                           inputStream:(NSInputStream *)istr
-                          outputStream:(NSOutputStream *)ostr;
+// called on the server queue when a new connection comes in; by default,
+// informs the delegate
+- (void)handleNewConnectionFromAddress:(NSData *)addr socket:(int)fd;
 
 @end
 
@@ -91,6 +106,14 @@ typedef enum {
 @private
     Class connClass;
     NSURL *docRoot;
+    dispatch_queue_t delegateQueue;
+    NSUInteger maxConnections;
+    NSTimeInterval idleTimeout;
+    NSTimeInterval headerTimeout;
+    NSTimeInterval bodyTimeout;
+    NSTimeInterval responseTimeout;
+    size_t maxHeaderLength;
+    size_t maxBodyLength;
     // Currently active connections spawned from the HTTPServer.
     NSMutableArray<HTTPConnection *> *connections;
 }
@@ -100,35 +123,95 @@ typedef enum {
 // a new connection comes in; by default, this is HTTPConnection
 - (void)setConnectionClass:(Class)value;
 
+// The queue on which connections call the delegate methods that deliver
+// requests and responses; the main queue by default. Set to NULL to call
+// them on the server queue.
+- (dispatch_queue_t)delegateQueue;
+- (void)setDelegateQueue:(dispatch_queue_t)value;
+
+// The limits below protect the listener from stray and slow clients, such
+// as browser preconnects and port scanners, and apply to the connections
+// accepted after they are set.
+
+// Connections accepted while this many are open are closed immediately;
+// 16 by default.
+- (NSUInteger)maxConnections;
+- (void)setMaxConnections:(NSUInteger)value;
+
+// Connections waiting for the next request are closed after this many
+// seconds, however many blank lines the peer sends meanwhile; connections
+// waiting for the peer to read a response are closed after this many
+// seconds without progress. 30 by default.
+- (NSTimeInterval)idleTimeout;
+- (void)setIdleTimeout:(NSTimeInterval)value;
+
+// Connections are closed when the request line and header fields of a
+// request take longer than this many seconds from its first byte; 10 by
+// default.
+- (NSTimeInterval)headerTimeout;
+- (void)setHeaderTimeout:(NSTimeInterval)value;
+
+// Connections are closed when the body of a request takes longer than
+// this many seconds; 10 by default.
+- (NSTimeInterval)bodyTimeout;
+- (void)setBodyTimeout:(NSTimeInterval)value;
+
+// Connections are closed when the delegate takes longer than this many
+// seconds to set the response to a request; 30 by default.
+- (NSTimeInterval)responseTimeout;
+- (void)setResponseTimeout:(NSTimeInterval)value;
+
+// Connections are closed when the request line and header fields, or the
+// body, of a request exceed these sizes in bytes; 16 KB and 64 KB by
+// default.
+- (size_t)maxHeaderLength;
+- (void)setMaxHeaderLength:(size_t)value;
+- (size_t)maxBodyLength;
+- (void)setMaxBodyLength:(size_t)value;
+
+// The number of open connections.
+- (NSUInteger)connectionCount;
+
+// Stops listening, and closes each connection once the responses to the
+// requests it already received are sent.
+- (BOOL)stop;
+
 @end
 
 @interface HTTPServer (HTTPServerDelegateMethods)
-// If the delegate implements this method, this is called 
-// by an HTTPServer when a new connection comes in.  If the
+// If the delegate implements this method, this is called on the server
+// queue by an HTTPServer when a new connection comes in.  If the
 // delegate wishes to refuse the connection, then it should
 // invalidate the connection object from within this method.
 - (void)HTTPServer:(HTTPServer *)serv didMakeNewConnection:(HTTPConnection *)conn;
 @end
 
 
-// This class represents each incoming client connection.
-@interface HTTPConnection : NSObject <NSStreamDelegate> {
+// This class represents each incoming client connection. The socket is
+// serviced by dispatch sources on the server queue, which keep the
+// connection alive until it is invalidated.
+@interface HTTPConnection : NSObject {
 @private
     __weak id delegate;
     NSData *peerAddress;
     __weak HTTPServer *server;
     NSMutableArray<HTTPServerRequest *> *requests;
-    NSInputStream *istream;
-    NSOutputStream *ostream;
-    NSMutableData *ibuffer;
-    NSMutableData *obuffer;
+    int socketFD;
+    dispatch_queue_t queue;
+    dispatch_queue_t delegateQueue;
+    dispatch_source_t readSource;
+    dispatch_source_t writeSource;
+    BOOL readSuspended;
+    BOOL writeSuspended;
+    BOOL readClosed;
     BOOL isValid;
     BOOL firstResponseDone;
 }
 
+// Takes ownership of the connected socket, which must be non-blocking.
+// A socket of -1 creates a connection that is not connected.
 - (id)initWithPeerAddress:(NSData *)addr
-              inputStream:(NSInputStream *)istr
-             outputStream:(NSOutputStream *)ostr
+                   socket:(int)fd
                 forServer:(HTTPServer *)serv;
 
 - (id)delegate;
@@ -142,8 +225,12 @@ typedef enum {
 - (HTTPServerRequest *)nextRequest;
 
 - (BOOL)isValid;
-// shut down the connection
+// shut down the connection; may be called on any queue
 - (void)invalidate;
+// stop reading requests and shut down the connection once the responses
+// to the requests already received are sent; may be called on any queue.
+// Responses with a "Connection: close" header field do the same.
+- (void)closeAfterPendingResponses;
 
 // perform the default handling action: GET and HEAD requests for files
 // in the local file system (relative to the documentRoot of the server)
@@ -153,6 +240,7 @@ typedef enum {
 
 @interface HTTPConnection (HTTPConnectionDelegateMethods)
 // The "didReceiveRequest:" tells the delegate when a new request comes in.
+// Both methods are called on the delegate queue of the server.
 - (void)HTTPConnection:(HTTPConnection *)conn didReceiveRequest:(HTTPServerRequest *)mess;
 - (void)HTTPConnection:(HTTPConnection *)conn didSendResponse:(HTTPServerRequest *)mess;
 @end
@@ -177,7 +265,8 @@ typedef enum {
 - (CFHTTPMessageRef)request;
 
 // The response may include a body.  As soon as the response is set,
-// the response may be written out to the network.
+// the response may be written out to the network.  The response may be
+// set on any queue.
 - (CFHTTPMessageRef)response;
 - (void)setResponse:(CFHTTPMessageRef)value;
 
@@ -0,0 +1,94 @@
+/*! @file OKTLoopbackSocket.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#ifndef OKTLoopbackSocket_h
+#define OKTLoopbackSocket_h
+
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief The number of pending connections a loopback listener queues before refusing more.
+ */
+#define OKT_LOOPBACK_LISTEN_BACKLOG 16
+
+/*! @brief Creates a non-blocking TCP listener on the loopback interface.
+    @param family @c AF_INET to listen on @c 127.0.0.1, or @c AF_INET6 to listen on @c ::1 only.
+    @param port On input, the port to bind, or 0 for a port chosen by the system. On success, set to
+        the bound port.
+    @return The listening socket, or -1 with @c errno set.
+    @discussion The socket, and the sockets accepted from it, are POSIX sockets that can be
+        monitored with dispatch sources, kqueue or epoll, so the loopback server does not depend on a
+        run loop. Plain C so that it builds on any platform.
+ */
+int OKTLoopbackSocketListen(int family, uint16_t *port);
+
+/*! @brief Creates IPv4 and IPv6 loopback listeners bound to the same port, trying fallback ports
+        when the preferred one is in use.
+    @param listeners Set to the IPv4 and the IPv6 listener, in that order. A family that is not
+        available on the host is set to -1.
+    @param port On input, the preferred port, or 0 for a port chosen by the system. On success, set
+        to the bound port.
+    @param fallbackPort The first port tried when the preferred port is in use, or 0 for none.
+    @param fallbackCount The number of consecutive ports tried from @c fallbackPort.
+    @return 0, or -1 with @c errno set if neither family could be bound. @c EADDRINUSE means every
+        port tried is in use.
+    @discussion A port is used only if both families can bind it, so that a redirect URI naming
+        @c localhost reaches the listener whichever address it resolves to.
+ */
+int OKTLoopbackSocketListenDualStack(int listeners[2],
+                                     uint16_t *port,
+                                     uint16_t fallbackPort,
+                                     uint16_t fallbackCount);
+
+/*! @brief Accepts a pending connection from a listener.
+    @param address Set to the address of the peer.
+    @param addressLength Set to the length of @c address.
+    @return The non-blocking connected socket, or -1 with @c errno set. @c EAGAIN or
+        @c EWOULDBLOCK means no connection is pending.
+    @discussion Writing to an accepted socket closed by the peer fails with @c EPIPE instead of
+        raising @c SIGPIPE.
+ */
+int OKTLoopbackSocketAccept(int listener,
+                            struct sockaddr_storage *address,
+                            socklen_t *addressLength);
+
+/*! @brief Reads available bytes from a connected socket, retrying on interruption.
+    @return The number of bytes read, 0 at end of stream, or -1 with @c errno set.
+ */
+ssize_t OKTLoopbackSocketRead(int socket, void *buffer, size_t length);
+
+/*! @brief Writes as much of the buffers as the socket accepts without blocking, retrying on
+        interruption.
+    @return The number of bytes written, or -1 with @c errno set. @c EAGAIN or @c EWOULDBLOCK means
+        the socket cannot accept more bytes yet.
+ */
+ssize_t OKTLoopbackSocketWrite(int socket, const struct iovec *buffers, int bufferCount);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OKTLoopbackSocket_h */
@@ -0,0 +1,133 @@
+/*! @file OKTMetricsRegistry.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class OKTLatencyHistogram;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief Token refresh requests sent by @c OKTTokenRefreshCoordinator on behalf of
+        @c OKTAuthState. A refresh shared by several states is counted once.
+ */
+extern NSString *const OKTMetricTokenRefreshes;
+
+/*! @brief Token refresh requests that failed, counted once per request.
+ */
+extern NSString *const OKTMetricTokenRefreshFailures;
+
+/*! @brief Actions and refreshes that waited on a refresh already in flight, in the same
+        @c OKTAuthState or in another one holding the same refresh token.
+ */
+extern NSString *const OKTMetricCoalescedRefreshWaiters;
+
+/*! @brief Actions performed with the current access token because it was still fresh.
+ */
+extern NSString *const OKTMetricTokenCacheHits;
+
+/*! @brief Actions that needed the tokens to be refreshed first.
+ */
+extern NSString *const OKTMetricTokenCacheMisses;
+
+/*! @brief Keychain items read by @c OktaOidcKeychain.
+ */
+extern NSString *const OKTMetricKeychainReads;
+
+/*! @brief Keychain items written by @c OktaOidcKeychain.
+ */
+extern NSString *const OKTMetricKeychainWrites;
+
+/*! @brief The latency of a token refresh request, from sending it to its response, recorded once
+        per request.
+    @discussion Network requests of @c OktaOidcRestApi are recorded under their
+        @c OKTNetworkOperation name.
+ */
+extern NSString *const OKTMetricOperationTokenRefresh;
+
+/*! @brief The latency of a keychain read.
+ */
+extern NSString *const OKTMetricOperationKeychainRead;
+
+/*! @brief The latency of a keychain write.
+ */
+extern NSString *const OKTMetricOperationKeychainWrite;
+
+/*! @brief An immutable copy of the metrics of an @c OKTMetricsRegistry.
+ */
+@interface OKTMetricsSnapshot : NSObject
+
+/*! @internal
+    @brief Unavailable. Use @c OKTMetricsRegistry.snapshot.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief The value of each counter that was incremented.
+ */
+@property(nonatomic, readonly) NSDictionary<NSString *, NSNumber *> *counters;
+
+/*! @brief The latency histogram of each operation that was recorded.
+ */
+@property(nonatomic, readonly) NSDictionary<NSString *, OKTLatencyHistogram *> *latencies;
+
+/*! @brief The value of a counter, or 0 if it was never incremented.
+ */
+- (NSUInteger)valueOfCounter:(NSString *)name NS_SWIFT_NAME(value(ofCounter:));
+
+/*! @brief The metrics in the Prometheus text exposition format.
+    @discussion Counters are exported as @c okta_oidc_<name>_total. Latencies are exported as the
+        @c okta_oidc_latency_seconds summary with an @c operation label and the 0.5, 0.9, 0.99 and
+        0.999 quantiles.
+ */
+- (NSString *)textRepresentation;
+
+@end
+
+/*! @brief Counts SDK events and keeps a latency histogram per operation.
+    @discussion The shared registry is fed by @c OKTAuthState, @c OKTTokenRefreshCoordinator,
+        @c OktaOidcRestApi and @c OktaOidcKeychain. Recording takes a lock; a latency is recorded
+        without allocating once its operation has a histogram. The registry is thread safe.
+ */
+@interface OKTMetricsRegistry : NSObject
+
+/*! @brief The process-wide registry the SDK records to.
+ */
++ (instancetype)sharedRegistry NS_SWIFT_NAME(shared());
+
+/*! @brief Adds one to a counter.
+    @param name One of the @c OKTMetric names.
+ */
+- (void)incrementCounter:(NSString *)name NS_SWIFT_NAME(increment(_:));
+
+/*! @brief Records the latency of an operation.
+ */
+- (void)recordLatency:(NSTimeInterval)latency
+         forOperation:(NSString *)operation NS_SWIFT_NAME(record(_:for:));
+
+/*! @brief Copies the current metrics.
+ */
+- (OKTMetricsSnapshot *)snapshot;
+
+/*! @brief Clears all counters and histograms.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,178 @@
+/*! @file OKTNetworkMetrics.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+@protocol OktaNetworkRequestCustomizationDelegate;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief OIDC discovery document download.
+ */
+extern NSString *const OKTNetworkOperationDiscovery;
+
+/*! @brief Authorization code exchange, and any other token request that is not a refresh.
+ */
+extern NSString *const OKTNetworkOperationTokenExchange;
+
+/*! @brief Refresh token request.
+ */
+extern NSString *const OKTNetworkOperationTokenRefresh;
+
+/*! @brief Token revocation request.
+ */
+extern NSString *const OKTNetworkOperationRevoke;
+
+/*! @brief Token introspection request.
+ */
+extern NSString *const OKTNetworkOperationIntrospect;
+
+/*! @brief Userinfo request.
+ */
+extern NSString *const OKTNetworkOperationUserInfo;
+
+/*! @brief Authorization request made with a session token, without a browser.
+ */
+extern NSString *const OKTNetworkOperationSessionTokenAuthorization;
+
+/*! @brief Dynamic client registration request.
+ */
+extern NSString *const OKTNetworkOperationRegistration;
+
+/*! @brief A request that was not tagged with an operation.
+ */
+extern NSString *const OKTNetworkOperationOther;
+
+/*! @brief Timing and transport details of one network request, derived from
+        @c NSURLSessionTaskMetrics.
+    @discussion Phase durations are taken from the last transaction of the task, which is the one
+        that produced the response; they are 0 when the phase did not happen, for example when the
+        connection was reused.
+ */
+@interface OKTNetworkMetrics : NSObject
+
+/*! @internal
+    @brief Unavailable. Please use @c initWithTaskMetrics:task:operation:.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief Derives the metrics of a task.
+    @param taskMetrics The metrics collected by the session.
+    @param task The task, used for the byte counts.
+    @param operation One of the @c OKTNetworkOperation values.
+ */
+- (instancetype)initWithTaskMetrics:(NSURLSessionTaskMetrics *)taskMetrics
+                               task:(nullable NSURLSessionTask *)task
+                          operation:(NSString *)operation NS_DESIGNATED_INITIALIZER;
+
+/*! @brief The logical operation, one of the @c OKTNetworkOperation values.
+ */
+@property(nonatomic, readonly) NSString *operation;
+
+/*! @brief The request URL.
+ */
+@property(nonatomic, readonly, nullable) NSURL *URL;
+
+/*! @brief The HTTP status code, or 0 if there was no HTTP response.
+ */
+@property(nonatomic, readonly) NSInteger statusCode;
+
+/*! @brief Time spent resolving the host name.
+ */
+@property(nonatomic, readonly) NSTimeInterval domainLookupDuration;
+
+/*! @brief Time spent establishing the connection, including the TLS handshake.
+ */
+@property(nonatomic, readonly) NSTimeInterval connectDuration;
+
+/*! @brief Time spent on the TLS handshake.
+ */
+@property(nonatomic, readonly) NSTimeInterval secureConnectionDuration;
+
+/*! @brief Time from sending the request to receiving the first byte of the response.
+ */
+@property(nonatomic, readonly) NSTimeInterval timeToFirstByte;
+
+/*! @brief Time from the first to the last byte of the response.
+ */
+@property(nonatomic, readonly) NSTimeInterval transferDuration;
+
+/*! @brief Time from the creation of the task to its completion, including redirects.
+ */
+@property(nonatomic, readonly) NSTimeInterval totalDuration;
+
+/*! @brief Bytes of request body sent.
+ */
+@property(nonatomic, readonly) int64_t requestBodyBytes;
+
+/*! @brief Bytes of response body received.
+ */
+@property(nonatomic, readonly) int64_t responseBodyBytes;
+
+/*! @brief Whether the request was sent on an existing connection.
+ */
+@property(nonatomic, readonly, getter=isReusedConnection) BOOL reusedConnection;
+
+/*! @brief The ALPN protocol, such as "h2" or "http/1.1".
+ */
+@property(nonatomic, readonly, nullable) NSString *networkProtocolName;
+
+/*! @brief The number of redirects the task followed.
+ */
+@property(nonatomic, readonly) NSUInteger redirectCount;
+
+@end
+
+/*! @brief Routes the task metrics of SDK requests to the @c didCollectMetrics: method of the
+        request customization delegate that issued them.
+    @discussion Requests are tagged with their operation and delegate through @c NSURLProtocol
+        properties. The session used by the SDK must forward
+        @c URLSession:task:didFinishCollectingMetrics: to @c collectMetrics:forTask:; the session
+        OktaOidc sets up does. Delegates are held weakly.
+ */
+@interface OKTNetworkMetricsCollector : NSObject
+
+/*! @brief The process-wide collector.
+ */
++ (instancetype)sharedCollector NS_SWIFT_NAME(shared());
+
+/*! @brief The operation a request was tagged with.
+ */
++ (nullable NSString *)operationOfRequest:(NSURLRequest *)request NS_SWIFT_NAME(operation(of:));
+
+/*! @brief Returns a copy of @c request tagged with an operation and a metrics delegate.
+    @param operation The operation, or nil to keep the current one.
+    @param delegate The delegate to receive the metrics, or nil to keep the current one. Delegates
+        that do not implement @c didCollectMetrics: are ignored.
+ */
+- (NSURLRequest *)request:(NSURLRequest *)request
+      taggedWithOperation:(nullable NSString *)operation
+                 delegate:(nullable id<OktaNetworkRequestCustomizationDelegate>)delegate
+    NS_SWIFT_NAME(request(_:taggedWithOperation:delegate:));
+
+/*! @brief Delivers the metrics of a finished task to the delegate its request was tagged with.
+    @discussion Called on the session delegate queue; the delegate is called synchronously.
+ */
+- (void)collectMetrics:(NSURLSessionTaskMetrics *)metrics
+               forTask:(NSURLSessionTask *)task NS_SWIFT_NAME(collect(_:for:));
+
+@end
+
+NS_ASSUME_NONNULL_END
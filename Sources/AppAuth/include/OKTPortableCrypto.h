@@ -0,0 +1,83 @@
+/*! @file OKTPortableCrypto.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#ifndef OKTPortableCrypto_h
+#define OKTPortableCrypto_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Length of a SHA-256 digest in bytes.
+ */
+#define OKT_SHA256_DIGEST_LENGTH 32
+
+/*! @brief Incremental SHA-256 state. Plain C so that it builds on any platform.
+ */
+typedef struct {
+  uint32_t state[8];
+  uint64_t length;
+  uint8_t block[64];
+  size_t blockLength;
+} OKTSHA256Context;
+
+void OKTSHA256Init(OKTSHA256Context *context);
+
+void OKTSHA256Update(OKTSHA256Context *context, const void *data, size_t length);
+
+/*! @brief Writes the digest and clears @c context.
+ */
+void OKTSHA256Final(OKTSHA256Context *context, uint8_t digest[OKT_SHA256_DIGEST_LENGTH]);
+
+/*! @brief Computes the SHA-256 digest of @c data in one call.
+    @see https://csrc.nist.gov/publications/detail/fips/180/4/final
+ */
+void OKTSHA256(const void *data, size_t length, uint8_t digest[OKT_SHA256_DIGEST_LENGTH]);
+
+/*! @brief Computes HMAC-SHA-256.
+    @see https://tools.ietf.org/html/rfc2104
+ */
+void OKTHMACSHA256(const void *key,
+                   size_t keyLength,
+                   const void *data,
+                   size_t length,
+                   uint8_t mac[OKT_SHA256_DIGEST_LENGTH]);
+
+/*! @brief Fills @c bytes with cryptographically secure random bytes.
+    @discussion Small requests are served from a process-wide buffer refilled by one bulk read of
+        the system CSPRNG (@c getentropy, or /dev/urandom where it is unavailable). Served bytes are
+        wiped from the buffer, and the buffer is discarded after @c fork so that parent and child
+        never share output. Large requests bypass the buffer. Thread safe.
+    @return 0 on success, or an @c errno value.
+ */
+int OKTBufferedRandomBytes(void *bytes, size_t length);
+
+/*! @brief Wipes the buffered random bytes, so the next request reads the system CSPRNG again.
+ */
+void OKTBufferedRandomReset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OKTPortableCrypto_h */
@@ -28,6 +28,7 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+@class OKTRedirectRouter;
 @protocol OKTExternalUserAgentSession;
 
 /*! @brief Start a HTTP server on the loopback interface (i.e. @c 127.0.0.1) to receive the OAuth
@@ -43,6 +44,12 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property(nonatomic, strong, nullable) id<OKTExternalUserAgentSession> currentAuthorizationFlow;
 
+/*! @brief Routes incoming request URLs to concurrent flows by their @c state.
+    @discussion Used when no @c currentAuthorizationFlow is set. The listener keeps running after a
+        flow consumes a redirect, so that it can serve the other registered flows.
+ */
+@property(nonatomic, strong, nullable) OKTRedirectRouter *router;
+
 /*! @brief Creates an a loopback HTTP redirect URI handler with the given success URL.
     @param successURL The URL that the user is redirected to after the external user-agent request flow completes
         either with a result of success or error. The contents of this page should instruct the user
@@ -66,6 +73,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable NSURL *)startHTTPListener:(nullable NSString *)domain withPort:(uint16_t)port error:(NSError **)returnError;
 
+/*! @brief Starts listening on the loopback interface like @c startHTTPListener:withPort:error:,
+        trying the fallback ports in order when the port is in use.
+    @param fallbackPorts Ports tried in order when @c port is in use. They must be registered as
+        redirect URIs too.
+ */
+- (nullable NSURL *)startHTTPListener:(nullable NSString *)domain
+                             withPort:(uint16_t)port
+                        fallbackPorts:(NSRange)fallbackPorts
+                                error:(NSError **)returnError;
+
 /*! @brief Starts listening on the loopback interface on a random available port, and returns a URL
         with the base address. Use the returned redirect URI to build a @c OKTExternalUserAgentRequest,
         and once you initiate the request, set the resulting @c OKTExternalUserAgentSession to
@@ -78,6 +95,30 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (nullable NSURL *)startHTTPListener:(nullable NSString *)domain error:(NSError **)returnError;
 
+/*! @brief Starts a listener that stays open between flows, and returns a URL with its base
+        address. Requests are dispatched through @c router, which defaults to
+        @c OKTRedirectRouter.sharedRouter, so that the listener serves any number of sequential or
+        concurrent flows registered there.
+    @param domain The host name of the returned URL, or nil for the loopback address.
+    @param port The preferred port, or 0 for a random available port.
+    @param fallbackPorts Ports tried in order when the preferred port is in use. They must be
+        registered as redirect URIs too.
+    @param returnError The error if an error occurred while starting the local HTTP server.
+    @return The URL containing the address of the server, or nil if there was an error.
+    @discussion The sockets are bound once. Calling this again while the listener is running
+        returns the URL of the running listener for @c domain, without binding again and without
+        affecting flows waiting on it; @c port and @c fallbackPorts are ignored then. The listener
+        runs until @c cancelHTTPListener is called or the handler is deallocated.
+ */
+- (nullable NSURL *)startPersistentHTTPListener:(nullable NSString *)domain
+                                       withPort:(uint16_t)port
+                                  fallbackPorts:(NSRange)fallbackPorts
+                                          error:(NSError **)returnError;
+
+/*! @brief The base URL of the running listener, or nil if it is not listening.
+ */
+@property(nonatomic, readonly, nullable) NSURL *listenerURL;
+
 /*! @brief Stops listening the loopback interface and sends an cancellation error (in the domain
         ::OKTGeneralErrorDomain, with the code ::OKTErrorCodeProgramCanceledAuthorizationFlow) to
         the @c currentAuthorizationFlow.  Has no effect if called when no requests are pending.
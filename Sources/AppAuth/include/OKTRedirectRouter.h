@@ -0,0 +1,72 @@
+/*! @file OKTRedirectRouter.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+@protocol OKTExternalUserAgentSession;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief Dispatches redirect URLs to concurrent external user-agent flows by their @c state.
+    @discussion Each flow registers under the @c state of its request. An incoming redirect, from a
+        custom URL scheme or the loopback HTTP listener, is delivered to the flow registered under
+        the @c state parameter of the URL with a single dictionary lookup, instead of being offered
+        to every pending flow in turn. Flows that receive no redirect within @c flowTimeout are
+        evicted and fail with ::OKTErrorCodeProgramCanceledAuthorizationFlow.
+ */
+@interface OKTRedirectRouter : NSObject
+
+/*! @brief The process-wide router.
+ */
++ (instancetype)sharedRouter NS_SWIFT_NAME(shared());
+
+/*! @brief The time after which a registered flow that received no redirect is evicted. Applies to
+        flows registered afterwards. Defaults to 10 minutes.
+ */
+@property(atomic) NSTimeInterval flowTimeout;
+
+/*! @brief The number of registered flows.
+ */
+@property(nonatomic, readonly) NSUInteger flowCount;
+
+/*! @brief Registers a flow to receive redirects carrying the given state.
+    @param flow The flow returned when presenting the request.
+    @param state The @c state of the presented request.
+    @return NO if a flow is already registered under the state.
+    @discussion The router keeps the flow until it consumes a redirect, is unregistered or is
+        evicted. Owners should unregister flows that finish in another way, for example when they
+        are cancelled.
+ */
+- (BOOL)registerFlow:(id<OKTExternalUserAgentSession>)flow forState:(NSString *)state;
+
+/*! @brief Removes the flow registered under the state, if any, without notifying it.
+ */
+- (void)unregisterFlowForState:(NSString *)state;
+
+/*! @brief Delivers a redirect URL to the flow registered under its @c state parameter.
+    @param URL The redirect URL. The @c state is read from the query, or from the fragment if the
+        query has none.
+    @return YES if a registered flow consumed the URL. The flow is then unregistered.
+ */
+- (BOOL)resumeExternalUserAgentFlowWithURL:(NSURL *)URL;
+
+@end
+
+NS_ASSUME_NONNULL_END
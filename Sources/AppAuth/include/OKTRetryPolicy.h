@@ -0,0 +1,142 @@
+/*! @file OKTRetryPolicy.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief Completion block used by @c OKTRetryPolicy, matching the @c NSURLSession data task
+        completion handler.
+ */
+typedef void (^OKTRetryPolicyCompletion)(NSData *_Nullable data,
+                                         NSURLResponse *_Nullable response,
+                                         NSError *_Nullable error);
+
+/*! @brief Describes how failed network requests made by the SDK are retried.
+    @discussion Delays between attempts use decorrelated jitter bounded by @c baseDelay and
+        @c maximumDelay. A @c Retry-After header sent with a 429 or 503 response takes precedence
+        over the computed delay; if it asks for more than @c maximumDelay, the request is not
+        retried. No attempt is started if it would begin after @c deadline has
+        elapsed since the first attempt.
+
+        Requests that are not idempotent (for example token requests, where the authorization
+        server may rotate the refresh token) are only retried when the server is known not to
+        have processed them: connection-level failures that happen before the request is sent,
+        and 429/503 responses. Idempotent requests are additionally retried after timeouts,
+        dropped connections and 500/502/504 responses.
+ */
+@interface OKTRetryPolicy : NSObject <NSCopying>
+
+/*! @brief The total number of attempts, including the first one. A value of 1 disables retries.
+ */
+@property(nonatomic, readonly) NSUInteger maximumAttempts;
+
+/*! @brief The lower bound of the delay before a retry, in seconds.
+ */
+@property(nonatomic, readonly) NSTimeInterval baseDelay;
+
+/*! @brief The upper bound of the delay before a retry, in seconds.
+ */
+@property(nonatomic, readonly) NSTimeInterval maximumDelay;
+
+/*! @brief The time budget of a single operation, including all retries, in seconds.
+ */
+@property(nonatomic, readonly) NSTimeInterval deadline;
+
+/*! @internal
+    @brief Unavailable. Please use @c initWithMaximumAttempts:baseDelay:maximumDelay:deadline:.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief Creates a retry policy.
+    @param maximumAttempts The total number of attempts, including the first one.
+    @param baseDelay The lower bound of the delay before a retry, in seconds.
+    @param maximumDelay The upper bound of the delay before a retry, in seconds.
+    @param deadline The time budget of a single operation, including all retries, in seconds.
+ */
+- (instancetype)initWithMaximumAttempts:(NSUInteger)maximumAttempts
+                              baseDelay:(NSTimeInterval)baseDelay
+                           maximumDelay:(NSTimeInterval)maximumDelay
+                               deadline:(NSTimeInterval)deadline NS_DESIGNATED_INITIALIZER;
+
+/*! @brief A policy that makes a single attempt. This is the default shared policy.
+ */
++ (instancetype)noRetryPolicy NS_SWIFT_NAME(noRetryPolicy());
+
+/*! @brief A policy with 3 attempts, 0.5s base delay, 8s maximum delay and a 30s deadline.
+ */
++ (instancetype)defaultRetryPolicy NS_SWIFT_NAME(defaultRetryPolicy());
+
+/*! @brief Obtains the policy used by the SDK for token and REST requests.
+    @return The policy set with @c setSharedPolicy:, or @c noRetryPolicy.
+ */
++ (OKTRetryPolicy *)sharedPolicy NS_SWIFT_NAME(sharedPolicy());
+
+/*! @brief Allows library consumers to change the policy used by the SDK for token and REST
+        requests.
+    @param policy The policy that should be used for subsequent requests.
+ */
++ (void)setSharedPolicy:(OKTRetryPolicy *)policy NS_SWIFT_NAME(setSharedPolicy(_:));
+
+/*! @brief Returns YES if the HTTP method of the request is idempotent per RFC 7231.
+    @param request The request to check.
+ */
++ (BOOL)isIdempotentRequest:(NSURLRequest *)request;
+
+/*! @brief Parses the @c Retry-After header of a response.
+    @param response The HTTP response.
+    @return The delay in seconds requested by the server, or a negative value when the header is
+        missing or cannot be parsed.
+ */
++ (NSTimeInterval)retryAfterIntervalForResponse:(nullable NSHTTPURLResponse *)response;
+
+/*! @brief Decides whether an attempt that finished with the given outcome may be retried.
+    @param error The transport error, if any.
+    @param response The response, if any.
+    @param idempotent Whether the request can be safely repeated if it reached the server.
+ */
+- (BOOL)shouldRetryWithError:(nullable NSError *)error
+                    response:(nullable NSURLResponse *)response
+                  idempotent:(BOOL)idempotent;
+
+/*! @brief Computes the next delay using decorrelated jitter.
+    @param previousDelay The previous delay, or 0 before the first retry.
+    @return A random delay in [baseDelay, min(maximumDelay, 3 * previousDelay)].
+ */
+- (NSTimeInterval)delayAfterPreviousDelay:(NSTimeInterval)previousDelay;
+
+/*! @brief Performs a data task, retrying it according to this policy.
+    @discussion Every attempt goes through the @c OKTCircuitBreaker of the request's origin, if
+        circuit breaking is enabled. Attempts rejected by an open breaker complete asynchronously
+        with an @c ::OKTErrorCodeCircuitBreakerOpen error and are not retried.
+    @param request The request to perform.
+    @param session The session used for every attempt.
+    @param idempotent Whether the request can be safely repeated if it reached the server.
+    @param completionHandler Called once with the outcome of the last attempt, on the queue of the
+        session's delegate, or on a global queue if the breaker rejected the attempt.
+ */
+- (void)performDataTaskWithRequest:(NSURLRequest *)request
+                           session:(NSURLSession *)session
+                        idempotent:(BOOL)idempotent
+                 completionHandler:(OKTRetryPolicyCompletion)completionHandler;
+
+@end
+
+NS_ASSUME_NONNULL_END
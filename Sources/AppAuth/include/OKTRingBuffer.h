@@ -0,0 +1,76 @@
+/*! @file OKTRingBuffer.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#ifndef OKTRingBuffer_h
+#define OKTRingBuffer_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief A fixed-capacity byte ring buffer whose free and filled regions are exposed as
+        @c iovec arrays, so that producers read straight into it and consumers write straight from
+        it with @c readv and @c writev.
+    @discussion The storage is allocated when free space is first requested and released by
+        @c OKTRingBufferRelease, so an idle buffer holds no memory. Plain C so that it builds on any
+        platform; not thread safe.
+ */
+typedef struct {
+  uint8_t *bytes;
+  size_t capacity;
+  size_t start;
+  size_t length;
+} OKTRingBuffer;
+
+/*! @brief Prepares an empty buffer without allocating its storage.
+ */
+void OKTRingBufferInit(OKTRingBuffer *buffer, size_t capacity);
+
+/*! @brief Releases the storage and discards the contents. The buffer can be used again.
+ */
+void OKTRingBufferRelease(OKTRingBuffer *buffer);
+
+/*! @brief Describes the free space, allocating the storage if needed.
+    @return The number of regions, 0 if the buffer is full or the storage cannot be allocated.
+ */
+int OKTRingBufferWritableRegions(OKTRingBuffer *buffer, struct iovec regions[2]);
+
+/*! @brief Appends @c length bytes written into the free space.
+ */
+void OKTRingBufferCommit(OKTRingBuffer *buffer, size_t length);
+
+/*! @brief Describes the contents in order.
+    @return The number of regions, 0 if the buffer is empty.
+ */
+int OKTRingBufferReadableRegions(const OKTRingBuffer *buffer, struct iovec regions[2]);
+
+/*! @brief Removes @c length bytes from the front of the contents.
+ */
+void OKTRingBufferConsume(OKTRingBuffer *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OKTRingBuffer_h */
@@ -115,6 +115,17 @@ typedef void (^OKTServiceConfigurationCreated)
  */
 - (instancetype)initWithDiscoveryDocument:(OKTServiceDiscovery *)discoveryDocument;
 
+/*! @brief Returns the configuration shared by the sessions of the same issuer.
+    @param configuration A configuration, usually one just discovered or decoded.
+    @return The shared configuration if it has the same endpoints and discovery document as
+        @c configuration, otherwise @c configuration, which becomes the shared one.
+    @discussion Configurations are keyed by issuer, or by token endpoint when there is no issuer,
+        and held weakly, so a configuration is shared for as long as a session refers to it.
+        Decoded configurations are always shared.
+ */
++ (OKTServiceConfiguration *)sharedConfigurationForConfiguration:
+    (OKTServiceConfiguration *)configuration NS_SWIFT_NAME(shared(for:));
+
 @end
 
 NS_ASSUME_NONNULL_END
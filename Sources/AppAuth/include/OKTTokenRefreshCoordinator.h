@@ -0,0 +1,69 @@
+/*! @file OKTTokenRefreshCoordinator.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+#import "OKTAuthorizationService.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief Collapses concurrent refreshes of the same refresh token into a single token request.
+    @discussion Several @c OKTAuthState instances restored from the same storage hold the same
+        refresh token. If they all refreshed it, servers that rotate refresh tokens would accept
+        only the first request and invalidate the others. The coordinator keys in-flight requests
+        by a SHA-256 hash of the refresh token and delivers the result of the one request to every
+        caller, so that each instance updates itself with the same response.
+
+        Requests are only merged if they have equal validators and equal additional parameters.
+        Instances of @c OKTDefaultTokenValidator are equal; other validators are compared with
+        @c isEqual:. The remaining limits of a merged request are:
+        - It is customized by the delegate of the caller that started it, since it is already sent
+          when others join.
+        - Its ID token is validated against the original authorization response of that caller.
+        - Delegates of callers that join after the response arrived don't receive it.
+ */
+@interface OKTTokenRefreshCoordinator : NSObject
+
+/*! @brief The process-wide coordinator used by @c OKTAuthState.
+ */
++ (instancetype)sharedCoordinator NS_SWIFT_NAME(shared());
+
+/*! @brief The number of refresh requests currently in flight.
+ */
+@property(nonatomic, readonly) NSUInteger inFlightRefreshCount;
+
+/*! @brief Performs a refresh token request, or joins the identical request already in flight.
+    @param request The refresh token request. Requests without a refresh token are not coalesced.
+    @param authorizationResponse The original authorization response related to this request.
+    @param delegate The network request customization delegate. Only the delegate of the caller
+        that starts the request customizes it. The distinct delegates of every caller receive the
+        response and the metrics of the request.
+    @param validator Validates the ID token of the response. Part of the key of the request.
+    @param callback Called on the main queue with the shared result.
+ */
+- (void)performTokenRefreshRequest:(OKTTokenRequest *)request
+     originalAuthorizationResponse:(nullable OKTAuthorizationResponse *)authorizationResponse
+                          delegate:(nullable id<OktaNetworkRequestCustomizationDelegate>)delegate
+                         validator:(id<OKTTokenValidator>)validator
+                          callback:(OKTTokenCallback)callback;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -159,6 +159,13 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (NSURLRequest *)URLRequest;
 
+/*! @brief Returns a copy without the authorization code, refresh token, code verifier and
+        additional parameters.
+    @discussion The copy refers to the shared configuration of the issuer, see
+        @c OKTServiceConfiguration.sharedConfigurationForConfiguration:.
+ */
+- (instancetype)compactCopy;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -107,6 +107,11 @@ NS_ASSUME_NONNULL_BEGIN
                      parameters:(NSDictionary<NSString *, NSObject<NSCopying> *> *)parameters
                      NS_DESIGNATED_INITIALIZER;
 
+/*! @brief Returns a copy without the additional parameters, made from the compact copy of the
+        request.
+ */
+- (instancetype)compactCopy;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -60,9 +60,9 @@ NS_ASSUME_NONNULL_BEGIN
 
 /*! @brief Form url encode the input string by applying application/x-www-form-urlencoded algorithm
     @param inputString The input string.
-    @return The encoded string.
+    @return The encoded string, or nil if the input string is not valid Unicode.
  */
-+ (NSString*)formUrlEncode:(NSString*)inputString;
++ (nullable NSString*)formUrlEncode:(NSString*)inputString;
 
 @end
 
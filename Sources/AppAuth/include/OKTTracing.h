@@ -0,0 +1,123 @@
+/*! @file OKTTracing.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief The OIDC discovery document download.
+ */
+extern NSString *const OKTTraceSpanDiscovery;
+
+/*! @brief A browser sign in, from the discovery request to the new auth state.
+ */
+extern NSString *const OKTTraceSpanBrowserSignIn;
+
+/*! @brief The browser round trip, from presenting the authorization request to the redirect.
+ */
+extern NSString *const OKTTraceSpanAuthorization;
+
+/*! @brief A session token sign in, from the discovery request to the new auth state.
+ */
+extern NSString *const OKTTraceSpanSessionTokenSignIn;
+
+/*! @brief The authorization request made with a session token, without a browser.
+ */
+extern NSString *const OKTTraceSpanSessionTokenAuthorization;
+
+/*! @brief A token endpoint request, for any grant type.
+ */
+extern NSString *const OKTTraceSpanTokenRequest;
+
+/*! @brief The validation of the ID token of a token response.
+ */
+extern NSString *const OKTTraceSpanIDTokenValidation;
+
+/*! @brief An @c OKTAuthState token refresh, including the pending actions it unblocks.
+ */
+extern NSString *const OKTTraceSpanTokenRefresh;
+
+/*! @brief Writing the auth state to the keychain.
+ */
+extern NSString *const OKTTraceSpanPersistence;
+
+/*! @brief A userinfo, introspect or revoke request of @c OktaOidcStateManager.
+ */
+extern NSString *const OKTTraceSpanEndpointRequest;
+
+/*! @brief A unit of work being traced.
+    @discussion Spans are ended exactly once. Implementations must be thread safe.
+ */
+@protocol OKTTraceSpan <NSObject>
+
+/*! @brief Attaches an attribute to the span, replacing any previous value for @c key.
+ */
+- (void)setAttribute:(NSString *)value forKey:(NSString *)key
+    NS_SWIFT_NAME(setAttribute(_:forKey:));
+
+/*! @brief Ends the span.
+    @param error The error the traced work failed with, or nil if it succeeded.
+ */
+- (void)endWithError:(nullable NSError *)error NS_SWIFT_NAME(end(error:));
+
+@end
+
+/*! @brief Receives the spans of the login and refresh pipelines.
+    @discussion Spans are not linked to a parent; phases of one operation are nested in time.
+        Implementations must be thread safe.
+ */
+@protocol OKTTracer <NSObject>
+
+/*! @brief Starts a span.
+    @param name One of the @c OKTTraceSpan names.
+ */
+- (id<OKTTraceSpan>)beginSpanWithName:(NSString *)name NS_SWIFT_NAME(beginSpan(_:));
+
+@end
+
+/*! @brief Holds the @c OKTTracer used by the SDK.
+    @discussion No tracer is installed by default. Until one is, @c beginSpanWithName: returns nil
+        after a single atomic load, so instrumented code costs a nil message send per phase. Callers
+        set attributes on the returned span rather than passing them in, so that attribute values
+        are not computed when tracing is off.
+ */
+@interface OKTTracing : NSObject
+
+/*! @internal
+    @brief Unavailable. This class should not be initialized.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief The installed tracer, if any.
+ */
++ (nullable id<OKTTracer>)tracer;
+
+/*! @brief Installs a tracer, or removes it when nil.
+ */
++ (void)setTracer:(nullable id<OKTTracer>)tracer;
+
+/*! @brief Starts a span with the installed tracer.
+    @return The span, or nil if no tracer is installed.
+ */
++ (nullable id<OKTTraceSpan>)beginSpanWithName:(NSString *)name NS_SWIFT_NAME(beginSpan(_:));
+
+@end
+
+NS_ASSUME_NONNULL_END
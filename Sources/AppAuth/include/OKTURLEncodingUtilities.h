@@ -0,0 +1,88 @@
+/*! @file OKTURLEncodingUtilities.h
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief The character set used when percent encoding.
+ */
+typedef NS_ENUM(NSInteger, OKTURLEncodingMode) {
+  /*! @brief Keeps the characters of @c NSCharacterSet.URLQueryAllowedCharacterSet except "=", "&"
+          and "+", so the result can be used as a query parameter name or value. Space is encoded
+          as "%20".
+   */
+  OKTURLEncodingModeQueryValue,
+
+  /*! @brief The application/x-www-form-urlencoded byte serializer: keeps only "*-._" and ASCII
+          alphanumerics, and encodes space as "+".
+      @see https://url.spec.whatwg.org/#urlencoded-serializing
+   */
+  OKTURLEncodingModeForm,
+};
+
+/*! @brief Percent encoding and application/x-www-form-urlencoded decoding of UTF-8 strings.
+    @discussion Each method makes a single pass over the UTF-8 bytes of its input, classifying them
+        with a lookup table, instead of the several passes and intermediate strings needed with
+        @c NSCharacterSet and @c NSURLComponents.
+ */
+@interface OKTURLEncodingUtilities : NSObject
+
+/*! @internal
+    @brief Unavailable. This class should not be initialized.
+ */
+- (instancetype)init NS_UNAVAILABLE;
+
+/*! @brief Percent encodes a string.
+    @param string The string to encode.
+    @param mode The characters to keep.
+    @return The encoded string, or nil if @c string is not valid Unicode.
+ */
++ (nullable NSString *)encodeString:(NSString *)string mode:(OKTURLEncodingMode)mode;
+
+/*! @brief Percent encodes a string, appending the result to @c data.
+    @param string The string to encode.
+    @param mode The characters to keep.
+    @param data The buffer the ASCII result is appended to.
+    @return NO if @c string is not valid Unicode, in which case @c data is left unchanged.
+ */
++ (BOOL)appendEncodedString:(NSString *)string
+                       mode:(OKTURLEncodingMode)mode
+                     toData:(NSMutableData *)data;
+
+/*! @brief Decodes an application/x-www-form-urlencoded name or value: "+" becomes space and
+        percent sequences are decoded. A "%" not followed by two hex digits is kept as is.
+    @param string The encoded string.
+    @return The decoded string, or nil if the decoded bytes are not valid UTF-8.
+    @see https://url.spec.whatwg.org/#urlencoded-parsing
+ */
++ (nullable NSString *)decodeFormString:(NSString *)string;
+
+/*! @brief Parses an application/x-www-form-urlencoded query string.
+    @param query The percent encoded query, without the leading "?".
+    @param block Called with each decoded name and value, in order. Parts without "=" and parts that
+        do not decode to valid UTF-8 are skipped.
+ */
++ (void)enumerateParametersInQuery:(NSString *)query
+                        usingBlock:(void (^)(NSString *name, NSString *value))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
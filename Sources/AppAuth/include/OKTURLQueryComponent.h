@@ -25,8 +25,9 @@
 NS_ASSUME_NONNULL_BEGIN
 
 /*! @brief If set to YES, will force the iOS 7-only code for @c OKTURLQueryComponent to be used,
-        even on non-iOS 7 devices and simulators. Useful for testing the iOS 7 code paths on the
-        simulator. Defaults to NO.
+        even on non-iOS 7 devices and simulators. Defaults to NO.
+    @discussion Kept for source compatibility. All platforms now share the same encoder, so this
+        flag has no effect.
  */
 extern BOOL gOKTURLQueryComponentForceIOS7Handling;
 
@@ -42,13 +43,14 @@ extern BOOL gOKTURLQueryComponentForceIOS7Handling;
  */
 @interface OKTURLQueryComponent : NSObject
 
-/*! @brief The parameter names in the query.
+/*! @brief The distinct parameter names in the query, in the order they were first added.
  */
 @property(nonatomic, readonly) NSArray<NSString *> *parameters;
 
 /*! @brief The parameters represented as a dictionary.
     @remarks All values are @c NSString except for parameters which contain multiple values, in
-        which case the value is an @c NSArray<NSString *> *.
+        which case the value is an @c NSArray<NSString *> *. The dictionary is built once and
+        returned again until a parameter is added.
  */
 @property(nonatomic, readonly) NSDictionary<NSString *, NSObject<NSCopying> *> *dictionaryValue;
 
@@ -70,7 +72,8 @@ extern BOOL gOKTURLQueryComponentForceIOS7Handling;
 - (void)addParameter:(NSString *)parameter value:(NSString *)value;
 
 /*! @brief Adds multiple parameters with associated values to the query.
-    @param parameters The parameter name value pairs to add to the query.
+    @param parameters The parameter name value pairs to add to the query. They are added sorted by
+        name, so that the encoded query does not depend on dictionary ordering.
  */
 - (void)addParameters:(NSDictionary<NSString *, NSString *> *)parameters;
 
@@ -79,7 +82,9 @@ extern BOOL gOKTURLQueryComponentForceIOS7Handling;
  */
 - (NSURL *)URLByReplacingQueryInURL:(NSURL *)URL;
 
-/*! @brief Builds an x-www-form-urlencoded string representing the parameters.
+/*! @brief Builds an x-www-form-urlencoded string representing the parameters, in the order they
+        were added.
+    @discussion Parameters whose name or value is not valid Unicode are left out.
     @return The x-www-form-urlencoded string representing the parameters.
  */
 - (NSString *)URLEncodedParameters;
@@ -12,6 +12,8 @@
 
 #import <Foundation/Foundation.h>
 
+@class OKTNetworkMetrics;
+
 /*! @brief Allows to modify network requests and track responses in OktaOidc.
     @discussion More information could be found here: https://github.com/okta/okta-oidc-ios/blob/master/README.md#modify-network-requests.
  */
@@ -32,4 +34,14 @@
 */
 - (void)didReceiveResponse: (nullable NSURLResponse *)response;
 
+@optional
+
+/*! @brief Reports the timing of a finished network request, tagged with its logical operation.
+    @discussion Requires the session to forward its task metrics to
+                @c OKTNetworkMetricsCollector, which the session OktaOidc sets up does.
+                Retried requests report once per attempt.
+    @param metrics Metrics of the request.
+*/
+- (void)didCollectMetrics: (nonnull OKTNetworkMetrics *)metrics NS_SWIFT_NAME(didCollectMetrics(_:));
+
 @end
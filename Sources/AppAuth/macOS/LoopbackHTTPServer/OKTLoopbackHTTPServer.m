@@ -22,13 +22,29 @@
 
 #if TARGET_OS_OSX
 
+#import "OKTHTTPRequestParser.h"
+#import "OKTLoopbackSocket.h"
+#import "OKTRingBuffer.h"
+
+#include <errno.h>
+#include <string.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <unistd.h>
 
-// We'll ignore the pointer arithmetic warnings for now.
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wpointer-arith"
+// Identifies the serial queues that service loopback sockets; the value
+// is the queue itself.
+static char kLoopbackQueueKey;
+
+static dispatch_queue_t LoopbackQueueCreate(void) {
+    dispatch_queue_t queue = dispatch_queue_create("com.okta.appauth.loopback-http-server", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_set_specific(queue, &kLoopbackQueueKey, (__bridge void *)queue, NULL);
+    return queue;
+}
+
+static BOOL LoopbackQueueIsCurrent(dispatch_queue_t queue) {
+    return dispatch_get_specific(&kLoopbackQueueKey) == (__bridge void *)queue;
+}
 
 @implementation HTTPServer
 
@@ -36,6 +52,14 @@
     self = [super init];
     connClass = [HTTPConnection self];
     connections = [[NSMutableArray alloc] init];
+    delegateQueue = dispatch_get_main_queue();
+    maxConnections = 16;
+    idleTimeout = 30;
+    headerTimeout = 10;
+    bodyTimeout = 10;
+    responseTimeout = 30;
+    maxHeaderLength = OKT_HTTP_DEFAULT_MAX_HEADER_LENGTH;
+    maxBodyLength = OKT_HTTP_DEFAULT_MAX_BODY_LENGTH;
     return self;
 }
 
@@ -47,14 +71,108 @@
     connClass = value;
 }
 
+- (dispatch_queue_t)delegateQueue {
+    return delegateQueue;
+}
+
+- (void)setDelegateQueue:(dispatch_queue_t)value {
+    delegateQueue = value;
+}
+
+- (NSUInteger)maxConnections {
+    return maxConnections;
+}
+
+- (void)setMaxConnections:(NSUInteger)value {
+    maxConnections = value;
+}
+
+- (NSTimeInterval)idleTimeout {
+    return idleTimeout;
+}
+
+- (void)setIdleTimeout:(NSTimeInterval)value {
+    idleTimeout = value;
+}
+
+- (NSTimeInterval)headerTimeout {
+    return headerTimeout;
+}
+
+- (void)setHeaderTimeout:(NSTimeInterval)value {
+    headerTimeout = value;
+}
+
+- (NSTimeInterval)bodyTimeout {
+    return bodyTimeout;
+}
+
+- (void)setBodyTimeout:(NSTimeInterval)value {
+    bodyTimeout = value;
+}
+
+- (NSTimeInterval)responseTimeout {
+    return responseTimeout;
+}
+
+- (void)setResponseTimeout:(NSTimeInterval)value {
+    responseTimeout = value;
+}
+
+- (size_t)maxHeaderLength {
+    return maxHeaderLength;
+}
+
+- (void)setMaxHeaderLength:(size_t)value {
+    maxHeaderLength = value;
+}
+
+- (size_t)maxBodyLength {
+    return maxBodyLength;
+}
+
+- (void)setMaxBodyLength:(size_t)value {
+    maxBodyLength = value;
+}
+
+- (NSUInteger)connectionCount {
+    __block NSUInteger count = 0;
+    dispatch_queue_t serverQueue = [self queue];
+    if (LoopbackQueueIsCurrent(serverQueue)) {
+        return [connections count];
+    }
+    dispatch_sync(serverQueue, ^{
+      count = [self->connections count];
+    });
+    return count;
+}
+
+- (BOOL)stop {
+    [super stop];
+    // Captures the list rather than self, as this is also called from dealloc.
+    NSMutableArray<HTTPConnection *> *openConnections = connections;
+    dispatch_async([self queue], ^{
+      for (HTTPConnection *connection in [openConnections copy]) {
+          [connection closeAfterPendingResponses];
+      }
+    });
+    return YES;
+}
+
 // Removes the connection from the list of active connections.
 - (void)removeConnection:(HTTPConnection *)connection {
     [connections removeObject:connection];
 }
 
 // Converts the TCPServer delegate notification into the HTTPServer delegate method.
-- (void)handleNewConnectionFromAddress:(NSData *)addr inputStream:(NSInputStream *)istr outputStream:(NSOutputStream *)ostr {
-    HTTPConnection *connection = [[connClass alloc] initWithPeerAddress:addr inputStream:istr outputStream:ostr forServer:self];
+- (void)handleNewConnectionFromAddress:(NSData *)addr socket:(int)fd {
+    if ([connections count] >= maxConnections) {
+        // Refuses the connection rather than letting stray clients pin
+        // file descriptors and memory.
+        close(fd);
+        return;
+    }
+    HTTPConnection *connection = [[connClass alloc] initWithPeerAddress:addr socket:fd forServer:self];
     // Adds connection to the active connection list to retain it.
     [connections addObject:connection];
     [connection setDelegate:[self delegate]];
@@ -66,29 +184,129 @@
 @end
 
 
-@implementation HTTPConnection
+// What the connection is waiting for, which determines its deadline.
+typedef enum {
+    ConnectionDeadlineNone = 0,
+    // The next request.
+    ConnectionDeadlineIdle,
+    ConnectionDeadlineHeader,
+    ConnectionDeadlineBody,
+    // The delegate setting the response.
+    ConnectionDeadlineResponse,
+    // The peer reading a response.
+    ConnectionDeadlineWrite,
+} ConnectionDeadline;
+
+// Whether the message has a "Connection: close" header field.
+static BOOL MessageClosesConnection(CFHTTPMessageRef message) {
+    NSString *value = (__bridge_transfer NSString *)CFHTTPMessageCopyHeaderFieldValue(message, (__bridge CFStringRef)@"Connection");
+    for (NSString *option in [value componentsSeparatedByString:@","]) {
+        NSString *trimmedOption = [option stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        if ([trimmedOption caseInsensitiveCompare:@"close"] == NSOrderedSame) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+// Size of the buffer that streamed response bodies are read into.
+static const size_t kResponseStreamBufferSize = 16 * 1024;
+
+// Most buffers passed to one writev call.
+static const int kMaxOutgoingBuffers = 8;
+
+@implementation HTTPConnection {
+    // Parses the incoming bytes as they arrive, one request at a time.
+    OKTHTTPRequestParser parser;
+    // Buffers of the current response not yet written, in order: the
+    // serialized header and the body of the response message, written
+    // from where they are without copying.
+    NSMutableArray<NSData *> *osegments;
+    // Bytes of the first segment already written.
+    NSUInteger osegmentOffset;
+    // Bytes of a streamed response body not yet written. The storage is
+    // allocated for the streamed response and released when it is done.
+    OKTRingBuffer obuffer;
+    // Closes the connection when the current deadline passes.
+    dispatch_source_t deadlineTimer;
+    ConnectionDeadline deadline;
+    NSTimeInterval idleTimeout;
+    NSTimeInterval headerTimeout;
+    NSTimeInterval bodyTimeout;
+    NSTimeInterval responseTimeout;
+}
 
 - (id)init {
     return nil;
 }
 
-- (id)initWithPeerAddress:(NSData *)addr inputStream:(NSInputStream *)istr outputStream:(NSOutputStream *)ostr forServer:(HTTPServer *)serv {
+- (id)initWithPeerAddress:(NSData *)addr socket:(int)fd forServer:(HTTPServer *)serv {
     peerAddress = [addr copy];
     server = serv;
-    istream = istr;
-    ostream = ostr;
-    [istream setDelegate:self];
-    [ostream setDelegate:self];
-    [istream scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:(id)kCFRunLoopCommonModes];
-    [ostream scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:(id)kCFRunLoopCommonModes];
-    [istream open];
-    [ostream open];
+    socketFD = fd;
+    queue = serv ? [serv queue] : LoopbackQueueCreate();
+    delegateQueue = serv ? [serv delegateQueue] : dispatch_get_main_queue();
+    idleTimeout = [serv idleTimeout];
+    headerTimeout = [serv headerTimeout];
+    bodyTimeout = [serv bodyTimeout];
+    responseTimeout = [serv responseTimeout];
+    OKTHTTPRequestParserInit(&parser, [serv maxHeaderLength], [serv maxBodyLength]);
+    OKTRingBufferInit(&obuffer, kResponseStreamBufferSize);
+    if (socketFD < 0) {
+        return self;
+    }
+
+    readSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, socketFD, 0, queue);
+    writeSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_WRITE, socketFD, 0, queue);
+    deadlineTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, queue);
+    if (!readSource || !writeSource || !deadlineTimer) {
+        close(socketFD);
+        readSource = nil;
+        writeSource = nil;
+        deadlineTimer = nil;
+        return self;
+    }
+
+    // The handlers retain the connection until -invalidate cancels the sources.
+    dispatch_source_set_event_handler(readSource, ^{
+      [self readAvailableBytes];
+    });
+    dispatch_source_set_event_handler(writeSource, ^{
+      [self processOutgoingBytes];
+    });
+    // Idle and slow clients are routine, so closing them at the deadline is not logged.
+    dispatch_source_set_event_handler(deadlineTimer, ^{
+      [self invalidate];
+    });
+
+    // Closes the socket once neither source monitors it.
+    dispatch_group_t monitors = dispatch_group_create();
+    dispatch_group_enter(monitors);
+    dispatch_group_enter(monitors);
+    dispatch_source_set_cancel_handler(readSource, ^{
+      dispatch_group_leave(monitors);
+    });
+    dispatch_source_set_cancel_handler(writeSource, ^{
+      dispatch_group_leave(monitors);
+    });
+    int closingFD = socketFD;
+    dispatch_group_notify(monitors, queue, ^{
+      close(closingFD);
+    });
+
+    // Sources are created suspended; the write source is resumed when there are bytes to write.
+    dispatch_resume(readSource);
+    writeSuspended = YES;
     isValid = YES;
+    [self updateDeadline];
+    dispatch_resume(deadlineTimer);
     return self;
 }
 
 - (void)dealloc {
-    [self invalidate];
+    // The sources retain a connected connection, so it is invalidated before it is deallocated.
+    OKTHTTPRequestParserDestroy(&parser);
+    OKTRingBufferRelease(&obuffer);
 }
 
 - (id)delegate {
@@ -121,201 +339,401 @@
 }
 
 - (void)invalidate {
+    if (!LoopbackQueueIsCurrent(queue)) {
+        dispatch_async(queue, ^{
+          [self invalidate];
+        });
+        return;
+    }
     if (isValid) {
         isValid = NO;
         [server removeConnection:self];
-        [istream setDelegate:nil];
-        [ostream setDelegate:nil];
-        [istream close];
-        [ostream close];
-        istream = nil;
-        ostream = nil;
-        ibuffer = nil;
-        obuffer = nil;
+        dispatch_source_cancel(readSource);
+        dispatch_source_cancel(writeSource);
+        dispatch_source_cancel(deadlineTimer);
+        // Suspended sources must be resumed to complete their cancellation.
+        if (readSuspended) {
+            dispatch_resume(readSource);
+        }
+        if (writeSuspended) {
+            dispatch_resume(writeSource);
+        }
+        readSource = nil;
+        writeSource = nil;
+        deadlineTimer = nil;
+        osegments = nil;
+        OKTRingBufferRelease(&obuffer);
         requests = nil;
     }
 }
 
-// YES return means that a complete request was parsed, and the caller
-// should call again as the buffered bytes may have another complete
-// request available.
-- (BOOL)processIncomingBytes {
-    CFHTTPMessageRef working = CFHTTPMessageCreateEmpty(kCFAllocatorDefault, TRUE);
-    CFHTTPMessageAppendBytes(working, [ibuffer bytes], [ibuffer length]);
-
-    // This "try and possibly succeed" approach is potentially expensive
-    // (lots of bytes being copied around), but the only API available for
-    // the server to use, short of doing the parsing itself.
-
-    // HTTPConnection does not handle the chunked transfer encoding
-    // described in the HTTP spec.  And if there is no Content-Length
-    // header, then the request is the remainder of the stream bytes.
-
-    if (CFHTTPMessageIsHeaderComplete(working)) {
-        NSString *contentLengthValue = (__bridge_transfer NSString *)CFHTTPMessageCopyHeaderFieldValue(working, (CFStringRef)@"Content-Length");
-        
-        unsigned contentLength = contentLengthValue ? [contentLengthValue intValue] : 0;
-        NSData *body = (__bridge_transfer NSData *)CFHTTPMessageCopyBody(working);
-        NSUInteger bodyLength = [body length];
-        if (contentLength <= bodyLength) {
-            NSData *newBody = [NSData dataWithBytes:[body bytes] length:contentLength];
-            [ibuffer setLength:0];
-            [ibuffer appendBytes:([body bytes] + contentLength) length:(bodyLength - contentLength)];
-            CFHTTPMessageSetBody(working, (__bridge CFDataRef)newBody);
-        } else {
-            CFRelease(working);
-            return NO;
-        }
+- (void)closeAfterPendingResponses {
+    if (!LoopbackQueueIsCurrent(queue)) {
+        dispatch_async(queue, ^{
+          [self closeAfterPendingResponses];
+        });
+        return;
+    }
+    if (!isValid) {
+        return;
+    }
+    readClosed = YES;
+    if ([requests count] == 0) {
+        [self invalidate];
+        return;
+    }
+    [self updateReadSource];
+}
+
+// Bounds how long the connection may wait for what it is waiting for.
+// The idle, header, body and response deadlines run from the start of
+// their phase, so that a client trickling bytes, including blank lines
+// before a request, cannot extend them; the write deadline restarts
+// whenever the peer reads part of a response.
+- (void)updateDeadline {
+    ConnectionDeadline newDeadline;
+    NSTimeInterval timeout;
+    OKTHTTPParsePhase phase = OKTHTTPRequestParserPhase(&parser);
+    if (0 < [osegments count] || 0 < obuffer.length) {
+        newDeadline = ConnectionDeadlineWrite;
+        timeout = idleTimeout;
+    } else if (phase == OKTHTTPParsePhaseHeader) {
+        newDeadline = ConnectionDeadlineHeader;
+        timeout = headerTimeout;
+    } else if (phase == OKTHTTPParsePhaseBody) {
+        newDeadline = ConnectionDeadlineBody;
+        timeout = bodyTimeout;
+    } else if (0 < [requests count]) {
+        // The delegate is preparing a response.
+        newDeadline = ConnectionDeadlineResponse;
+        timeout = responseTimeout;
     } else {
-        return NO;
+        newDeadline = ConnectionDeadlineIdle;
+        timeout = idleTimeout;
+    }
+    if (newDeadline == deadline && newDeadline != ConnectionDeadlineWrite) {
+        return;
+    }
+    deadline = newDeadline;
+    dispatch_time_t start = (newDeadline == ConnectionDeadlineNone || timeout <= 0)
+        ? DISPATCH_TIME_FOREVER
+        : dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC));
+    dispatch_source_set_timer(deadlineTimer, start, DISPATCH_TIME_FOREVER, NSEC_PER_SEC / 10);
+}
+
+// Reads the bytes available on the socket. At the end of the stream no
+// more requests are coming in, and the connection is closed once the
+// pending responses are sent.
+- (void)readAvailableBytes {
+    uint8_t buffer[16 * 1024];
+    ssize_t amount = OKTLoopbackSocketRead(socketFD, buffer, sizeof(buffer));
+    if (0 < amount) {
+        [self processIncomingBytes:buffer length:amount];
+    } else if (0 == amount) {
+        readClosed = YES;
+        [self updateReadSource];
+        if ([requests count] == 0) {
+            [self invalidate];
+        }
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        NSLog(@"HTTPServer socket error: %s", strerror(errno));
+        [self invalidate];
+    }
+    if (isValid) {
+        [self updateDeadline];
+    }
+}
+
+// Feeds newly received bytes to the parser, which examines each byte once, and dispatches every
+// request they complete. Bytes following a complete request are parsed as the next (pipelined)
+// request. Malformed or oversized requests close the connection.
+- (void)processIncomingBytes:(const uint8_t *)bytes length:(NSUInteger)length {
+    NSUInteger offset = 0;
+    while (isValid && offset < length) {
+        OKTHTTPParseStatus status;
+        offset += OKTHTTPRequestParserExecute(&parser, bytes + offset, length - offset, &status);
+        if (status == OKTHTTPParseStatusIncomplete) {
+            return;
+        }
+
+        CFHTTPMessageRef message = status == OKTHTTPParseStatusComplete ? [self copyParsedRequest] : NULL;
+        if (!message) {
+            // Not logged: any local process can send malformed requests to the port.
+            [self invalidate];
+            return;
+        }
+        OKTHTTPRequestParserReset(&parser);
+        [self handleRequest:message];
+        BOOL closes = MessageClosesConnection(message);
+        CFRelease(message);
+        if (closes) {
+            // No more requests are read; bytes following this request are dropped.
+            readClosed = YES;
+            [self updateReadSource];
+            return;
+        }
+    }
+}
+
+// Builds the request message from the parsed request line, header fields and body.
+- (CFHTTPMessageRef)copyParsedRequest CF_RETURNS_RETAINED {
+    NSString *method = [[NSString alloc] initWithBytes:parser.head
+                                                length:parser.methodLength
+                                              encoding:NSASCIIStringEncoding];
+    NSString *target = [[NSString alloc] initWithBytes:parser.head + parser.targetOffset
+                                                length:parser.targetLength
+                                              encoding:NSUTF8StringEncoding];
+    NSString *version = [[NSString alloc] initWithBytes:parser.head + parser.versionOffset
+                                                 length:parser.versionLength
+                                               encoding:NSASCIIStringEncoding];
+
+    // Resolves origin-form targets against the Host header, so that the request URL is absolute
+    // as it is for messages parsed by CFHTTPMessage.
+    NSURL *url = nil;
+    size_t hostLength = 0;
+    const char *host = OKTHTTPRequestParserHeaderValue(&parser, "Host", &hostLength);
+    if (host && [target hasPrefix:@"/"]) {
+        NSString *hostValue = [[NSString alloc] initWithBytes:host
+                                                       length:hostLength
+                                                     encoding:NSUTF8StringEncoding];
+        url = [NSURL URLWithString:[NSString stringWithFormat:@"http://%@%@", hostValue, target]];
+    } else if (target) {
+        url = [NSURL URLWithString:target];
+    }
+    if (!method || !version || !url) {
+        return NULL;
     }
 
-    HTTPServerRequest *request = [[HTTPServerRequest alloc] initWithRequest:working connection:self];
+    CFHTTPMessageRef message = CFHTTPMessageCreateRequest(kCFAllocatorDefault,
+                                                          (__bridge CFStringRef)method,
+                                                          (__bridge CFURLRef)url,
+                                                          (__bridge CFStringRef)version);
+    for (size_t i = 0; i < parser.fieldCount; i++) {
+        OKTHTTPHeaderField field = parser.fields[i];
+        NSString *name = [[NSString alloc] initWithBytes:parser.head + field.nameOffset
+                                                  length:field.nameLength
+                                                encoding:NSASCIIStringEncoding];
+        NSString *value = [[NSString alloc] initWithBytes:parser.head + field.valueOffset
+                                                   length:field.valueLength
+                                                 encoding:NSUTF8StringEncoding];
+        if (!name || !value) {
+            continue;
+        }
+        // Repeated fields are combined into one comma-separated value.
+        NSString *previousValue = (__bridge_transfer NSString *)CFHTTPMessageCopyHeaderFieldValue(message, (__bridge CFStringRef)name);
+        if (previousValue) {
+            value = [NSString stringWithFormat:@"%@, %@", previousValue, value];
+        }
+        CFHTTPMessageSetHeaderFieldValue(message, (__bridge CFStringRef)name, (__bridge CFStringRef)value);
+    }
+    if (parser.bodyLength > 0) {
+        NSData *body = [NSData dataWithBytes:parser.body length:parser.bodyLength];
+        CFHTTPMessageSetBody(message, (__bridge CFDataRef)body);
+    }
+    return message;
+}
+
+- (void)handleRequest:(CFHTTPMessageRef)message {
+    HTTPServerRequest *request = [[HTTPServerRequest alloc] initWithRequest:message connection:self];
     if (!requests) {
         requests = [[NSMutableArray alloc] init];
     }
     [requests addObject:request];
     if (delegate && [delegate respondsToSelector:@selector(HTTPConnection:didReceiveRequest:)]) {
-        // Schedules the delegate to be executed later on the main thread. Cannot call the delegate
-        // directly as this method is called in a loop in order to process multiple messages, and
-        // the delegate may choose to stop and dealloc the listener – so we need queue the messages
-        // and process them separately.
+        // Schedules the delegate to be executed later on the delegate queue. Cannot call the
+        // delegate directly as this method is called in a loop in order to process multiple
+        // messages, and the delegate may choose to stop and dealloc the listener – so we need
+        // queue the messages and process them separately.
         id myDelegate = delegate;
-        dispatch_async(dispatch_get_main_queue(), ^() {
+        dispatch_async(delegateQueue ?: queue, ^() {
           [myDelegate HTTPConnection:self didReceiveRequest:request];
         });
     } else {
         [self performDefaultRequestHandling:request];
     }
+}
+
+// Reads requests only while the end of the stream was not reached and
+// the responses already written are not waiting for the peer to read
+// them, so that a peer that sends requests without reading the responses
+// cannot make the connection buffer them.
+- (void)updateReadSource {
+    BOOL blocked = 0 < [osegments count] || 0 < obuffer.length;
+    BOOL suspend = readClosed || blocked;
+    if (suspend && !readSuspended) {
+        dispatch_suspend(readSource);
+        readSuspended = YES;
+    } else if (!suspend && readSuspended) {
+        dispatch_resume(readSource);
+        readSuspended = NO;
+    }
+}
 
-    CFRelease(working);
-    return YES;
+// Responses may be set on any queue; they are written on the connection
+// queue.
+- (void)scheduleOutgoingBytes {
+    dispatch_async(queue, ^{
+      [self processOutgoingBytes];
+    });
 }
 
 - (void)processOutgoingBytes {
+    [self writeOutgoingBytes];
+    if (!isValid) {
+        return;
+    }
+
+    // A write source fires for as long as the socket has space, so it is
+    // resumed only while there are bytes to write.
+    HTTPServerRequest *req = [requests firstObject];
+    BOOL pending = 0 < [osegments count] || 0 < obuffer.length || (req && [req response]);
+    if (pending && writeSuspended) {
+        dispatch_resume(writeSource);
+        writeSuspended = NO;
+    } else if (!pending && !writeSuspended) {
+        dispatch_suspend(writeSource);
+        writeSuspended = YES;
+    }
+    [self updateReadSource];
+    [self updateDeadline];
+}
+
+- (void)writeOutgoingBytes {
     // The HTTP headers, then the body if any, then the response stream get
     // written out, in that order.  The Content-Length: header is assumed to
     // be properly set in the response.  Outgoing responses are processed in
     // the order the requests were received (required by HTTP).
 
-    // Write as many bytes as possible, from buffered bytes, response
-    // headers and body, and response stream.
+    // Write as many bytes as the socket accepts, from the response header
+    // and body, and response stream, then wait for the write source.
 
-    if (![ostream hasSpaceAvailable]) {
-        return;
-    }
+    while (isValid) {
+        HTTPServerRequest *req = [requests firstObject];
+        CFHTTPMessageRef cfresp = req ? [req response] : NULL;
+        if (!cfresp) return;
 
-    NSUInteger olen = [obuffer length];
-    if (0 < olen) {
-        NSInteger writ = [ostream write:[obuffer bytes] maxLength:olen];
-        // buffer any unwritten bytes for later writing
-        if (writ < olen) {
-            memmove([obuffer mutableBytes], [obuffer mutableBytes] + writ, olen - writ);
-            [obuffer setLength:olen - writ];
-            return;
+        if (!firstResponseDone) {
+            firstResponseDone = YES;
+            [self enqueueResponse:cfresp];
         }
-        [obuffer setLength:0];
-    }
 
-    NSUInteger cnt = requests ? [requests count] : 0;
-    HTTPServerRequest *req = (0 < cnt) ? [requests objectAtIndex:0] : nil;
+        NSInputStream *respStream = [req responseBodyStream];
+        if (respStream && 0 == [osegments count]) {
+            [self readResponseStream:respStream];
+        }
 
-    CFHTTPMessageRef cfresp = req ? [req response] : NULL;
-    if (!cfresp) return;
+        if (0 == [osegments count] && 0 == obuffer.length) {
+            // When we get to this point with nothing left to write, then
+            // the processing of the response is done. If the end of the
+            // input stream was reached, then no more requests are coming in.
+            id myDelegate = delegate;
+            if (myDelegate && [myDelegate respondsToSelector:@selector(HTTPConnection:didSendResponse:)]) {
+                dispatch_async(delegateQueue ?: queue, ^() {
+                  [myDelegate HTTPConnection:self didSendResponse:req];
+                });
+            }
+            [requests removeObjectAtIndex:0];
+            firstResponseDone = NO;
+            // Holds no output buffers while idle.
+            osegments = nil;
+            OKTRingBufferRelease(&obuffer);
+            if (MessageClosesConnection(cfresp) || (readClosed && [requests count] == 0)) {
+                [self invalidate];
+            }
+            continue;
+        }
 
-    if (!obuffer) {
-        obuffer = [[NSMutableData alloc] init];
+        if (![self writeQueuedBytes]) {
+            return;
+        }
     }
+}
 
-    if (!firstResponseDone) {
-        firstResponseDone = YES;
-        NSData *serialized = (__bridge_transfer NSData *)CFHTTPMessageCopySerializedMessage(cfresp);
-        NSUInteger olen = [serialized length];
-        if (0 < olen) {
-            NSInteger writ = [ostream write:[serialized bytes] maxLength:olen];
-            if (writ < olen) {
-                // buffer any unwritten bytes for later writing
-                [obuffer setLength:(olen - writ)];
-                memmove([obuffer mutableBytes], [serialized bytes] + writ, olen - writ);
-                return;
-            }
-        }
+// Queues the serialized header and the body of the response. The body
+// is not copied: the message body is written as it is.
+- (void)enqueueResponse:(CFHTTPMessageRef)response {
+    NSData *body = (__bridge_transfer NSData *)CFHTTPMessageCopyBody(response);
+    CFHTTPMessageRef header = CFHTTPMessageCreateCopy(kCFAllocatorDefault, response);
+    CFHTTPMessageSetBody(header, (__bridge CFDataRef)[NSData data]);
+    NSData *serializedHeader = (__bridge_transfer NSData *)CFHTTPMessageCopySerializedMessage(header);
+    CFRelease(header);
+
+    if (!osegments) {
+        osegments = [[NSMutableArray alloc] init];
+    }
+    if (0 < [serializedHeader length]) {
+        [osegments addObject:serializedHeader];
     }
+    if (0 < [body length]) {
+        [osegments addObject:body];
+    }
+    osegmentOffset = 0;
+}
 
-    NSInputStream *respStream = [req responseBodyStream];
-    if (respStream) {
-        if ([respStream streamStatus] == NSStreamStatusNotOpen) {
-            [respStream open];
-        }
-        // read some bytes from the stream into our local buffer
-        [obuffer setLength:16 * 1024];
-        NSInteger read = [respStream read:[obuffer mutableBytes] maxLength:[obuffer length]];
-        [obuffer setLength:read];
-    }
-
-    if (0 == [obuffer length]) {
-        // When we get to this point with an empty buffer, then the
-        // processing of the response is done. If the input stream
-        // is closed or at EOF, then no more requests are coming in.
-        if (delegate && [delegate respondsToSelector:@selector(HTTPConnection:didSendResponse:)]) {
-            [delegate HTTPConnection:self didSendResponse:req];
+// Reads the response stream into the free space of the ring buffer.
+- (void)readResponseStream:(NSInputStream *)respStream {
+    if ([respStream streamStatus] == NSStreamStatusNotOpen) {
+        [respStream open];
+    }
+    struct iovec regions[2];
+    int count = OKTRingBufferWritableRegions(&obuffer, regions);
+    for (int i = 0; i < count; i++) {
+        NSInteger read = [respStream read:regions[i].iov_base maxLength:regions[i].iov_len];
+        if (read <= 0) {
+            break;
         }
-        [requests removeObjectAtIndex:0];
-        firstResponseDone = NO;
-        if ([istream streamStatus] == NSStreamStatusAtEnd && [requests count] == 0) {
-            [self invalidate];
+        OKTRingBufferCommit(&obuffer, read);
+        if ((size_t)read < regions[i].iov_len) {
+            break;
         }
-        return;
     }
+}
 
-    olen = [obuffer length];
-    if (0 < olen) {
-        NSInteger writ = [ostream write:[obuffer bytes] maxLength:olen];
-        // buffer any unwritten bytes for later writing
-        if (writ < olen) {
-            memmove([obuffer mutableBytes], [obuffer mutableBytes] + writ, olen - writ);
+// Writes the queued segments and the ring buffer contents with a single
+// writev call, and drops the bytes written. Returns NO when the socket
+// did not accept all of them; closes the connection when the peer can no
+// longer receive them.
+- (BOOL)writeQueuedBytes {
+    struct iovec buffers[kMaxOutgoingBuffers];
+    int count = 0;
+    size_t total = 0;
+    for (NSData *segment in osegments) {
+        if (count == kMaxOutgoingBuffers - 2) {
+            break;
         }
-        [obuffer setLength:olen - writ];
+        NSUInteger offset = (0 == count) ? osegmentOffset : 0;
+        buffers[count].iov_base = (uint8_t *)[segment bytes] + offset;
+        buffers[count].iov_len = [segment length] - offset;
+        total += buffers[count].iov_len;
+        count++;
     }
-}
+    int streamCount = OKTRingBufferReadableRegions(&obuffer, buffers + count);
+    for (int i = count; i < count + streamCount; i++) {
+        total += buffers[i].iov_len;
+    }
+    count += streamCount;
 
-- (void)stream:(NSStream *)stream handleEvent:(NSStreamEvent)streamEvent {
-    switch(streamEvent) {
-    case NSStreamEventHasBytesAvailable:;
-        uint8_t buf[16 * 1024];
-        uint8_t *buffer = NULL;
-        NSUInteger len = 0;
-        if (![istream getBuffer:&buffer length:&len]) {
-            NSInteger amount = [istream read:buf maxLength:sizeof(buf)];
-            buffer = buf;
-            len = amount;
-        }
-        if (0 < len) {
-            if (!ibuffer) {
-                ibuffer = [[NSMutableData alloc] init];
-            }
-            [ibuffer appendBytes:buffer length:len];
-        }
-        do {} while ([self processIncomingBytes]);
-        break;
-    case NSStreamEventHasSpaceAvailable:;
-        [self processOutgoingBytes];
-        break;
-    case NSStreamEventEndEncountered:;
-        [self processIncomingBytes];
-        if (stream == ostream) {
-            // When the output stream is closed, no more writing will succeed and
-            // will abandon the processing of any pending requests and further
-            // incoming bytes.
+    ssize_t writ = OKTLoopbackSocketWrite(socketFD, buffers, count);
+    if (writ < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
             [self invalidate];
         }
-        break;
-    case NSStreamEventErrorOccurred:;
-        NSLog(@"HTTPServer stream error: %@", [stream streamError]);
-        break;
-    default:
-        break;
+        return NO;
     }
+
+    size_t remaining = writ;
+    while (0 < remaining && 0 < [osegments count]) {
+        size_t available = [osegments[0] length] - osegmentOffset;
+        if (remaining < available) {
+            osegmentOffset += remaining;
+            return NO;
+        }
+        remaining -= available;
+        [osegments removeObjectAtIndex:0];
+        osegmentOffset = 0;
+    }
+    OKTRingBufferConsume(&obuffer, remaining);
+    return (size_t)writ == total;
 }
 
 - (void)performDefaultRequestHandling:(HTTPServerRequest *)mess {
@@ -364,17 +782,22 @@
 }
 
 - (CFHTTPMessageRef)response {
-    return response;
+    @synchronized(self) {
+        return response;
+    }
 }
 
 - (void)setResponse:(CFHTTPMessageRef)value {
-    if (value != response) {
-        if (response) CFRelease(response);
-        response = (CFHTTPMessageRef)CFRetain(value);
-        if (response) {
-            // check to see if the response can now be sent out
-            [connection processOutgoingBytes];
+    @synchronized(self) {
+        if (value == response) {
+            return;
         }
+        if (response) CFRelease(response);
+        response = value ? (CFHTTPMessageRef)CFRetain(value) : NULL;
+    }
+    if (value) {
+        // check to see if the response can now be sent out
+        [connection scheduleOutgoingBytes];
     }
 }
 
@@ -395,6 +818,7 @@ NSString * const TCPServerErrorDomain = @"TCPServerErrorDomain";
 @implementation TCPServer
 
 - (id)init {
+    queue = LoopbackQueueCreate();
     return self;
 }
 
@@ -402,6 +826,10 @@ NSString * const TCPServerErrorDomain = @"TCPServerErrorDomain";
     [self stop];
 }
 
+- (dispatch_queue_t)queue {
+    return queue;
+}
+
 - (id)delegate {
     return delegate;
 }
@@ -448,125 +876,97 @@ NSString * const TCPServerErrorDomain = @"TCPServerErrorDomain";
     port = value;
 }
 
-- (void)handleNewConnectionFromAddress:(NSData *)addr inputStream:(NSInputStream *)istr outputStream:(NSOutputStream *)ostr {
+- (NSRange)fallbackPorts {
+    return fallbackPorts;
+}
+
+- (void)setFallbackPorts:(NSRange)value {
+    fallbackPorts = value;
+}
+
+- (void)handleNewConnectionFromAddress:(NSData *)addr socket:(int)fd {
     // if the delegate implements the delegate method, call it
-    if (delegate && [(NSObject*)delegate respondsToSelector:@selector(TCPServer:didReceiveConnectionFromAddress:inputStream:outputStream:)]) {
-        [delegate TCPServer:self didReceiveConnectionFromAddress:addr inputStream:istr outputStream:ostr];
-    }
-}
-
-// This function is called by CFSocket when a new connection comes in.
-// We gather some data here, and convert the function call to a method
-// invocation on TCPServer.
-static void TCPServerAcceptCallBack(CFSocketRef socket, CFSocketCallBackType type, CFDataRef address, const void *data, void *info) {
-    TCPServer *server = (__bridge TCPServer *)info;
-    if (kCFSocketAcceptCallBack == type) {
-        // for an AcceptCallBack, the data parameter is a pointer to a CFSocketNativeHandle
-        CFSocketNativeHandle nativeSocketHandle = *(CFSocketNativeHandle *)data;
-        uint8_t name[SOCK_MAXADDRLEN];
-        socklen_t namelen = sizeof(name);
-        NSData *peer = nil;
-        if (0 == getpeername(nativeSocketHandle, (struct sockaddr *)name, &namelen)) {
-            peer = [NSData dataWithBytes:name length:namelen];
+    if (delegate && [(NSObject*)delegate respondsToSelector:@selector(TCPServer:didReceiveConnectionFromAddress:socket:)]) {
+        [delegate TCPServer:self didReceiveConnectionFromAddress:addr socket:fd];
+    } else {
+        close(fd);
+    }
+}
+
+// This function is called on the server queue when connections are
+// pending on a listening socket. We accept them all and convert each
+// one to a method invocation on TCPServer.
+static void TCPServerAcceptConnections(TCPServer *server, int listener) {
+    for (;;) {
+        struct sockaddr_storage address;
+        socklen_t addressLength = 0;
+        int fd = OKTLoopbackSocketAccept(listener, &address, &addressLength);
+        if (fd < 0) {
+            if (errno == ECONNABORTED) {
+                continue;
+            }
+            return;
         }
-        CFReadStreamRef readStream = NULL;
-	CFWriteStreamRef writeStream = NULL;
-        CFStreamCreatePairWithSocket(kCFAllocatorDefault, nativeSocketHandle, &readStream, &writeStream);
-        if (readStream && writeStream) {
-            CFReadStreamSetProperty(readStream, kCFStreamPropertyShouldCloseNativeSocket, kCFBooleanTrue);
-            CFWriteStreamSetProperty(writeStream, kCFStreamPropertyShouldCloseNativeSocket, kCFBooleanTrue);
-            [server handleNewConnectionFromAddress:peer inputStream:(__bridge NSInputStream *)readStream outputStream:(__bridge NSOutputStream *)writeStream];
-        } else {
-            // on any failure, need to destroy the CFSocketNativeHandle
-            // since we are not going to use it any more
-            close(nativeSocketHandle);
+        if (!server) {
+            close(fd);
+            continue;
         }
-        if (readStream) CFRelease(readStream);
-        if (writeStream) CFRelease(writeStream);
+        NSData *peer = [NSData dataWithBytes:&address length:addressLength];
+        [server handleNewConnectionFromAddress:peer socket:fd];
     }
 }
 
-- (BOOL)start:(NSError **)error {
-    CFSocketContext socketCtxt = {0, (__bridge void *)(self), NULL, NULL, NULL};
-    ipv4socket = CFSocketCreate(kCFAllocatorDefault, PF_INET, SOCK_STREAM, IPPROTO_TCP, kCFSocketAcceptCallBack, (CFSocketCallBack)&TCPServerAcceptCallBack, &socketCtxt);
-    ipv6socket = CFSocketCreate(kCFAllocatorDefault, PF_INET6, SOCK_STREAM, IPPROTO_TCP, kCFSocketAcceptCallBack, (CFSocketCallBack)&TCPServerAcceptCallBack, &socketCtxt);
-
-    if (NULL == ipv4socket || NULL == ipv6socket) {
-        if (error) *error = [[NSError alloc] initWithDomain:TCPServerErrorDomain code:kTCPServerNoSocketsAvailable userInfo:nil];
-        if (ipv4socket) CFRelease(ipv4socket);
-        if (ipv6socket) CFRelease(ipv6socket);
-        ipv4socket = NULL;
-        ipv6socket = NULL;
-        return NO;
+// Services the listening socket on the server queue, and closes it when
+// the source is cancelled.
+- (dispatch_source_t)acceptSourceForListener:(int)listener {
+    dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, listener, 0, queue);
+    if (!source) {
+        close(listener);
+        return nil;
     }
+    __weak TCPServer *weakSelf = self;
+    dispatch_source_set_event_handler(source, ^{
+      TCPServerAcceptConnections(weakSelf, listener);
+    });
+    dispatch_source_set_cancel_handler(source, ^{
+      close(listener);
+    });
+    dispatch_resume(source);
+    return source;
+}
 
-    int yes = 1;
-    setsockopt(CFSocketGetNative(ipv4socket), SOL_SOCKET, SO_REUSEADDR, (void *)&yes, sizeof(yes));
-    setsockopt(CFSocketGetNative(ipv6socket), SOL_SOCKET, SO_REUSEADDR, (void *)&yes, sizeof(yes));
-
-    // set up the IPv4 endpoint; if port is 0, this will cause the kernel to choose a port for us
-    struct sockaddr_in addr4;
-    memset(&addr4, 0, sizeof(addr4));
-    addr4.sin_len = sizeof(addr4);
-    addr4.sin_family = AF_INET;
-    addr4.sin_port = htons(port);
-    addr4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
-    NSData *address4 = [NSData dataWithBytes:&addr4 length:sizeof(addr4)];
-
-    if (kCFSocketSuccess == CFSocketSetAddress(ipv4socket, (CFDataRef)address4)) {
-        if (0 == port) {
-            // now that the binding was successful, we get the port number
-            // -- we will need it for the v6 endpoint and for the NSNetService
-            NSData *addr = (__bridge_transfer NSData *)CFSocketCopyAddress(ipv4socket);
-            memcpy(&addr4, [addr bytes], [addr length]);
-            port = ntohs(addr4.sin_port);
-        }
-    } else {
-        if (ipv4socket) CFRelease(ipv4socket);
-        ipv4socket = NULL;
-    }
-
-    // set up the IPv6 endpoint
-    struct sockaddr_in6 addr6;
-    memset(&addr6, 0, sizeof(addr6));
-    addr6.sin6_len = sizeof(addr6);
-    addr6.sin6_family = AF_INET6;
-    addr6.sin6_port = htons(port);
-    memcpy(&(addr6.sin6_addr), &in6addr_loopback, sizeof(addr6.sin6_addr));
-    NSData *address6 = [NSData dataWithBytes:&addr6 length:sizeof(addr6)];
-
-    if (kCFSocketSuccess == CFSocketSetAddress(ipv6socket, (CFDataRef)address6)) {
-        if (0 == port) {
-            // In this case the IPv4 socket failed to bind but the IPv6 socket succeeded
-            // Get the port number of the IPv6 socket
-            NSData *addr = (__bridge_transfer NSData *)CFSocketCopyAddress(ipv6socket);
-            memcpy(&addr6, [addr bytes], [addr length]);
-            port = ntohs(addr6.sin6_port);
-        }
-    } else {
-        if (ipv6socket) CFRelease(ipv6socket);
-        ipv6socket = NULL;
+- (BOOL)start:(NSError **)error {
+    // set up the IPv4 and IPv6 endpoints on one port; if port is 0, the
+    // kernel chooses a port for us, and if it is in use, the fallback
+    // ports are tried in order
+    uint16_t boundPort = port;
+    uint16_t fallbackPort = (uint16_t)MIN(fallbackPorts.location, UINT16_MAX);
+    uint16_t fallbackCount = (uint16_t)MIN(fallbackPorts.length, UINT16_MAX);
+    int listeners[2];
+    if (OKTLoopbackSocketListenDualStack(listeners, &boundPort, fallbackPort, fallbackCount) == 0) {
+        // now that the binding was successful, we have the port number
+        // -- we will need it for the NSNetService
+        port = boundPort;
     }
+    int ipv4listener = listeners[0];
+    int ipv6listener = listeners[1];
 
-    if (!ipv4socket && !ipv6socket) {
+    if (ipv4listener < 0 && ipv6listener < 0) {
         // Couldn't bind an IPv4 or IPv6 socket, return an error
         if (error) *error = [[NSError alloc] initWithDomain:TCPServerErrorDomain code:kTCPServerCouldNotBindToIPv4Address userInfo:nil];
         return NO;
     }
 
-    // set up the run loop sources for the sockets
-    CFRunLoopRef cfrl = CFRunLoopGetCurrent();
-
-    if (ipv4socket) {
-        CFRunLoopSourceRef source4 = CFSocketCreateRunLoopSource(kCFAllocatorDefault, ipv4socket, 0);
-        CFRunLoopAddSource(cfrl, source4, kCFRunLoopCommonModes);
-        CFRelease(source4);
+    // the sockets are serviced on the server queue rather than on a run loop
+    if (0 <= ipv4listener) {
+        ipv4source = [self acceptSourceForListener:ipv4listener];
     }
-
-    if (ipv6socket) {
-        CFRunLoopSourceRef source6 = CFSocketCreateRunLoopSource(kCFAllocatorDefault, ipv6socket, 0);
-        CFRunLoopAddSource(cfrl, source6, kCFRunLoopCommonModes);
-        CFRelease(source6);
+    if (0 <= ipv6listener) {
+        ipv6source = [self acceptSourceForListener:ipv6listener];
+    }
+    if (!ipv4source && !ipv6source) {
+        if (error) *error = [[NSError alloc] initWithDomain:TCPServerErrorDomain code:kTCPServerNoSocketsAvailable userInfo:nil];
+        return NO;
     }
 
     // we can only publish the service if we have a type to publish with
@@ -591,29 +991,26 @@ static void TCPServerAcceptCallBack(CFSocketRef socket, CFSocketCallBackType typ
 - (BOOL)stop {
     [netService stop];
     netService = nil;
-    if (ipv4socket) {
-      CFSocketInvalidate(ipv4socket);
-      CFRelease(ipv4socket);
-      ipv4socket = NULL;
+    // cancelling the sources closes the listening sockets
+    if (ipv4source) {
+      dispatch_source_cancel(ipv4source);
+      ipv4source = nil;
     }
-    if (ipv6socket) {
-      CFSocketInvalidate(ipv6socket);
-      CFRelease(ipv6socket);
-      ipv6socket = NULL;
+    if (ipv6source) {
+      dispatch_source_cancel(ipv6source);
+      ipv6source = nil;
     }
     return YES;
 }
 
 - (BOOL)hasIPv4Socket {
-    return ipv4socket != nil;
+    return ipv4source != nil;
 }
 
 - (BOOL)hasIPv6Socket {
-    return ipv6socket != nil;
+    return ipv6source != nil;
 }
 
 @end
 
-#pragma GCC diagnostic pop
-
 #endif
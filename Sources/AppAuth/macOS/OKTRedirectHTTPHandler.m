@@ -26,6 +26,7 @@
 #import "OKTErrorUtilities.h"
 #import "OKTExternalUserAgentSession.h"
 #import "OKTLoopbackHTTPServer.h"
+#import "OKTRedirectRouter.h"
 
 /*! @brief Page that is returned following a completed authorization. Show your own page instead by
         supplying a URL in @c initWithSuccessURL that the user will be redirected to.
@@ -51,9 +52,14 @@ static NSString *const kHTMLErrorMissingCurrentAuthorizationFlow =
 static NSString *const kHTMLErrorRedirectNotValid =
     @"<html><body>AppAuth Error: Not a valid redirect.</body></html>";
 
+/*! @brief The port used by @c startHTTPListener:error:.
+ */
+static const uint16_t kDefaultLoopbackPort = 63875;
+
 @implementation OKTRedirectHTTPHandler {
   HTTPServer *_httpServ;
   NSURL *_successURL;
+  BOOL _persistent;
 }
 
 - (instancetype)init {
@@ -69,21 +75,68 @@ static NSString *const kHTMLErrorRedirectNotValid =
 }
 
 - (NSURL *)startHTTPListener:(NSString *)domain withPort:(uint16_t)port error:(NSError **)returnError  {
+  return [self startHTTPListener:domain withPort:port fallbackPorts:NSMakeRange(0, 0) error:returnError];
+}
+
+- (NSURL *)startHTTPListener:(NSString *)domain
+                    withPort:(uint16_t)port
+               fallbackPorts:(NSRange)fallbackPorts
+                       error:(NSError **)returnError {
   // Cancels any pending requests.
   [self cancelHTTPListener];
+  return [self startServerWithDomain:domain port:port fallbackPorts:fallbackPorts error:returnError];
+}
+
+- (NSURL *)startPersistentHTTPListener:(NSString *)domain
+                              withPort:(uint16_t)port
+                         fallbackPorts:(NSRange)fallbackPorts
+                                 error:(NSError **)returnError {
+  if (_persistent && _httpServ) {
+    // The domain only names the loopback address in the URL, so flows already waiting on the
+    // listener are kept rather than cancelled by restarting it.
+    return [self baseURLWithDomain:domain];
+  }
+  [self cancelHTTPListener];
+
+  if (!_router) {
+    _router = [OKTRedirectRouter sharedRouter];
+  }
+  NSURL *listenerURL = [self startServerWithDomain:domain
+                                              port:port
+                                     fallbackPorts:fallbackPorts
+                                             error:returnError];
+  if (listenerURL) {
+    _persistent = YES;
+  }
+  return listenerURL;
+}
 
-  // Starts a HTTP server on the loopback interface.
-  // By not specifying a port, a random available one will be assigned.
+/*! @brief Starts a HTTP server on the loopback interface, and returns its base URL.
+    @param port The port to listen on. By not specifying a port, a random available one will be
+        assigned.
+ */
+- (nullable NSURL *)startServerWithDomain:(nullable NSString *)domain
+                                     port:(uint16_t)port
+                            fallbackPorts:(NSRange)fallbackPorts
+                                    error:(NSError **)returnError {
   _httpServ = [[HTTPServer alloc] init];
   [_httpServ setPort:port];
+  [_httpServ setFallbackPorts:fallbackPorts];
   [_httpServ setDelegate:self];
   NSError *error = nil;
   if (![_httpServ start:&error]) {
+    _httpServ = nil;
     if (returnError) {
       *returnError = error;
     }
     return nil;
-  } else if (domain.length > 0) {
+  }
+  _listenerURL = [self baseURLWithDomain:domain];
+  return _listenerURL;
+}
+
+- (nullable NSURL *)baseURLWithDomain:(nullable NSString *)domain {
+  if (domain.length > 0) {
       // Use provided domain name
       NSString *serverURL = [NSString stringWithFormat:@"http://%@:%d/", domain, [_httpServ port]];
       return [NSURL URLWithString:serverURL];
@@ -102,7 +155,7 @@ static NSString *const kHTMLErrorRedirectNotValid =
 
 - (NSURL *)startHTTPListener:(NSString *)domain error:(NSError **)returnError {
   // A port of 0 requests a random available port
-  return [self startHTTPListener:domain withPort:63875 error:returnError];
+  return [self startHTTPListener:domain withPort:kDefaultLoopbackPort error:returnError];
 }
 
 - (void)cancelHTTPListener {
@@ -125,6 +178,8 @@ static NSString *const kHTMLErrorRedirectNotValid =
   _httpServ.delegate = nil;
   [_httpServ stop];
   _httpServ = nil;
+  _listenerURL = nil;
+  _persistent = NO;
 }
 
 - (BOOL)isOptionsHTTPServerRequest:(HTTPServerRequest *)request {
@@ -174,15 +229,21 @@ static NSString *const kHTMLErrorRedirectNotValid =
   }
 
   BOOL handled = NO;
+  BOOL routed = !_currentAuthorizationFlow && _router;
   // Sends URL to AppAuth.
   CFURLRef url = CFHTTPMessageCopyRequestURL(mess.request);
   if (url != nil) {
-    handled = [_currentAuthorizationFlow resumeExternalUserAgentFlowWithURL:(__bridge NSURL *)url];
+    if (routed) {
+      handled = [_router resumeExternalUserAgentFlowWithURL:(__bridge NSURL *)url];
+    } else {
+      handled = [_currentAuthorizationFlow resumeExternalUserAgentFlowWithURL:(__bridge NSURL *)url];
+    }
     CFRelease(url);
   }
 
-  // Stops listening to further requests after the first valid authorization response.
-  if (handled) {
+  // Stops listening to further requests after the first valid authorization response, unless the
+  // listener serves the flows of a router.
+  if (handled && !routed) {
     _currentAuthorizationFlow = nil;
     [self stopHTTPListener];
   }
@@ -192,7 +253,7 @@ static NSString *const kHTMLErrorRedirectNotValid =
   NSInteger httpResponseCode = (_successURL) ? 302 : 200;
   // Returns an error page if a URL other than the expected redirect is requested.
   if (!handled) {
-    if (_currentAuthorizationFlow) {
+    if (_currentAuthorizationFlow || routed) {
       bodyText = kHTMLErrorRedirectNotValid;
       httpResponseCode = 404;
     } else {
@@ -216,6 +277,12 @@ static NSString *const kHTMLErrorRedirectNotValid =
                                    (__bridge CFStringRef)[NSString stringWithFormat:@"%lu",
                                        (unsigned long)data.length]);
   CFHTTPMessageSetBody(response, (__bridge CFDataRef)data);
+  // Closes the connection once the response to the redirect is sent; the listener is done.
+  if (handled) {
+    CFHTTPMessageSetHeaderFieldValue(response,
+                                     (__bridge CFStringRef)@"Connection",
+                                     (__bridge CFStringRef)@"close");
+  }
 
   [mess setResponse:response];
   CFRelease(response);
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#include "OKTBenchmarkAllocations.h"
+
+#include <stdatomic.h>
+
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#endif
+
+static _Atomic uint64_t OKTBenchmarkAllocations = 0;
+
+#ifdef __APPLE__
+
+#define OKT_MALLOC_LOG_TYPE_ALLOCATE 2
+
+/*! @brief The hook libmalloc calls on every allocation and deallocation while it is set. Declared
+        by libmalloc, which uses it for stack logging.
+ */
+typedef void(malloc_logger_t)(uint32_t type,
+                              uintptr_t arg1,
+                              uintptr_t arg2,
+                              uintptr_t arg3,
+                              uintptr_t result,
+                              uint32_t num_hot_frames_to_skip);
+extern malloc_logger_t *malloc_logger;
+
+static void OKTBenchmarkMallocLogger(uint32_t type,
+                                     uintptr_t arg1,
+                                     uintptr_t arg2,
+                                     uintptr_t arg3,
+                                     uintptr_t result,
+                                     uint32_t num_hot_frames_to_skip) {
+  (void)arg1;
+  (void)arg2;
+  (void)arg3;
+  (void)result;
+  (void)num_hot_frames_to_skip;
+  if (type & OKT_MALLOC_LOG_TYPE_ALLOCATE) {
+    atomic_fetch_add_explicit(&OKTBenchmarkAllocations, 1, memory_order_relaxed);
+  }
+}
+
+bool OKTBenchmarkAllocationsStart(void) {
+  // Another logger, such as MallocStackLogging, is left in place.
+  if (malloc_logger && malloc_logger != OKTBenchmarkMallocLogger) {
+    return false;
+  }
+  malloc_logger = OKTBenchmarkMallocLogger;
+  return true;
+}
+
+uint64_t OKTBenchmarkHeapBytesInUse(void) {
+  malloc_statistics_t statistics;
+  malloc_zone_statistics(NULL, &statistics);
+  return statistics.size_in_use;
+}
+
+#else
+
+bool OKTBenchmarkAllocationsStart(void) {
+  return false;
+}
+
+uint64_t OKTBenchmarkHeapBytesInUse(void) {
+  return 0;
+}
+
+#endif
+
+uint64_t OKTBenchmarkAllocationCount(void) {
+  return atomic_load_explicit(&OKTBenchmarkAllocations, memory_order_relaxed);
+}
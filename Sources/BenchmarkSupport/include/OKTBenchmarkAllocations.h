@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#ifndef OKTBenchmarkAllocations_h
+#define OKTBenchmarkAllocations_h
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Starts counting heap allocations made by any thread of the process.
+    @return false if allocations cannot be counted on this platform.
+    @discussion On Apple platforms the count comes from the malloc logger hook that malloc calls for
+        every allocation, so no allocator is replaced. Allocations are counted until the process
+        exits; calling this again has no effect.
+ */
+bool OKTBenchmarkAllocationsStart(void);
+
+/*! @brief The number of allocations since counting started. A @c realloc counts as one.
+ */
+uint64_t OKTBenchmarkAllocationCount(void);
+
+/*! @brief The number of heap bytes currently allocated by the process, or 0 if unknown.
+    @discussion On Apple platforms this sums the bytes in use of every malloc zone.
+ */
+uint64_t OKTBenchmarkHeapBytesInUse(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OKTBenchmarkAllocations_h */
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+import BenchmarkSupport
+import Foundation
+
+/// A named operation measured in isolation. `run` performs the operation once.
+struct Benchmark {
+    let name: String
+    let run: () -> Void
+}
+
+struct BenchmarkResult: Encodable {
+    let name: String
+    let iterations: Int
+    let nsPerOp: Double
+    let allocsPerOp: Double?
+
+    enum CodingKeys: String, CodingKey {
+        case name
+        case iterations
+        case nsPerOp = "ns_per_op"
+        case allocsPerOp = "allocs_per_op"
+    }
+}
+
+struct BenchmarkReport: Encodable {
+    let date: String
+    let platform: String
+    let benchmarks: [BenchmarkResult]
+    let sessionFootprints: [SessionFootprint]
+
+    enum CodingKeys: String, CodingKey {
+        case date
+        case platform
+        case benchmarks
+        case sessionFootprints = "session_footprints"
+    }
+}
+
+/// Runs benchmarks in batches sized to take at least `minimumSampleTime`, and reports the median
+/// time per operation of `sampleCount` batches. Allocations are counted over one extra batch.
+final class BenchmarkRunner {
+
+    var minimumSampleTime: TimeInterval = 0.1
+    var sampleCount = 5
+
+    private let countsAllocations = OKTBenchmarkAllocationsStart()
+
+    func run(_ benchmark: Benchmark) -> BenchmarkResult {
+        // The doubling batches also warm up caches and lazily initialized state.
+        var iterations = 1
+        let minimumNanoseconds = UInt64(minimumSampleTime * 1_000_000_000)
+        while measure(benchmark, iterations: iterations) < minimumNanoseconds && iterations < 1 << 24 {
+            iterations *= 2
+        }
+
+        let samples = (0 ..< sampleCount).map { _ in
+            Double(measure(benchmark, iterations: iterations)) / Double(iterations)
+        }.sorted()
+
+        var allocsPerOp: Double?
+        if countsAllocations {
+            let start = OKTBenchmarkAllocationCount()
+            _ = measure(benchmark, iterations: iterations)
+            allocsPerOp = Double(OKTBenchmarkAllocationCount() - start) / Double(iterations)
+        }
+
+        return BenchmarkResult(name: benchmark.name,
+                               iterations: iterations,
+                               nsPerOp: samples[samples.count / 2],
+                               allocsPerOp: allocsPerOp)
+    }
+
+    /// Returns the duration of a batch in nanoseconds. Objects autoreleased by the batch are
+    /// released within it, so that their cost is included.
+    private func measure(_ benchmark: Benchmark, iterations: Int) -> UInt64 {
+        return autoreleasepool {
+            let start = DispatchTime.now().uptimeNanoseconds
+            for _ in 0 ..< iterations {
+                benchmark.run()
+            }
+            return DispatchTime.now().uptimeNanoseconds - start
+        }
+    }
+}
+
+/// Keeps the compiler from optimizing away a result that is otherwise unused.
+@inline(never)
+func blackHole<T>(_ value: T) {
+    withExtendedLifetime(value) {}
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+
+import BenchmarkSupport
+import Foundation
+import OktaOidc_AppAuth
+
+struct SessionFootprint: Encodable {
+    let name: String
+    let sessions: Int
+    let compact: Bool
+    let heapBytesPerSession: Double?
+    let archivedBytesPerSession: Double
+
+    enum CodingKeys: String, CodingKey {
+        case name
+        case sessions
+        case compact
+        case heapBytesPerSession = "heap_bytes_per_session"
+        case archivedBytesPerSession = "archived_bytes_per_session"
+    }
+}
+
+/// Measures the heap and keychain footprint of signed-in sessions, with and without
+/// `OKTAuthState.compactsResponses`. Every session has its own tokens, code, state and PKCE values
+/// and a configuration parsed from its own copy of the discovery document, as sessions restored or
+/// signed in one at a time do.
+enum SessionFootprintBenchmarks {
+
+    static let sessionCounts = [1, 100, 10_000]
+
+    static var all: [(name: String, sessions: Int, compact: Bool)] {
+        return [false, true].flatMap { compact in
+            sessionCounts.map { sessions in
+                (name: "SessionFootprint.\(compact ? "compact" : "full").\(sessions)", sessions: sessions, compact: compact)
+            }
+        }
+    }
+
+    static func measure(name: String, sessions: Int, compact: Bool) -> SessionFootprint {
+        let discoveryData = try! JSONSerialization.data(withJSONObject: AppAuthBenchmarks.makeDiscoveryDocument())
+
+        return autoreleasepool {
+            let heapBytesBefore = OKTBenchmarkHeapBytesInUse()
+            let authStates = (0 ..< sessions).map { index -> OKTAuthState in
+                let authState = makeAuthState(index: index, discoveryData: discoveryData)
+                authState.compactsResponses = compact
+                return authState
+            }
+            let heapBytesAfter = OKTBenchmarkHeapBytesInUse()
+
+            let archivedBytes = authStates.reduce(0) { total, authState in
+                total + (try! NSKeyedArchiver.archivedData(withRootObject: authState, requiringSecureCoding: true)).count
+            }
+
+            var heapBytesPerSession: Double?
+            if heapBytesBefore > 0 {
+                heapBytesPerSession = Double(Int64(heapBytesAfter) - Int64(heapBytesBefore)) / Double(sessions)
+            }
+            return SessionFootprint(name: name,
+                                    sessions: sessions,
+                                    compact: compact,
+                                    heapBytesPerSession: heapBytesPerSession,
+                                    archivedBytesPerSession: Double(archivedBytes) / Double(sessions))
+        }
+    }
+
+    private static func makeAuthState(index: Int, discoveryData: Data) -> OKTAuthState {
+        let discovery = try! OKTServiceDiscovery(jsonData: discoveryData)
+        let configuration = OKTServiceConfiguration(discoveryDocument: discovery)
+        let random = { OKTTokenUtilities.randomURLSafeString(withSize: 32)! }
+        let codeVerifier = random()
+
+        let authorizationRequest = OKTAuthorizationRequest(configuration: configuration,
+                                                           clientId: AppAuthBenchmarks.clientID,
+                                                           clientSecret: nil,
+                                                           scope: "openid profile offline_access",
+                                                           redirectURL: AppAuthBenchmarks.redirectURL,
+                                                           responseType: OKTResponseTypeCode,
+                                                           state: random(),
+                                                           nonce: random(),
+                                                           codeVerifier: codeVerifier,
+                                                           codeChallenge: OKTAuthorizationRequest.codeChallengeS256(forVerifier: codeVerifier),
+                                                           codeChallengeMethod: OKTOAuthorizationRequestCodeChallengeMethodS256,
+                                                           additionalParameters: ["device_id": "\(index)"])
+        let code = random()
+        let authorizationResponse = OKTAuthorizationResponse(request: authorizationRequest,
+                                                             parameters: ["code": code as NSString,
+                                                                          "state": authorizationRequest.state! as NSString])
+        let tokenRequest = OKTTokenRequest(configuration: configuration,
+                                           grantType: OKTGrantTypeAuthorizationCode,
+                                           authorizationCode: code,
+                                           redirectURL: AppAuthBenchmarks.redirectURL,
+                                           clientID: AppAuthBenchmarks.clientID,
+                                           clientSecret: nil,
+                                           scope: "openid profile offline_access",
+                                           refreshToken: nil,
+                                           codeVerifier: codeVerifier,
+                                           additionalParameters: ["device_id": "\(index)"])
+        var tokenParameters = AppAuthBenchmarks.makeTokenParameters()
+        tokenParameters["access_token"] = "eyJraWQiOiJ2S2h4In0.\(random()).\(random())" as NSString
+        tokenParameters["refresh_token"] = random() as NSString
+        tokenParameters["id_token"] = AppAuthBenchmarks.makeIDToken() as NSString
+        let tokenResponse = OKTTokenResponse(request: tokenRequest, parameters: tokenParameters)
+        return OKTAuthState(authorizationResponse: authorizationResponse, tokenResponse: tokenResponse)
+    }
+}
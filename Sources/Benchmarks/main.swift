@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+import Foundation
+
+// Usage: Benchmarks [--filter <substring>] [--min-time <seconds>] [--json] [--json-output <path>]
+
+var filter: String?
+var jsonOutputPath: String?
+var printsJSON = false
+let runner = BenchmarkRunner()
+
+var arguments = CommandLine.arguments.dropFirst().makeIterator()
+while let argument = arguments.next() {
+    switch argument {
+    case "--filter":
+        filter = arguments.next()
+    case "--min-time":
+        if let value = arguments.next().flatMap(TimeInterval.init) {
+            runner.minimumSampleTime = value
+        }
+    case "--json":
+        printsJSON = true
+    case "--json-output":
+        jsonOutputPath = arguments.next()
+    default:
+        FileHandle.standardError.write("Unknown argument: \(argument)\n".data(using: .utf8)!)
+        exit(EXIT_FAILURE)
+    }
+}
+
+var results: [BenchmarkResult] = []
+for benchmark in AppAuthBenchmarks.all where filter.map({ benchmark.name.contains($0) }) ?? true {
+    let result = runner.run(benchmark)
+    results.append(result)
+
+    if !printsJSON {
+        let nsPerOp = String(format: "%12.1f", result.nsPerOp)
+        let allocsPerOp = result.allocsPerOp.map { String(format: "%10.1f", $0) } ?? "       n/a"
+        print("\(benchmark.name.padding(toLength: 36, withPad: " ", startingAt: 0)) \(nsPerOp) ns/op \(allocsPerOp) allocs/op")
+    }
+}
+
+var sessionFootprints: [SessionFootprint] = []
+for footprint in SessionFootprintBenchmarks.all where filter.map({ footprint.name.contains($0) }) ?? true {
+    let result = SessionFootprintBenchmarks.measure(name: footprint.name, sessions: footprint.sessions, compact: footprint.compact)
+    sessionFootprints.append(result)
+
+    if !printsJSON {
+        let heapBytes = result.heapBytesPerSession.map { String(format: "%10.0f", $0) } ?? "       n/a"
+        let archivedBytes = String(format: "%10.0f", result.archivedBytesPerSession)
+        print("\(footprint.name.padding(toLength: 36, withPad: " ", startingAt: 0)) \(heapBytes) heap B/session \(archivedBytes) archived B/session")
+    }
+}
+
+let report = BenchmarkReport(date: ISO8601DateFormatter().string(from: Date()),
+                             platform: ProcessInfo.processInfo.operatingSystemVersionString,
+                             benchmarks: results,
+                             sessionFootprints: sessionFootprints)
+let encoder = JSONEncoder()
+encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+// swiftlint:disable:next force_try
+let json = try! encoder.encode(report)
+
+if printsJSON {
+    print(String(data: json, encoding: .utf8)!)
+}
+if let jsonOutputPath = jsonOutputPath {
+    do {
+        try json.write(to: URL(fileURLWithPath: jsonOutputPath))
+    } catch {
+        FileHandle.standardError.write("Failed to write \(jsonOutputPath): \(error)\n".data(using: .utf8)!)
+        exit(EXIT_FAILURE)
+    }
+}
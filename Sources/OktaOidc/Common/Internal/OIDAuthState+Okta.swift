@@ -20,7 +20,9 @@ extension OKTAuthState {
     static func getState(withAuthRequest authRequest: OKTAuthorizationRequest, delegate: OktaNetworkRequestCustomizationDelegate? = nil, validator: OKTTokenValidator, callback finalize: @escaping (OKTAuthState?, OktaOidcError?) -> Void ) {
         
         // Make authCode request
+        let authorizationSpan = OKTTracing.beginSpan(OKTTraceSpanSessionTokenAuthorization)
         OKTAuthorizationService.perform(authRequest: authRequest, delegate: delegate) { authResponse, error in
+            authorizationSpan?.end(error: error.map { $0 as NSError })
             guard let authResponse = authResponse else {
                 finalize(nil, .api(message: "Authorization Error: \(error?.localizedDescription ?? "No authentication response.")", underlyingError: error))
                 return
@@ -24,11 +24,12 @@ extension OKTAuthorizationService {
     ) {
         var urlRequest = URLRequest(url: authRequest.externalUserAgentRequestURL())
         urlRequest.httpMethod = "GET"
-        urlRequest.allHTTPHeaderFields = [
-            "Accept": "application/json",
-            "Content-Type": "application/x-www-form-urlencoded"
-        ]
-        let customizedRequest = delegate?.customizableURLRequest(urlRequest) ?? urlRequest
+        urlRequest.allHTTPHeaderFields = OktaOidcRequestHeaders.formPost
+        let customizedRequest = OKTNetworkMetricsCollector.shared().request(
+            delegate?.customizableURLRequest(urlRequest) ?? urlRequest,
+            taggedWithOperation: OKTNetworkOperationSessionTokenAuthorization,
+            delegate: delegate
+        )
 
         let session = OKTURLSessionProvider.session()
         session.dataTask(with: customizedRequest) { [weak delegate] (_, response, error) in
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#if SWIFT_PACKAGE
+import OktaOidc_AppAuth
+#endif
+
+// Okta Extension of OKTTracing
+extension OKTTracing {
+
+    /// Starts a span and returns `callback` wrapped to end it with the error the callback receives.
+    /// Returns `callback` itself when no tracer is installed.
+    static func traced<T>(_ name: String,
+                          attributes: () -> [String: String] = { [:] },
+                          callback: @escaping (T?, OktaOidcError?) -> Void) -> (T?, OktaOidcError?) -> Void {
+        guard let span = beginSpan(name) else {
+            return callback
+        }
+
+        attributes().forEach { span.setAttribute($0.value, forKey: $0.key) }
+        return { result, error in
+            span.end(error: error.map { $0 as NSError })
+            callback(result, error)
+        }
+    }
+}
@@ -46,6 +46,17 @@ enum OktaOidcEndpoint {
         }
     }
     
+    var networkOperation: String {
+        switch self {
+        case .introspection:
+            return OKTNetworkOperationIntrospect
+        case .revocation:
+            return OKTNetworkOperationRevoke
+        case .userInfo:
+            return OKTNetworkOperationUserInfo
+        }
+    }
+
     private var discoveryMetadataKey: String {
         switch self {
         case .introspection:
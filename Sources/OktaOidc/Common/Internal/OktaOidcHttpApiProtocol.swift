@@ -94,8 +94,7 @@ extension OktaOidcHttpApiProtocol {
                       body: Data? = nil) -> URLRequest {
         var request = URLRequest(url: url)
         request.httpMethod = method
-        request.allHTTPHeaderFields = headers ?? request.allHTTPHeaderFields
-        request.addValue(OktaUserAgent.userAgentHeaderValue(), forHTTPHeaderField: OktaUserAgent.userAgentHeaderKey())
+        request.allHTTPHeaderFields = OktaOidcRequestHeaders.current.fields(merging: headers)
 
         if let data = body {
             request.httpBody = data
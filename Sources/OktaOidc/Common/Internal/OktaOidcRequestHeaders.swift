@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+import Foundation
+
+#if SWIFT_PACKAGE
+import OktaOidc_AppAuth
+#endif
+
+/// Immutable set of headers sent with every REST request: the User-Agent plus any static custom headers.
+/// The current template is built once and rebuilt only when the User-Agent changes, so building a
+/// request is a single merge.
+final class OktaOidcRequestHeaders {
+
+    /// Headers of the form-encoded POST requests sent to the Okta endpoints.
+    static let formPost = [
+        "Accept": "application/json",
+        "Content-Type": "application/x-www-form-urlencoded"
+    ]
+
+    let userAgent: String
+    let fields: [String: String]
+
+    init(userAgent: String, customHeaders: [String: String] = [:]) {
+        self.userAgent = userAgent
+
+        var fields = customHeaders
+        fields[OktaUserAgent.userAgentHeaderKey()] = userAgent
+        self.fields = fields
+    }
+
+    /// Returns the template fields with `headers` applied on top.
+    func fields(merging headers: [String: String]?) -> [String: String] {
+        guard let headers = headers, !headers.isEmpty else {
+            return fields
+        }
+
+        return fields.merging(headers) { _, new in new }
+    }
+
+    /// The template for the current User-Agent.
+    static var current: OktaOidcRequestHeaders {
+        let userAgent = OktaUserAgent.userAgentHeaderValue()
+        lock.lock()
+        defer { lock.unlock() }
+
+        if let template = cachedTemplate, template.userAgent == userAgent {
+            return template
+        }
+
+        let template = OktaOidcRequestHeaders(userAgent: userAgent)
+        cachedTemplate = template
+        return template
+    }
+
+    private static let lock = NSLock()
+    private static var cachedTemplate: OktaOidcRequestHeaders?
+}
@@ -20,31 +20,64 @@ class OktaOidcRestApi: OktaOidcHttpApiProtocol {
     func fireRequest(_ request: URLRequest,
                      onSuccess: @escaping OktaApiSuccessCallback,
                      onError: @escaping OktaApiErrorCallback) {
-        let customizedRequest = requestCustomizationDelegate?.customizableURLRequest(request) ?? request
-        let task = OKTURLSessionProvider.session().dataTask(with: customizedRequest) { data, response, error in
+        // The customized request may be a new request, so the operation is carried over.
+        let customizedRequest = OKTNetworkMetricsCollector.shared().request(
+            requestCustomizationDelegate?.customizableURLRequest(request) ?? request,
+            taggedWithOperation: OKTNetworkMetricsCollector.operation(of: request),
+            delegate: requestCustomizationDelegate
+        )
+        let operation = OKTNetworkMetricsCollector.operation(of: customizedRequest) ?? OKTNetworkOperationOther
+        let startTime = CFAbsoluteTimeGetCurrent()
+        let completion: OktaOidcRequestCoalescer.Completion = { response, result in
+            OKTMetricsRegistry.shared().record(CFAbsoluteTimeGetCurrent() - startTime, for: operation)
             self.requestCustomizationDelegate?.didReceive(response)
+            DispatchQueue.main.async {
+                switch result {
+                case .success(let responseJson):
+                    onSuccess(responseJson)
+                case .failure(let error):
+                    onError(error)
+                }
+            }
+        }
+
+        let coalescer = OktaOidcRequestCoalescer.shared
+        guard coalescer.isEnabled else {
+            perform(customizedRequest, completion: completion)
+            return
+        }
+
+        let key = OktaOidcRequestCoalescer.Key(request: customizedRequest)
+        guard coalescer.register(completion, for: key) else {
+            return
+        }
+        perform(customizedRequest) { response, result in
+            coalescer.complete(key, response: response, result: result)
+        }
+    }
+
+    private func perform(_ request: URLRequest, completion: @escaping OktaOidcRequestCoalescer.Completion) {
+        let retryPolicy = OKTRetryPolicy.sharedPolicy()
+        let isIdempotent = OKTRetryPolicy.isIdempotentRequest(request)
+        retryPolicy.performDataTask(with: request,
+                                    session: OKTURLSessionProvider.session(),
+                                    idempotent: isIdempotent) { data, response, error in
             guard let data = data,
                   error == nil,
                   let httpResponse = response as? HTTPURLResponse else {
                 let errorMessage = error?.localizedDescription ?? "No response data"
-                DispatchQueue.main.async {
-                    onError(OktaOidcError.api(message: errorMessage, underlyingError: error))
-                }
+                completion(response, .failure(OktaOidcError.api(message: errorMessage, underlyingError: error)))
                 return
             }
 
             guard 200 ..< 300 ~= httpResponse.statusCode else {
-                DispatchQueue.main.async {
-                    onError(OktaOidcError.api(message: HTTPURLResponse.localizedString(forStatusCode: httpResponse.statusCode), underlyingError: nil))
-                }
+                completion(response, .failure(OktaOidcError.api(message: HTTPURLResponse.localizedString(forStatusCode: httpResponse.statusCode), underlyingError: nil)))
                 return
             }
 
-            let responseJson = (try? JSONSerialization.jsonObject(with: data, options: .mutableContainers)) as? [String: Any]
-            DispatchQueue.main.async {
-                onSuccess(responseJson)
-            }
+            // Parsed without mutable containers: coalesced callers share the same object.
+            let responseJson = (try? JSONSerialization.jsonObject(with: data, options: [])) as? [String: Any]
+            completion(response, .success(responseJson))
         }
-        task.resume()
     }
 }
@@ -22,15 +22,14 @@ class OktaOidcAuthenticateTask: OktaOidcTask {
                                       delegate: OktaNetworkRequestCustomizationDelegate? = nil,
                                       validator: OKTTokenValidator,
                                       callback: @escaping (OKTAuthState?, OktaOidcError?) -> Void) {
+        let callback = OKTTracing.traced(OKTTraceSpanSessionTokenSignIn, callback: callback)
         self.downloadOidcConfiguration() { oidConfig, error in
             guard let oidConfig = oidConfig else {
                 callback(nil, error)
                 return
             }
             
-            let codeVerifier = OKTAuthorizationRequest.generateCodeVerifier()
-            let codeChallenge = OKTAuthorizationRequest.codeChallengeS256(forVerifier: codeVerifier)
-            let state = OKTAuthorizationRequest.generateState()
+            let material = OKTAuthorizationMaterialPool.shared().takeMaterial()
             var additionalParameters = self.config.additionalParams ?? [String: String]()
             additionalParameters["sessionToken"] = sessionToken
             
@@ -41,10 +40,10 @@ class OktaOidcAuthenticateTask: OktaOidcTask {
                 scope: self.config.scopes,
                 redirectURL: self.config.redirectUri,
                 responseType: OKTResponseTypeCode,
-                state: state,
-                nonce: OKTAuthorizationRequest.generateState(),
-                codeVerifier: codeVerifier,
-                codeChallenge: codeChallenge,
+                state: material?.state,
+                nonce: material?.nonce,
+                codeVerifier: material?.codeVerifier,
+                codeChallenge: material?.codeChallenge,
                 codeChallengeMethod: OKTOAuthorizationRequestCodeChallengeMethodS256,
                 additionalParameters: additionalParameters
             )
@@ -23,6 +23,7 @@ class OktaOidcBrowserTask: OktaOidcTask {
     func signIn(delegate: OktaNetworkRequestCustomizationDelegate? = nil,
                 validator: OKTTokenValidator,
                 callback: @escaping ((OKTAuthState?, OktaOidcError?) -> Void)) {
+        let callback = OKTTracing.traced(OKTTraceSpanBrowserSignIn, callback: callback)
         self.downloadOidcConfiguration() { oidConfig, error in
             guard let oidConfiguration = oidConfig else {
                 callback(nil, error)
@@ -45,11 +46,13 @@ class OktaOidcBrowserTask: OktaOidcTask {
                 return
             }
 
+            var isFinished = false
             let userAgentSession = self.authStateClass().authState(byPresenting: request,
                                                                    externalUserAgent: externalUserAgent,
                                                                    delegate: delegate,
                                                                    validator: validator) { authorizationResponse, error in
-                defer { self.userAgentSession = nil }
+                isFinished = true
+                defer { self.finishUserAgentSession(state: request.state) }
 
                 if let authResponse = authorizationResponse {
                     callback(authResponse, nil)
@@ -73,7 +76,9 @@ class OktaOidcBrowserTask: OktaOidcTask {
                 
                 return callback(nil, OktaOidcError.api(message: "Authorization Error: \(error.localizedDescription)", underlyingError: error))
             }
-            self.userAgentSession = userAgentSession
+            if !isFinished {
+                self.startUserAgentSession(userAgentSession, state: request.state)
+            }
         }
     }
     
@@ -99,8 +104,10 @@ class OktaOidcBrowserTask: OktaOidcTask {
                 return
             }
             
-            let userAgentSession = self.authorizationServiceClass().present(request, externalUserAgent: externalUserAgent) { _, responseError in    
-                self.userAgentSession = nil
+            var isFinished = false
+            let userAgentSession = self.authorizationServiceClass().present(request, externalUserAgent: externalUserAgent) { _, responseError in
+                isFinished = true
+                self.finishUserAgentSession(state: request.state)
                 
                 var error: OktaOidcError?
                 if let responseError = responseError {
@@ -109,7 +116,25 @@ class OktaOidcBrowserTask: OktaOidcTask {
                 
                 callback((), error)
             }
-            self.userAgentSession = userAgentSession
+            if !isFinished {
+                self.startUserAgentSession(userAgentSession, state: request.state)
+            }
+        }
+    }
+
+    /// Keeps the session of a presented request, and registers it to receive the redirects carrying
+    /// the state of the request, so that concurrent sessions each get their own redirect.
+    func startUserAgentSession(_ userAgentSession: OKTExternalUserAgentSession?, state: String?) {
+        self.userAgentSession = userAgentSession
+        if let userAgentSession = userAgentSession, let state = state {
+            OKTRedirectRouter.shared().registerFlow(userAgentSession, forState: state)
+        }
+    }
+
+    func finishUserAgentSession(state: String?) {
+        self.userAgentSession = nil
+        if let state = state {
+            OKTRedirectRouter.shared().unregisterFlow(forState: state)
         }
     }
 
@@ -24,6 +24,7 @@ class OktaOidcTask {
     }
 
     func downloadOidcConfiguration(callback: @escaping (OKTServiceConfiguration?, OktaOidcError?) -> Void) {
+        let callback = OKTTracing.traced(OKTTraceSpanDiscovery, callback: callback)
         guard let configUrl = URL(string: "\(config.issuer)/.well-known/openid-configuration") else {
             DispatchQueue.main.async {
                 callback(nil, OktaOidcError.noDiscoveryEndpoint)
@@ -31,13 +32,16 @@ class OktaOidcTask {
             return
         }
 
-        oktaAPI.get(configUrl, headers: nil, onSuccess: { response in
+        let request = OKTNetworkMetricsCollector.shared().request(oktaAPI.setupRequest(configUrl, method: "GET", headers: nil),
+                                                                  taggedWithOperation: OKTNetworkOperationDiscovery,
+                                                                  delegate: nil)
+        oktaAPI.fireRequest(request, onSuccess: { response in
             guard let dictResponse = response, let oidConfig = try? OKTServiceDiscovery(dictionary: dictResponse) else {
                 callback(nil, OktaOidcError.parseFailure)
                 return
             }
 
-            callback(OKTServiceConfiguration(discoveryDocument: oidConfig), nil)
+            callback(OKTServiceConfiguration.shared(for: OKTServiceConfiguration(discoveryDocument: oidConfig)), nil)
         }, onError: { error in
             callback(nil, error)
         })
@@ -13,26 +13,47 @@
 #import "OKTAuthState.h"
 #import "OKTAuthStateChangeDelegate.h"
 #import "OKTAuthStateErrorDelegate.h"
+#import "OKTAuthStateSharedStorage.h"
 #import "OKTAuthorizationRequest.h"
+#import "OKTAuthorizationMaterialPool.h"
 #import "OKTAuthorizationResponse.h"
 #import "OKTAuthorizationService.h"
+#import "OKTCircuitBreaker.h"
+#import "OKTCrossProcessRefreshLock.h"
 #import "OKTError.h"
 #import "OKTErrorUtilities.h"
 #import "OKTExternalUserAgent.h"
 #import "OKTExternalUserAgentRequest.h"
 #import "OKTExternalUserAgentSession.h"
+#import "OKTFileLock.h"
 #import "OKTGrantTypes.h"
 #import "OKTIDToken.h"
+#import "OKTRedirectRouter.h"
 #import "OKTRegistrationRequest.h"
 #import "OKTRegistrationResponse.h"
+#import "OKTRetryPolicy.h"
 #import "OKTResponseTypes.h"
 #import "OKTScopes.h"
 #import "OKTScopeUtilities.h"
 #import "OKTServiceConfiguration.h"
 #import "OKTServiceDiscovery.h"
 #import "OKTTokenRequest.h"
+#import "OKTTokenRefreshCoordinator.h"
 #import "OKTTokenResponse.h"
+#import "OKTCryptoProvider.h"
+#import "OKTAppleCryptoProvider.h"
+#import "OKTHTTPRequestParser.h"
+#import "OKTLoopbackSocket.h"
+#import "OKTRingBuffer.h"
+#import "OKTPortableCrypto.h"
+#import "OKTPortableCryptoProvider.h"
 #import "OKTTokenUtilities.h"
+#import "OKTNetworkMetrics.h"
+#import "OKTLatencyHistogram.h"
+#import "OKTMetricsRegistry.h"
+#import "OKTTracing.h"
+#import "OKTInMemoryTracer.h"
+#import "OKTURLEncodingUtilities.h"
 #import "OKTURLSessionProvider.h"
 #import "OKTEndSessionRequest.h"
 #import "OKTEndSessionResponse.h"
@@ -27,6 +27,9 @@ public class OktaOidc: NSObject {
         } else {
             self.configuration = try OktaOidcConfig.default()
         }
+
+        // Generates the PKCE and state values of the first sign in ahead of time.
+        OKTAuthorizationMaterialPool.shared().prewarm()
     }
 
     @objc public func authenticate(withSessionToken sessionToken: String,
@@ -45,6 +48,7 @@ public class OktaOidc: NSObject {
                     return
                 }
 
+                authState.compactsResponses = self.configuration.compactsSessions
                 let authStateManager = OktaOidcStateManager(authState: authState)
                 if let delegate = self.configuration.requestCustomizationDelegate {
                     authStateManager.requestCustomizationDelegate = delegate
@@ -54,21 +58,23 @@ public class OktaOidc: NSObject {
     }
 
     @objc public func hasActiveBrowserSession() -> Bool {
-        return currentUserSessionTask != nil
+        return !userSessionTasks.isEmpty
     }
 
     func signInWithBrowserTask(_ task: OktaOidcBrowserTask,
                                callback: @escaping ((OktaOidcStateManager?, Error?) -> Void)) {
-        currentUserSessionTask = task
+        userSessionTasks.append(task)
+        let taskID = ObjectIdentifier(task)
 
         task.signIn(delegate: configuration.requestCustomizationDelegate,
                     validator: configuration.tokenValidator) { [weak self] authState, error in
-            defer { self?.currentUserSessionTask = nil }
+            defer { self?.removeUserSessionTask(taskID) }
             guard let authState = authState else {
                 callback(nil, error)
                 return
             }
             
+            authState.compactsResponses = self?.configuration.compactsSessions ?? false
             let authStateManager = OktaOidcStateManager(authState: authState)
             if let delegate = self?.configuration.requestCustomizationDelegate {
                 authStateManager.requestCustomizationDelegate = delegate
@@ -83,14 +89,42 @@ public class OktaOidc: NSObject {
     func signOutWithBrowserTask(_ task: OktaOidcBrowserTask,
                                 idToken: String,
                                 callback: @escaping ((Error?) -> Void)) {
-        currentUserSessionTask = task
+        userSessionTasks.append(task)
+        let taskID = ObjectIdentifier(task)
 
         task.signOutWithIdToken(idToken: idToken) { [weak self] _, error in
-            defer { self?.currentUserSessionTask = nil }
+            defer { self?.removeUserSessionTask(taskID) }
             callback(error)
         }
     }
 
-    // Holds the browser session
-    var currentUserSessionTask: OktaOidcBrowserTask?
+    /// Cancels every browser session in progress, and calls the completion once all are cancelled.
+    func cancelUserSessionTasks(completion: (() -> Void)?) {
+        let userAgentSessions = userSessionTasks.compactMap { $0.userAgentSession }
+        guard !userAgentSessions.isEmpty else {
+            completion?()
+            return
+        }
+
+        let group = DispatchGroup()
+        for userAgentSession in userAgentSessions {
+            group.enter()
+            userAgentSession.cancel { group.leave() }
+        }
+        group.notify(queue: .main) {
+            completion?()
+        }
+    }
+
+    private func removeUserSessionTask(_ taskID: ObjectIdentifier) {
+        userSessionTasks.removeAll { ObjectIdentifier($0) == taskID }
+    }
+
+    // Holds the browser sessions in progress. Their redirects are dispatched by OKTRedirectRouter.
+    var userSessionTasks: [OktaOidcBrowserTask] = []
+
+    // The most recently started browser session
+    var currentUserSessionTask: OktaOidcBrowserTask? {
+        return userSessionTasks.last
+    }
 }
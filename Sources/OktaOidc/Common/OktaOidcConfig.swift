@@ -32,6 +32,13 @@ public class OktaOidcConfig: NSObject {
     @objc public weak var requestCustomizationDelegate: OktaNetworkRequestCustomizationDelegate?
     
     @objc public var tokenValidator: OKTTokenValidator = OKTDefaultTokenValidator()
+
+    /*!
+     Set to keep only the tokens and the endpoints needed to refresh them in the sessions signed in
+     with this configuration. Codes, nonces, PKCE values and additional response parameters are
+     dropped once tokens are issued, which shrinks sessions held in memory and in the keychain.
+     */
+    @objc public var compactsSessions = false
     
     private var _noSSO = false
     
@@ -88,6 +95,11 @@ public class OktaOidcConfig: NSObject {
     public class func setUserAgent(value: String) {
         OktaUserAgent.setUserAgentValue(value)
     }
+
+    /// Sets the policy used to retry failed token and REST requests, e.g. `OKTRetryPolicy.defaultRetryPolicy()`.
+    public class func setRetryPolicy(_ policy: OKTRetryPolicy) {
+        OKTRetryPolicy.setSharedPolicy(policy)
+    }
     
     override public func isEqual(_ object: Any?) -> Bool {
         guard let config = object as? OktaOidcConfig else {
@@ -173,5 +185,9 @@ public class OktaOidcConfig: NSObject {
             // prevent redirect
             completionHandler(nil)
         }
+
+        public func urlSession(_ session: URLSession, task: URLSessionTask, didFinishCollecting metrics: URLSessionTaskMetrics) {
+            OKTNetworkMetricsCollector.shared().collect(metrics, for: task)
+        }
     }
 }
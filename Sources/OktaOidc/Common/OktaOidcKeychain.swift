@@ -12,6 +12,10 @@
 
 import Foundation
 
+#if SWIFT_PACKAGE
+import OktaOidc_AppAuth
+#endif
+
 public enum OktaOidcKeychainError: Error {
     case codingError
     case failed(String)
@@ -52,6 +56,13 @@ public class OktaOidcKeychain: NSObject {
         }
         
         let cfDictionary = q as CFDictionary
+        let metrics = OKTMetricsRegistry.shared()
+        metrics.increment(OKTMetricKeychainWrites)
+        let startTime = CFAbsoluteTimeGetCurrent()
+        defer {
+            metrics.record(CFAbsoluteTimeGetCurrent() - startTime, for: OKTMetricOperationKeychainWrite)
+        }
+
         // Delete existing (if applicable)
         SecItemDelete(cfDictionary)
         
@@ -88,8 +99,11 @@ public class OktaOidcKeychain: NSObject {
         ] as CFDictionary
         
         var ref: AnyObject?
-        
+        let metrics = OKTMetricsRegistry.shared()
+        metrics.increment(OKTMetricKeychainReads)
+        let startTime = CFAbsoluteTimeGetCurrent()
         let sanityCheck = SecItemCopyMatching(q, &ref)
+        metrics.record(CFAbsoluteTimeGetCurrent() - startTime, for: OKTMetricOperationKeychainRead)
         guard sanityCheck == noErr else {
             if sanityCheck == errSecItemNotFound {
                 throw OktaOidcKeychainError.notFound
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+import Foundation
+
+/// Shares one network call between identical REST requests (userinfo, introspect, revoke, discovery)
+/// that are in flight at the same time. Requests are identical when their method, URL, headers and
+/// body match; headers take part so that requests authorized with different tokens are never merged.
+/// Coalescing is disabled by default.
+public final class OktaOidcRequestCoalescer: NSObject {
+
+    @objc public static let shared = OktaOidcRequestCoalescer()
+
+    /// Enables coalescing for requests started afterwards.
+    @objc public var isEnabled: Bool {
+        get { lock.synchronized { enabled } }
+        set { lock.synchronized { enabled = newValue } }
+    }
+
+    /// Number of network calls started while coalescing was enabled.
+    @objc public var issuedRequestCount: Int {
+        lock.synchronized { issuedCount }
+    }
+
+    /// Number of requests that joined a call already in flight instead of starting their own.
+    @objc public var coalescedRequestCount: Int {
+        lock.synchronized { coalescedCount }
+    }
+
+    @objc public func resetCounters() {
+        lock.synchronized {
+            issuedCount = 0
+            coalescedCount = 0
+        }
+    }
+
+    struct Key: Hashable {
+        let method: String
+        let url: URL?
+        let headers: [String: String]
+        let body: Data?
+
+        init(request: URLRequest) {
+            method = request.httpMethod ?? "GET"
+            url = request.url
+            headers = request.allHTTPHeaderFields ?? [:]
+            body = request.httpBody
+        }
+    }
+
+    typealias Completion = (URLResponse?, Result<[String: Any]?, OktaOidcError>) -> Void
+
+    private let lock = NSLock()
+    private var enabled = false
+    private var issuedCount = 0
+    private var coalescedCount = 0
+    private var waiters: [Key: [Completion]] = [:]
+
+    /// Registers a completion for the key. Returns `true` if the caller must issue the request and
+    /// later call `complete(_:response:result:)`, or `false` if an identical request is in flight.
+    func register(_ completion: @escaping Completion, for key: Key) -> Bool {
+        return lock.synchronized {
+            if waiters[key] != nil {
+                waiters[key]?.append(completion)
+                coalescedCount += 1
+                return false
+            }
+
+            waiters[key] = [completion]
+            issuedCount += 1
+            return true
+        }
+    }
+
+    /// Delivers the result of the request issued for the key to every registered completion.
+    func complete(_ key: Key, response: URLResponse?, result: Result<[String: Any]?, OktaOidcError>) {
+        let completions = lock.synchronized { waiters.removeValue(forKey: key) ?? [] }
+        completions.forEach { $0(response, result) }
+    }
+}
+
+private extension NSLock {
+    func synchronized<T>(_ body: () throws -> T) rethrows -> T {
+        lock()
+        defer { unlock() }
+        return try body()
+    }
+}
@@ -186,6 +186,16 @@ open class OktaOidcStateManager: NSObject, NSSecureCoding {
         
         performRequest(to: .userInfo, headers: headers, callback: callback)
     }
+
+    /// Coordinates token refreshes with other processes, such as app extensions, that share this session
+    /// in secure storage. Before refreshing, the auth state takes an advisory lock on `lockFileURL` and
+    /// re-reads secure storage, adopting tokens another process has already refreshed. Refreshed tokens
+    /// are written to secure storage before the lock is released. The lock file must be in a directory
+    /// all processes can write to, such as an app group container.
+    @objc public func enableCrossProcessRefresh(lockFileURL: URL) {
+        authState.crossProcessRefreshLock = OKTCrossProcessRefreshLock(lockFileURL: lockFileURL)
+        authState.sharedStorage = self
+    }
 }
 
 @objc public extension OktaOidcStateManager {
@@ -200,6 +210,7 @@ open class OktaOidcStateManager: NSObject, NSSecureCoding {
     }
     
     @objc func writeToSecureStorage() {
+        let span = OKTTracing.beginSpan(OKTTraceSpanPersistence)
         let authStateData: Data
         do {
             if #available(iOS 11, OSX 10.14, *) {
@@ -213,7 +224,9 @@ open class OktaOidcStateManager: NSObject, NSSecureCoding {
                 data: authStateData,
                 accessibility: self.accessibility
             )
+            span?.end(error: nil)
         } catch let error {
+            span?.end(error: error as NSError)
             print("Error: \(error)")
         }
     }
@@ -252,6 +265,16 @@ open class OktaOidcStateManager: NSObject, NSSecureCoding {
     }
 }
 
+extension OktaOidcStateManager: OKTAuthStateSharedStorage {
+    public func storedAuthState(for authState: OKTAuthState) -> OKTAuthState? {
+        return OktaOidcStateManager.readFromSecureStorage(forKey: clientId)?.authState
+    }
+
+    public func storeAuthState(_ authState: OKTAuthState) {
+        writeToSecureStorage()
+    }
+}
+
 internal extension OktaOidcStateManager {
     var discoveryDictionary: [String: Any]? {
         return authState.lastAuthorizationResponse.request.configuration.discoveryDocument?.discoveryDictionary
@@ -286,6 +309,9 @@ private extension OktaOidcStateManager {
                         headers: [String: String]? = nil,
                         postString: String? = nil,
                         callback: @escaping ([String: Any]?, OktaOidcError?) -> Void) {
+        let callback = OKTTracing.traced(OKTTraceSpanEndpointRequest,
+                                         attributes: { ["endpoint": "\(endpoint)"] },
+                                         callback: callback)
         guard let endpointURL = endpoint.getURL(discoveredMetadata: discoveryDictionary, issuer: issuer) else {
             DispatchQueue.main.async {
                 callback(nil, endpoint.noEndpointError)
@@ -293,15 +319,18 @@ private extension OktaOidcStateManager {
             return
         }
         
-        var requestHeaders = [
-            "Accept": "application/json",
-            "Content-Type": "application/x-www-form-urlencoded"
-        ]
-        
+        var requestHeaders = OktaOidcRequestHeaders.formPost
         if let headers = headers {
             requestHeaders.merge(headers) { (_, new) in new }
         }
-        restAPI.post(endpointURL, headers: requestHeaders, postString: postString, onSuccess: { response in
+        let request = restAPI.setupRequest(endpointURL,
+                                           method: "POST",
+                                           headers: requestHeaders,
+                                           body: postString?.data(using: .utf8))
+        let taggedRequest = OKTNetworkMetricsCollector.shared().request(request,
+                                                                        taggedWithOperation: endpoint.networkOperation,
+                                                                        delegate: nil)
+        restAPI.fireRequest(taggedRequest, onSuccess: { response in
             callback(response, nil)
         }, onError: { error in
             callback(nil, error)
@@ -81,11 +81,7 @@ extension OktaOidc: OktaOidcBrowserProtocolIOS {
     }
 
     @objc public func cancelBrowserSession(completion: (() -> Void)? = nil) {
-        guard let userAgentSession = currentUserSessionTask?.userAgentSession else {
-            completion?()
-            return
-        }
-        userAgentSession.cancel(completion: completion)
+        cancelUserSessionTasks(completion: completion)
     }
 }
 #endif
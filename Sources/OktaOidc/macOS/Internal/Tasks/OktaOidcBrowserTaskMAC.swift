@@ -30,35 +30,46 @@ class OktaOidcBrowserTaskMAC: OktaOidcBrowserTask {
          oktaAPI: OktaOidcHttpApiProtocol,
          redirectServerConfiguration: OktaRedirectServerConfiguration? = nil) {
         if let redirectServerConfiguration = redirectServerConfiguration {
-            redirectServer = OktaRedirectServer(successURL: redirectServerConfiguration.successRedirectURL,
-                                                port: redirectServerConfiguration.port ?? 0)
+            if redirectServerConfiguration.isPersistent {
+                redirectServer = OktaRedirectServer.persistentServer(for: redirectServerConfiguration)
+            } else {
+                redirectServer = OktaRedirectServer(successURL: redirectServerConfiguration.successRedirectURL,
+                                                    port: redirectServerConfiguration.port ?? 0,
+                                                    fallbackPorts: redirectServerConfiguration.fallbackPorts)
+            }
         }
         self.domainName = redirectServerConfiguration?.domainName
         self.redirectServerConfiguration = redirectServerConfiguration
 
         super.init(config: config, oktaAPI: oktaAPI)
 
-        NSAppleEventManager.shared().setEventHandler(self,
-                                                     andSelector: #selector(OktaOidcBrowserTaskMAC.handleEvent(_:withReplyEvent:)),
-                                                     forEventClass: AEEventClass(kInternetEventClass),
-                                                     andEventID: AEEventID(kAEGetURL))
+        OktaOidcRedirectEventHandler.shared.addTask()
     }
 
     deinit {
-        redirectServer?.stopListener()
-        NSAppleEventManager.shared().removeEventHandler(forEventClass: AEEventClass(kInternetEventClass), andEventID: AEEventID(kAEGetURL))
+        if !usesPersistentListener {
+            redirectServer?.stopListener()
+        }
+        OktaOidcRedirectEventHandler.shared.removeTask()
     }
 
     override var userAgentSession: OKTExternalUserAgentSession? {
         didSet {
-            self.redirectServer?.redirectHandler.currentAuthorizationFlow = userAgentSession
+            // A persistent listener is shared by all flows and finds their sessions by state.
+            if !usesPersistentListener {
+                self.redirectServer?.redirectHandler.currentAuthorizationFlow = userAgentSession
+            }
         }
     }
 
+    var usesPersistentListener: Bool {
+        return redirectServerConfiguration?.isPersistent ?? false
+    }
+
     override func signIn(delegate: OktaNetworkRequestCustomizationDelegate? = nil, validator: OKTTokenValidator, callback: @escaping ((OKTAuthState?, OktaOidcError?) -> Void)) {
         if let redirectServer = self.redirectServer {
             do {
-                redirectURL = try redirectServer.startListener(with: domainName)
+                redirectURL = try startListener(of: redirectServer)
             } catch let error {
                 callback(nil, OktaOidcError.redirectServerError("Redirect server error: \(error.localizedDescription)"))
                 return
@@ -73,7 +84,7 @@ class OktaOidcBrowserTaskMAC: OktaOidcBrowserTask {
     override func signOutWithIdToken(idToken: String, callback: @escaping (Void?, OktaOidcError?) -> Void) {
         if let redirectServer = self.redirectServer {
             do {
-                redirectURL = try redirectServer.startListener(with: domainName)
+                redirectURL = try startListener(of: redirectServer)
             } catch let error {
                 callback(nil, OktaOidcError.redirectServerError("Redirect server error: \(error.localizedDescription)"))
                 return
@@ -85,6 +96,13 @@ class OktaOidcBrowserTaskMAC: OktaOidcBrowserTask {
         super.signOutWithIdToken(idToken: idToken, callback: callback)
     }
 
+    func startListener(of redirectServer: OktaRedirectServer) throws -> URL {
+        if usesPersistentListener {
+            return try redirectServer.startPersistentListener(with: domainName)
+        }
+        return try redirectServer.startListener(with: domainName)
+    }
+
     override func signInRedirectUri() -> URL? {
         return redirectURL
     }
@@ -96,12 +114,53 @@ class OktaOidcBrowserTaskMAC: OktaOidcBrowserTask {
     override func externalUserAgent() -> OKTExternalUserAgent? {
         return OKTExternalUserAgentMac()
     }
-    
+}
+
+/// Receives custom scheme redirects for all browser tasks and dispatches them by state. An Apple
+/// event has a single handler, so one handler is installed while any task exists, rather than one
+/// per task.
+final class OktaOidcRedirectEventHandler: NSObject {
+
+    static let shared = OktaOidcRedirectEventHandler()
+
+    /// Guards `taskCount` and installing or removing the handler. Tasks are created and released
+    /// on any thread.
+    private let lock = NSLock()
+    private var taskCount = 0
+
+    /// The number of tasks the handler is installed for.
+    var activeTaskCount: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return taskCount
+    }
+
+    func addTask() {
+        lock.lock()
+        defer { lock.unlock() }
+        if taskCount == 0 {
+            NSAppleEventManager.shared().setEventHandler(self,
+                                                         andSelector: #selector(handleEvent(_:withReplyEvent:)),
+                                                         forEventClass: AEEventClass(kInternetEventClass),
+                                                         andEventID: AEEventID(kAEGetURL))
+        }
+        taskCount += 1
+    }
+
+    func removeTask() {
+        lock.lock()
+        defer { lock.unlock() }
+        taskCount -= 1
+        if taskCount == 0 {
+            NSAppleEventManager.shared().removeEventHandler(forEventClass: AEEventClass(kInternetEventClass), andEventID: AEEventID(kAEGetURL))
+        }
+    }
+
     @objc func handleEvent(_ event: NSAppleEventDescriptor!, withReplyEvent: NSAppleEventDescriptor!) {
         if let eventDescriptor = event.paramDescriptor(forKeyword: AEEventID(keyDirectObject)),
            let stringValue = eventDescriptor.stringValue,
            let url = URL(string: stringValue) {
-                self.resume(with: url)
+                OKTRedirectRouter.shared().resumeExternalUserAgentFlow(with: url)
         }
     }
 }
@@ -87,11 +87,7 @@ extension OktaOidc: OktaOidcBrowserProtocolMAC {
     }
 
     @objc public func cancelBrowserSession(completion: (() -> Void)? = nil) {
-        guard let userAgentSession = currentUserSessionTask?.userAgentSession else {
-            completion?()
-            return
-        }
-        userAgentSession.cancel(completion: completion)
+        cancelUserSessionTasks(completion: completion)
     }
 }
 #endif
@@ -22,20 +22,57 @@ public class OktaRedirectServer {
 
     var redirectHandler: OKTRedirectHTTPHandler
     let port: UInt16
+    let fallbackPorts: ClosedRange<UInt16>?
 
-    public init(successURL: URL?, port: UInt16 = 0) {
+    public init(successURL: URL?, port: UInt16 = 0, fallbackPorts: ClosedRange<UInt16>? = nil) {
         redirectHandler = OKTRedirectHTTPHandler(successURL: successURL)
         self.port = port
+        self.fallbackPorts = fallbackPorts
     }
 
     public func startListener(with domainName: String? = nil) throws -> URL {
         if port == 0 {
             return try startListenerOnRandomPort(with: domainName)
         } else {
-            return try redirectHandler.startHTTPListener(domainName, withPort: port)
+            return try redirectHandler.startHTTPListener(domainName, withPort: port, fallbackPorts: fallbackPortRange)
         }
     }
 
+    /// Starts a listener that stays open between flows and dispatches redirects by `state`. Binds
+    /// only on the first call, and returns the same URL afterwards.
+    public func startPersistentListener(with domainName: String? = nil) throws -> URL {
+        return try redirectHandler.startPersistentHTTPListener(domainName, withPort: port, fallbackPorts: fallbackPortRange)
+    }
+
+    /// Returns the persistent server for the port, fallback ports and success URL of the
+    /// configuration, creating it for the first flow that uses them. Safe to call from any thread.
+    static func persistentServer(for configuration: OktaRedirectServerConfiguration) -> OktaRedirectServer {
+        let fallbackPorts = configuration.fallbackPorts.map { "\($0.lowerBound)-\($0.upperBound)" } ?? ""
+        let key = "\(configuration.port ?? 0)|\(fallbackPorts)|\(configuration.successRedirectURL?.absoluteString ?? "")"
+
+        persistentServersLock.lock()
+        defer { persistentServersLock.unlock() }
+        if let server = persistentServers[key] {
+            return server
+        }
+
+        let server = OktaRedirectServer(successURL: configuration.successRedirectURL,
+                                        port: configuration.port ?? 0,
+                                        fallbackPorts: configuration.fallbackPorts)
+        persistentServers[key] = server
+        return server
+    }
+
+    private static let persistentServersLock = NSLock()
+    private static var persistentServers: [String: OktaRedirectServer] = [:]
+
+    private var fallbackPortRange: NSRange {
+        guard let fallbackPorts = fallbackPorts else {
+            return NSRange(location: 0, length: 0)
+        }
+        return NSRange(location: Int(fallbackPorts.lowerBound), length: fallbackPorts.count)
+    }
+
     public func stopListener() {
         redirectHandler.cancelHTTPListener()
     }
@@ -18,6 +18,11 @@ public class OktaRedirectServerConfiguration: NSObject {
     public var port: UInt16?
     public var successRedirectURL: URL?
     public var domainName: String?
+    /// Ports tried in order when `port` is in use. Each must be allowed as a redirect URI.
+    public var fallbackPorts: ClosedRange<UInt16>?
+    /// Keeps one listener open for every flow that uses the same port and success URL, instead of
+    /// starting and stopping a listener for each flow. Redirects are dispatched by `state`.
+    public var isPersistent = false
 
     public init(successRedirectURL: URL?, port: UInt16?, domainName: String?) {
         self.successRedirectURL = successRedirectURL
@@ -24,9 +24,12 @@
 #import "OKTRegistrationResponseTests.h"
 #import "OKTTokenResponseTests.h"
 #import "OKTAuthState.h"
+#import "OKTAuthorizationRequest.h"
 #import "OKTAuthorizationResponse.h"
 #import "OKTErrorUtilities.h"
 #import "OKTRegistrationResponse.h"
+#import "OKTServiceConfiguration.h"
+#import "OKTTokenRequest.h"
 #import "OKTTokenResponse.h"
 #import "OKTTokenRequestTests.h"
 
@@ -379,6 +382,99 @@
   XCTAssertEqual(authStateCopy.authorizationError.code, authState.authorizationError.code, @"");
 }
 
+/*! @brief Tests that a compacting state drops what is only needed to obtain the first tokens.
+ */
+- (void)testCompactsResponsesAfterTokenExchange {
+  OKTAuthorizationResponse *authorizationResponse =
+      [OKTAuthorizationResponseTests testInstanceCodeFlow];
+  OKTAuthState *authState =
+      [[OKTAuthState alloc] initWithAuthorizationResponse:authorizationResponse];
+  authState.compactsResponses = YES;
+  XCTAssertEqual(authState.lastAuthorizationResponse, authorizationResponse,
+                 @"The code is kept until it is exchanged");
+
+  OKTTokenResponse *tokenResponse = [OKTTokenResponseTests testInstance];
+  [authState updateWithTokenResponse:tokenResponse error:nil];
+
+  OKTAuthorizationResponse *compactAuthorizationResponse = authState.lastAuthorizationResponse;
+  XCTAssertNil(compactAuthorizationResponse.authorizationCode, @"");
+  XCTAssertNil(compactAuthorizationResponse.state, @"");
+  XCTAssertNil(compactAuthorizationResponse.additionalParameters, @"");
+  XCTAssertNil(compactAuthorizationResponse.request.state, @"");
+  XCTAssertNil(compactAuthorizationResponse.request.nonce, @"");
+  XCTAssertNil(compactAuthorizationResponse.request.codeVerifier, @"");
+  XCTAssertEqualObjects(compactAuthorizationResponse.request.clientID,
+                        authorizationResponse.request.clientID, @"");
+  XCTAssertEqualObjects(compactAuthorizationResponse.request.redirectURL,
+                        authorizationResponse.request.redirectURL, @"");
+  XCTAssertEqual(compactAuthorizationResponse.request.configuration,
+                 [OKTServiceConfiguration
+                     sharedConfigurationForConfiguration:authorizationResponse.request.configuration],
+                 @"");
+
+  OKTTokenResponse *compactTokenResponse = authState.lastTokenResponse;
+  XCTAssertNotEqual(compactTokenResponse, tokenResponse, @"");
+  XCTAssertEqualObjects(compactTokenResponse.accessToken, tokenResponse.accessToken, @"");
+  XCTAssertEqualObjects(compactTokenResponse.accessTokenExpirationDate,
+                        tokenResponse.accessTokenExpirationDate, @"");
+  XCTAssertEqualObjects(compactTokenResponse.idToken, tokenResponse.idToken, @"");
+  XCTAssertEqualObjects(compactTokenResponse.refreshToken, tokenResponse.refreshToken, @"");
+  XCTAssertEqualObjects(compactTokenResponse.scope, tokenResponse.scope, @"");
+  XCTAssertNil(compactTokenResponse.additionalParameters, @"");
+  XCTAssertNil(compactTokenResponse.request.authorizationCode, @"");
+  XCTAssertNil(compactTokenResponse.request.codeVerifier, @"");
+  XCTAssertTrue(authState.isAuthorized, @"");
+
+  OKTTokenRequest *refreshRequest = [authState tokenRefreshRequest];
+  XCTAssertEqualObjects(refreshRequest.refreshToken, tokenResponse.refreshToken, @"");
+  XCTAssertEqualObjects(refreshRequest.clientID, authorizationResponse.request.clientID, @"");
+  XCTAssertEqualObjects(refreshRequest.configuration.tokenEndpoint,
+                        authorizationResponse.request.configuration.tokenEndpoint, @"");
+}
+
+/*! @brief Tests that refreshed token responses are compacted too, and that a new authorization
+        response is kept whole until its code is exchanged.
+ */
+- (void)testCompactsRefreshedTokenResponses {
+  OKTAuthState *authState = [[self class] testInstance];
+  authState.compactsResponses = YES;
+  XCTAssertNil(authState.lastAuthorizationResponse.authorizationCode, @"");
+
+  OKTTokenResponse *tokenResponse = [OKTTokenResponseTests testInstance];
+  [authState updateWithTokenResponse:tokenResponse error:nil];
+  XCTAssertNil(authState.lastTokenResponse.additionalParameters, @"");
+  XCTAssertEqualObjects(authState.refreshToken, tokenResponse.refreshToken, @"");
+
+  OKTAuthorizationResponse *authorizationResponse =
+      [OKTAuthorizationResponseTests testInstanceCodeFlow];
+  [authState updateWithAuthorizationResponse:authorizationResponse error:nil];
+  XCTAssertEqual(authState.lastAuthorizationResponse, authorizationResponse, @"");
+
+  [authState updateWithTokenResponse:[OKTTokenResponseTests testInstanceCodeExchange] error:nil];
+  XCTAssertNil(authState.lastAuthorizationResponse.authorizationCode, @"");
+}
+
+- (void)testSecureCodingOfCompactState {
+  OKTAuthState *authState = [[self class] testInstance];
+  authState.compactsResponses = YES;
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:authState];
+  NSData *fullData = [NSKeyedArchiver archivedDataWithRootObject:[[self class] testInstance]];
+  XCTAssertLessThan(data.length, fullData.length, @"");
+
+  OKTAuthState *authStateCopy = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertTrue(authStateCopy.compactsResponses, @"");
+  XCTAssertTrue(authStateCopy.isAuthorized, @"");
+  XCTAssertEqualObjects(authStateCopy.accessToken, authState.accessToken, @"");
+  XCTAssertEqualObjects(authStateCopy.refreshToken, authState.refreshToken, @"");
+  XCTAssertNil(authStateCopy.lastAuthorizationResponse.authorizationCode, @"");
+  XCTAssertNotNil([authStateCopy tokenRefreshRequest], @"");
+
+  OKTAuthState *otherCopy = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqual(otherCopy.lastAuthorizationResponse.request.configuration,
+                 authStateCopy.lastAuthorizationResponse.request.configuration,
+                 @"Restored sessions of one issuer share their configuration");
+}
+
 - (void)testIsTokenFreshWithFreshToken {
   OKTAuthorizationResponse *authorizationResponse =
       [OKTAuthorizationResponseTests testInstanceCodeFlow];
@@ -0,0 +1,124 @@
+/*! @file OKTAuthorizationMaterialPoolTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OKTAuthorizationMaterialPool.h"
+#import "OKTAuthorizationRequest.h"
+#import "OKTResponseTypes.h"
+#import "OKTServiceConfiguration.h"
+
+// Ignore warnings about "Use of GNU statement expression extension" which is raised by our use of
+// the XCTAssert___ macros.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wgnu"
+
+/*! @brief Length of 32 random bytes encoded with base64url without padding.
+ */
+static const NSUInteger kEncodedValueLength = 43;
+
+@interface OKTAuthorizationMaterialPoolTests : XCTestCase
+@end
+
+/*! @brief Unit tests for @c OKTAuthorizationMaterialPool.
+ */
+@implementation OKTAuthorizationMaterialPoolTests
+
+- (void)waitForAvailableCount:(NSUInteger)count inPool:(OKTAuthorizationMaterialPool *)pool {
+  NSPredicate *predicate = [NSPredicate predicateWithBlock:^BOOL(id object, NSDictionary *bindings) {
+    return [object availableCount] == count;
+  }];
+  [self expectationForPredicate:predicate evaluatedWithObject:pool handler:nil];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testGenerateMaterial {
+  OKTAuthorizationMaterial *material = [OKTAuthorizationMaterial generateMaterial];
+  XCTAssertEqual(material.codeVerifier.length, kEncodedValueLength);
+  XCTAssertEqual(material.state.length, kEncodedValueLength);
+  XCTAssertEqual(material.nonce.length, kEncodedValueLength);
+  XCTAssertEqualObjects(material.codeChallenge,
+                        [OKTAuthorizationRequest codeChallengeS256ForVerifier:material.codeVerifier]);
+  XCTAssertNotEqualObjects(material.state, material.nonce);
+  XCTAssertNotEqualObjects(material.state, material.codeVerifier);
+}
+
+- (void)testPrewarmFillsPool {
+  OKTAuthorizationMaterialPool *pool = [[OKTAuthorizationMaterialPool alloc] init];
+  XCTAssertEqual(pool.availableCount, 0);
+
+  [pool prewarm];
+  [self waitForAvailableCount:pool.capacity inPool:pool];
+}
+
+- (void)testTakeMaterialIsSingleUseAndRefills {
+  OKTAuthorizationMaterialPool *pool = [[OKTAuthorizationMaterialPool alloc] init];
+  pool.capacity = 2;
+
+  NSMutableSet<NSString *> *values = [NSMutableSet set];
+  NSUInteger takeCount = 10;
+  for (NSUInteger i = 0; i < takeCount; i++) {
+    OKTAuthorizationMaterial *material = [pool takeMaterial];
+    XCTAssertNotNil(material);
+    XCTAssertEqualObjects(material.codeChallenge,
+        [OKTAuthorizationRequest codeChallengeS256ForVerifier:material.codeVerifier]);
+    [values addObject:material.codeVerifier];
+    [values addObject:material.state];
+    [values addObject:material.nonce];
+  }
+  XCTAssertEqual(values.count, 3 * takeCount);
+
+  [self waitForAvailableCount:2 inPool:pool];
+}
+
+- (void)testZeroCapacityDisablesPooling {
+  OKTAuthorizationMaterialPool *pool = [[OKTAuthorizationMaterialPool alloc] init];
+  [pool prewarm];
+  [self waitForAvailableCount:pool.capacity inPool:pool];
+
+  pool.capacity = 0;
+  XCTAssertEqual(pool.availableCount, 0);
+  XCTAssertNotNil([pool takeMaterial]);
+  [pool prewarm];
+  XCTAssertEqual(pool.availableCount, 0);
+}
+
+- (void)testAuthorizationRequestUsesPooledMaterial {
+  NSURL *URL = [NSURL URLWithString:@"https://www.example.com/"];
+  OKTServiceConfiguration *configuration =
+      [[OKTServiceConfiguration alloc] initWithAuthorizationEndpoint:URL tokenEndpoint:URL];
+  OKTAuthorizationRequest *request =
+      [[OKTAuthorizationRequest alloc] initWithConfiguration:configuration
+                                                    clientId:@"client"
+                                                      scopes:@[ @"openid" ]
+                                                 redirectURL:URL
+                                                responseType:OKTResponseTypeCode
+                                        additionalParameters:nil];
+  XCTAssertEqual(request.codeVerifier.length, kEncodedValueLength);
+  XCTAssertEqualObjects(request.codeChallenge,
+                        [OKTAuthorizationRequest codeChallengeS256ForVerifier:request.codeVerifier]);
+  XCTAssertEqual(request.state.length, kEncodedValueLength);
+  XCTAssertEqual(request.nonce.length, kEncodedValueLength);
+  XCTAssertNotEqualObjects(request.state, request.nonce);
+}
+
+@end
+
+#pragma GCC diagnostic pop
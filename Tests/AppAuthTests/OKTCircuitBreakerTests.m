@@ -0,0 +1,200 @@
+/*! @file OKTCircuitBreakerTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OKTCircuitBreaker.h"
+#import "OKTError.h"
+
+// Ignore warnings about "Use of GNU statement expression extension" which is raised by our use of
+// the XCTAssert___ macros.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wgnu"
+
+/*! @brief Test URL of the authorization server.
+ */
+static NSString *const kTestURL = @"https://www.example.com/oauth2/default/v1/token";
+
+@interface OKTCircuitBreakerTests : XCTestCase <OKTCircuitBreakerDelegate>
+@end
+
+/*! @brief Unit tests for @c OKTCircuitBreaker.
+ */
+@implementation OKTCircuitBreakerTests {
+  NSMutableArray<NSNumber *> *_transitions;
+  XCTestExpectation *_transitionExpectation;
+}
+
+- (void)setUp {
+  [super setUp];
+  _transitions = [NSMutableArray array];
+}
+
+- (void)tearDown {
+  [OKTCircuitBreaker disable];
+  OKTCircuitBreaker.delegate = nil;
+  [super tearDown];
+}
+
+- (void)circuitBreaker:(OKTCircuitBreaker *)circuitBreaker
+    didChangeFromState:(OKTCircuitBreakerState)fromState
+               toState:(OKTCircuitBreakerState)toState {
+  [_transitions addObject:@(toState)];
+  [_transitionExpectation fulfill];
+}
+
+- (NSHTTPURLResponse *)responseWithStatusCode:(NSInteger)statusCode {
+  return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:kTestURL]
+                                     statusCode:statusCode
+                                    HTTPVersion:@"HTTP/1.1"
+                                   headerFields:nil];
+}
+
+- (OKTCircuitBreaker *)circuitBreakerWithCooldown:(NSTimeInterval)cooldown {
+  return [[OKTCircuitBreaker alloc] initWithOrigin:@"https://www.example.com:443"
+                                  failureThreshold:3
+                                  latencyThreshold:2
+                                          cooldown:cooldown];
+}
+
+- (void)testDisabledByDefault {
+  XCTAssertFalse([OKTCircuitBreaker isEnabled]);
+  XCTAssertNil([OKTCircuitBreaker circuitBreakerForURL:[NSURL URLWithString:kTestURL]]);
+}
+
+- (void)testBreakersAreSharedPerOrigin {
+  [OKTCircuitBreaker enableWithFailureThreshold:3 latencyThreshold:0 cooldown:10];
+  OKTCircuitBreaker *tokenBreaker =
+      [OKTCircuitBreaker circuitBreakerForURL:[NSURL URLWithString:kTestURL]];
+  OKTCircuitBreaker *userInfoBreaker = [OKTCircuitBreaker circuitBreakerForURL:
+      [NSURL URLWithString:@"https://WWW.example.com:443/oauth2/default/v1/userinfo"]];
+  OKTCircuitBreaker *otherBreaker =
+      [OKTCircuitBreaker circuitBreakerForURL:[NSURL URLWithString:@"https://other.example.com/"]];
+
+  XCTAssertNotNil(tokenBreaker);
+  XCTAssertEqual(tokenBreaker, userInfoBreaker);
+  XCTAssertNotEqual(tokenBreaker, otherBreaker);
+  XCTAssertEqualObjects(tokenBreaker.origin, @"https://www.example.com:443");
+  XCTAssertEqual(tokenBreaker.failureThreshold, (NSUInteger)3);
+}
+
+- (void)testOpensAfterConsecutiveFailures {
+  OKTCircuitBreaker *breaker = [self circuitBreakerWithCooldown:60];
+  NSError *error = [NSError errorWithDomain:NSURLErrorDomain
+                                       code:NSURLErrorCannotConnectToHost
+                                   userInfo:nil];
+
+  [breaker recordResultWithError:error response:nil latency:0.1];
+  [breaker recordResultWithError:nil response:[self responseWithStatusCode:503] latency:0.1];
+  XCTAssertEqual(breaker.state, OKTCircuitBreakerStateClosed);
+
+  // A success resets the count.
+  [breaker recordResultWithError:nil response:[self responseWithStatusCode:200] latency:0.1];
+  [breaker recordResultWithError:nil response:[self responseWithStatusCode:500] latency:0.1];
+  [breaker recordResultWithError:nil response:[self responseWithStatusCode:429] latency:0.1];
+  XCTAssertEqual(breaker.state, OKTCircuitBreakerStateClosed);
+
+  // Client errors say nothing about the health of the server.
+  [breaker recordResultWithError:nil response:[self responseWithStatusCode:400] latency:0.1];
+  XCTAssertEqual(breaker.state, OKTCircuitBreakerStateClosed);
+
+  [breaker recordResultWithError:error response:nil latency:0.1];
+  [breaker recordResultWithError:error response:nil latency:0.1];
+  [breaker recordResultWithError:error response:nil latency:0.1];
+  XCTAssertEqual(breaker.state, OKTCircuitBreakerStateOpen);
+  XCTAssertFalse([breaker allowRequest]);
+}
+
+- (void)testOpensOnHighLatency {
+  OKTCircuitBreaker *breaker = [self circuitBreakerWithCooldown:60];
+  for (int i = 0; i < 3; i++) {
+    XCTAssertTrue([breaker allowRequest]);
+    [breaker recordResultWithError:nil response:[self responseWithStatusCode:200] latency:5];
+  }
+  XCTAssertEqual(breaker.state, OKTCircuitBreakerStateOpen);
+}
+
+- (void)testHalfOpenAllowsSingleProbe {
+  OKTCircuitBreaker *breaker = [self circuitBreakerWithCooldown:0];
+  for (int i = 0; i < 3; i++) {
+    [breaker recordResultWithError:nil response:[self responseWithStatusCode:502] latency:0.1];
+  }
+  XCTAssertEqual(breaker.state, OKTCircuitBreakerStateOpen);
+
+  XCTAssertTrue([breaker allowRequest]);
+  XCTAssertEqual(breaker.state, OKTCircuitBreakerStateHalfOpen);
+  XCTAssertFalse([breaker allowRequest]);
+
+  // A failed probe re-opens the breaker.
+  [breaker recordResultWithError:nil response:[self responseWithStatusCode:503] latency:0.1];
+  XCTAssertEqual(breaker.state, OKTCircuitBreakerStateOpen);
+
+  // A successful probe closes it.
+  XCTAssertTrue([breaker allowRequest]);
+  [breaker recordResultWithError:nil response:[self responseWithStatusCode:200] latency:0.1];
+  XCTAssertEqual(breaker.state, OKTCircuitBreakerStateClosed);
+  XCTAssertTrue([breaker allowRequest]);
+  XCTAssertTrue([breaker allowRequest]);
+}
+
+- (void)testCancelledProbeFreesSlot {
+  OKTCircuitBreaker *breaker = [self circuitBreakerWithCooldown:0];
+  for (int i = 0; i < 3; i++) {
+    [breaker recordResultWithError:nil response:[self responseWithStatusCode:500] latency:0.1];
+  }
+  XCTAssertTrue([breaker allowRequest]);
+  NSError *cancelled = [NSError errorWithDomain:NSURLErrorDomain
+                                           code:NSURLErrorCancelled
+                                       userInfo:nil];
+  [breaker recordResultWithError:cancelled response:nil latency:0.1];
+  XCTAssertEqual(breaker.state, OKTCircuitBreakerStateHalfOpen);
+  XCTAssertTrue([breaker allowRequest]);
+}
+
+- (void)testDelegateReceivesTransitions {
+  OKTCircuitBreaker.delegate = self;
+  _transitionExpectation = [self expectationWithDescription:@"Transitions reported"];
+  _transitionExpectation.expectedFulfillmentCount = 3;
+
+  OKTCircuitBreaker *breaker = [self circuitBreakerWithCooldown:0];
+  for (int i = 0; i < 3; i++) {
+    [breaker recordResultWithError:nil response:[self responseWithStatusCode:500] latency:0.1];
+  }
+  [breaker allowRequest];
+  [breaker recordResultWithError:nil response:[self responseWithStatusCode:200] latency:0.1];
+
+  [self waitForExpectationsWithTimeout:2 handler:nil];
+  NSArray *expected = @[ @(OKTCircuitBreakerStateOpen),
+                         @(OKTCircuitBreakerStateHalfOpen),
+                         @(OKTCircuitBreakerStateClosed) ];
+  XCTAssertEqualObjects(_transitions, expected);
+}
+
+- (void)testOpenError {
+  NSError *error = [OKTCircuitBreaker circuitBreakerOpenErrorForURL:[NSURL URLWithString:kTestURL]];
+  XCTAssertEqualObjects(error.domain, OKTGeneralErrorDomain);
+  XCTAssertEqual(error.code, OKTErrorCodeCircuitBreakerOpen);
+  XCTAssertTrue([OKTCircuitBreaker isCircuitBreakerOpenError:error]);
+  XCTAssertFalse([OKTCircuitBreaker isCircuitBreakerOpenError:nil]);
+}
+
+@end
+
+#pragma GCC diagnostic pop
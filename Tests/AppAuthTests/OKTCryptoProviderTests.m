@@ -0,0 +1,197 @@
+/*! @file OKTCryptoProviderTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OKTAppleCryptoProvider.h"
+#import "OKTCryptoProvider.h"
+#import "OKTPortableCrypto.h"
+#import "OKTPortableCryptoProvider.h"
+#import "OKTTokenUtilities.h"
+
+// Ignore warnings about "Use of GNU statement expression extension" which is raised by our use of
+// the XCTAssert___ macros.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wgnu"
+
+/*! @brief Number of operations in each benchmark iteration.
+ */
+static const NSUInteger kBenchmarkIterations = 10000;
+
+@interface OKTCryptoProviderTests : XCTestCase
+@end
+
+/*! @brief Unit tests and benchmarks for the @c OKTCryptoProvider implementations.
+ */
+@implementation OKTCryptoProviderTests {
+  /*! @brief The provider installed before the test, restored in @c tearDown.
+   */
+  id<OKTCryptoProvider> _previousProvider;
+}
+
+- (void)setUp {
+  [super setUp];
+  _previousProvider = [OKTCrypto provider];
+}
+
+- (void)tearDown {
+  [OKTCrypto setProvider:_previousProvider];
+  [super tearDown];
+}
+
+- (NSArray<id<OKTCryptoProvider>> *)providers {
+  return @[ [[OKTAppleCryptoProvider alloc] init], [[OKTPortableCryptoProvider alloc] init] ];
+}
+
+- (NSString *)hexStringFromData:(NSData *)data {
+  NSMutableString *hex = [NSMutableString stringWithCapacity:data.length * 2];
+  const uint8_t *bytes = data.bytes;
+  for (NSUInteger i = 0; i < data.length; i++) {
+    [hex appendFormat:@"%02x", bytes[i]];
+  }
+  return hex;
+}
+
+- (void)testDefaultProvider {
+  XCTAssert([_previousProvider isKindOfClass:[OKTAppleCryptoProvider class]]);
+}
+
+/*! @brief Test vectors from FIPS 180-2.
+ */
+- (void)testSHA256 {
+  NSDictionary<NSString *, NSString *> *vectors = @{
+    @"" : @"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+    @"abc" : @"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+    @"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq" :
+        @"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+  };
+  for (id<OKTCryptoProvider> provider in [self providers]) {
+    for (NSString *input in vectors) {
+      NSData *digest = [provider SHA256DigestOfData:[input dataUsingEncoding:NSUTF8StringEncoding]];
+      XCTAssertEqualObjects([self hexStringFromData:digest], vectors[input], @"%@", provider);
+    }
+  }
+}
+
+/*! @brief Hashing in uneven pieces must match hashing in one call.
+ */
+- (void)testSHA256Incremental {
+  NSMutableData *data = [NSMutableData dataWithLength:1000];
+  XCTAssert([[[OKTAppleCryptoProvider alloc] init] getRandomBytes:data.mutableBytes
+                                                             length:data.length]);
+  OKTSHA256Context context;
+  OKTSHA256Init(&context);
+  const uint8_t *bytes = data.bytes;
+  for (size_t offset = 0, chunk = 1; offset < data.length; offset += chunk, chunk += 7) {
+    OKTSHA256Update(&context, bytes + offset, MIN(chunk, data.length - offset));
+  }
+  NSMutableData *digest = [NSMutableData dataWithLength:OKT_SHA256_DIGEST_LENGTH];
+  OKTSHA256Final(&context, digest.mutableBytes);
+  XCTAssertEqualObjects(digest, [[[OKTAppleCryptoProvider alloc] init] SHA256DigestOfData:data]);
+}
+
+/*! @brief Test vectors from RFC 4231 (test cases 2 and 6).
+ */
+- (void)testHMACSHA256 {
+  NSMutableData *longKey = [NSMutableData dataWithLength:131];
+  memset(longKey.mutableBytes, 0xaa, longKey.length);
+  NSData *longKeyMessage = [@"Test Using Larger Than Block-Size Key - Hash Key First"
+      dataUsingEncoding:NSUTF8StringEncoding];
+  for (id<OKTCryptoProvider> provider in [self providers]) {
+    NSData *mac = [provider HMACSHA256OfData:[@"what do ya want for nothing?"
+                                                 dataUsingEncoding:NSUTF8StringEncoding]
+                                         key:[@"Jefe" dataUsingEncoding:NSUTF8StringEncoding]];
+    XCTAssertEqualObjects([self hexStringFromData:mac],
+        @"5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843", @"%@", provider);
+    mac = [provider HMACSHA256OfData:longKeyMessage key:longKey];
+    XCTAssertEqualObjects([self hexStringFromData:mac],
+        @"60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54", @"%@", provider);
+  }
+}
+
+- (void)testRandomBytes {
+  for (id<OKTCryptoProvider> provider in [self providers]) {
+    // Covers requests served from the portable buffer and requests that bypass it.
+    for (NSNumber *length in @[ @32, @96, @1000, @5000 ]) {
+      NSMutableData *first = [NSMutableData dataWithLength:length.unsignedIntegerValue];
+      NSMutableData *second = [NSMutableData dataWithLength:length.unsignedIntegerValue];
+      XCTAssert([provider getRandomBytes:first.mutableBytes length:first.length]);
+      XCTAssert([provider getRandomBytes:second.mutableBytes length:second.length]);
+      XCTAssertNotEqualObjects(first, second, @"%@", provider);
+    }
+  }
+}
+
+- (void)testRandomBytesAfterReset {
+  uint8_t bytes[32];
+  OKTBufferedRandomReset();
+  XCTAssertEqual(OKTBufferedRandomBytes(bytes, sizeof(bytes)), 0);
+}
+
+- (void)testTokenUtilitiesUseInstalledProvider {
+  [OKTCrypto setProvider:[[OKTPortableCryptoProvider alloc] init]];
+  XCTAssertEqualObjects([self hexStringFromData:[OKTTokenUtilities sha256:@"abc"]],
+      @"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  XCTAssertEqual([OKTTokenUtilities randomURLSafeStringWithSize:32].length, 43);
+}
+
+#pragma mark - Benchmarks
+
+- (void)measureRandomBytesWithProvider:(id<OKTCryptoProvider>)provider {
+  [self measureBlock:^{
+    uint8_t bytes[32];
+    for (NSUInteger i = 0; i < kBenchmarkIterations; i++) {
+      [provider getRandomBytes:bytes length:sizeof(bytes)];
+    }
+  }];
+}
+
+- (void)measureSHA256WithProvider:(id<OKTCryptoProvider>)provider {
+  // The size of a PKCE code verifier.
+  NSData *data = [[OKTTokenUtilities randomURLSafeStringWithSize:32]
+      dataUsingEncoding:NSUTF8StringEncoding];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kBenchmarkIterations; i++) {
+      @autoreleasepool {
+        (void)[provider SHA256DigestOfData:data];
+      }
+    }
+  }];
+}
+
+- (void)testBenchmarkRandomBytesApple {
+  [self measureRandomBytesWithProvider:[[OKTAppleCryptoProvider alloc] init]];
+}
+
+- (void)testBenchmarkRandomBytesPortable {
+  [self measureRandomBytesWithProvider:[[OKTPortableCryptoProvider alloc] init]];
+}
+
+- (void)testBenchmarkSHA256Apple {
+  [self measureSHA256WithProvider:[[OKTAppleCryptoProvider alloc] init]];
+}
+
+- (void)testBenchmarkSHA256Portable {
+  [self measureSHA256WithProvider:[[OKTPortableCryptoProvider alloc] init]];
+}
+
+@end
+
+#pragma GCC diagnostic pop
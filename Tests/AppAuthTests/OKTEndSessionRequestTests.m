@@ -123,4 +123,10 @@ static NSString *const kTestIdTokenHint = @"id-token-hint";
     XCTAssertEqualObjects(query[@"post_logout_redirect_uri"], kTestRedirectURL);
 }
 
+- (void)testLogoutRequestURLIsCached {
+    OKTEndSessionRequest *request = [[self class] testInstance];
+    XCTAssertEqual(request.endSessionRequestURL, request.endSessionRequestURL);
+    XCTAssert([request.description containsString:request.endSessionRequestURL.absoluteString]);
+}
+
 @end
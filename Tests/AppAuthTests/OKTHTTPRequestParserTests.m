@@ -0,0 +1,267 @@
+/*! @file OKTHTTPRequestParserTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OKTHTTPRequestParser.h"
+
+// Ignore warnings about "Use of GNU statement expression extension" which is raised by our use of
+// the XCTAssert___ macros.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wgnu"
+
+/*! @brief Number of requests parsed in each benchmark iteration.
+ */
+static const NSUInteger kBenchmarkIterations = 10000;
+
+/*! @brief Size of the reads delivered to the parsers in the benchmarks.
+ */
+static const NSUInteger kBenchmarkReadSize = 64;
+
+/*! @brief A redirect request as sent by a browser to the loopback server.
+ */
+static NSString *const kRedirectRequest =
+    @"GET /callback?code=SplxlOBeZQQYbYS6WxSbIA&state=af0ifjsldkj HTTP/1.1\r\n"
+     "Host: 127.0.0.1:53124\r\n"
+     "User-Agent: Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/605.1.15\r\n"
+     "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+     "Accept-Language: en-US,en;q=0.9\r\n"
+     "Accept-Encoding: gzip, deflate\r\n"
+     "Connection: keep-alive\r\n"
+     "\r\n";
+
+@interface OKTHTTPRequestParserTests : XCTestCase
+@end
+
+/*! @brief Unit tests and benchmarks for @c OKTHTTPRequestParser.
+ */
+@implementation OKTHTTPRequestParserTests {
+  OKTHTTPRequestParser _parser;
+}
+
+- (void)setUp {
+  [super setUp];
+  OKTHTTPRequestParserInit(&_parser, 0, 0);
+}
+
+- (void)tearDown {
+  OKTHTTPRequestParserDestroy(&_parser);
+  [super tearDown];
+}
+
+/*! @brief Feeds the request in pieces of @c pieceLength bytes.
+    @return The status after the last piece fed.
+ */
+- (OKTHTTPParseStatus)feedString:(NSString *)string pieceLength:(NSUInteger)pieceLength {
+  NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+  const uint8_t *bytes = data.bytes;
+  OKTHTTPParseStatus status = OKTHTTPParseStatusIncomplete;
+  for (NSUInteger offset = 0; offset < data.length; offset += pieceLength) {
+    NSUInteger length = MIN(pieceLength, data.length - offset);
+    size_t consumed = OKTHTTPRequestParserExecute(&_parser, bytes + offset, length, &status);
+    if (status == OKTHTTPParseStatusComplete) {
+      XCTAssertEqual(offset + consumed, data.length);
+    }
+    if (status != OKTHTTPParseStatusIncomplete) {
+      break;
+    }
+    XCTAssertEqual(consumed, length);
+  }
+  return status;
+}
+
+- (NSString *)stringAtOffset:(size_t)offset length:(size_t)length {
+  return [[NSString alloc] initWithBytes:_parser.head + offset
+                                  length:length
+                                encoding:NSUTF8StringEncoding];
+}
+
+- (NSString *)headerValue:(const char *)name {
+  size_t length = 0;
+  const char *value = OKTHTTPRequestParserHeaderValue(&_parser, name, &length);
+  return value ? [[NSString alloc] initWithBytes:value length:length encoding:NSUTF8StringEncoding]
+               : nil;
+}
+
+- (NSString *)body {
+  return [[NSString alloc] initWithBytes:_parser.body
+                                  length:_parser.bodyLength
+                                encoding:NSUTF8StringEncoding];
+}
+
+#pragma mark - Parsing
+
+- (void)testParsesRequestFedInAnyPieces {
+  NSUInteger length = [kRedirectRequest lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+  for (NSUInteger pieceLength = 1; pieceLength <= length; pieceLength++) {
+    OKTHTTPRequestParserReset(&_parser);
+    XCTAssertEqual([self feedString:kRedirectRequest pieceLength:pieceLength],
+                   OKTHTTPParseStatusComplete);
+    XCTAssertEqualObjects([self stringAtOffset:0 length:_parser.methodLength], @"GET");
+    XCTAssertEqualObjects([self stringAtOffset:_parser.targetOffset length:_parser.targetLength],
+                          @"/callback?code=SplxlOBeZQQYbYS6WxSbIA&state=af0ifjsldkj");
+    XCTAssertEqualObjects([self stringAtOffset:_parser.versionOffset length:_parser.versionLength],
+                          @"HTTP/1.1");
+    XCTAssertEqual(_parser.fieldCount, 6u);
+    XCTAssertEqualObjects([self headerValue:"host"], @"127.0.0.1:53124");
+    XCTAssertEqual(_parser.bodyLength, 0u);
+  }
+}
+
+- (void)testParsesContentLengthBody {
+  NSString *request = @"POST /callback HTTP/1.1\r\nHost: localhost\r\nContent-Length: 11\r\n\r\n"
+                       "code=abc&x=";
+  XCTAssertEqual([self feedString:request pieceLength:3], OKTHTTPParseStatusComplete);
+  XCTAssertEqualObjects([self body], @"code=abc&x=");
+}
+
+- (void)testParsesChunkedBody {
+  NSString *request = @"POST /callback HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                       "5;ext=1\r\ncode=\r\n3\r\nabc\r\n0\r\nTrailer: ignored\r\n\r\n";
+  XCTAssertEqual([self feedString:request pieceLength:1], OKTHTTPParseStatusComplete);
+  XCTAssertEqualObjects([self body], @"code=abc");
+}
+
+- (void)testParsesPipelinedRequests {
+  NSString *requests = @"GET /first HTTP/1.1\r\nHost: a\r\n\r\n"
+                        "POST /second HTTP/1.1\r\nContent-Length: 2\r\n\r\nok"
+                        "GET /third HTTP/1.1\r\n\r\n";
+  NSData *data = [requests dataUsingEncoding:NSUTF8StringEncoding];
+  NSMutableArray<NSString *> *targets = [NSMutableArray array];
+  size_t offset = 0;
+  while (offset < data.length) {
+    OKTHTTPParseStatus status;
+    offset += OKTHTTPRequestParserExecute(&_parser, (const uint8_t *)data.bytes + offset,
+                                          data.length - offset, &status);
+    XCTAssertEqual(status, OKTHTTPParseStatusComplete);
+    [targets addObject:[self stringAtOffset:_parser.targetOffset length:_parser.targetLength]];
+    OKTHTTPRequestParserReset(&_parser);
+  }
+  XCTAssertEqualObjects(targets, (@[ @"/first", @"/second", @"/third" ]));
+}
+
+- (void)testIncompleteRequest {
+  XCTAssertEqual([self feedString:@"GET / HTTP/1.1\r\nHost: localhost\r\n" pieceLength:4],
+                 OKTHTTPParseStatusIncomplete);
+}
+
+#pragma mark - Errors
+
+- (void)assertString:(NSString *)request failsWithError:(OKTHTTPParseError)error {
+  OKTHTTPRequestParserReset(&_parser);
+  XCTAssertEqual([self feedString:request pieceLength:request.length], OKTHTTPParseStatusError,
+                 @"%@", request);
+  XCTAssertEqual(_parser.error, error, @"%@", request);
+}
+
+- (void)testRejectsMalformedRequests {
+  [self assertString:@"GET /\r\n\r\n" failsWithError:OKTHTTPParseErrorMalformedRequestLine];
+  [self assertString:@"GET / FTP/1.0\r\n\r\n" failsWithError:OKTHTTPParseErrorMalformedRequestLine];
+  [self assertString:@"GET / HTTP/1.1\r\nNoColon\r\n\r\n"
+      failsWithError:OKTHTTPParseErrorMalformedHeader];
+  [self assertString:@"GET / HTTP/1.1\r\nA: b\r\n folded\r\n\r\n"
+      failsWithError:OKTHTTPParseErrorMalformedHeader];
+  [self assertString:@"POST / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n"
+      failsWithError:OKTHTTPParseErrorInvalidContentLength];
+  [self assertString:@"POST / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n"
+      failsWithError:OKTHTTPParseErrorInvalidContentLength];
+  [self assertString:@"POST / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n"
+      failsWithError:OKTHTTPParseErrorUnsupportedTransferEncoding];
+  [self assertString:@"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\nContent-Length: 1\r\n\r\n"
+      failsWithError:OKTHTTPParseErrorInvalidContentLength];
+  [self assertString:@"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n"
+      failsWithError:OKTHTTPParseErrorMalformedChunk];
+  // a bare CR is not skipped inside chunk framing
+  [self assertString:@"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1\r0\n"
+      failsWithError:OKTHTTPParseErrorMalformedChunk];
+  [self assertString:@"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1;a\rb\r\n"
+      failsWithError:OKTHTTPParseErrorMalformedChunk];
+  [self assertString:@"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1\r\na\r\r\n"
+      failsWithError:OKTHTTPParseErrorMalformedChunk];
+  [self assertString:@"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n0\r\nA: b\rc\r\n\r\n"
+      failsWithError:OKTHTTPParseErrorMalformedChunk];
+}
+
+- (void)testBoundsHeaderAndBodySizes {
+  OKTHTTPRequestParserDestroy(&_parser);
+  OKTHTTPRequestParserInit(&_parser, 64, 4);
+
+  NSString *longHeader = [@"GET / HTTP/1.1\r\nCookie: "
+      stringByPaddingToLength:200 withString:@"x" startingAtIndex:0];
+  [self assertString:longHeader failsWithError:OKTHTTPParseErrorHeaderTooLarge];
+  [self assertString:@"POST / HTTP/1.1\r\nContent-Length: 5\r\n\r\n"
+      failsWithError:OKTHTTPParseErrorBodyTooLarge];
+  [self assertString:@"POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n2\r\n"
+      failsWithError:OKTHTTPParseErrorBodyTooLarge];
+
+  OKTHTTPRequestParserDestroy(&_parser);
+  OKTHTTPRequestParserInit(&_parser, 0, 0);
+  NSMutableString *manyHeaders = [NSMutableString stringWithString:@"GET / HTTP/1.1\r\n"];
+  for (int i = 0; i <= OKT_HTTP_MAX_HEADER_FIELDS; i++) {
+    [manyHeaders appendFormat:@"X-%d: %d\r\n", i, i];
+  }
+  [manyHeaders appendString:@"\r\n"];
+  [self assertString:manyHeaders failsWithError:OKTHTTPParseErrorTooManyHeaders];
+}
+
+#pragma mark - Benchmarks
+
+/*! @brief Parses the redirect request delivered in @c kBenchmarkReadSize reads.
+ */
+- (void)testIncrementalParserPerformance {
+  NSData *data = [kRedirectRequest dataUsingEncoding:NSUTF8StringEncoding];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kBenchmarkIterations; i++) {
+      OKTHTTPParseStatus status = OKTHTTPParseStatusIncomplete;
+      for (NSUInteger offset = 0; offset < data.length; offset += kBenchmarkReadSize) {
+        OKTHTTPRequestParserExecute(&self->_parser, (const uint8_t *)data.bytes + offset,
+                                    MIN(kBenchmarkReadSize, data.length - offset), &status);
+      }
+      XCTAssertEqual(status, OKTHTTPParseStatusComplete);
+      OKTHTTPRequestParserReset(&self->_parser);
+    }
+  }];
+}
+
+/*! @brief Baseline: the buffer-and-reparse loop that the loopback server used before, which
+        parses the whole buffered request again after each read.
+ */
+- (void)testReparsingPerformanceBaseline {
+  NSData *data = [kRedirectRequest dataUsingEncoding:NSUTF8StringEncoding];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kBenchmarkIterations; i++) {
+      NSMutableData *buffer = [NSMutableData data];
+      BOOL complete = NO;
+      for (NSUInteger offset = 0; offset < data.length; offset += kBenchmarkReadSize) {
+        [buffer appendBytes:(const uint8_t *)data.bytes + offset
+                     length:MIN(kBenchmarkReadSize, data.length - offset)];
+        CFHTTPMessageRef message = CFHTTPMessageCreateEmpty(kCFAllocatorDefault, TRUE);
+        CFHTTPMessageAppendBytes(message, buffer.bytes, buffer.length);
+        complete = CFHTTPMessageIsHeaderComplete(message);
+        CFRelease(message);
+      }
+      XCTAssertTrue(complete);
+    }
+  }];
+}
+
+@end
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+#import <XCTest/XCTest.h>
+#import "OKTLoopbackHTTPServer.h"
+
+#if TARGET_OS_OSX
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/*! @brief Number of connections served in each benchmark iteration.
+ */
+static const NSUInteger kBenchmarkIterations = 200;
+
+/*! @brief Size of the large response bodies.
+ */
+static const NSUInteger kLargeBodyLength = 1024 * 1024;
+
+/*! @brief A redirect request as sent by a browser to the loopback server.
+ */
+static NSString *const kRedirectRequest =
+    @"GET /callback?code=abc&state=xyz HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+
+@interface OKTLoopbackHTTPServerTests : XCTestCase
+@end
+
+/*! @brief Tests and benchmarks for the loopback HTTP server, served without a run loop.
+ */
+@implementation OKTLoopbackHTTPServerTests {
+    HTTPServer *_server;
+    NSData *_largeBody;
+    // Guarded by @c self.
+    NSUInteger _requestCount;
+    BOOL _calledOnMainThread;
+}
+
+- (void)setUp {
+    [super setUp];
+    NSMutableData *largeBody = [NSMutableData dataWithLength:kLargeBodyLength];
+    for (NSUInteger i = 0; i < kLargeBodyLength; i++) {
+        ((uint8_t *)largeBody.mutableBytes)[i] = (uint8_t)i;
+    }
+    _largeBody = largeBody;
+    [self startServerWithConfiguration:nil];
+}
+
+// Starts a new server, configured by the block before it starts listening.
+- (void)startServerWithConfiguration:(void (^)(HTTPServer *server))configuration {
+    [_server stop];
+    _server = [[HTTPServer alloc] init];
+    [_server setDelegate:self];
+    [_server setDelegateQueue:dispatch_queue_create("com.okta.appauth.tests.loopback", DISPATCH_QUEUE_SERIAL)];
+    if (configuration) {
+        configuration(_server);
+    }
+    NSError *error = nil;
+    XCTAssertTrue([_server start:&error], @"%@", error);
+}
+
+- (void)tearDown {
+    [_server stop];
+    _server = nil;
+    [super tearDown];
+}
+
+// Responds to /large with a large body, to /stream with a large streamed body, never to /hold,
+// and to other paths with the URL of the request.
+- (void)HTTPConnection:(HTTPConnection *)conn didReceiveRequest:(HTTPServerRequest *)mess {
+    @synchronized(self) {
+        _requestCount++;
+        _calledOnMainThread = _calledOnMainThread || [NSThread isMainThread];
+    }
+    NSURL *url = (__bridge_transfer NSURL *)CFHTTPMessageCopyRequestURL(mess.request);
+    if ([url.path isEqualToString:@"/hold"]) {
+        return;
+    }
+    NSData *body = [url.absoluteString dataUsingEncoding:NSUTF8StringEncoding];
+    if ([url.path isEqualToString:@"/large"] || [url.path isEqualToString:@"/stream"]) {
+        body = _largeBody;
+    }
+    CFHTTPMessageRef response = CFHTTPMessageCreateResponse(kCFAllocatorDefault, 200, NULL, kCFHTTPVersion1_1);
+    CFHTTPMessageSetHeaderFieldValue(response,
+                                     (__bridge CFStringRef)@"Content-Length",
+                                     (__bridge CFStringRef)[NSString stringWithFormat:@"%lu", (unsigned long)body.length]);
+    if ([url.path isEqualToString:@"/stream"]) {
+        [mess setResponseBodyStream:[NSInputStream inputStreamWithData:body]];
+    } else {
+        CFHTTPMessageSetBody(response, (__bridge CFDataRef)body);
+    }
+    [mess setResponse:response];
+    CFRelease(response);
+}
+
+// Returns the length of the response once its header was received, or NSNotFound.
+- (NSUInteger)lengthOfResponse:(NSData *)data {
+    NSData *separator = [@"\r\n\r\n" dataUsingEncoding:NSUTF8StringEncoding];
+    NSRange headerEnd = [data rangeOfData:separator options:0 range:NSMakeRange(0, data.length)];
+    if (headerEnd.location == NSNotFound) {
+        return NSNotFound;
+    }
+    NSUInteger headerLength = NSMaxRange(headerEnd);
+    CFHTTPMessageRef message = CFHTTPMessageCreateEmpty(kCFAllocatorDefault, FALSE);
+    CFHTTPMessageAppendBytes(message, data.bytes, headerLength);
+    NSString *contentLength = (__bridge_transfer NSString *)CFHTTPMessageCopyHeaderFieldValue(message, (__bridge CFStringRef)@"Content-Length");
+    CFRelease(message);
+    return headerLength + (NSUInteger)contentLength.integerValue;
+}
+
+- (NSData *)bodyOfResponse:(NSString *)response {
+    NSData *data = [response dataUsingEncoding:NSISOLatin1StringEncoding];
+    NSRange headerEnd = [data rangeOfData:[@"\r\n\r\n" dataUsingEncoding:NSUTF8StringEncoding]
+                                  options:0
+                                    range:NSMakeRange(0, data.length)];
+    return headerEnd.location == NSNotFound ? nil : [data subdataWithRange:NSMakeRange(NSMaxRange(headerEnd), data.length - NSMaxRange(headerEnd))];
+}
+
+// Sends the request on a new connection and blocks until the response is read or the server
+// closes the connection.
+- (NSString *)responseToRequest:(NSString *)request {
+    return [self responseToRequest:request readDelay:0];
+}
+
+// Waits @c readDelay seconds before reading the response, so that the server fills the socket
+// buffers and has to wait for the client.
+- (NSString *)responseToRequest:(NSString *)request readDelay:(NSTimeInterval)readDelay {
+    int fd = [self connectClient];
+    if (fd < 0) {
+        return nil;
+    }
+    [self send:request on:fd];
+    if (readDelay > 0) {
+        [NSThread sleepForTimeInterval:readDelay];
+    }
+    NSString *response = [self readResponseFrom:fd];
+    close(fd);
+    return response;
+}
+
+// Connects a blocking client socket to the server, or returns -1.
+- (int)connectClient {
+    int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    struct timeval timeout = { 5, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_len = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_port = htons([_server port]);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+- (BOOL)send:(NSString *)request on:(int)fd {
+    NSData *requestData = [request dataUsingEncoding:NSUTF8StringEncoding];
+    return send(fd, requestData.bytes, requestData.length, 0) == (ssize_t)requestData.length;
+}
+
+// Whether the server closed the connection, without waiting.
+- (BOOL)isClosed:(int)fd {
+    uint8_t byte;
+    ssize_t amount = recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    return amount == 0 || (amount < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+}
+
+- (BOOL)waitForClose:(int)fd timeout:(NSTimeInterval)timeout {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:timeout];
+    while (![self isClosed:fd]) {
+        if ([deadline timeIntervalSinceNow] < 0) {
+            return NO;
+        }
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    return YES;
+}
+
+- (BOOL)waitForConnectionCount:(NSUInteger)count {
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:2];
+    while ([_server connectionCount] != count) {
+        if ([deadline timeIntervalSinceNow] < 0) {
+            return NO;
+        }
+        [NSThread sleepForTimeInterval:0.01];
+    }
+    return YES;
+}
+
+- (NSString *)readResponseFrom:(int)fd {
+    NSMutableData *response = [NSMutableData data];
+    NSUInteger responseLength = NSNotFound;
+    uint8_t buffer[16 * 1024];
+    while (response.length < responseLength) {
+        ssize_t amount = recv(fd, buffer, sizeof(buffer), 0);
+        if (amount <= 0) {
+            break;
+        }
+        [response appendBytes:buffer length:amount];
+        if (responseLength == NSNotFound) {
+            responseLength = [self lengthOfResponse:response];
+        }
+    }
+    // Latin-1 maps every byte, so binary bodies survive the round trip through NSString.
+    return [[NSString alloc] initWithData:response encoding:NSISOLatin1StringEncoding];
+}
+
+// The test blocks the main thread, so the request is served without the main run loop.
+- (void)testServesRequestWithoutRunLoop {
+    NSString *response = [self responseToRequest:kRedirectRequest];
+
+    XCTAssertTrue([response hasPrefix:@"HTTP/1.1 200"], @"%@", response);
+    XCTAssertTrue([response hasSuffix:@"http://127.0.0.1/callback?code=abc&state=xyz"], @"%@", response);
+    @synchronized(self) {
+        XCTAssertEqual(_requestCount, 1u);
+        XCTAssertFalse(_calledOnMainThread);
+    }
+}
+
+- (void)testClosesConnectionOnMalformedRequest {
+    NSString *response = [self responseToRequest:@"NOT HTTP\r\n\r\n"];
+
+    XCTAssertEqualObjects(response, @"");
+    @synchronized(self) {
+        XCTAssertEqual(_requestCount, 0u);
+    }
+}
+
+- (void)testServesSequentialConnections {
+    for (int i = 0; i < 10; i++) {
+        XCTAssertTrue([[self responseToRequest:kRedirectRequest] hasPrefix:@"HTTP/1.1 200"]);
+    }
+    @synchronized(self) {
+        XCTAssertEqual(_requestCount, 10u);
+    }
+}
+
+- (void)testWritesLargeBodyToSlowReader {
+    NSString *response = [self responseToRequest:@"GET /large HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n"
+                                       readDelay:0.2];
+
+    XCTAssertTrue([response hasPrefix:@"HTTP/1.1 200"]);
+    XCTAssertEqualObjects([self bodyOfResponse:response], _largeBody);
+}
+
+- (void)testWritesStreamedBody {
+    NSString *response = [self responseToRequest:@"GET /stream HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n"
+                                       readDelay:0.2];
+
+    XCTAssertTrue([response hasPrefix:@"HTTP/1.1 200"]);
+    XCTAssertEqualObjects([self bodyOfResponse:response], _largeBody);
+}
+
+- (void)testFallsBackToNextPortWhenPortIsInUse {
+    HTTPServer *server = [[HTTPServer alloc] init];
+    [server setPort:[_server port]];
+    [server setFallbackPorts:NSMakeRange([_server port] - 8, 8)];
+    NSError *error = nil;
+
+    XCTAssertTrue([server start:&error], @"%@", error);
+    XCTAssertNotEqual([server port], [_server port]);
+    XCTAssertGreaterThanOrEqual([server port], [_server port] - 8);
+    XCTAssertTrue([server hasIPv4Socket]);
+    [server stop];
+}
+
+- (void)testFailsWhenPortIsInUseWithoutFallback {
+    HTTPServer *server = [[HTTPServer alloc] init];
+    [server setPort:[_server port]];
+    NSError *error = nil;
+
+    XCTAssertFalse([server start:&error]);
+    XCTAssertEqualObjects(error.domain, TCPServerErrorDomain);
+}
+
+#pragma mark - Limits
+
+- (void)testRefusesConnectionsBeyondLimit {
+    [self startServerWithConfiguration:^(HTTPServer *server) {
+        [server setMaxConnections:4];
+    }];
+    int clients[4];
+    for (int i = 0; i < 4; i++) {
+        clients[i] = [self connectClient];
+    }
+    XCTAssertTrue([self waitForConnectionCount:4]);
+
+    int refused = [self connectClient];
+    XCTAssertTrue([self waitForClose:refused timeout:1]);
+    XCTAssertEqual([_server connectionCount], 4u);
+    for (int i = 0; i < 4; i++) {
+        XCTAssertFalse([self isClosed:clients[i]]);
+        close(clients[i]);
+    }
+    close(refused);
+}
+
+- (void)testClosesIdleConnection {
+    [self startServerWithConfiguration:^(HTTPServer *server) {
+        [server setIdleTimeout:0.2];
+    }];
+    int fd = [self connectClient];
+
+    XCTAssertTrue([self waitForClose:fd timeout:2]);
+    XCTAssertTrue([self waitForConnectionCount:0]);
+    close(fd);
+}
+
+// A client sending blank lines, which the parser skips before a request, does not extend the idle
+// deadline.
+- (void)testIdleDeadlineIsNotExtendedByBlankLines {
+    [self startServerWithConfiguration:^(HTTPServer *server) {
+        [server setIdleTimeout:0.3];
+        [server setHeaderTimeout:5];
+    }];
+    int fd = [self connectClient];
+    NSDate *start = [NSDate date];
+    while (![self isClosed:fd] && [start timeIntervalSinceNow] > -3) {
+        [self send:@"\r\n" on:fd];
+        [NSThread sleepForTimeInterval:0.05];
+    }
+
+    XCTAssertTrue([self isClosed:fd]);
+    XCTAssertLessThan(-[start timeIntervalSinceNow], 1.5);
+    XCTAssertTrue([self waitForConnectionCount:0]);
+    close(fd);
+}
+
+- (void)testClosesConnectionOnResponseDeadline {
+    [self startServerWithConfiguration:^(HTTPServer *server) {
+        [server setResponseTimeout:0.2];
+    }];
+    int fd = [self connectClient];
+    [self send:@"GET /hold HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n" on:fd];
+
+    XCTAssertTrue([self waitForClose:fd timeout:2]);
+    XCTAssertTrue([self waitForConnectionCount:0]);
+    @synchronized(self) {
+        XCTAssertEqual(_requestCount, 1u);
+    }
+    close(fd);
+}
+
+// A client sending one byte at a time does not extend the header deadline.
+- (void)testHeaderDeadlineIsNotExtendedByTricklingBytes {
+    [self startServerWithConfiguration:^(HTTPServer *server) {
+        [server setIdleTimeout:5];
+        [server setHeaderTimeout:0.3];
+    }];
+    int fd = [self connectClient];
+    NSDate *start = [NSDate date];
+    [self send:@"GET /callback HTTP/1.1\r\n" on:fd];
+    while (![self isClosed:fd] && [start timeIntervalSinceNow] > -3) {
+        [self send:@"X" on:fd];
+        [NSThread sleepForTimeInterval:0.05];
+    }
+
+    XCTAssertTrue([self isClosed:fd]);
+    XCTAssertLessThan(-[start timeIntervalSinceNow], 1.5);
+    close(fd);
+}
+
+- (void)testClosesConnectionOnBodyDeadline {
+    [self startServerWithConfiguration:^(HTTPServer *server) {
+        [server setBodyTimeout:0.2];
+    }];
+    int fd = [self connectClient];
+    [self send:@"POST /callback HTTP/1.1\r\nContent-Length: 10\r\n\r\nabc" on:fd];
+
+    XCTAssertTrue([self waitForClose:fd timeout:2]);
+    @synchronized(self) {
+        XCTAssertEqual(_requestCount, 0u);
+    }
+    close(fd);
+}
+
+- (void)testClosesConnectionOnOversizedRequest {
+    [self startServerWithConfiguration:^(HTTPServer *server) {
+        [server setMaxHeaderLength:1024];
+    }];
+    NSString *longTarget = [@"/callback?" stringByPaddingToLength:4096 withString:@"x" startingAtIndex:0];
+    NSString *request = [NSString stringWithFormat:@"GET %@ HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", longTarget];
+
+    XCTAssertEqualObjects([self responseToRequest:request], @"");
+    @synchronized(self) {
+        XCTAssertEqual(_requestCount, 0u);
+    }
+}
+
+- (void)testClosesConnectionAfterConnectionCloseRequest {
+    int fd = [self connectClient];
+    [self send:@"GET /callback HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n" on:fd];
+
+    XCTAssertTrue([[self readResponseFrom:fd] hasPrefix:@"HTTP/1.1 200"]);
+    XCTAssertTrue([self waitForClose:fd timeout:1]);
+    close(fd);
+}
+
+- (void)testStopClosesIdleConnections {
+    int fd = [self connectClient];
+    XCTAssertTrue([self waitForConnectionCount:1]);
+
+    [_server stop];
+    XCTAssertTrue([self waitForClose:fd timeout:1]);
+    close(fd);
+}
+
+// Many clients trickle header bytes while the connection limit is reached. Clients beyond the
+// limit are refused, the others are closed at the header deadline, and the listener then serves
+// the redirect.
+- (void)testManySlowClientsStress {
+    static const int kSlowClientCount = 64;
+    [self startServerWithConfiguration:^(HTTPServer *server) {
+        [server setMaxConnections:16];
+        [server setIdleTimeout:0.5];
+        [server setHeaderTimeout:0.5];
+    }];
+    int clients[kSlowClientCount];
+    for (int i = 0; i < kSlowClientCount; i++) {
+        clients[i] = [self connectClient];
+        [self send:@"GET /callback?" on:clients[i]];
+    }
+
+    NSDate *start = [NSDate date];
+    int openCount = kSlowClientCount;
+    while (0 < openCount && [start timeIntervalSinceNow] > -5) {
+        openCount = 0;
+        for (int i = 0; i < kSlowClientCount; i++) {
+            if (![self isClosed:clients[i]]) {
+                [self send:@"x" on:clients[i]];
+                openCount++;
+            }
+        }
+        [NSThread sleepForTimeInterval:0.05];
+    }
+
+    XCTAssertEqual(openCount, 0);
+    XCTAssertLessThan(-[start timeIntervalSinceNow], 2.5);
+    XCTAssertTrue([self waitForConnectionCount:0]);
+    XCTAssertTrue([[self responseToRequest:kRedirectRequest] hasPrefix:@"HTTP/1.1 200"]);
+    @synchronized(self) {
+        XCTAssertEqual(_requestCount, 1u);
+    }
+    for (int i = 0; i < kSlowClientCount; i++) {
+        close(clients[i]);
+    }
+}
+
+#pragma mark - Benchmarks
+
+/*! @brief Measures the time from connecting to the listener to receiving the complete response.
+ */
+- (void)testAcceptToResponseLatencyPerformance {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < kBenchmarkIterations; i++) {
+            XCTAssertNotNil([self responseToRequest:kRedirectRequest]);
+        }
+    }];
+}
+
+/*! @brief Measures writing large response bodies, from memory and from a stream.
+ */
+- (void)testLargeResponsePerformance {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 10; i++) {
+            XCTAssertNotNil([self responseToRequest:@"GET /large HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n"]);
+            XCTAssertNotNil([self responseToRequest:@"GET /stream HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n"]);
+        }
+    }];
+}
+
+@end
+
+#endif
@@ -0,0 +1,127 @@
+/*! @file OKTMetricsRegistryTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OKTLatencyHistogram.h"
+#import "OKTMetricsRegistry.h"
+
+// Ignore warnings about "Use of GNU statement expression extension" which is raised by our use of
+// the XCTAssert___ macros.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wgnu"
+
+@interface OKTMetricsRegistryTests : XCTestCase
+@end
+
+/*! @brief Unit tests for @c OKTMetricsRegistry and @c OKTLatencyHistogram.
+ */
+@implementation OKTMetricsRegistryTests
+
+- (void)testEmptyHistogram {
+  OKTLatencyHistogram *histogram = [[OKTLatencyHistogram alloc] init];
+  XCTAssertEqual(histogram.count, 0u);
+  XCTAssertEqual(histogram.mean, 0);
+  XCTAssertEqual([histogram latencyAtPercentile:99], 0);
+}
+
+- (void)testHistogramPercentiles {
+  OKTLatencyHistogram *histogram = [[OKTLatencyHistogram alloc] init];
+  // 1ms to 1s in 1ms steps
+  for (int i = 1; i <= 1000; i++) {
+    [histogram recordLatency:i / 1000.0];
+  }
+
+  XCTAssertEqual(histogram.count, 1000u);
+  XCTAssertEqualWithAccuracy(histogram.minimum, 0.001, 1e-9);
+  XCTAssertEqualWithAccuracy(histogram.maximum, 1.0, 1e-9);
+  XCTAssertEqualWithAccuracy(histogram.mean, 0.5005, 1e-6);
+  XCTAssertEqualWithAccuracy([histogram latencyAtPercentile:50], 0.5, 0.5 * 0.04);
+  XCTAssertEqualWithAccuracy([histogram latencyAtPercentile:99], 0.99, 0.99 * 0.04);
+  XCTAssertEqualWithAccuracy([histogram latencyAtPercentile:100], 1.0, 1e-9);
+}
+
+- (void)testHistogramClampsOutOfRangeLatencies {
+  OKTLatencyHistogram *histogram = [[OKTLatencyHistogram alloc] init];
+  [histogram recordLatency:-1];
+  [histogram recordLatency:24 * 60 * 60];
+
+  XCTAssertEqual(histogram.count, 2u);
+  XCTAssertEqual(histogram.minimum, 0);
+  XCTAssertEqualWithAccuracy(histogram.maximum, 4294.967295, 1e-6);
+}
+
+- (void)testHistogramCopyIsIndependent {
+  OKTLatencyHistogram *histogram = [[OKTLatencyHistogram alloc] init];
+  [histogram recordLatency:0.1];
+  OKTLatencyHistogram *copy = [histogram copy];
+  [histogram recordLatency:0.2];
+
+  XCTAssertEqual(copy.count, 1u);
+  XCTAssertEqualWithAccuracy([copy latencyAtPercentile:100], 0.1, 1e-9);
+}
+
+- (void)testCountersAndSnapshot {
+  OKTMetricsRegistry *registry = [[OKTMetricsRegistry alloc] init];
+  [registry incrementCounter:OKTMetricTokenRefreshes];
+  [registry incrementCounter:OKTMetricTokenRefreshes];
+  [registry recordLatency:0.25 forOperation:OKTMetricOperationTokenRefresh];
+
+  OKTMetricsSnapshot *snapshot = [registry snapshot];
+  [registry incrementCounter:OKTMetricTokenRefreshes];
+
+  XCTAssertEqual([snapshot valueOfCounter:OKTMetricTokenRefreshes], 2u);
+  XCTAssertEqual([snapshot valueOfCounter:OKTMetricKeychainReads], 0u);
+  XCTAssertEqual(snapshot.latencies[OKTMetricOperationTokenRefresh].count, 1u);
+
+  [registry reset];
+  XCTAssertEqual([registry snapshot].counters.count, 0u);
+}
+
+- (void)testTextRepresentation {
+  OKTMetricsRegistry *registry = [[OKTMetricsRegistry alloc] init];
+  [registry incrementCounter:OKTMetricKeychainWrites];
+  [registry recordLatency:0.5 forOperation:OKTMetricOperationKeychainWrite];
+
+  NSString *expected =
+      @"# TYPE okta_oidc_keychain_writes_total counter\n"
+       "okta_oidc_keychain_writes_total 1\n"
+       "# TYPE okta_oidc_latency_seconds summary\n"
+       "okta_oidc_latency_seconds{operation=\"keychain_write\",quantile=\"0.5\"} 0.500000\n"
+       "okta_oidc_latency_seconds{operation=\"keychain_write\",quantile=\"0.9\"} 0.500000\n"
+       "okta_oidc_latency_seconds{operation=\"keychain_write\",quantile=\"0.99\"} 0.500000\n"
+       "okta_oidc_latency_seconds{operation=\"keychain_write\",quantile=\"0.999\"} 0.500000\n"
+       "okta_oidc_latency_seconds_sum{operation=\"keychain_write\"} 0.500000\n"
+       "okta_oidc_latency_seconds_count{operation=\"keychain_write\"} 1\n";
+  XCTAssertEqualObjects([[registry snapshot] textRepresentation], expected);
+}
+
+- (void)testRecordingPerformance {
+  OKTMetricsRegistry *registry = [[OKTMetricsRegistry alloc] init];
+  [self measureBlock:^{
+    for (int i = 0; i < 100000; i++) {
+      [registry recordLatency:i / 1e6 forOperation:OKTMetricOperationTokenRefresh];
+    }
+  }];
+}
+
+@end
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,216 @@
+/*! @file OKTNetworkMetricsTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OKTNetworkMetrics.h"
+#import "OktaNetworkRequestCustomizationDelegate.h"
+
+// Ignore warnings about "Use of GNU statement expression extension" which is raised by our use of
+// the XCTAssert___ macros.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wgnu"
+// The session metrics classes are only meant to be created by NSURLSession.
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+/*! @brief A transaction with fixed phase dates.
+ */
+@interface OKTTransactionMetricsFake : NSURLSessionTaskTransactionMetrics
+@end
+
+@implementation OKTTransactionMetricsFake
+
+- (NSDate *)base {
+  return [NSDate dateWithTimeIntervalSinceReferenceDate:1000];
+}
+
+- (NSURLRequest *)request {
+  return [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://example.com/token"]];
+}
+
+- (NSURLResponse *)response {
+  return [[NSHTTPURLResponse alloc] initWithURL:self.request.URL
+                                     statusCode:200
+                                    HTTPVersion:@"HTTP/1.1"
+                                   headerFields:nil];
+}
+
+- (NSDate *)domainLookupStartDate {
+  return self.base;
+}
+
+- (NSDate *)domainLookupEndDate {
+  return [self.base dateByAddingTimeInterval:0.01];
+}
+
+- (NSDate *)connectStartDate {
+  return [self.base dateByAddingTimeInterval:0.01];
+}
+
+- (NSDate *)secureConnectionStartDate {
+  return [self.base dateByAddingTimeInterval:0.02];
+}
+
+- (NSDate *)secureConnectionEndDate {
+  return [self.base dateByAddingTimeInterval:0.05];
+}
+
+- (NSDate *)connectEndDate {
+  return [self.base dateByAddingTimeInterval:0.05];
+}
+
+- (NSDate *)requestStartDate {
+  return [self.base dateByAddingTimeInterval:0.05];
+}
+
+- (NSDate *)responseStartDate {
+  return [self.base dateByAddingTimeInterval:0.15];
+}
+
+- (NSDate *)responseEndDate {
+  return [self.base dateByAddingTimeInterval:0.2];
+}
+
+- (NSString *)networkProtocolName {
+  return @"h2";
+}
+
+- (BOOL)isReusedConnection {
+  return NO;
+}
+
+@end
+
+/*! @brief Task metrics with one @c OKTTransactionMetricsFake transaction.
+ */
+@interface OKTTaskMetricsFake : NSURLSessionTaskMetrics
+@end
+
+@implementation OKTTaskMetricsFake
+
+- (NSArray<NSURLSessionTaskTransactionMetrics *> *)transactionMetrics {
+  return @[ [[OKTTransactionMetricsFake alloc] init] ];
+}
+
+- (NSDateInterval *)taskInterval {
+  return [[NSDateInterval alloc] initWithStartDate:[NSDate dateWithTimeIntervalSinceReferenceDate:1000]
+                                          duration:0.25];
+}
+
+- (NSUInteger)redirectCount {
+  return 0;
+}
+
+@end
+
+/*! @brief Records the metrics it receives.
+ */
+@interface OKTMetricsDelegateFake : NSObject <OktaNetworkRequestCustomizationDelegate>
+@property(nonatomic) NSMutableArray<OKTNetworkMetrics *> *metrics;
+@end
+
+@implementation OKTMetricsDelegateFake
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _metrics = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (nullable NSURLRequest *)customizableURLRequest:(nullable NSURLRequest *)request {
+  return request;
+}
+
+- (void)didReceiveResponse:(nullable NSURLResponse *)response {
+}
+
+- (void)didCollectMetrics:(OKTNetworkMetrics *)metrics {
+  [_metrics addObject:metrics];
+}
+
+@end
+
+@interface OKTNetworkMetricsTests : XCTestCase
+@end
+
+/*! @brief Unit tests for @c OKTNetworkMetrics and @c OKTNetworkMetricsCollector.
+ */
+@implementation OKTNetworkMetricsTests
+
+- (void)testMetricsFromTransaction {
+  OKTNetworkMetrics *metrics =
+      [[OKTNetworkMetrics alloc] initWithTaskMetrics:[[OKTTaskMetricsFake alloc] init]
+                                                task:nil
+                                           operation:OKTNetworkOperationTokenRefresh];
+
+  XCTAssertEqualObjects(metrics.operation, OKTNetworkOperationTokenRefresh);
+  XCTAssertEqualObjects(metrics.URL.absoluteString, @"https://example.com/token");
+  XCTAssertEqual(metrics.statusCode, 200);
+  XCTAssertEqualWithAccuracy(metrics.domainLookupDuration, 0.01, 0.0001);
+  XCTAssertEqualWithAccuracy(metrics.connectDuration, 0.04, 0.0001);
+  XCTAssertEqualWithAccuracy(metrics.secureConnectionDuration, 0.03, 0.0001);
+  XCTAssertEqualWithAccuracy(metrics.timeToFirstByte, 0.1, 0.0001);
+  XCTAssertEqualWithAccuracy(metrics.transferDuration, 0.05, 0.0001);
+  XCTAssertEqualWithAccuracy(metrics.totalDuration, 0.25, 0.0001);
+  XCTAssertFalse(metrics.reusedConnection);
+  XCTAssertEqualObjects(metrics.networkProtocolName, @"h2");
+}
+
+- (void)testCollectorDeliversToTaggedDelegate {
+  OKTMetricsDelegateFake *delegate = [[OKTMetricsDelegateFake alloc] init];
+  OKTNetworkMetricsCollector *collector = [OKTNetworkMetricsCollector sharedCollector];
+  NSURLRequest *request =
+      [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://example.com/userinfo"]];
+  NSURLRequest *taggedRequest = [collector request:request
+                               taggedWithOperation:OKTNetworkOperationUserInfo
+                                          delegate:delegate];
+  XCTAssertEqualObjects([OKTNetworkMetricsCollector operationOfRequest:taggedRequest],
+                        OKTNetworkOperationUserInfo);
+
+  // A customized copy keeps the tags.
+  NSMutableURLRequest *customizedRequest = [taggedRequest mutableCopy];
+  [customizedRequest setValue:@"value" forHTTPHeaderField:@"X-Custom"];
+  NSURLSessionTask *task = [[NSURLSession sharedSession] dataTaskWithRequest:customizedRequest];
+  [collector collectMetrics:[[OKTTaskMetricsFake alloc] init] forTask:task];
+
+  XCTAssertEqual(delegate.metrics.count, 1u);
+  XCTAssertEqualObjects(delegate.metrics.firstObject.operation, OKTNetworkOperationUserInfo);
+}
+
+- (void)testUntaggedTaskIsIgnored {
+  OKTMetricsDelegateFake *delegate = [[OKTMetricsDelegateFake alloc] init];
+  NSURLRequest *request =
+      [NSURLRequest requestWithURL:[NSURL URLWithString:@"https://example.com/userinfo"]];
+  NSURLRequest *taggedRequest = [[OKTNetworkMetricsCollector sharedCollector] request:request
+                                                                  taggedWithOperation:nil
+                                                                             delegate:nil];
+  XCTAssertEqual(taggedRequest, request);
+
+  NSURLSessionTask *task = [[NSURLSession sharedSession] dataTaskWithRequest:request];
+  [[OKTNetworkMetricsCollector sharedCollector] collectMetrics:[[OKTTaskMetricsFake alloc] init]
+                                                       forTask:task];
+  XCTAssertEqual(delegate.metrics.count, 0u);
+}
+
+@end
+
+#pragma GCC diagnostic pop
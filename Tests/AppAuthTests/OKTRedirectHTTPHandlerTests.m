@@ -13,6 +13,7 @@
 #import <XCTest/XCTest.h>
 #import "OKTRedirectHTTPHandler.h"
 #import "OKTLoopbackHTTPServer.h"
+#import "OKTRedirectRouter.h"
 
 @interface OKTRedirectHTTPHandlerTests<OKTExternalUserAgentSession> : XCTestCase
 
@@ -38,7 +39,7 @@
     
     CFStringRef requestMethod = CFSTR("GET");
     CFHTTPMessageRef myRequest = CFHTTPMessageCreateRequest(kCFAllocatorDefault, requestMethod, myURL, kCFHTTPVersion1_1);
-    HTTPConnection *connection = [[HTTPConnection alloc] initWithPeerAddress:nil inputStream:nil outputStream:nil forServer:nil];
+    HTTPConnection *connection = [[HTTPConnection alloc] initWithPeerAddress:nil socket:-1 forServer:nil];
     HTTPServerRequest *request = [[HTTPServerRequest alloc] initWithRequest:myRequest connection:connection];
     BOOL isOptionsRequest = [handler isOptionsHTTPServerRequest: request];
     XCTAssertFalse(isOptionsRequest);
@@ -66,7 +67,7 @@
     CFURLRef myURL = CFURLCreateWithString(kCFAllocatorDefault, url, NULL);
     CFStringRef requestMethod = CFSTR("GET");
     CFHTTPMessageRef myRequest = CFHTTPMessageCreateRequest(kCFAllocatorDefault, requestMethod, myURL, kCFHTTPVersion1_1);
-    HTTPConnection *connection = [[HTTPConnection alloc] initWithPeerAddress:nil inputStream:nil outputStream:nil forServer:nil];
+    HTTPConnection *connection = [[HTTPConnection alloc] initWithPeerAddress:nil socket:-1 forServer:nil];
     HTTPServerRequest *request = [[HTTPServerRequest alloc] initWithRequest:myRequest connection:connection];
     
     self.resumeExternalUserAgentFlowWithURLCalled = NO;
@@ -89,7 +90,7 @@
     CFURLRef myURL = CFURLCreateWithString(kCFAllocatorDefault, url, NULL);
     CFStringRef requestMethod = CFSTR("OPTIONS");
     CFHTTPMessageRef myRequest = CFHTTPMessageCreateRequest(kCFAllocatorDefault, requestMethod, myURL, kCFHTTPVersion1_1);
-    HTTPConnection *connection = [[HTTPConnection alloc] initWithPeerAddress:nil inputStream:nil outputStream:nil forServer:nil];
+    HTTPConnection *connection = [[HTTPConnection alloc] initWithPeerAddress:nil socket:-1 forServer:nil];
     HTTPServerRequest *request = [[HTTPServerRequest alloc] initWithRequest:myRequest connection:connection];
     CFStringRef privateNetworkHeader = CFSTR("Access-Control-Request-Private-Network");
     CFStringRef privateNetworkValue = CFSTR("true");
@@ -121,6 +122,65 @@
     XCTAssertTrue(contentLengthHeaderExists);
 }
 
+- (void)testDidReceiveRequestDelegate_Router {
+    OKTRedirectHTTPHandler *handler = [OKTRedirectHTTPHandler new];
+    handler.router = [[OKTRedirectRouter alloc] init];
+    [handler.router registerFlow:(id<OKTExternalUserAgentSession>)self forState:@"xyz"];
+    HTTPConnection *connection = [[HTTPConnection alloc] initWithPeerAddress:nil socket:-1 forServer:nil];
+
+    CFURLRef otherURL = CFURLCreateWithString(kCFAllocatorDefault, CFSTR("http://127.0.0.1/?code=abc&state=other"), NULL);
+    CFHTTPMessageRef otherRequest = CFHTTPMessageCreateRequest(kCFAllocatorDefault, CFSTR("GET"), otherURL, kCFHTTPVersion1_1);
+    HTTPServerRequest *request = [[HTTPServerRequest alloc] initWithRequest:otherRequest connection:connection];
+    self.resumeExternalUserAgentFlowWithURLCalled = NO;
+    [handler HTTPConnection:connection didReceiveRequest:request];
+    XCTAssertFalse(self.resumeExternalUserAgentFlowWithURLCalled);
+    XCTAssertEqual(CFHTTPMessageGetResponseStatusCode(request.response), 404);
+    CFRelease(otherRequest);
+    CFRelease(otherURL);
+
+    CFURLRef myURL = CFURLCreateWithString(kCFAllocatorDefault, CFSTR("http://127.0.0.1/?code=abc&state=xyz"), NULL);
+    CFHTTPMessageRef myRequest = CFHTTPMessageCreateRequest(kCFAllocatorDefault, CFSTR("GET"), myURL, kCFHTTPVersion1_1);
+    request = [[HTTPServerRequest alloc] initWithRequest:myRequest connection:connection];
+    [handler HTTPConnection:connection didReceiveRequest:request];
+    XCTAssertTrue(self.resumeExternalUserAgentFlowWithURLCalled);
+    XCTAssertEqual(CFHTTPMessageGetResponseStatusCode(request.response), 200);
+    XCTAssertEqual(handler.router.flowCount, 0u);
+    CFRelease(myRequest);
+    CFRelease(myURL);
+}
+
+// The persistent listener stays open after a flow completes, and serves the next flow without
+// binding again.
+- (void)testPersistentListenerServesSequentialFlows {
+    OKTRedirectHTTPHandler *handler = [OKTRedirectHTTPHandler new];
+    handler.router = [[OKTRedirectRouter alloc] init];
+    NSError *error = nil;
+    NSURL *listenerURL = [handler startPersistentHTTPListener:nil withPort:0 fallbackPorts:NSMakeRange(0, 0) error:&error];
+    XCTAssertNotNil(listenerURL, @"%@", error);
+
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+    for (NSString *state in @[ @"first", @"second" ]) {
+        [handler.router registerFlow:(id<OKTExternalUserAgentSession>)self forState:state];
+        self.resumeExternalUserAgentFlowWithURLCalled = NO;
+        NSURL *redirectURL = [NSURL URLWithString:[NSString stringWithFormat:@"?code=abc&state=%@", state] relativeToURL:listenerURL];
+        XCTestExpectation *responded = [self expectationWithDescription:state];
+        [[session dataTaskWithURL:redirectURL completionHandler:^(NSData *data, NSURLResponse *response, NSError *taskError) {
+            XCTAssertNil(taskError);
+            XCTAssertEqual(((NSHTTPURLResponse *)response).statusCode, 200);
+            [responded fulfill];
+        }] resume];
+        [self waitForExpectationsWithTimeout:5 handler:nil];
+
+        XCTAssertTrue(self.resumeExternalUserAgentFlowWithURLCalled);
+        XCTAssertEqualObjects([handler startPersistentHTTPListener:nil withPort:0 fallbackPorts:NSMakeRange(0, 0) error:NULL], listenerURL);
+    }
+    XCTAssertEqual(handler.router.flowCount, 0u);
+
+    [session invalidateAndCancel];
+    [handler cancelHTTPListener];
+    XCTAssertNil(handler.listenerURL);
+}
+
 - (BOOL)resumeExternalUserAgentFlowWithURL:(NSURL *)URL {
     self.resumeExternalUserAgentFlowWithURLCalled = YES;
     return true;
@@ -0,0 +1,219 @@
+/*! @file OKTRedirectRouterTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OKTError.h"
+#import "OKTExternalUserAgentSession.h"
+#import "OKTRedirectRouter.h"
+
+// Ignore warnings about "Use of GNU statement expression extension" which is raised by our use of
+// the XCTAssert___ macros.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wgnu"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*! @brief A flow that consumes redirects to its redirect URL, and records what it received.
+ */
+@interface OKTRedirectRouterTestFlow : NSObject <OKTExternalUserAgentSession>
+
+@property(nonatomic, copy) NSString *redirectPrefix;
+@property(nonatomic, copy, nullable) NSURL *resumedURL;
+@property(nonatomic, copy, nullable) NSError *error;
+@property(nonatomic, copy, nullable) void (^onFailure)(void);
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+@implementation OKTRedirectRouterTestFlow
+
+- (void)cancel {
+}
+
+- (void)cancelWithCompletion:(nullable void (^)(void))completion {
+}
+
+- (BOOL)resumeExternalUserAgentFlowWithURL:(NSURL *)URL {
+  if (![URL.absoluteString hasPrefix:_redirectPrefix]) {
+    return NO;
+  }
+  _resumedURL = URL;
+  return YES;
+}
+
+- (void)failExternalUserAgentFlowWithError:(NSError *)error {
+  _error = error;
+  if (_onFailure) {
+    _onFailure();
+  }
+}
+
+@end
+
+@interface OKTRedirectRouterTests : XCTestCase
+@end
+
+/*! @brief Unit tests for @c OKTRedirectRouter.
+ */
+@implementation OKTRedirectRouterTests {
+  OKTRedirectRouter *_router;
+}
+
+- (void)setUp {
+  [super setUp];
+  _router = [[OKTRedirectRouter alloc] init];
+}
+
+- (OKTRedirectRouterTestFlow *)registerFlowForState:(NSString *)state {
+  OKTRedirectRouterTestFlow *flow = [[OKTRedirectRouterTestFlow alloc] init];
+  flow.redirectPrefix = @"com.example.app:/callback";
+  XCTAssertTrue([_router registerFlow:flow forState:state]);
+  return flow;
+}
+
+- (void)testDispatchesToFlowRegisteredForState {
+  NSMutableArray<OKTRedirectRouterTestFlow *> *flows = [NSMutableArray array];
+  for (int i = 0; i < 100; i++) {
+    [flows addObject:[self registerFlowForState:[NSString stringWithFormat:@"state%d", i]]];
+  }
+  NSURL *URL = [NSURL URLWithString:@"com.example.app:/callback?code=abc&state=state42"];
+
+  XCTAssertTrue([_router resumeExternalUserAgentFlowWithURL:URL]);
+  XCTAssertEqualObjects(flows[42].resumedURL, URL);
+  XCTAssertNil(flows[41].resumedURL);
+  XCTAssertNil(flows[43].resumedURL);
+  XCTAssertEqual(_router.flowCount, 99u);
+
+  // The flow is unregistered once it consumed its redirect.
+  XCTAssertFalse([_router resumeExternalUserAgentFlowWithURL:URL]);
+}
+
+- (void)testDispatchesLoopbackRedirect {
+  OKTRedirectRouterTestFlow *flow = [self registerFlowForState:@"xyz"];
+  flow.redirectPrefix = @"http://127.0.0.1:63875/";
+  NSURL *URL = [NSURL URLWithString:@"http://127.0.0.1:63875/?code=abc&state=xyz"];
+
+  XCTAssertTrue([_router resumeExternalUserAgentFlowWithURL:URL]);
+  XCTAssertEqualObjects(flow.resumedURL, URL);
+}
+
+- (void)testReadsStateFromFragment {
+  OKTRedirectRouterTestFlow *flow = [self registerFlowForState:@"xyz"];
+  NSURL *URL = [NSURL URLWithString:@"com.example.app:/callback#code=abc&state=xyz"];
+
+  XCTAssertTrue([_router resumeExternalUserAgentFlowWithURL:URL]);
+  XCTAssertEqualObjects(flow.resumedURL, URL);
+}
+
+- (void)testDecodesState {
+  OKTRedirectRouterTestFlow *flow = [self registerFlowForState:@"a b/c"];
+  NSURL *URL = [NSURL URLWithString:@"com.example.app:/callback?state=a+b%2Fc"];
+
+  XCTAssertTrue([_router resumeExternalUserAgentFlowWithURL:URL]);
+  XCTAssertNotNil(flow.resumedURL);
+}
+
+- (void)testRejectsUnknownOrMissingState {
+  OKTRedirectRouterTestFlow *flow = [self registerFlowForState:@"xyz"];
+
+  XCTAssertFalse([_router resumeExternalUserAgentFlowWithURL:
+      [NSURL URLWithString:@"com.example.app:/callback?code=abc&state=other"]]);
+  XCTAssertFalse([_router resumeExternalUserAgentFlowWithURL:
+      [NSURL URLWithString:@"com.example.app:/callback?code=abc"]]);
+  XCTAssertNil(flow.resumedURL);
+  XCTAssertEqual(_router.flowCount, 1u);
+}
+
+- (void)testKeepsFlowThatRejectsURL {
+  OKTRedirectRouterTestFlow *flow = [self registerFlowForState:@"xyz"];
+
+  XCTAssertFalse([_router resumeExternalUserAgentFlowWithURL:
+      [NSURL URLWithString:@"com.example.other:/callback?state=xyz"]]);
+  XCTAssertEqual(_router.flowCount, 1u);
+  XCTAssertTrue([_router resumeExternalUserAgentFlowWithURL:
+      [NSURL URLWithString:@"com.example.app:/callback?state=xyz"]]);
+  XCTAssertNotNil(flow.resumedURL);
+}
+
+- (void)testRejectsDuplicateState {
+  [self registerFlowForState:@"xyz"];
+  OKTRedirectRouterTestFlow *other = [[OKTRedirectRouterTestFlow alloc] init];
+
+  XCTAssertFalse([_router registerFlow:other forState:@"xyz"]);
+  XCTAssertEqual(_router.flowCount, 1u);
+}
+
+- (void)testUnregister {
+  OKTRedirectRouterTestFlow *flow = [self registerFlowForState:@"xyz"];
+  [_router unregisterFlowForState:@"xyz"];
+
+  XCTAssertEqual(_router.flowCount, 0u);
+  XCTAssertFalse([_router resumeExternalUserAgentFlowWithURL:
+      [NSURL URLWithString:@"com.example.app:/callback?state=xyz"]]);
+  XCTAssertNil(flow.resumedURL);
+  XCTAssertNil(flow.error);
+}
+
+- (void)testEvictsExpiredFlows {
+  _router.flowTimeout = 0.2;
+  OKTRedirectRouterTestFlow *expiring = [self registerFlowForState:@"expiring"];
+  _router.flowTimeout = 60;
+  OKTRedirectRouterTestFlow *pending = [self registerFlowForState:@"pending"];
+
+  XCTestExpectation *evicted = [self expectationWithDescription:@"Flow evicted"];
+  expiring.onFailure = ^{
+    [evicted fulfill];
+  };
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+
+  XCTAssertEqualObjects(expiring.error.domain, OKTGeneralErrorDomain);
+  XCTAssertEqual(expiring.error.code, OKTErrorCodeProgramCanceledAuthorizationFlow);
+  XCTAssertNil(pending.error);
+  XCTAssertEqual(_router.flowCount, 1u);
+  XCTAssertFalse([_router resumeExternalUserAgentFlowWithURL:
+      [NSURL URLWithString:@"com.example.app:/callback?state=expiring"]]);
+}
+
+/*! @brief Measures dispatching redirects among many registered flows.
+ */
+- (void)testDispatchPerformance {
+  static const int kFlowCount = 1000;
+  NSMutableArray<NSURL *> *URLs = [NSMutableArray array];
+  for (int i = 0; i < kFlowCount; i++) {
+    [URLs addObject:[NSURL URLWithString:
+        [NSString stringWithFormat:@"com.example.app:/callback?code=abc&state=state%d", i]]];
+  }
+
+  [self measureBlock:^{
+    for (int i = 0; i < kFlowCount; i++) {
+      [self registerFlowForState:[NSString stringWithFormat:@"state%d", i]];
+    }
+    for (NSURL *URL in URLs) {
+      [self->_router resumeExternalUserAgentFlowWithURL:URL];
+    }
+  }];
+  XCTAssertEqual(_router.flowCount, 0u);
+}
+
+@end
+
+#pragma GCC diagnostic pop
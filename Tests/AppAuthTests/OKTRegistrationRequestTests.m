@@ -187,4 +187,11 @@ static NSString *kTokenEndpointAuthMethodTestValue = @"client_secret_basic";
   XCTAssertEqualObjects(parsedJSON[kTestAdditionalParameterKey], kTestAdditionalParameterValue);
 }
 
+/*! @brief The request is built once and shared by later calls.
+ */
+- (void)testURLRequestIsCached {
+  OKTRegistrationRequest *request = [[self class] testInstance];
+  XCTAssertEqual([request URLRequest], [request URLRequest]);
+}
+
 @end
@@ -0,0 +1,174 @@
+/*! @file OKTRetryPolicyTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OKTRetryPolicy.h"
+
+// Ignore warnings about "Use of GNU statement expression extension" which is raised by our use of
+// the XCTAssert___ macros.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wgnu"
+
+/*! @brief Test URL used for the fake responses.
+ */
+static NSString *const kTestURL = @"https://www.example.com/token";
+
+@interface OKTRetryPolicyTests : XCTestCase
+@end
+
+/*! @brief Unit tests for @c OKTRetryPolicy.
+ */
+@implementation OKTRetryPolicyTests
+
+- (void)tearDown {
+  [OKTRetryPolicy setSharedPolicy:[OKTRetryPolicy noRetryPolicy]];
+  [super tearDown];
+}
+
+- (NSHTTPURLResponse *)responseWithStatusCode:(NSInteger)statusCode
+                                      headers:(nullable NSDictionary<NSString *, NSString *> *)headers {
+  return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:kTestURL]
+                                     statusCode:statusCode
+                                    HTTPVersion:@"HTTP/1.1"
+                                   headerFields:headers];
+}
+
+- (void)testSharedPolicyDefaultsToSingleAttempt {
+  XCTAssertEqual([OKTRetryPolicy sharedPolicy].maximumAttempts, (NSUInteger)1);
+
+  OKTRetryPolicy *policy = [OKTRetryPolicy defaultRetryPolicy];
+  [OKTRetryPolicy setSharedPolicy:policy];
+  XCTAssertEqual([OKTRetryPolicy sharedPolicy], policy);
+}
+
+- (void)testIdempotentMethods {
+  NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:kTestURL]];
+  XCTAssertTrue([OKTRetryPolicy isIdempotentRequest:request]);
+  request.HTTPMethod = @"DELETE";
+  XCTAssertTrue([OKTRetryPolicy isIdempotentRequest:request]);
+  request.HTTPMethod = @"POST";
+  XCTAssertFalse([OKTRetryPolicy isIdempotentRequest:request]);
+  request.HTTPMethod = @"PATCH";
+  XCTAssertFalse([OKTRetryPolicy isIdempotentRequest:request]);
+}
+
+- (void)testShouldRetryNonIdempotentRequestOnlyWhenNotProcessed {
+  OKTRetryPolicy *policy = [OKTRetryPolicy defaultRetryPolicy];
+  NSError *cannotConnect = [NSError errorWithDomain:NSURLErrorDomain
+                                               code:NSURLErrorCannotConnectToHost
+                                           userInfo:nil];
+  NSError *timedOut = [NSError errorWithDomain:NSURLErrorDomain
+                                          code:NSURLErrorTimedOut
+                                      userInfo:nil];
+  NSError *cancelled = [NSError errorWithDomain:NSURLErrorDomain
+                                           code:NSURLErrorCancelled
+                                       userInfo:nil];
+
+  XCTAssertTrue([policy shouldRetryWithError:cannotConnect response:nil idempotent:NO]);
+  XCTAssertFalse([policy shouldRetryWithError:timedOut response:nil idempotent:NO]);
+  XCTAssertFalse([policy shouldRetryWithError:cancelled response:nil idempotent:NO]);
+  XCTAssertTrue([policy shouldRetryWithError:nil
+                                    response:[self responseWithStatusCode:429 headers:nil]
+                                  idempotent:NO]);
+  XCTAssertTrue([policy shouldRetryWithError:nil
+                                    response:[self responseWithStatusCode:503 headers:nil]
+                                  idempotent:NO]);
+  XCTAssertFalse([policy shouldRetryWithError:nil
+                                     response:[self responseWithStatusCode:500 headers:nil]
+                                   idempotent:NO]);
+  XCTAssertFalse([policy shouldRetryWithError:nil
+                                     response:[self responseWithStatusCode:400 headers:nil]
+                                   idempotent:NO]);
+}
+
+- (void)testShouldRetryIdempotentRequestOnTransientFailures {
+  OKTRetryPolicy *policy = [OKTRetryPolicy defaultRetryPolicy];
+  NSError *timedOut = [NSError errorWithDomain:NSURLErrorDomain
+                                          code:NSURLErrorTimedOut
+                                      userInfo:nil];
+
+  XCTAssertTrue([policy shouldRetryWithError:timedOut response:nil idempotent:YES]);
+  for (NSNumber *statusCode in @[ @500, @502, @503, @504, @429 ]) {
+    XCTAssertTrue([policy shouldRetryWithError:nil
+                                      response:[self responseWithStatusCode:statusCode.integerValue
+                                                                    headers:nil]
+                                    idempotent:YES], @"%@", statusCode);
+  }
+  for (NSNumber *statusCode in @[ @200, @401, @404, @501 ]) {
+    XCTAssertFalse([policy shouldRetryWithError:nil
+                                       response:[self responseWithStatusCode:statusCode.integerValue
+                                                                     headers:nil]
+                                     idempotent:YES], @"%@", statusCode);
+  }
+}
+
+- (void)testDecorrelatedJitterBounds {
+  OKTRetryPolicy *policy = [[OKTRetryPolicy alloc] initWithMaximumAttempts:5
+                                                                 baseDelay:1
+                                                              maximumDelay:10
+                                                                  deadline:60];
+  NSTimeInterval delay = 0;
+  for (int i = 0; i < 1000; i++) {
+    NSTimeInterval previousDelay = delay;
+    delay = [policy delayAfterPreviousDelay:previousDelay];
+    XCTAssertGreaterThanOrEqual(delay, 1);
+    XCTAssertLessThanOrEqual(delay, MIN(10, MAX(previousDelay, 1) * 3));
+  }
+}
+
+- (void)testRetryAfterDeltaSeconds {
+  NSHTTPURLResponse *response = [self responseWithStatusCode:503 headers:@{ @"Retry-After" : @"7" }];
+  XCTAssertEqual([OKTRetryPolicy retryAfterIntervalForResponse:response], 7);
+
+  response = [self responseWithStatusCode:503 headers:@{ @"retry-after" : @" 0 " }];
+  XCTAssertEqual([OKTRetryPolicy retryAfterIntervalForResponse:response], 0);
+}
+
+- (void)testRetryAfterHTTPDate {
+  NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+  formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+  formatter.timeZone = [NSTimeZone timeZoneForSecondsFromGMT:0];
+  formatter.dateFormat = @"EEE, dd MMM yyyy HH:mm:ss 'GMT'";
+  NSString *date = [formatter stringFromDate:[NSDate dateWithTimeIntervalSinceNow:120]];
+
+  NSHTTPURLResponse *response = [self responseWithStatusCode:429 headers:@{ @"Retry-After" : date }];
+  NSTimeInterval interval = [OKTRetryPolicy retryAfterIntervalForResponse:response];
+  XCTAssertGreaterThan(interval, 110);
+  XCTAssertLessThanOrEqual(interval, 120);
+
+  response = [self responseWithStatusCode:429
+                                  headers:@{ @"Retry-After" : @"Wed, 21 Oct 2015 07:28:00 GMT" }];
+  XCTAssertEqual([OKTRetryPolicy retryAfterIntervalForResponse:response], 0);
+}
+
+- (void)testRetryAfterMissingOrInvalid {
+  XCTAssertLessThan([OKTRetryPolicy retryAfterIntervalForResponse:nil], 0);
+  NSHTTPURLResponse *response = [self responseWithStatusCode:503 headers:nil];
+  XCTAssertLessThan([OKTRetryPolicy retryAfterIntervalForResponse:response], 0);
+  response = [self responseWithStatusCode:503 headers:@{ @"Retry-After" : @"soon" }];
+  XCTAssertLessThan([OKTRetryPolicy retryAfterIntervalForResponse:response], 0);
+  response = [self responseWithStatusCode:503 headers:@{ @"Retry-After" : @"-5" }];
+  XCTAssertLessThan([OKTRetryPolicy retryAfterIntervalForResponse:response], 0);
+}
+
+@end
+
+#pragma GCC diagnostic pop
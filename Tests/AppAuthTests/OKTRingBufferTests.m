@@ -0,0 +1,115 @@
+/*! @file OKTRingBufferTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OKTRingBuffer.h"
+
+// Ignore warnings about "Use of GNU statement expression extension" which is raised by our use of
+// the XCTAssert___ macros.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wgnu"
+
+@interface OKTRingBufferTests : XCTestCase
+@end
+
+/*! @brief Unit tests for @c OKTRingBuffer.
+ */
+@implementation OKTRingBufferTests {
+  OKTRingBuffer _buffer;
+}
+
+- (void)setUp {
+  [super setUp];
+  OKTRingBufferInit(&_buffer, 8);
+}
+
+- (void)tearDown {
+  OKTRingBufferRelease(&_buffer);
+  [super tearDown];
+}
+
+- (void)append:(const char *)bytes {
+  struct iovec regions[2];
+  int count = OKTRingBufferWritableRegions(&_buffer, regions);
+  size_t length = strlen(bytes);
+  for (int i = 0; i < count && 0 < length; i++) {
+    size_t part = MIN(length, regions[i].iov_len);
+    memcpy(regions[i].iov_base, bytes, part);
+    OKTRingBufferCommit(&_buffer, part);
+    bytes += part;
+    length -= part;
+  }
+  XCTAssertEqual(length, 0u);
+}
+
+- (NSString *)contents {
+  struct iovec regions[2];
+  int count = OKTRingBufferReadableRegions(&_buffer, regions);
+  NSMutableString *contents = [NSMutableString string];
+  for (int i = 0; i < count; i++) {
+    [contents appendString:[[NSString alloc] initWithBytes:regions[i].iov_base
+                                                    length:regions[i].iov_len
+                                                  encoding:NSUTF8StringEncoding]];
+  }
+  return contents;
+}
+
+- (void)testAllocatesStorageOnlyWhenNeeded {
+  struct iovec regions[2];
+  XCTAssertEqual(OKTRingBufferReadableRegions(&_buffer, regions), 0);
+  XCTAssertTrue(_buffer.bytes == NULL);
+
+  XCTAssertEqual(OKTRingBufferWritableRegions(&_buffer, regions), 1);
+  XCTAssertEqual(regions[0].iov_len, 8u);
+  XCTAssertTrue(_buffer.bytes != NULL);
+
+  OKTRingBufferRelease(&_buffer);
+  XCTAssertTrue(_buffer.bytes == NULL);
+  XCTAssertEqual(_buffer.capacity, 8u);
+}
+
+- (void)testWrapsAroundTheEnd {
+  [self append:"abcdef"];
+  OKTRingBufferConsume(&_buffer, 4);
+
+  struct iovec regions[2];
+  XCTAssertEqual(OKTRingBufferWritableRegions(&_buffer, regions), 2);
+  XCTAssertEqual(regions[0].iov_len, 2u);
+  XCTAssertEqual(regions[1].iov_len, 4u);
+
+  [self append:"ghijkl"];
+  XCTAssertEqual(OKTRingBufferWritableRegions(&_buffer, regions), 0);
+  XCTAssertEqual(OKTRingBufferReadableRegions(&_buffer, regions), 2);
+  XCTAssertEqualObjects([self contents], @"efghijkl");
+}
+
+- (void)testEmptiedBufferRestartsAtFront {
+  [self append:"abcde"];
+  OKTRingBufferConsume(&_buffer, 5);
+
+  struct iovec regions[2];
+  XCTAssertEqual(OKTRingBufferWritableRegions(&_buffer, regions), 1);
+  XCTAssertEqual(regions[0].iov_len, 8u);
+}
+
+@end
+
+#pragma GCC diagnostic pop
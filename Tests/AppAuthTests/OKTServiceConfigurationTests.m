@@ -368,6 +368,45 @@ static NSString *const kIssuerTestExpectedFullDiscoveryURL =
   XCTAssertEqualObjects(configuration.registrationEndpoint, unarchived.registrationEndpoint, @"");
 }
 
+/*! @brief Tests that equivalent configurations resolve to the one shared instance.
+ */
+- (void)testSharedConfiguration {
+  OKTServiceConfiguration *configuration = [[self class] testInstance];
+  OKTServiceConfiguration *shared =
+      [OKTServiceConfiguration sharedConfigurationForConfiguration:configuration];
+  XCTAssertEqual(shared, configuration, @"");
+
+  OKTServiceConfiguration *equivalent = [[self class] testInstance];
+  XCTAssertNotEqual(equivalent, configuration, @"");
+  XCTAssertEqual([OKTServiceConfiguration sharedConfigurationForConfiguration:equivalent],
+                 configuration, @"");
+}
+
+/*! @brief Tests that a configuration with other endpoints replaces the shared one of its issuer.
+ */
+- (void)testSharedConfigurationIsReplacedWhenEndpointsChange {
+  OKTServiceConfiguration *configuration =
+      [OKTServiceConfiguration sharedConfigurationForConfiguration:[[self class] testInstance]];
+
+  NSURL *otherAuthEndpoint = [NSURL URLWithString:@"https://www.example.com/other/authorize"];
+  OKTServiceConfiguration *changed =
+      [[OKTServiceConfiguration alloc] initWithAuthorizationEndpoint:otherAuthEndpoint
+                                                       tokenEndpoint:configuration.tokenEndpoint];
+  XCTAssertEqual([OKTServiceConfiguration sharedConfigurationForConfiguration:changed], changed,
+                 @"");
+  XCTAssertEqual([OKTServiceConfiguration
+                     sharedConfigurationForConfiguration:[changed copy]], changed, @"");
+}
+
+/*! @brief Tests that decoding the same configuration twice yields the one shared instance.
+ */
+- (void)testDecodedConfigurationIsShared {
+  NSData *data = [NSKeyedArchiver archivedDataWithRootObject:[[self class] testInstance]];
+  OKTServiceConfiguration *first = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  OKTServiceConfiguration *second = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+  XCTAssertEqual(first, second, @"");
+}
+
 /*! @brief Tests the @c NSCopying implementation by round-tripping an instance through the copying
         process and checking to make sure the source and destination instances have equivalent
         dictionaries.
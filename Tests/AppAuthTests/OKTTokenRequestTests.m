@@ -239,6 +239,20 @@ static NSString *const kTestAdditionalParameterValue = @"1";
   XCTAssertNotNil(authorization);
 }
 
+/*! @brief Later requests reuse the encoded body and client credentials.
+ */
+- (void)testURLRequestReusesEncodedBody {
+  OKTTokenRequest *request = [[self class] testInstanceCodeExchangeClientAuth];
+  NSURLRequest *first = [request URLRequest];
+  NSURLRequest *second = [request URLRequest];
+
+  XCTAssertEqualObjects(first.HTTPBody, second.HTTPBody);
+  XCTAssertEqualObjects([first valueForHTTPHeaderField:@"Authorization"],
+                        [second valueForHTTPHeaderField:@"Authorization"]);
+  NSString *body = [[NSString alloc] initWithData:first.HTTPBody encoding:NSUTF8StringEncoding];
+  XCTAssert([request.description containsString:body]);
+}
+
 - (void)testAuthorizationCodeNullRedirectURL {
   OKTAuthorizationResponse *authResponse = [OKTAuthorizationResponseTests testInstance];
   NSArray<NSString *> *scopesArray =
@@ -52,4 +52,10 @@
   XCTAssertEqualObjects([OKTTokenUtilities formUrlEncode:@""], @"", @"");
 }
 
+- (void)testFormUrlEncodeInvalidUnicode {
+  unichar loneSurrogate = 0xD800;
+  NSString *invalid = [NSString stringWithCharacters:&loneSurrogate length:1];
+  XCTAssertNil([OKTTokenUtilities formUrlEncode:invalid], @"");
+}
+
 @end
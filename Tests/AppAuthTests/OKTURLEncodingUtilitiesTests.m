@@ -0,0 +1,227 @@
+/*! @file OKTURLEncodingUtilitiesTests.m
+    @brief AppAuth iOS SDK
+    @copyright
+        Copyright 2015 Google Inc. All Rights Reserved.
+    @copydetails
+        Licensed under the Apache License, Version 2.0 (the "License");
+        you may not use this file except in compliance with the License.
+        You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+        Unless required by applicable law or agreed to in writing, software
+        distributed under the License is distributed on an "AS IS" BASIS,
+        WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+        See the License for the specific language governing permissions and
+        limitations under the License.
+    @modifications
+        Copyright (C) 2019 Okta Inc.
+ */
+
+#import <XCTest/XCTest.h>
+
+#import "OKTURLEncodingUtilities.h"
+#import "OKTURLQueryComponent.h"
+
+// Ignore warnings about "Use of GNU statement expression extension" which is raised by our use of
+// the XCTAssert___ macros.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wgnu"
+
+/*! @brief The unencoded example from RFC6749 Appendix B.
+    @see https://tools.ietf.org/html/rfc6749#appendix-B
+ */
+static NSString *const kEncodingTestUnencoded = @" %&+£€";
+
+/*! @brief Number of iterations of each benchmark.
+ */
+static const NSUInteger kBenchmarkIterations = 10000;
+
+@interface OKTURLEncodingUtilitiesTests : XCTestCase
+@end
+
+/*! @brief Unit tests and benchmarks for @c OKTURLEncodingUtilities.
+ */
+@implementation OKTURLEncodingUtilitiesTests
+
+#pragma mark - Encoding
+
+- (void)testEncodeQueryValue {
+  XCTAssertEqualObjects([OKTURLEncodingUtilities encodeString:kEncodingTestUnencoded
+                                                         mode:OKTURLEncodingModeQueryValue],
+                        @"%20%25%26%2B%C2%A3%E2%82%AC");
+  XCTAssertEqualObjects([OKTURLEncodingUtilities encodeString:@"a=b#c/d?e:f@g~h"
+                                                         mode:OKTURLEncodingModeQueryValue],
+                        @"a%3Db%23c/d?e:f@g~h");
+  XCTAssertEqualObjects([OKTURLEncodingUtilities encodeString:@""
+                                                         mode:OKTURLEncodingModeQueryValue],
+                        @"");
+}
+
+- (void)testEncodeForm {
+  XCTAssertEqualObjects([OKTURLEncodingUtilities encodeString:kEncodingTestUnencoded
+                                                         mode:OKTURLEncodingModeForm],
+                        @"+%25%26%2B%C2%A3%E2%82%AC");
+  XCTAssertEqualObjects([OKTURLEncodingUtilities encodeString:@"t _9V-F*I+Z1Lk.u7:2/8L+w="
+                                                         mode:OKTURLEncodingModeForm],
+                        @"t+_9V-F*I%2BZ1Lk.u7%3A2%2F8L%2Bw%3D");
+  XCTAssertEqualObjects([OKTURLEncodingUtilities encodeString:@"~!'()"
+                                                         mode:OKTURLEncodingModeForm],
+                        @"%7E%21%27%28%29");
+}
+
+/*! @brief Every ASCII character must be encoded exactly as by the @c NSCharacterSet based
+        implementations it replaces.
+ */
+- (void)testEncodeMatchesCharacterSets {
+  NSMutableString *ascii = [NSMutableString string];
+  for (unichar c = 1; c < 128; c++) {
+    [ascii appendFormat:@"%C", c];
+  }
+
+  NSString *queryValueExpected = [ascii stringByAddingPercentEncodingWithAllowedCharacters:
+      [OKTURLQueryComponent URLParamValueAllowedCharacters]];
+  XCTAssertEqualObjects([OKTURLEncodingUtilities encodeString:ascii
+                                                         mode:OKTURLEncodingModeQueryValue],
+                        queryValueExpected);
+
+  NSCharacterSet *formAllowed = [NSCharacterSet characterSetWithCharactersInString:
+      @" *-._0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"];
+  NSString *formExpected = [[ascii stringByAddingPercentEncodingWithAllowedCharacters:formAllowed]
+      stringByReplacingOccurrencesOfString:@" " withString:@"+"];
+  XCTAssertEqualObjects([OKTURLEncodingUtilities encodeString:ascii mode:OKTURLEncodingModeForm],
+                        formExpected);
+}
+
+- (void)testEncodeInvalidUnicode {
+  unichar loneSurrogate = 0xD800;
+  NSString *invalid = [NSString stringWithCharacters:&loneSurrogate length:1];
+  XCTAssertNil([OKTURLEncodingUtilities encodeString:invalid mode:OKTURLEncodingModeForm]);
+
+  NSMutableData *data = [[@"a=" dataUsingEncoding:NSASCIIStringEncoding] mutableCopy];
+  XCTAssertFalse([OKTURLEncodingUtilities appendEncodedString:invalid
+                                                         mode:OKTURLEncodingModeQueryValue
+                                                       toData:data]);
+  XCTAssertEqual(data.length, 2);
+}
+
+- (void)testAppendEncodedString {
+  NSMutableData *data = [NSMutableData data];
+  XCTAssertTrue([OKTURLEncodingUtilities appendEncodedString:@"a b"
+                                                        mode:OKTURLEncodingModeForm
+                                                      toData:data]);
+  [data appendBytes:"&" length:1];
+  XCTAssertTrue([OKTURLEncodingUtilities appendEncodedString:@"€"
+                                                        mode:OKTURLEncodingModeQueryValue
+                                                      toData:data]);
+  XCTAssertEqualObjects([[NSString alloc] initWithData:data encoding:NSASCIIStringEncoding],
+                        @"a+b&%E2%82%AC");
+}
+
+#pragma mark - Decoding
+
+- (void)testDecodeForm {
+  XCTAssertEqualObjects([OKTURLEncodingUtilities decodeFormString:@"+%25%26%2B%C2%A3%E2%82%AC"],
+                        kEncodingTestUnencoded);
+  XCTAssertEqualObjects([OKTURLEncodingUtilities decodeFormString:@"%20%25%26%2b%c2%a3%e2%82%ac"],
+                        kEncodingTestUnencoded);
+  XCTAssertEqualObjects([OKTURLEncodingUtilities decodeFormString:@""], @"");
+}
+
+- (void)testDecodeKeepsMalformedPercentSequences {
+  XCTAssertEqualObjects([OKTURLEncodingUtilities decodeFormString:@"100%"], @"100%");
+  XCTAssertEqualObjects([OKTURLEncodingUtilities decodeFormString:@"%zz%4"], @"%zz%4");
+}
+
+- (void)testDecodeInvalidUTF8 {
+  XCTAssertNil([OKTURLEncodingUtilities decodeFormString:@"%C3"]);
+}
+
+- (void)testEnumerateParameters {
+  NSMutableArray<NSString *> *pairs = [NSMutableArray array];
+  [OKTURLEncodingUtilities enumerateParametersInQuery:@"a=1&b=x+y&&novalue&c=&=d&e=%E2%82%AC&f=%C3"
+                                           usingBlock:^(NSString *name, NSString *value) {
+    [pairs addObject:[NSString stringWithFormat:@"%@:%@", name, value]];
+  }];
+  NSArray<NSString *> *expected = @[ @"a:1", @"b:x y", @"c:", @":d", @"e:€" ];
+  XCTAssertEqualObjects(pairs, expected);
+}
+
+#pragma mark - Benchmarks
+
+/*! @brief A token request body, with a client assertion as its largest value.
+ */
+- (NSDictionary<NSString *, NSString *> *)tokenRequestParameters {
+  NSMutableString *assertion = [NSMutableString string];
+  while (assertion.length < 1024) {
+    [assertion appendString:@"eyJhbGciOiJSUzI1NiIsImtpZCI6ImtleSJ9.eyJzdWIiOiJjbGllbnQifQ."];
+  }
+  return @{
+    @"grant_type" : @"authorization_code",
+    @"code" : @"SplxlOBeZQQYbYS6WxSbIA",
+    @"redirect_uri" : @"com.example.app:/oauth2/callback",
+    @"code_verifier" : @"dBjftJeZ4CVP-mB92K27uhbUJU1p1r_wW1gFWFOEjXk",
+    @"client_assertion" : assertion,
+    @"scope" : @"openid profile email offline_access",
+  };
+}
+
+- (void)testBenchmarkURLEncodedParameters {
+  OKTURLQueryComponent *query = [[OKTURLQueryComponent alloc] init];
+  [query addParameters:[self tokenRequestParameters]];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kBenchmarkIterations; i++) {
+      @autoreleasepool {
+        (void)[query URLEncodedParameters];
+      }
+    }
+  }];
+}
+
+/*! @brief The previous NSURLComponents based implementation, for comparison.
+ */
+- (void)testBenchmarkURLEncodedParametersBaseline {
+  NSDictionary<NSString *, NSString *> *parameters = [self tokenRequestParameters];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kBenchmarkIterations; i++) {
+      @autoreleasepool {
+        NSMutableArray<NSURLQueryItem *> *queryItems = [NSMutableArray array];
+        for (NSString *name in parameters) {
+          [queryItems addObject:[NSURLQueryItem queryItemWithName:name value:parameters[name]]];
+        }
+        NSURLComponents *components = [[NSURLComponents alloc] init];
+        components.queryItems = queryItems;
+        (void)[components.percentEncodedQuery stringByReplacingOccurrencesOfString:@"+"
+                                                                        withString:@"%2B"];
+      }
+    }
+  }];
+}
+
+- (void)testBenchmarkFormEncode {
+  NSString *value = [self tokenRequestParameters][@"client_assertion"];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kBenchmarkIterations; i++) {
+      @autoreleasepool {
+        (void)[OKTURLEncodingUtilities encodeString:value mode:OKTURLEncodingModeForm];
+      }
+    }
+  }];
+}
+
+- (void)testBenchmarkParseAuthorizationResponse {
+  NSURL *URL = [NSURL URLWithString:@"com.example.app:/oauth2/callback?state=z634l182"
+      "&code=4/WQAstm4iiN_0Qi-n4mEo-jL-85CvQ&scope=openid+profile+email%20offline_access"
+      "&session_state=ab78c20&prompt=consent"];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < kBenchmarkIterations; i++) {
+      @autoreleasepool {
+        (void)[[OKTURLQueryComponent alloc] initWithURL:URL];
+      }
+    }
+  }];
+}
+
+@end
+
+#pragma GCC diagnostic pop
@@ -241,6 +241,109 @@ static NSString *const kTestURLRoot = @"https://www.example.com/";
   XCTAssertEqualObjects(parsedParameters.dictionaryValue, parameters, @"");
 }
 
+/*! @brief Tests that parameters are serialized in the order they were added, including repeated
+        names.
+ */
+- (void)testEncodingPreservesInsertionOrder {
+  OKTURLQueryComponent *query = [[OKTURLQueryComponent alloc] init];
+  [query addParameter:@"z" value:@"1"];
+  [query addParameter:@"a" value:@"2"];
+  [query addParameter:@"z" value:@"3"];
+  XCTAssertEqualObjects([query URLEncodedParameters], @"z=1&a=2&z=3", @"");
+  XCTAssertEqualObjects(query.parameters, (@[ @"z", @"a" ]), @"");
+  XCTAssertEqualObjects([query valuesForParameter:@"z"], (@[ @"1", @"3" ]), @"");
+  XCTAssertNil([query valuesForParameter:@"missing"], @"");
+}
+
+/*! @brief Tests that lookups hand out immutable arrays, so callers cannot change the cached
+        grouping.
+ */
+- (void)testLookupsReturnImmutableArrays {
+  OKTURLQueryComponent *query = [[OKTURLQueryComponent alloc] init];
+  [query addParameter:@"z" value:@"1"];
+  [query addParameter:@"z" value:@"3"];
+  XCTAssertFalse([[query valuesForParameter:@"z"] isKindOfClass:[NSMutableArray class]], @"");
+  XCTAssertFalse([query.parameters isKindOfClass:[NSMutableArray class]], @"");
+  XCTAssertFalse([query.dictionaryValue[@"z"] isKindOfClass:[NSMutableArray class]], @"");
+}
+
+/*! @brief Tests that concurrent readers build the lookup caches once and see the same values.
+ */
+- (void)testConcurrentLookups {
+  OKTURLQueryComponent *query = [[OKTURLQueryComponent alloc] init];
+  for (NSUInteger i = 0; i < 50; i++) {
+    [query addParameter:[NSString stringWithFormat:@"p%lu", (unsigned long)(i % 10)] value:@"v"];
+  }
+  NSDictionary *expected = [[OKTURLQueryComponent alloc] initWithURL:
+      [NSURL URLWithString:[@"https://example.com/?" stringByAppendingString:
+          [query URLEncodedParameters]]]].dictionaryValue;
+  dispatch_apply(100, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+    XCTAssertEqual([query valuesForParameter:@"p3"].count, 5u);
+    XCTAssertEqual(query.parameters.count, 10u);
+    XCTAssertEqualObjects(query.dictionaryValue, expected);
+  });
+}
+
+/*! @brief Tests that serializing while parameters are being added only ever sees whole pairs.
+ */
+- (void)testConcurrentAddingAndEncoding {
+  OKTURLQueryComponent *query = [[OKTURLQueryComponent alloc] init];
+  dispatch_apply(200, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+    if (i % 2 == 0) {
+      [query addParameter:@"n" value:@"v"];
+      return;
+    }
+    NSString *encoded = [query URLEncodedParameters];
+    if (encoded.length == 0) {
+      return;
+    }
+    for (NSString *pair in [encoded componentsSeparatedByString:@"&"]) {
+      XCTAssertEqualObjects(pair, @"n=v", @"");
+    }
+  });
+  XCTAssertEqual([query valuesForParameter:@"n"].count, 100u, @"");
+}
+
+/*! @brief Tests that parameters that are not valid Unicode are left out rather than serialized
+        with an empty name or value.
+ */
+- (void)testEncodingSkipsInvalidUnicode {
+  unichar loneSurrogate = 0xD800;
+  NSString *invalid = [NSString stringWithCharacters:&loneSurrogate length:1];
+  OKTURLQueryComponent *query = [[OKTURLQueryComponent alloc] init];
+  [query addParameter:invalid value:@"1"];
+  [query addParameter:@"a" value:@"2"];
+  [query addParameter:@"b" value:invalid];
+  [query addParameter:@"c" value:@"3"];
+  XCTAssertEqualObjects([query URLEncodedParameters], @"a=2&c=3", @"");
+
+  OKTURLQueryComponent *invalidQuery = [[OKTURLQueryComponent alloc] init];
+  [invalidQuery addParameter:@"b" value:invalid];
+  XCTAssertEqualObjects([invalidQuery URLEncodedParameters], @"", @"");
+}
+
+/*! @brief Tests that parameters added from a dictionary are serialized sorted by name.
+ */
+- (void)testAddingParametersIsDeterministic {
+  OKTURLQueryComponent *query = [[OKTURLQueryComponent alloc] init];
+  [query addParameters:@{ @"c" : @"3", @"a" : @"1", @"b" : @"2" }];
+  XCTAssertEqualObjects([query URLEncodedParameters], @"a=1&b=2&c=3", @"");
+}
+
+/*! @brief Tests that the dictionary view is reused until a parameter is added.
+ */
+- (void)testDictionaryValueIsCached {
+  OKTURLQueryComponent *query = [[OKTURLQueryComponent alloc] init];
+  [query addParameter:kTestParameterName value:kTestParameterValue];
+  NSDictionary *dictionaryValue = query.dictionaryValue;
+  XCTAssertEqual(query.dictionaryValue, dictionaryValue, @"");
+
+  [query addParameter:kTestParameterName2 value:kTestParameterValue2];
+  XCTAssertNotEqual(query.dictionaryValue, dictionaryValue, @"");
+  XCTAssertEqualObjects(query.dictionaryValue[kTestParameterName2], kTestParameterValue2, @"");
+  XCTAssertEqual(dictionaryValue.count, 1, @"");
+}
+
 - (void)testParsingQueryString {
   NSString *URLString =
       [NSString stringWithFormat:@"%@?%@", kTestURLRoot, kTestSimpleParameterStringEncoded];
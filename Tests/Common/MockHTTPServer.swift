@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+import Foundation
+#if canImport(Glibc)
+import Glibc
+private let streamSocketType = Int32(SOCK_STREAM.rawValue)
+private let sendFlags = Int32(MSG_NOSIGNAL)
+#else
+import Darwin
+private let streamSocketType = SOCK_STREAM
+private let sendFlags: Int32 = 0
+#endif
+
+struct MockHTTPRequest {
+    let method: String
+    let path: String
+    let queryItems: [String: String]
+    /// Header values keyed by lowercased name.
+    let headers: [String: String]
+    let body: Data
+
+    /// The parameters of an `application/x-www-form-urlencoded` body.
+    var formParameters: [String: String] {
+        return MockHTTPRequest.decodeForm(String(decoding: body, as: UTF8.self))
+    }
+
+    /// Parses one request from the start of `buffer`, or returns nil if it is not complete yet.
+    init?(parsing buffer: Data) {
+        guard let headerEnd = buffer.range(of: Data("\r\n\r\n".utf8)) else {
+            return nil
+        }
+
+        let lines = String(decoding: buffer[buffer.startIndex ..< headerEnd.lowerBound], as: UTF8.self)
+            .components(separatedBy: "\r\n")
+        let requestLine = lines[0].split(separator: " ")
+        guard requestLine.count == 3 else {
+            return nil
+        }
+
+        var headers: [String: String] = [:]
+        for line in lines.dropFirst() {
+            guard let colon = line.firstIndex(of: ":") else {
+                continue
+            }
+            let name = line[line.startIndex ..< colon].lowercased()
+            headers[name] = line[line.index(after: colon)...].trimmingCharacters(in: .whitespaces)
+        }
+
+        let contentLength = headers["content-length"].flatMap { Int($0) } ?? 0
+        guard buffer.distance(from: headerEnd.upperBound, to: buffer.endIndex) >= contentLength else {
+            return nil
+        }
+
+        let target = String(requestLine[1])
+        let queryStart = target.firstIndex(of: "?")
+        method = String(requestLine[0])
+        path = String(target[target.startIndex ..< (queryStart ?? target.endIndex)])
+        queryItems = queryStart.map { MockHTTPRequest.decodeForm(String(target[target.index(after: $0)...])) } ?? [:]
+        self.headers = headers
+        body = buffer.subdata(in: headerEnd.upperBound ..< buffer.index(headerEnd.upperBound, offsetBy: contentLength))
+    }
+
+    private static func decodeForm(_ string: String) -> [String: String] {
+        var parameters: [String: String] = [:]
+        for pair in string.split(separator: "&") {
+            let parts = pair.split(separator: "=", maxSplits: 1).map {
+                $0.replacingOccurrences(of: "+", with: " ").removingPercentEncoding ?? String($0)
+            }
+            parameters[parts[0]] = parts.count > 1 ? parts[1] : ""
+        }
+        return parameters
+    }
+}
+
+struct MockHTTPResponse {
+    var statusCode: Int
+    var headers: [String: String] = [:]
+    var body = Data()
+
+    static func json(_ object: Any, statusCode: Int = 200) -> MockHTTPResponse {
+        let body = try! JSONSerialization.data(withJSONObject: object, options: [])
+        return MockHTTPResponse(statusCode: statusCode, headers: ["Content-Type": "application/json"], body: body)
+    }
+
+    static func redirect(to location: String) -> MockHTTPResponse {
+        return MockHTTPResponse(statusCode: 302, headers: ["Location": location])
+    }
+
+    func serialized() -> Data {
+        var head = "HTTP/1.1 \(statusCode) \(HTTPURLResponse.localizedString(forStatusCode: statusCode))\r\n"
+        var fields = headers
+        fields["Content-Length"] = String(body.count)
+        fields["Connection"] = "close"
+        for (name, value) in fields {
+            head += "\(name): \(value)\r\n"
+        }
+        head += "\r\n"
+        return Data(head.utf8) + body
+    }
+}
+
+enum MockHTTPServerError: Error {
+    case socketFailure(Int32)
+}
+
+/// A minimal HTTP/1.1 server on an ephemeral 127.0.0.1 port, built on BSD sockets and dispatch
+/// sources so that it needs neither a run loop nor Darwin-only APIs. Each connection carries one
+/// request; the response closes it.
+final class MockHTTPServer {
+
+    typealias Handler = (MockHTTPRequest, @escaping (MockHTTPResponse) -> Void) -> Void
+
+    private(set) var port: UInt16 = 0
+
+    private let queue = DispatchQueue(label: "com.okta.oidc.tests.mock-http-server")
+    private let handler: Handler
+    private var listenSource: DispatchSourceRead?
+    /// The open connections by the order in which they were accepted. A socket number can be
+    /// reused as soon as its connection closes, so it cannot identify the connection a delayed
+    /// response belongs to. Accessed on `queue`.
+    private var connections: [UInt64: Connection] = [:]
+    private var nextConnectionID: UInt64 = 0
+
+    private struct Connection {
+        let socket: Int32
+        let source: DispatchSourceRead
+        var buffer = Data()
+        var isHandled = false
+        var isReadingSuspended = false
+    }
+
+    init(handler: @escaping Handler) {
+        self.handler = handler
+    }
+
+    deinit {
+        stop()
+    }
+
+    func start() throws {
+        let listenSocket = socket(AF_INET, streamSocketType, 0)
+        guard listenSocket >= 0 else {
+            throw MockHTTPServerError.socketFailure(errno)
+        }
+
+        var reuse: Int32 = 1
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, socklen_t(MemoryLayout<Int32>.size))
+
+        var address = sockaddr_in()
+        #if !canImport(Glibc)
+        address.sin_len = UInt8(MemoryLayout<sockaddr_in>.size)
+        #endif
+        address.sin_family = sa_family_t(AF_INET)
+        address.sin_addr.s_addr = UInt32(0x7F00_0001).bigEndian
+        var length = socklen_t(MemoryLayout<sockaddr_in>.size)
+        let bound = withUnsafeMutablePointer(to: &address) { pointer in
+            pointer.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+                bind(listenSocket, $0, length) == 0 && getsockname(listenSocket, $0, &length) == 0
+            }
+        }
+        guard bound, listen(listenSocket, SOMAXCONN) == 0 else {
+            let error = errno
+            close(listenSocket)
+            throw MockHTTPServerError.socketFailure(error)
+        }
+        port = UInt16(bigEndian: address.sin_port)
+        _ = fcntl(listenSocket, F_SETFL, fcntl(listenSocket, F_GETFL) | O_NONBLOCK)
+
+        let source = DispatchSource.makeReadSource(fileDescriptor: listenSocket, queue: queue)
+        source.setEventHandler { [unowned self] in
+            self.acceptConnections(on: listenSocket)
+        }
+        source.setCancelHandler {
+            close(listenSocket)
+        }
+        listenSource = source
+        source.resume()
+    }
+
+    func stop() {
+        queue.sync {
+            listenSource?.cancel()
+            listenSource = nil
+            Array(connections.keys).forEach(closeConnection)
+        }
+    }
+
+    private func acceptConnections(on listenSocket: Int32) {
+        while true {
+            let connection = accept(listenSocket, nil, nil)
+            guard connection >= 0 else {
+                return
+            }
+            #if !canImport(Glibc)
+            var noSigPipe: Int32 = 1
+            setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, socklen_t(MemoryLayout<Int32>.size))
+            #endif
+            _ = fcntl(connection, F_SETFL, fcntl(connection, F_GETFL) | O_NONBLOCK)
+
+            let connectionID = nextConnectionID
+            nextConnectionID += 1
+            let source = DispatchSource.makeReadSource(fileDescriptor: connection, queue: queue)
+            source.setEventHandler { [unowned self] in
+                self.readAvailableBytes(from: connectionID)
+            }
+            source.setCancelHandler {
+                close(connection)
+            }
+            connections[connectionID] = Connection(socket: connection, source: source)
+            source.resume()
+        }
+    }
+
+    private func readAvailableBytes(from connectionID: UInt64) {
+        guard let socket = connections[connectionID]?.socket else {
+            return
+        }
+
+        var chunk = [UInt8](repeating: 0, count: 16 * 1024)
+        var isPeerClosed = false
+        while true {
+            let count = read(socket, &chunk, chunk.count)
+            if count > 0 {
+                connections[connectionID]?.buffer.append(chunk, count: count)
+                continue
+            }
+            if count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break
+            }
+            if count < 0 {
+                closeConnection(connectionID)
+                return
+            }
+            isPeerClosed = true
+            break
+        }
+
+        let isHandled = handleRequestIfComplete(on: connectionID)
+        if isPeerClosed {
+            // A peer that half-closes after sending its request is still answered. Reading stops,
+            // so that the end of the stream is not reported again while the response is pending.
+            guard isHandled else {
+                closeConnection(connectionID)
+                return
+            }
+            connections[connectionID]?.source.suspend()
+            connections[connectionID]?.isReadingSuspended = true
+        }
+    }
+
+    /// Passes the request to the handler once it has been received in full.
+    /// - Returns: Whether the request of the connection has been passed to the handler.
+    private func handleRequestIfComplete(on connectionID: UInt64) -> Bool {
+        guard let state = connections[connectionID] else {
+            return false
+        }
+        if state.isHandled {
+            return true
+        }
+        guard let request = MockHTTPRequest(parsing: state.buffer) else {
+            return false
+        }
+        connections[connectionID]?.isHandled = true
+        handler(request) { [weak self] response in
+            self?.queue.async {
+                self?.respond(with: response, on: connectionID)
+            }
+        }
+        return true
+    }
+
+    private func respond(with response: MockHTTPResponse, on connectionID: UInt64) {
+        // The response of a connection that is gone is dropped, even if its socket number has been
+        // reused by a later connection.
+        guard let socket = connections[connectionID]?.socket else {
+            return
+        }
+
+        // Responses are small; writing them blocking keeps the server simple.
+        _ = fcntl(socket, F_SETFL, fcntl(socket, F_GETFL) & ~O_NONBLOCK)
+        let data = response.serialized()
+        data.withUnsafeBytes { bytes in
+            var offset = 0
+            while offset < bytes.count {
+                let written = send(socket, bytes.baseAddress! + offset, bytes.count - offset, sendFlags)
+                guard written > 0 else {
+                    break
+                }
+                offset += written
+            }
+        }
+        closeConnection(connectionID)
+    }
+
+    private func closeConnection(_ connectionID: UInt64) {
+        guard let connection = connections.removeValue(forKey: connectionID) else {
+            return
+        }
+        connection.source.cancel()
+        if connection.isReadingSuspended {
+            // A suspended source only runs its cancel handler, which closes the socket, once resumed.
+            connection.source.resume()
+        }
+    }
+}
@@ -18,6 +18,7 @@ import Foundation
 class OKTRedirectHTTPHandlerMock: OKTRedirectHTTPHandler {
 
     var startCalled = false
+    var persistentStartCount = 0
     var cancelCalled = false
     
     override func startHTTPListener(_ domain: String?) throws -> URL {
@@ -30,6 +31,16 @@ class OKTRedirectHTTPHandlerMock: OKTRedirectHTTPHandler {
         return try super.startHTTPListener(domain, withPort: port)
     }
 
+    override func startHTTPListener(_ domain: String?, withPort port: UInt16, fallbackPorts: NSRange) throws -> URL {
+        startCalled = true
+        return try super.startHTTPListener(domain, withPort: port, fallbackPorts: fallbackPorts)
+    }
+
+    override func startPersistentHTTPListener(_ domain: String?, withPort port: UInt16, fallbackPorts: NSRange) throws -> URL {
+        persistentStartCount += 1
+        return try super.startPersistentHTTPListener(domain, withPort: port, fallbackPorts: fallbackPorts)
+    }
+
     override func cancelHTTPListener() {
         cancelCalled = true
         super.cancelHTTPListener()
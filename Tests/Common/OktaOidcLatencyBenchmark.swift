@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import Foundation
+
+#if SWIFT_PACKAGE
+import OktaOidc_AppAuth
+#endif
+
+/// Measures the latency of session token sign-ins and token renewals against an
+/// `OktaOidcMockProvider`, phase by phase.
+///
+/// Each run signs in `signInCount` times with `authenticate(withSessionToken:)`, then renews the
+/// tokens of the last session `renewCount` times. Operations run one after another, so that the
+/// tracing spans the SDK emits can be attributed to the operation in progress. Phases are the
+/// spans of the pipelines and nest in time: `token_request` includes `id_token_validation`.
+/// `state_manager` is the time from the end of the sign-in pipeline to the callback of
+/// `authenticate`, and `total` the time from the call to the callback.
+final class OktaOidcLatencyBenchmark {
+
+    struct Configuration {
+        var signInCount = 10
+        var renewCount = 50
+        /// Latency the provider adds to every response.
+        var injectedLatency: TimeInterval = 0
+        /// Time allowed for each sign-in or renewal.
+        var timeout: TimeInterval = 10
+
+        /// Reads `OKTA_BENCHMARK_SIGN_INS`, `OKTA_BENCHMARK_RENEWS` and
+        /// `OKTA_BENCHMARK_LATENCY_MS`, keeping the defaults for missing values.
+        init(environment: [String: String] = ProcessInfo.processInfo.environment) {
+            if let value = environment["OKTA_BENCHMARK_SIGN_INS"].flatMap(Int.init) {
+                signInCount = value
+            }
+            if let value = environment["OKTA_BENCHMARK_RENEWS"].flatMap(Int.init) {
+                renewCount = value
+            }
+            if let value = environment["OKTA_BENCHMARK_LATENCY_MS"].flatMap(Double.init) {
+                injectedLatency = value / 1000
+            }
+        }
+    }
+
+    struct Phase: Encodable {
+        let operation: String
+        let name: String
+        let count: Int
+        let p50: Double
+        let p95: Double
+        let p99: Double
+        let max: Double
+
+        enum CodingKeys: String, CodingKey {
+            case operation
+            case name
+            case count
+            case p50 = "p50_ms"
+            case p95 = "p95_ms"
+            case p99 = "p99_ms"
+            case max = "max_ms"
+        }
+    }
+
+    struct Report: Encodable {
+        let signIns: Int
+        let renewals: Int
+        let injectedLatency: Double
+        let phases: [Phase]
+
+        enum CodingKeys: String, CodingKey {
+            case signIns = "sign_ins"
+            case renewals
+            case injectedLatency = "injected_latency_ms"
+            case phases
+        }
+
+        func phase(_ name: String, of operation: Operation) -> Phase? {
+            return phases.first { $0.operation == operation.rawValue && $0.name == name }
+        }
+
+        var textRepresentation: String {
+            var lines = ["operation  phase                          count     p50 ms     p95 ms     p99 ms"]
+            for phase in phases {
+                let columns = [phase.p50, phase.p95, phase.p99].map { String(format: "%10.2f", $0) }.joined(separator: " ")
+                lines.append(phase.operation.padding(toLength: 11, withPad: " ", startingAt: 0)
+                             + phase.name.padding(toLength: 28, withPad: " ", startingAt: 0)
+                             + String(format: "%8d ", phase.count)
+                             + columns)
+            }
+            return lines.joined(separator: "\n")
+        }
+    }
+
+    enum Operation: String {
+        case signIn = "sign_in"
+        case renew
+    }
+
+    enum BenchmarkError: Error {
+        case timedOut(Operation)
+        case failed(Operation, Error?)
+    }
+
+    static let statePhase = "state_manager"
+    static let totalPhase = "total"
+
+    let provider: OktaOidcMockProvider
+    let configuration: Configuration
+
+    private let tracer = PhaseTracer()
+
+    init(provider: OktaOidcMockProvider, configuration: Configuration = Configuration()) {
+        self.provider = provider
+        self.configuration = configuration
+    }
+
+    /// Runs the benchmark on the calling thread, which must be the main thread: the SDK calls back
+    /// on the main queue, so the main run loop is run while waiting.
+    func run() throws -> Report {
+        provider.setLatency(configuration.injectedLatency)
+        let oktaOidc = try OktaOidc(configuration: provider.makeConfig())
+
+        let previousTracer = OKTTracing.tracer()
+        OKTTracing.setTracer(tracer)
+        defer { OKTTracing.setTracer(previousTracer) }
+
+        var stateManager: OktaOidcStateManager?
+        for _ in 0 ..< configuration.signInCount {
+            stateManager = try signIn(with: oktaOidc)
+        }
+        if let stateManager = stateManager {
+            for _ in 0 ..< configuration.renewCount {
+                try renew(stateManager)
+            }
+        }
+
+        return Report(signIns: configuration.signInCount,
+                      renewals: stateManager == nil ? 0 : configuration.renewCount,
+                      injectedLatency: configuration.injectedLatency * 1000,
+                      phases: tracer.phases())
+    }
+}
+
+private extension OktaOidcLatencyBenchmark {
+
+    func signIn(with oktaOidc: OktaOidc) throws -> OktaOidcStateManager {
+        tracer.operation = .signIn
+        let start = DispatchTime.now()
+        let result: OktaOidcStateManager? = try perform(.signIn) { completion in
+            oktaOidc.authenticate(withSessionToken: "sessionToken") { stateManager, error in
+                let end = DispatchTime.now()
+                if stateManager != nil {
+                    self.tracer.record(OktaOidcLatencyBenchmark.totalPhase, start: start, end: end)
+                    if let pipelineEnd = self.tracer.lastEnd(of: OKTTraceSpanSessionTokenSignIn) {
+                        self.tracer.record(OktaOidcLatencyBenchmark.statePhase, start: pipelineEnd, end: end)
+                    }
+                }
+                completion(stateManager, error)
+            }
+        }
+        return result!
+    }
+
+    func renew(_ stateManager: OktaOidcStateManager) throws {
+        tracer.operation = .renew
+        let start = DispatchTime.now()
+        let _: OktaOidcStateManager? = try perform(.renew) { completion in
+            stateManager.renew { renewedStateManager, error in
+                if renewedStateManager != nil {
+                    self.tracer.record(OktaOidcLatencyBenchmark.totalPhase, start: start, end: DispatchTime.now())
+                }
+                completion(renewedStateManager, error)
+            }
+        }
+    }
+
+    func perform<T>(_ operation: Operation, _ body: (@escaping (T?, Error?) -> Void) -> Void) throws -> T? {
+        var isFinished = false
+        var result: T?
+        var resultError: Error?
+        body { value, error in
+            result = value
+            resultError = error
+            isFinished = true
+        }
+
+        let deadline = Date(timeIntervalSinceNow: configuration.timeout)
+        while !isFinished && Date() < deadline {
+            RunLoop.main.run(mode: .default, before: min(deadline, Date(timeIntervalSinceNow: 0.01)))
+        }
+        guard isFinished else {
+            throw BenchmarkError.timedOut(operation)
+        }
+        guard result != nil else {
+            throw BenchmarkError.failed(operation, resultError)
+        }
+        return result
+    }
+}
+
+/// Records the duration of every span into a histogram keyed by the operation in progress and the
+/// span name.
+private final class PhaseTracer: NSObject, OKTTracer {
+
+    var operation: OktaOidcLatencyBenchmark.Operation {
+        get { lock.synchronized { currentOperation } }
+        set { lock.synchronized { currentOperation = newValue } }
+    }
+
+    private let lock = NSLock()
+    private var currentOperation = OktaOidcLatencyBenchmark.Operation.signIn
+    private var histograms: [String: [String: OKTLatencyHistogram]] = [:]
+    private var phaseOrder: [(OktaOidcLatencyBenchmark.Operation, String)] = []
+    private var lastEnds: [String: DispatchTime] = [:]
+
+    func beginSpan(_ name: String) -> OKTTraceSpan {
+        return PhaseSpan(name: name, tracer: self)
+    }
+
+    func record(_ phase: String, start: DispatchTime, end: DispatchTime) {
+        let latency = TimeInterval(end.uptimeNanoseconds - start.uptimeNanoseconds) / 1_000_000_000
+        lock.synchronized {
+            lastEnds[phase] = end
+            if histograms[currentOperation.rawValue]?[phase] == nil {
+                histograms[currentOperation.rawValue, default: [:]][phase] = OKTLatencyHistogram()
+                phaseOrder.append((currentOperation, phase))
+            }
+            histograms[currentOperation.rawValue]![phase]!.record(latency)
+        }
+    }
+
+    func lastEnd(of phase: String) -> DispatchTime? {
+        return lock.synchronized { lastEnds[phase] }
+    }
+
+    /// The phases of each operation in the order they were first recorded.
+    func phases() -> [OktaOidcLatencyBenchmark.Phase] {
+        return lock.synchronized {
+            phaseOrder.map { operation, name in
+                let histogram = histograms[operation.rawValue]![name]!
+                return OktaOidcLatencyBenchmark.Phase(operation: operation.rawValue,
+                                                      name: name,
+                                                      count: Int(histogram.count),
+                                                      p50: histogram.latency(atPercentile: 50) * 1000,
+                                                      p95: histogram.latency(atPercentile: 95) * 1000,
+                                                      p99: histogram.latency(atPercentile: 99) * 1000,
+                                                      max: histogram.maximum * 1000)
+            }
+        }
+    }
+}
+
+private final class PhaseSpan: NSObject, OKTTraceSpan {
+
+    private let name: String
+    private let start = DispatchTime.now()
+    private weak var tracer: PhaseTracer?
+
+    init(name: String, tracer: PhaseTracer) {
+        self.name = name
+        self.tracer = tracer
+    }
+
+    func setAttribute(_ value: String, forKey key: String) {}
+
+    func end(error: Error?) {
+        guard error == nil else {
+            return
+        }
+        tracer?.record(name, start: start, end: DispatchTime.now())
+    }
+}
+
+private extension NSLock {
+    func synchronized<T>(_ body: () throws -> T) rethrows -> T {
+        lock()
+        defer { unlock() }
+        return try body()
+    }
+}
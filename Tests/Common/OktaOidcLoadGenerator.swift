@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import Foundation
+
+#if SWIFT_PACKAGE
+import OktaOidc_AppAuth
+#endif
+
+/// Drives many `OktaOidcStateManager` sessions at once against an `OktaOidcMockProvider`.
+///
+/// The generator signs in `sessionCount` sessions whose access tokens go stale at staggered times
+/// within `expiryWindow`. Then `workerCount` threads issue operations on random sessions for
+/// `duration`: actions with fresh tokens, userinfo, introspect and revoke requests. Revocations
+/// target throwaway tokens so that sessions stay usable.
+///
+/// The report has the throughput and latency percentiles of each operation, the refresh counters of
+/// `OKTMetricsRegistry`, the delay of blocks dispatched to the main queue, which every SDK callback
+/// goes through, and the peak resident memory.
+final class OktaOidcLoadGenerator {
+
+    struct Configuration {
+        var sessionCount = 50
+        var workerCount = 8
+        var duration: TimeInterval = 2
+        /// The window over which the access tokens of the sessions go stale.
+        var expiryWindow: TimeInterval = 1
+        /// Latency the provider adds to every response.
+        var injectedLatency: TimeInterval = 0
+        /// Relative weights of the operations picked by the workers.
+        var weights: [Operation: Int] = [.freshTokens: 6, .userInfo: 2, .introspect: 1, .revoke: 1]
+        /// Time allowed for each sign-in or operation.
+        var timeout: TimeInterval = 30
+
+        /// Reads `OKTA_LOAD_SESSIONS`, `OKTA_LOAD_WORKERS`, `OKTA_LOAD_DURATION`,
+        /// `OKTA_LOAD_EXPIRY_WINDOW` and `OKTA_LOAD_LATENCY_MS`, keeping the defaults for missing
+        /// values.
+        init(environment: [String: String] = ProcessInfo.processInfo.environment) {
+            if let value = environment["OKTA_LOAD_SESSIONS"].flatMap(Int.init) {
+                sessionCount = value
+            }
+            if let value = environment["OKTA_LOAD_WORKERS"].flatMap(Int.init) {
+                workerCount = value
+            }
+            if let value = environment["OKTA_LOAD_DURATION"].flatMap(TimeInterval.init) {
+                duration = value
+            }
+            if let value = environment["OKTA_LOAD_EXPIRY_WINDOW"].flatMap(TimeInterval.init) {
+                expiryWindow = value
+            }
+            if let value = environment["OKTA_LOAD_LATENCY_MS"].flatMap(Double.init) {
+                injectedLatency = value / 1000
+            }
+        }
+    }
+
+    enum Operation: String, CaseIterable {
+        case freshTokens = "fresh_tokens"
+        case userInfo = "user_info"
+        case introspect
+        case revoke
+    }
+
+    struct OperationResult: Encodable {
+        let name: String
+        let count: Int
+        let errors: Int
+        let throughput: Double
+        let p50: Double
+        let p99: Double
+        let p999: Double
+        let max: Double
+
+        enum CodingKeys: String, CodingKey {
+            case name
+            case count
+            case errors
+            case throughput = "ops_per_second"
+            case p50 = "p50_ms"
+            case p99 = "p99_ms"
+            case p999 = "p999_ms"
+            case max = "max_ms"
+        }
+    }
+
+    struct Report: Encodable {
+        let sessions: Int
+        let workers: Int
+        let duration: Double
+        let throughput: Double
+        let operations: [OperationResult]
+        /// Refresh requests sent, each counted once, and actions or sessions that joined a refresh
+        /// already in flight instead.
+        let tokenRefreshes: Int
+        let coalescedRefreshWaiters: Int
+        let tokenRequests: Int
+        /// The share of the actions needing a refresh that did not start their own.
+        let coalescingEfficiency: Double
+        let mainQueueDelayP50: Double
+        let mainQueueDelayP99: Double
+        let peakResidentBytes: UInt64
+
+        enum CodingKeys: String, CodingKey {
+            case sessions
+            case workers
+            case duration = "duration_s"
+            case throughput = "ops_per_second"
+            case operations
+            case tokenRefreshes = "token_refreshes"
+            case coalescedRefreshWaiters = "coalesced_refresh_waiters"
+            case tokenRequests = "token_requests"
+            case coalescingEfficiency = "coalescing_efficiency"
+            case mainQueueDelayP50 = "main_queue_delay_p50_ms"
+            case mainQueueDelayP99 = "main_queue_delay_p99_ms"
+            case peakResidentBytes = "peak_resident_bytes"
+        }
+
+        func operation(_ operation: Operation) -> OperationResult? {
+            return operations.first { $0.name == operation.rawValue }
+        }
+
+        var textRepresentation: String {
+            var lines = [String(format: "%d sessions, %d workers, %.1f s: %.0f ops/s", sessions, workers, duration, throughput),
+                         "operation        count  errors     ops/s     p50 ms     p99 ms   p99.9 ms"]
+            for operation in operations {
+                lines.append(operation.name.padding(toLength: 14, withPad: " ", startingAt: 0)
+                             + String(format: "%8d %7d %9.0f %10.2f %10.2f %10.2f",
+                                      operation.count, operation.errors, operation.throughput,
+                                      operation.p50, operation.p99, operation.p999))
+            }
+            lines.append(String(format: "refreshes %d, coalesced waiters %d, token requests %d, coalescing %.1f%%",
+                                tokenRefreshes, coalescedRefreshWaiters, tokenRequests, coalescingEfficiency * 100))
+            lines.append(String(format: "main queue delay p50 %.2f ms, p99 %.2f ms", mainQueueDelayP50, mainQueueDelayP99))
+            lines.append("peak resident memory \(ByteCountFormatter.string(fromByteCount: Int64(peakResidentBytes), countStyle: .memory))")
+            return lines.joined(separator: "\n")
+        }
+    }
+
+    enum LoadError: Error {
+        case timedOut
+        case signInFailed(Error?)
+    }
+
+    /// `OKTAuthState` treats access tokens expiring within this interval as stale.
+    static let expiryTolerance: TimeInterval = 60
+
+    let provider: OktaOidcMockProvider
+    let configuration: Configuration
+
+    private let lock = NSLock()
+    private var histograms: [Operation: OKTLatencyHistogram] = [:]
+    private var errorCounts: [Operation: Int] = [:]
+    private let mainQueueDelays = OKTLatencyHistogram()
+
+    init(provider: OktaOidcMockProvider, configuration: Configuration = Configuration()) {
+        self.provider = provider
+        self.configuration = configuration
+    }
+
+    /// Runs the load on the calling thread, which must be the main thread: the SDK calls back on
+    /// the main queue, so the main run loop is run while the workers wait for their callbacks.
+    func run() throws -> Report {
+        provider.setLatency(configuration.injectedLatency)
+        let sessions = try makeSessions()
+
+        // Tokens issued by refreshes go stale again after another window.
+        provider.tokenLifetime = OktaOidcLoadGenerator.expiryTolerance + configuration.expiryWindow
+        let tokenRequestsBefore = provider.requestCount(for: .token)
+        OKTMetricsRegistry.shared().reset()
+
+        let delaySampler = startMainQueueDelaySampler()
+        let start = Date()
+        let group = DispatchGroup()
+        for worker in 0 ..< configuration.workerCount {
+            group.enter()
+            Thread.detachNewThread {
+                self.runWorker(worker, sessions: sessions, until: start.addingTimeInterval(self.configuration.duration))
+                group.leave()
+            }
+        }
+        try waitOnMainRunLoop(timeout: configuration.duration + configuration.timeout) { done in
+            group.notify(queue: .global()) { done() }
+        }
+        let elapsed = Date().timeIntervalSince(start)
+        delaySampler.cancel()
+
+        let metrics = OKTMetricsRegistry.shared().snapshot()
+        let refreshes = Int(metrics.value(ofCounter: OKTMetricTokenRefreshes))
+        let waiters = Int(metrics.value(ofCounter: OKTMetricCoalescedRefreshWaiters))
+        return lock.synchronized {
+            let operations = Operation.allCases.compactMap { operation -> OperationResult? in
+                guard let histogram = histograms[operation] else {
+                    return nil
+                }
+                return OperationResult(name: operation.rawValue,
+                                       count: Int(histogram.count),
+                                       errors: errorCounts[operation] ?? 0,
+                                       throughput: Double(histogram.count) / elapsed,
+                                       p50: histogram.latency(atPercentile: 50) * 1000,
+                                       p99: histogram.latency(atPercentile: 99) * 1000,
+                                       p999: histogram.latency(atPercentile: 99.9) * 1000,
+                                       max: histogram.maximum * 1000)
+            }
+            return Report(sessions: sessions.count,
+                          workers: configuration.workerCount,
+                          duration: elapsed,
+                          throughput: Double(operations.reduce(0) { $0 + $1.count }) / elapsed,
+                          operations: operations,
+                          tokenRefreshes: refreshes,
+                          coalescedRefreshWaiters: waiters,
+                          tokenRequests: provider.requestCount(for: .token) - tokenRequestsBefore,
+                          coalescingEfficiency: refreshes + waiters == 0 ? 0 : Double(waiters) / Double(refreshes + waiters),
+                          mainQueueDelayP50: mainQueueDelays.latency(atPercentile: 50) * 1000,
+                          mainQueueDelayP99: mainQueueDelays.latency(atPercentile: 99) * 1000,
+                          peakResidentBytes: OktaOidcLoadGenerator.peakResidentBytes())
+        }
+    }
+}
+
+private extension OktaOidcLoadGenerator {
+
+    /// Signs in the sessions, as many at a time as there are workers. The token lifetime grows
+    /// with each batch, so that the tokens of later sessions go stale later.
+    func makeSessions() throws -> [OktaOidcStateManager] {
+        let oktaOidc = try OktaOidc(configuration: provider.makeConfig())
+        var sessions: [OktaOidcStateManager] = []
+        let batchSize = max(configuration.workerCount, 1)
+        while sessions.count < configuration.sessionCount {
+            let count = min(batchSize, configuration.sessionCount - sessions.count)
+            let fraction = Double(sessions.count) / Double(configuration.sessionCount)
+            provider.tokenLifetime = OktaOidcLoadGenerator.expiryTolerance + configuration.expiryWindow * fraction
+
+            var batch: [OktaOidcStateManager] = []
+            var failure: Error?
+            try waitOnMainRunLoop(timeout: configuration.timeout) { done in
+                var pending = count
+                for _ in 0 ..< count {
+                    oktaOidc.authenticate(withSessionToken: "sessionToken") { stateManager, error in
+                        if let stateManager = stateManager {
+                            batch.append(stateManager)
+                        } else {
+                            failure = error
+                        }
+                        pending -= 1
+                        if pending == 0 {
+                            done()
+                        }
+                    }
+                }
+            }
+            guard failure == nil else {
+                throw LoadError.signInFailed(failure)
+            }
+            sessions += batch
+        }
+        return sessions
+    }
+
+    func runWorker(_ worker: Int, sessions: [OktaOidcStateManager], until deadline: Date) {
+        guard !sessions.isEmpty else {
+            return
+        }
+
+        let operations = Operation.allCases.flatMap { Array(repeating: $0, count: configuration.weights[$0] ?? 0) }
+        var revocationCount = 0
+        let semaphore = DispatchSemaphore(value: 0)
+        while !operations.isEmpty && Date() < deadline {
+            let session = sessions.randomElement()!
+            let operation = operations.randomElement()!
+            let start = DispatchTime.now()
+            var failed = false
+            let completion = { (error: Error?) in
+                failed = error != nil
+                semaphore.signal()
+            }
+
+            switch operation {
+            case .freshTokens:
+                session.authState.performAction { _, _, error in completion(error) }
+            case .userInfo:
+                session.getUser { _, error in completion(error) }
+            case .introspect:
+                session.introspect(token: session.accessToken) { _, error in completion(error) }
+            case .revoke:
+                revocationCount += 1
+                session.revoke("load-\(worker)-\(revocationCount)") { _, error in completion(error) }
+            }
+
+            guard semaphore.wait(timeout: .now() + configuration.timeout) == .success else {
+                record(operation, start: start, failed: true)
+                return
+            }
+            record(operation, start: start, failed: failed)
+        }
+    }
+
+    func record(_ operation: Operation, start: DispatchTime, failed: Bool) {
+        let latency = TimeInterval(DispatchTime.now().uptimeNanoseconds - start.uptimeNanoseconds) / 1_000_000_000
+        lock.synchronized {
+            if histograms[operation] == nil {
+                histograms[operation] = OKTLatencyHistogram()
+            }
+            histograms[operation]!.record(latency)
+            if failed {
+                errorCounts[operation, default: 0] += 1
+            }
+        }
+    }
+
+    /// Measures how long blocks wait to run on the main queue, every 10 ms.
+    func startMainQueueDelaySampler() -> DispatchSourceTimer {
+        let timer = DispatchSource.makeTimerSource(queue: DispatchQueue.global(qos: .utility))
+        timer.schedule(deadline: .now(), repeating: .milliseconds(10))
+        timer.setEventHandler {
+            let posted = DispatchTime.now()
+            DispatchQueue.main.async {
+                let delay = TimeInterval(DispatchTime.now().uptimeNanoseconds - posted.uptimeNanoseconds) / 1_000_000_000
+                self.lock.synchronized {
+                    self.mainQueueDelays.record(delay)
+                }
+            }
+        }
+        timer.resume()
+        return timer
+    }
+
+    /// Runs the main run loop until `body` calls its completion. The completion may be called from
+    /// any thread.
+    func waitOnMainRunLoop(timeout: TimeInterval, _ body: (@escaping () -> Void) -> Void) throws {
+        let finished = DispatchSemaphore(value: 0)
+        body { finished.signal() }
+
+        let deadline = Date(timeIntervalSinceNow: timeout)
+        while finished.wait(timeout: .now()) != .success {
+            guard Date() < deadline else {
+                throw LoadError.timedOut
+            }
+            RunLoop.main.run(mode: .default, before: min(deadline, Date(timeIntervalSinceNow: 0.01)))
+        }
+    }
+
+    static func peakResidentBytes() -> UInt64 {
+        var usage = rusage()
+        guard getrusage(RUSAGE_SELF, &usage) == 0 else {
+            return 0
+        }
+        #if canImport(Darwin)
+        return UInt64(usage.ru_maxrss)
+        #else
+        return UInt64(usage.ru_maxrss) * 1024
+        #endif
+    }
+}
+
+private extension NSLock {
+    func synchronized<T>(_ body: () throws -> T) rethrows -> T {
+        lock()
+        defer { unlock() }
+        return try body()
+    }
+}
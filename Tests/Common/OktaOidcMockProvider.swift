@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import Foundation
+
+#if SWIFT_PACKAGE
+import OktaOidc_AppAuth
+#endif
+
+/// An in-process stand-in for an Okta authorization server, served over HTTP on 127.0.0.1.
+///
+/// It implements discovery, authorize (answering session token requests with a 302 carrying the
+/// code), the authorization code and refresh token grants with refresh token rotation, introspect,
+/// revoke, userinfo and JWKS. ID and access tokens are HS256 JWTs signed with a random key that the
+/// JWKS endpoint publishes as an `oct` key. Latency and errors can be injected per endpoint.
+final class OktaOidcMockProvider {
+
+    enum Endpoint: String, CaseIterable {
+        case discovery = "/.well-known/openid-configuration"
+        case authorize = "/v1/authorize"
+        case token = "/v1/token"
+        case introspect = "/v1/introspect"
+        case revoke = "/v1/revoke"
+        case userInfo = "/v1/userinfo"
+        case keys = "/v1/keys"
+        case logout = "/v1/logout"
+    }
+
+    static let authorizationServerPath = "/oauth2/default"
+    static let subject = "00umockuser"
+
+    let clientId: String
+    let signingKey: Data
+
+    /// Lifetime of issued access and ID tokens.
+    var tokenLifetime: TimeInterval {
+        get { lock.synchronized { lifetime } }
+        set { lock.synchronized { lifetime = newValue } }
+    }
+
+    /// Whether refresh token grants replace the refresh token and revoke the old one.
+    var rotatesRefreshTokens: Bool {
+        get { lock.synchronized { rotation } }
+        set { lock.synchronized { rotation = newValue } }
+    }
+
+    var issuer: String {
+        return "http://127.0.0.1:\(server.port)\(OktaOidcMockProvider.authorizationServerPath)"
+    }
+
+    private let lock = NSLock()
+    private var lifetime: TimeInterval = 3600
+    private var rotation = true
+    private var defaultLatency: TimeInterval = 0
+    private var latencies: [Endpoint: TimeInterval] = [:]
+    private var injectedErrors: [Endpoint: [MockHTTPResponse]] = [:]
+    private var requestCounts: [Endpoint: Int] = [:]
+    private var authorizationCodes: [String: AuthorizationGrant] = [:]
+    private var refreshTokens: [String: String] = [:]
+    private var accessTokens: Set<String> = []
+    private var server: MockHTTPServer!
+
+    private struct AuthorizationGrant {
+        let redirectUri: String
+        let scope: String
+        let nonce: String?
+        let codeChallenge: String?
+    }
+
+    init(clientId: String = TestUtils.mockClientId) {
+        self.clientId = clientId
+        signingKey = Data(OKTTokenUtilities.randomURLSafeString(withSize: 32)!.utf8)
+        server = MockHTTPServer { [unowned self] request, respond in
+            self.handle(request, respond: respond)
+        }
+    }
+
+    func start() throws {
+        try server.start()
+    }
+
+    func stop() {
+        server.stop()
+    }
+
+    /// An OktaOidc configuration pointing at this provider. Creating it also installs the SDK's
+    /// own URL session, replacing any mock session set by an earlier test.
+    func makeConfig(scopes: String = "openid profile offline_access") throws -> OktaOidcConfig {
+        return try OktaOidcConfig(with: [
+            "issuer": issuer,
+            "clientId": clientId,
+            "redirectUri": TestUtils.mockRedirectUri,
+            "scopes": scopes
+        ])
+    }
+
+    /// Delays responses of `endpoint`, or of every endpoint without its own latency when nil.
+    func setLatency(_ latency: TimeInterval, for endpoint: Endpoint? = nil) {
+        lock.synchronized {
+            if let endpoint = endpoint {
+                latencies[endpoint] = latency
+            } else {
+                defaultLatency = latency
+            }
+        }
+    }
+
+    /// Answers the next `count` requests to `endpoint` with an OAuth error response.
+    func injectError(statusCode: Int, error: String = "server_error", for endpoint: Endpoint, count: Int = 1) {
+        let response = MockHTTPResponse.json(["error": error, "error_description": "Injected error"], statusCode: statusCode)
+        lock.synchronized {
+            injectedErrors[endpoint, default: []] += Array(repeating: response, count: count)
+        }
+    }
+
+    func requestCount(for endpoint: Endpoint) -> Int {
+        return lock.synchronized { requestCounts[endpoint] ?? 0 }
+    }
+}
+
+private extension OktaOidcMockProvider {
+
+    func handle(_ request: MockHTTPRequest, respond: @escaping (MockHTTPResponse) -> Void) {
+        let path = request.path.hasPrefix(OktaOidcMockProvider.authorizationServerPath)
+            ? String(request.path.dropFirst(OktaOidcMockProvider.authorizationServerPath.count))
+            : request.path
+        guard let endpoint = Endpoint(rawValue: path) else {
+            respond(MockHTTPResponse(statusCode: 404))
+            return
+        }
+
+        let (response, latency): (MockHTTPResponse, TimeInterval) = lock.synchronized {
+            requestCounts[endpoint, default: 0] += 1
+            let latency = latencies[endpoint] ?? defaultLatency
+            if let injectedError = injectedErrors[endpoint]?.first {
+                injectedErrors[endpoint]?.removeFirst()
+                return (injectedError, latency)
+            }
+            return (makeResponse(to: request, at: endpoint), latency)
+        }
+
+        if latency > 0 {
+            DispatchQueue.global().asyncAfter(deadline: .now() + latency) {
+                respond(response)
+            }
+        } else {
+            respond(response)
+        }
+    }
+
+    /// Called with `lock` held.
+    func makeResponse(to request: MockHTTPRequest, at endpoint: Endpoint) -> MockHTTPResponse {
+        switch endpoint {
+        case .discovery:
+            return .json(discoveryDocument())
+        case .authorize:
+            return authorize(request.queryItems)
+        case .token:
+            return token(request.formParameters)
+        case .introspect:
+            let token = request.formParameters["token"] ?? ""
+            guard accessTokens.contains(token) || refreshTokens[token] != nil else {
+                return .json(["active": false])
+            }
+            return .json(["active": true, "sub": OktaOidcMockProvider.subject, "client_id": clientId] as [String: Any])
+        case .revoke:
+            let token = request.formParameters["token"] ?? ""
+            accessTokens.remove(token)
+            refreshTokens.removeValue(forKey: token)
+            return MockHTTPResponse(statusCode: 200)
+        case .userInfo:
+            let authorization = request.headers["authorization"] ?? ""
+            guard authorization.hasPrefix("Bearer "), accessTokens.contains(String(authorization.dropFirst(7))) else {
+                return .json(["error": "invalid_token"], statusCode: 401)
+            }
+            return .json(["sub": OktaOidcMockProvider.subject, "name": "Mock User", "preferred_username": "mock.user@example.com"])
+        case .keys:
+            let key = OKTTokenUtilities.encodeBase64urlNoPadding(signingKey)
+            return .json(["keys": [["kty": "oct", "kid": "mock", "alg": "HS256", "use": "sig", "k": key]]])
+        case .logout:
+            guard let redirectUri = request.queryItems["post_logout_redirect_uri"] else {
+                return MockHTTPResponse(statusCode: 200)
+            }
+            return .redirect(to: redirectURL(redirectUri, ["state": request.queryItems["state"]]))
+        }
+    }
+
+    func discoveryDocument() -> [String: Any] {
+        let endpoint = { (endpoint: Endpoint) in self.issuer + endpoint.rawValue }
+        return [
+            "issuer": issuer,
+            "authorization_endpoint": endpoint(.authorize),
+            "token_endpoint": endpoint(.token),
+            "userinfo_endpoint": endpoint(.userInfo),
+            "introspection_endpoint": endpoint(.introspect),
+            "revocation_endpoint": endpoint(.revoke),
+            "end_session_endpoint": endpoint(.logout),
+            "jwks_uri": endpoint(.keys),
+            "response_types_supported": ["code"],
+            "subject_types_supported": ["public"],
+            "id_token_signing_alg_values_supported": ["HS256"],
+            "grant_types_supported": ["authorization_code", "refresh_token"],
+            "code_challenge_methods_supported": ["S256"]
+        ]
+    }
+
+    func authorize(_ query: [String: String]) -> MockHTTPResponse {
+        guard query["client_id"] == clientId, let redirectUri = query["redirect_uri"] else {
+            return .json(["error": "invalid_client"], statusCode: 400)
+        }
+        guard query["sessionToken"]?.isEmpty == false else {
+            return .redirect(to: redirectURL(redirectUri, ["error": "login_required", "state": query["state"]]))
+        }
+
+        let code = OKTTokenUtilities.randomURLSafeString(withSize: 16)!
+        authorizationCodes[code] = AuthorizationGrant(redirectUri: redirectUri,
+                                                      scope: query["scope"] ?? "openid",
+                                                      nonce: query["nonce"],
+                                                      codeChallenge: query["code_challenge"])
+        return .redirect(to: redirectURL(redirectUri, ["code": code, "state": query["state"]]))
+    }
+
+    func token(_ parameters: [String: String]) -> MockHTTPResponse {
+        guard parameters["client_id"] == clientId else {
+            return .json(["error": "invalid_client"], statusCode: 401)
+        }
+
+        switch parameters["grant_type"] {
+        case "authorization_code":
+            guard let code = parameters["code"],
+                  let grant = authorizationCodes.removeValue(forKey: code),
+                  grant.redirectUri == parameters["redirect_uri"] else {
+                return .json(["error": "invalid_grant"], statusCode: 400)
+            }
+            if let challenge = grant.codeChallenge {
+                let verifier = parameters["code_verifier"] ?? ""
+                guard OKTTokenUtilities.encodeBase64urlNoPadding(OKTTokenUtilities.sha256(verifier)) == challenge else {
+                    return .json(["error": "invalid_grant"], statusCode: 400)
+                }
+            }
+            return .json(issueTokens(scope: grant.scope, nonce: grant.nonce, refreshToken: nil))
+        case "refresh_token":
+            guard let refreshToken = parameters["refresh_token"], let scope = refreshTokens[refreshToken] else {
+                return .json(["error": "invalid_grant"], statusCode: 400)
+            }
+            return .json(issueTokens(scope: scope, nonce: nil, refreshToken: refreshToken))
+        default:
+            return .json(["error": "unsupported_grant_type"], statusCode: 400)
+        }
+    }
+
+    /// Called with `lock` held.
+    func issueTokens(scope: String, nonce: String?, refreshToken currentRefreshToken: String?) -> [String: Any] {
+        let now = Int(Date().timeIntervalSince1970)
+        let expiresIn = Int(lifetime)
+        var idTokenClaims: [String: Any] = [
+            "iss": issuer,
+            "sub": OktaOidcMockProvider.subject,
+            "aud": clientId,
+            "iat": now,
+            "exp": now + expiresIn,
+            "auth_time": now
+        ]
+        idTokenClaims["nonce"] = nonce
+        let accessToken = signedJWT([
+            "iss": issuer,
+            "sub": OktaOidcMockProvider.subject,
+            "aud": "api://default",
+            "cid": clientId,
+            "scp": scope.split(separator: " ").map(String.init),
+            "iat": now,
+            "exp": now + expiresIn,
+            "jti": OKTTokenUtilities.randomURLSafeString(withSize: 8)!
+        ])
+        accessTokens.insert(accessToken)
+
+        var tokens: [String: Any] = [
+            "access_token": accessToken,
+            "token_type": "Bearer",
+            "expires_in": expiresIn,
+            "scope": scope,
+            "id_token": signedJWT(idTokenClaims)
+        ]
+        if let currentRefreshToken = currentRefreshToken, !rotation {
+            tokens["refresh_token"] = currentRefreshToken
+        } else if scope.split(separator: " ").contains("offline_access") {
+            if let currentRefreshToken = currentRefreshToken {
+                refreshTokens.removeValue(forKey: currentRefreshToken)
+            }
+            let refreshToken = OKTTokenUtilities.randomURLSafeString(withSize: 32)!
+            refreshTokens[refreshToken] = scope
+            tokens["refresh_token"] = refreshToken
+        }
+        return tokens
+    }
+
+    func signedJWT(_ claims: [String: Any]) -> String {
+        let encode = { (object: [String: Any]) in
+            OKTTokenUtilities.encodeBase64urlNoPadding(try! JSONSerialization.data(withJSONObject: object, options: []))
+        }
+        let signingInput = encode(["alg": "HS256", "kid": "mock", "typ": "JWT"]) + "." + encode(claims)
+        let signature = OKTCrypto.provider().hmacSHA256(of: Data(signingInput.utf8), key: signingKey)
+        return signingInput + "." + OKTTokenUtilities.encodeBase64urlNoPadding(signature)
+    }
+
+    func redirectURL(_ redirectUri: String, _ parameters: [String: String?]) -> String {
+        var components = URLComponents(string: redirectUri)!
+        components.queryItems = parameters.compactMap { name, value in
+            value.map { URLQueryItem(name: name, value: $0) }
+        }
+        return components.string!
+    }
+}
+
+private extension NSLock {
+    func synchronized<T>(_ body: () throws -> T) rethrows -> T {
+        lock()
+        defer { unlock() }
+        return try body()
+    }
+}
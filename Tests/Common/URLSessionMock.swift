@@ -34,23 +34,51 @@ class URLSessionMock: URLSession {
         var statusCode: Int = 200
         var headerFields: [String: String]?
         var data = Data()
+        var error: Error?
     }
 
     var request: URLRequest?
     var responses: [Response]?
+    var requestCount = 0
+
+    /// When set, tasks don't complete on `resume()` but wait for `completePendingTasks()`.
+    var defersCompletion = false
+    private var pendingCompletions: [() -> Void] = []
+
+    func completePendingTasks() {
+        let completions = pendingCompletions
+        pendingCompletions = []
+        completions.forEach { $0() }
+    }
     
     override func dataTask(with request: URLRequest, completionHandler: @escaping (Data?, URLResponse?, Error?) -> Void) -> URLSessionDataTask {
         self.request = request
-        let responseData = responses?.removeFirst() ?? Response()
-        
-        let response = HTTPURLResponse(
-            url: request.url!,
-            statusCode: responseData.statusCode,
-            httpVersion: nil,
-            headerFields: responseData.headerFields
-        )
+        requestCount += 1
+        let responseData = responses?.isEmpty == false ? responses!.removeFirst() : Response()
+
+        let completion: () -> Void
+        if let error = responseData.error {
+            completion = {
+                completionHandler(nil, nil, error)
+            }
+        } else {
+            let response = HTTPURLResponse(
+                url: request.url!,
+                statusCode: responseData.statusCode,
+                httpVersion: nil,
+                headerFields: responseData.headerFields
+            )
+            completion = {
+                completionHandler(responseData.data, response, nil)
+            }
+        }
+
         return URLSessionDataTaskMock() {
-            completionHandler(responseData.data, response, nil)
+            if self.defersCompletion {
+                self.pendingCompletions.append(completion)
+            } else {
+                completion()
+            }
         }
     }
 }
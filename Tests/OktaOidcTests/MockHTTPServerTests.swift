@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+
+import XCTest
+#if canImport(Glibc)
+import Glibc
+private let streamSocketType = Int32(SOCK_STREAM.rawValue)
+private let writeShutdown = Int32(SHUT_WR)
+#else
+import Darwin
+private let streamSocketType = SOCK_STREAM
+private let writeShutdown = SHUT_WR
+#endif
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class MockHTTPServerTests: XCTestCase {
+
+    var server: MockHTTPServer!
+
+    override func setUp() {
+        super.setUp()
+
+        // Responds to "/<delay in milliseconds>" after that delay, with the path as the body.
+        server = MockHTTPServer { request, respond in
+            let delay = Double(request.path.dropFirst()).map { $0 / 1000 } ?? 0
+            DispatchQueue.global().asyncAfter(deadline: .now() + delay) {
+                respond(MockHTTPResponse(statusCode: 200, body: Data(request.path.utf8)))
+            }
+        }
+        try! server.start()
+    }
+
+    override func tearDown() {
+        server.stop()
+        server = nil
+        super.tearDown()
+    }
+
+    func testHalfClosedRequestIsAnswered() {
+        let client = connectClient()
+        sendRequest("GET /0 HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", to: client)
+        shutdown(client, writeShutdown)
+
+        let response = readResponse(from: client)
+        XCTAssertTrue(response.hasPrefix("HTTP/1.1 200"))
+        XCTAssertTrue(response.hasSuffix("/0"))
+    }
+
+    func testDelayedResponseIsNotSentToLaterConnection() {
+        // The first client resets its connection while its response is delayed, so that the server
+        // closes the connection and can reuse its socket number for the next one.
+        let resetClient = connectClient()
+        sendRequest("GET /300 HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", to: resetClient)
+        var reset = linger(l_onoff: 1, l_linger: 0)
+        setsockopt(resetClient, SOL_SOCKET, SO_LINGER, &reset, socklen_t(MemoryLayout<linger>.size))
+        close(resetClient)
+        Thread.sleep(forTimeInterval: 0.1)
+
+        let client = connectClient()
+        sendRequest("GET /600 HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n", to: client)
+
+        let response = readResponse(from: client)
+        XCTAssertTrue(response.hasSuffix("/600"), response)
+    }
+}
+
+private extension MockHTTPServerTests {
+
+    func connectClient() -> Int32 {
+        let client = socket(AF_INET, streamSocketType, 0)
+        var address = sockaddr_in()
+        #if !canImport(Glibc)
+        address.sin_len = UInt8(MemoryLayout<sockaddr_in>.size)
+        #endif
+        address.sin_family = sa_family_t(AF_INET)
+        address.sin_port = server.port.bigEndian
+        address.sin_addr.s_addr = UInt32(0x7F00_0001).bigEndian
+        let connected = withUnsafePointer(to: &address) { pointer in
+            pointer.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+                connect(client, $0, socklen_t(MemoryLayout<sockaddr_in>.size)) == 0
+            }
+        }
+        XCTAssertTrue(connected)
+        return client
+    }
+
+    func sendRequest(_ request: String, to client: Int32) {
+        let bytes = Array(request.utf8)
+        XCTAssertEqual(write(client, bytes, bytes.count), bytes.count)
+    }
+
+    /// Reads until the server closes the connection.
+    func readResponse(from client: Int32) -> String {
+        var timeout = timeval(tv_sec: 5, tv_usec: 0)
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, socklen_t(MemoryLayout<timeval>.size))
+        var response = Data()
+        var chunk = [UInt8](repeating: 0, count: 4096)
+        while true {
+            let count = read(client, &chunk, chunk.count)
+            guard count > 0 else {
+                break
+            }
+            response.append(chunk, count: count)
+        }
+        close(client)
+        return String(decoding: response, as: UTF8.self)
+    }
+}
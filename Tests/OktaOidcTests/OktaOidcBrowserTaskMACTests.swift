@@ -125,6 +125,21 @@ class OktaOidcBrowserTaskMACTests: XCTestCase {
         waitForExpectations(timeout: 5.0, handler: nil)
     }
 
+    func testRedirectEventHandlerCountsTasksFromManyThreads() {
+        let handler = OktaOidcRedirectEventHandler.shared
+        let initialCount = handler.activeTaskCount
+
+        DispatchQueue.concurrentPerform(iterations: 200) { _ in
+            handler.addTask()
+        }
+        XCTAssertEqual(handler.activeTaskCount, initialCount + 200)
+
+        DispatchQueue.concurrentPerform(iterations: 200) { _ in
+            handler.removeTask()
+        }
+        XCTAssertEqual(handler.activeTaskCount, initialCount)
+    }
+
     func testExternalUserAgentMethod() {
         guard let config = createTestConfig() else {
             XCTFail("Failed to create test config")
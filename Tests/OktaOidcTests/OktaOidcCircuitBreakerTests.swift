@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcCircuitBreakerTests: XCTestCase {
+
+    var sessionMock: URLSessionMock!
+
+    override func setUp() {
+        super.setUp()
+
+        sessionMock = URLSessionMock()
+        OKTURLSessionProvider.setSession(sessionMock)
+        OKTCircuitBreaker.enable(failureThreshold: 2, latencyThreshold: 0, cooldown: 60)
+    }
+
+    override func tearDown() {
+        OKTCircuitBreaker.disable()
+        super.tearDown()
+    }
+
+    func testFireRequest_FailsFastWhenOpen() {
+        sessionMock.responses = [.init(statusCode: 503), .init(statusCode: 503), .init(statusCode: 200)]
+
+        XCTAssertNotNil(fireRequest())
+        XCTAssertNotNil(fireRequest())
+        XCTAssertEqual(OKTCircuitBreaker.circuitBreaker(for: testUrl)?.state, .open)
+
+        let error = fireRequest()
+        guard case .api(_, let underlyingError)? = error else {
+            XCTFail("Unexpected error: \(String(describing: error))")
+            return
+        }
+        XCTAssertTrue(OKTCircuitBreaker.isCircuitBreakerOpenError(underlyingError))
+        XCTAssertEqual(sessionMock.requestCount, 2)
+    }
+
+    func testFireRequest_RetriesStopWhenBreakerOpens() {
+        OktaOidcConfig.setRetryPolicy(OKTRetryPolicy(maximumAttempts: 5, baseDelay: 0.01, maximumDelay: 0.01, deadline: 5))
+        defer { OktaOidcConfig.setRetryPolicy(.noRetryPolicy()) }
+        sessionMock.responses = Array(repeating: .init(statusCode: 503), count: 5)
+
+        XCTAssertNotNil(fireRequest())
+        XCTAssertEqual(sessionMock.requestCount, 2)
+    }
+
+    func testTokenRequest_ReturnsCircuitBreakerError() {
+        openCircuitBreaker()
+
+        var tokenError: Error?
+        var isReturned = false
+        let requestCompleteExpectation = expectation(description: "Request completed!")
+        OKTAuthorizationService.perform(tokenRequest, delegate: nil) { _, error in
+            XCTAssertTrue(isReturned)
+            XCTAssertTrue(Thread.isMainThread)
+            tokenError = error
+            requestCompleteExpectation.fulfill()
+        }
+        isReturned = true
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        XCTAssertEqual((tokenError as NSError?)?.domain, OKTGeneralErrorDomain)
+        XCTAssertEqual((tokenError as NSError?)?.code, OKTErrorCode.circuitBreakerOpen.rawValue)
+        XCTAssertEqual(sessionMock.requestCount, 0)
+    }
+
+    func testRefresh_ServesUnexpiredTokensWhenOpen() {
+        let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: 30)
+        openCircuitBreaker()
+
+        let actionExpectation = expectation(description: "Action performed!")
+        authState.performAction { accessToken, _, error in
+            XCTAssertNil(error)
+            XCTAssertEqual(accessToken, TestUtils.mockAccessToken)
+            actionExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, 0)
+    }
+
+    func testRefresh_FailsWhenOpenAndTokenExpired() {
+        let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: -10)
+        openCircuitBreaker()
+
+        let actionExpectation = expectation(description: "Action performed!")
+        authState.performAction { _, _, error in
+            XCTAssertEqual((error as NSError?)?.code, OKTErrorCode.circuitBreakerOpen.rawValue)
+            actionExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, 0)
+    }
+}
+
+private extension OktaOidcCircuitBreakerTests {
+
+    var testUrl: URL {
+        return URL(string: TestUtils.mockIssuer)!
+    }
+
+    var tokenRequest: OKTTokenRequest {
+        return OKTTokenRequest(
+            configuration: TestUtils.makeMockServiceConfig(issuer: testUrl),
+            grantType: OKTGrantTypeRefreshToken,
+            authorizationCode: nil,
+            redirectURL: testUrl,
+            clientID: TestUtils.mockClientId,
+            clientSecret: nil,
+            scope: nil,
+            refreshToken: TestUtils.mockRefreshToken,
+            codeVerifier: nil,
+            additionalParameters: nil
+        )
+    }
+
+    func openCircuitBreaker() {
+        let circuitBreaker = OKTCircuitBreaker.circuitBreaker(for: testUrl)!
+        for _ in 0 ..< circuitBreaker.failureThreshold {
+            circuitBreaker.recordResult(error: URLError(.cannotConnectToHost), response: nil, latency: 0.1)
+        }
+    }
+
+    func fireRequest() -> OktaOidcError? {
+        var result: OktaOidcError?
+        let requestCompleteExpectation = expectation(description: "Request completed!")
+        OktaOidcRestApi().fireRequest(
+            URLRequest(url: testUrl),
+            onSuccess: { _ in
+                requestCompleteExpectation.fulfill()
+            },
+            onError: { error in
+                result = error
+                requestCompleteExpectation.fulfill()
+            }
+        )
+        waitForExpectations(timeout: 5.0, handler: nil)
+        return result
+    }
+}
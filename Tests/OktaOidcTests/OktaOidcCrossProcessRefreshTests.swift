@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcCrossProcessRefreshTests: XCTestCase {
+
+    var sessionMock: URLSessionMock!
+    var lockFileURL: URL!
+    var storage: SharedStorageMock!
+
+    override func setUp() {
+        super.setUp()
+
+        sessionMock = URLSessionMock()
+        OKTURLSessionProvider.setSession(sessionMock)
+        lockFileURL = FileManager.default.temporaryDirectory.appendingPathComponent("\(UUID().uuidString).lock")
+        storage = SharedStorageMock()
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: lockFileURL)
+        super.tearDown()
+    }
+
+    func testLock_ExcludesOtherInstances() {
+        let lock = OKTCrossProcessRefreshLock(lockFileURL: lockFileURL)
+        let otherLock = OKTCrossProcessRefreshLock(lockFileURL: lockFileURL)
+
+        XCTAssertTrue(lock.tryLock())
+        XCTAssertTrue(lock.isLocked)
+        XCTAssertFalse(otherLock.tryLock())
+        XCTAssertFalse(lock.tryLock())
+
+        lock.unlock()
+        XCTAssertFalse(lock.isLocked)
+        XCTAssertTrue(otherLock.tryLock())
+        otherLock.unlock()
+    }
+
+    func testLock_FailsForUnwritableLocation() {
+        let lock = OKTCrossProcessRefreshLock(lockFileURL: URL(fileURLWithPath: "/nonexistent/directory/refresh.lock"))
+
+        XCTAssertThrowsError(try lock.lock()) { error in
+            XCTAssertEqual((error as NSError).domain, NSPOSIXErrorDomain)
+        }
+        XCTAssertFalse(lock.isLocked)
+        XCTAssertFalse(lock.tryLock())
+    }
+
+    #if os(macOS)
+    func testLock_ExcludesOtherProcesses() throws {
+        let perlURL = URL(fileURLWithPath: "/usr/bin/perl")
+        guard FileManager.default.isExecutableFile(atPath: perlURL.path) else {
+            throw XCTSkip("perl is not available")
+        }
+
+        let holder = Process()
+        let output = Pipe()
+        holder.executableURL = perlURL
+        holder.arguments = ["-e", "use Fcntl ':flock'; open(F, '>>', $ARGV[0]) or die; flock(F, LOCK_EX) or die; $| = 1; print \"locked\\n\"; sleep 30;",
+                            lockFileURL.path]
+        holder.standardOutput = output
+        try holder.run()
+        defer { holder.terminate() }
+
+        let line = String(data: output.fileHandleForReading.availableData, encoding: .utf8)
+        XCTAssertEqual(line, "locked\n")
+
+        let lock = OKTCrossProcessRefreshLock(lockFileURL: lockFileURL)
+        XCTAssertFalse(lock.tryLock())
+
+        // the lock is released when the holding process exits
+        holder.terminate()
+        holder.waitUntilExit()
+        XCTAssertTrue(lock.tryLock())
+        lock.unlock()
+    }
+    #endif
+
+    func testRefresh_AdoptsTokensRefreshedByAnotherProcess() {
+        let authState = makeAuthState(expiresIn: -10, refreshToken: TestUtils.mockRefreshToken)
+        storage.storedState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: 300, refreshToken: "rotatedRefreshToken")
+
+        let actionExpectation = expectation(description: "Action performed!")
+        authState.performAction { accessToken, _, error in
+            XCTAssertNil(error)
+            XCTAssertEqual(accessToken, TestUtils.mockAccessToken)
+            actionExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        XCTAssertEqual(sessionMock.requestCount, 0)
+        XCTAssertEqual(authState.refreshToken, "rotatedRefreshToken")
+        XCTAssertEqual(storage.storeCount, 0)
+        XCTAssertFalse(authState.crossProcessRefreshLock!.isLocked)
+    }
+
+    func testRefresh_StoresRefreshedStateBeforeUnlocking() {
+        let authState = makeAuthState(expiresIn: -10, refreshToken: TestUtils.mockRefreshToken)
+        storage.storedState = authState
+        sessionMock.responses = [.init(statusCode: 200, data: refreshResponse)]
+
+        let otherLock = OKTCrossProcessRefreshLock(lockFileURL: lockFileURL)
+        storage.onStore = { [unowned self] in
+            XCTAssertFalse(otherLock.tryLock())
+            XCTAssertEqual(self.storage.storedState?.refreshToken, "rotatedRefreshToken")
+        }
+
+        let actionExpectation = expectation(description: "Action performed!")
+        authState.performAction { accessToken, _, error in
+            XCTAssertNil(error)
+            XCTAssertEqual(accessToken, "refreshedAccessToken")
+            actionExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        XCTAssertEqual(sessionMock.requestCount, 1)
+        XCTAssertEqual(storage.storeCount, 1)
+        XCTAssertTrue(otherLock.tryLock())
+        otherLock.unlock()
+    }
+
+    func testRefresh_WaitsForLockHeldElsewhere() {
+        let authState = makeAuthState(expiresIn: -10, refreshToken: TestUtils.mockRefreshToken)
+        let otherLock = OKTCrossProcessRefreshLock(lockFileURL: lockFileURL)
+        XCTAssertTrue(otherLock.tryLock())
+
+        var actionPerformed = false
+        let actionExpectation = expectation(description: "Action performed!")
+        authState.performAction { accessToken, _, error in
+            actionPerformed = true
+            XCTAssertNil(error)
+            XCTAssertEqual(accessToken, TestUtils.mockAccessToken)
+            actionExpectation.fulfill()
+        }
+
+        // meanwhile the other holder refreshes and stores new tokens
+        DispatchQueue.main.asyncAfter(deadline: .now() + 0.2) {
+            XCTAssertFalse(actionPerformed)
+            self.storage.storedState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: 300, refreshToken: "rotatedRefreshToken")
+            otherLock.unlock()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        XCTAssertEqual(sessionMock.requestCount, 0)
+        XCTAssertEqual(authState.refreshToken, "rotatedRefreshToken")
+    }
+}
+
+private extension OktaOidcCrossProcessRefreshTests {
+
+    var refreshResponse: Data {
+        let json = """
+        {"access_token":"refreshedAccessToken","token_type":"Bearer","expires_in":300,"refresh_token":"rotatedRefreshToken"}
+        """
+        return json.data(using: .utf8)!
+    }
+
+    func makeAuthState(expiresIn: TimeInterval, refreshToken: String) -> OKTAuthState {
+        let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: expiresIn, refreshToken: refreshToken)
+        authState.crossProcessRefreshLock = OKTCrossProcessRefreshLock(lockFileURL: lockFileURL)
+        authState.sharedStorage = storage
+        return authState
+    }
+}
+
+class SharedStorageMock: NSObject, OKTAuthStateSharedStorage {
+
+    var storedState: OKTAuthState?
+    var storeCount = 0
+    var onStore: (() -> Void)?
+
+    func storedAuthState(for authState: OKTAuthState) -> OKTAuthState? {
+        return storedState
+    }
+
+    func storeAuthState(_ authState: OKTAuthState) {
+        storeCount += 1
+        storedState = authState
+        onStore?()
+    }
+}
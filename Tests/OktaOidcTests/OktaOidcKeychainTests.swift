@@ -129,6 +129,21 @@ class OktaKeychainTests: XCTestCase {
             XCTFail(e.localizedDescription)
         }
     }
+
+    func testReadsAndWritesAreCounted() throws {
+        let metrics = OKTMetricsRegistry.shared()
+        metrics.reset()
+        defer { metrics.reset() }
+
+        try OktaOidcKeychain.set(key: "test_key", string: "test_value")
+        let _: String = try OktaOidcKeychain.get(key: "test_key")
+        let _: String = try OktaOidcKeychain.get(key: "test_key")
+
+        let snapshot = metrics.snapshot()
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricKeychainWrites), 1)
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricKeychainReads), 2)
+        XCTAssertEqual(snapshot.latencies[OKTMetricOperationKeychainRead]?.count, 2)
+    }
 }
 
 #endif
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcLatencyBenchmarkTests: XCTestCase {
+
+    var provider: OktaOidcMockProvider!
+
+    override func setUp() {
+        super.setUp()
+
+        provider = OktaOidcMockProvider()
+        try! provider.start()
+    }
+
+    override func tearDown() {
+        provider.stop()
+        provider = nil
+        super.tearDown()
+    }
+
+    /// Runs with the counts and latency of the `OKTA_BENCHMARK_*` environment variables, prints the
+    /// report and writes it as JSON to `OKTA_BENCHMARK_OUTPUT` when set.
+    func testSignInAndRenewLatency() throws {
+        let benchmark = OktaOidcLatencyBenchmark(provider: provider)
+        let report = try benchmark.run()
+        print(report.textRepresentation)
+
+        if let path = ProcessInfo.processInfo.environment["OKTA_BENCHMARK_OUTPUT"] {
+            let encoder = JSONEncoder()
+            encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+            try encoder.encode(report).write(to: URL(fileURLWithPath: path))
+        }
+
+        let configuration = benchmark.configuration
+        for phase in [OKTTraceSpanDiscovery,
+                      OKTTraceSpanSessionTokenAuthorization,
+                      OKTTraceSpanTokenRequest,
+                      OKTTraceSpanIDTokenValidation,
+                      OktaOidcLatencyBenchmark.statePhase,
+                      OktaOidcLatencyBenchmark.totalPhase] {
+            XCTAssertEqual(report.phase(phase, of: .signIn)?.count, configuration.signInCount, phase)
+        }
+        for phase in [OKTTraceSpanTokenRefresh, OKTTraceSpanTokenRequest, OktaOidcLatencyBenchmark.totalPhase] {
+            XCTAssertEqual(report.phase(phase, of: .renew)?.count, configuration.renewCount, phase)
+        }
+        XCTAssertEqual(provider.requestCount(for: .token), configuration.signInCount + configuration.renewCount)
+    }
+
+    func testInjectedLatencyIsReportedPerPhase() throws {
+        var configuration = OktaOidcLatencyBenchmark.Configuration(environment: [:])
+        configuration.signInCount = 2
+        configuration.renewCount = 3
+        configuration.injectedLatency = 0.05
+
+        let report = try OktaOidcLatencyBenchmark(provider: provider, configuration: configuration).run()
+
+        let discovery = report.phase(OKTTraceSpanDiscovery, of: .signIn)!
+        XCTAssertGreaterThanOrEqual(discovery.p50, 50)
+        XCTAssertLessThanOrEqual(discovery.p50, discovery.p95)
+        XCTAssertLessThanOrEqual(discovery.p95, discovery.p99)
+        // Discovery, authorize and the token exchange each wait for the provider.
+        XCTAssertGreaterThanOrEqual(report.phase(OktaOidcLatencyBenchmark.totalPhase, of: .signIn)!.p50, 150)
+        XCTAssertGreaterThanOrEqual(report.phase(OKTTraceSpanTokenRefresh, of: .renew)!.p50, 50)
+        XCTAssertEqual(report.renewals, 3)
+    }
+
+    func testConfigurationFromEnvironment() {
+        let configuration = OktaOidcLatencyBenchmark.Configuration(environment: [
+            "OKTA_BENCHMARK_SIGN_INS": "3",
+            "OKTA_BENCHMARK_RENEWS": "500",
+            "OKTA_BENCHMARK_LATENCY_MS": "25"
+        ])
+
+        XCTAssertEqual(configuration.signInCount, 3)
+        XCTAssertEqual(configuration.renewCount, 500)
+        XCTAssertEqual(configuration.injectedLatency, 0.025, accuracy: 0.0001)
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcLoadGeneratorTests: XCTestCase {
+
+    var provider: OktaOidcMockProvider!
+
+    override func setUp() {
+        super.setUp()
+
+        provider = OktaOidcMockProvider()
+        try! provider.start()
+    }
+
+    override func tearDown() {
+        provider.stop()
+        provider = nil
+        OKTMetricsRegistry.shared().reset()
+        super.tearDown()
+    }
+
+    /// Runs with the sizes of the `OKTA_LOAD_*` environment variables, prints the report and writes
+    /// it as JSON to `OKTA_LOAD_OUTPUT` when set.
+    func testLoad() throws {
+        let generator = OktaOidcLoadGenerator(provider: provider)
+        let report = try generator.run()
+        print(report.textRepresentation)
+
+        if let path = ProcessInfo.processInfo.environment["OKTA_LOAD_OUTPUT"] {
+            let encoder = JSONEncoder()
+            encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+            try encoder.encode(report).write(to: URL(fileURLWithPath: path))
+        }
+
+        XCTAssertEqual(report.sessions, generator.configuration.sessionCount)
+        XCTAssertGreaterThan(report.throughput, 0)
+        for operation in OktaOidcLoadGenerator.Operation.allCases {
+            XCTAssertEqual(report.operation(operation)?.errors ?? 0, 0, operation.rawValue)
+        }
+    }
+
+    func testStaleSessionsRefreshOnce() throws {
+        var configuration = OktaOidcLoadGenerator.Configuration(environment: [:])
+        configuration.sessionCount = 4
+        configuration.workerCount = 8
+        configuration.duration = 0.5
+        // The sessions are signed in in one batch, so their tokens are stale from the start. Renewed
+        // tokens stay fresh for the rest of the run.
+        configuration.expiryWindow = 5
+        configuration.weights = [.freshTokens: 1]
+
+        let report = try OktaOidcLoadGenerator(provider: provider, configuration: configuration).run()
+
+        XCTAssertEqual(report.operation(.freshTokens)?.errors, 0)
+        XCTAssertNil(report.operation(.userInfo))
+        XCTAssertEqual(report.tokenRefreshes, 4)
+        XCTAssertEqual(report.tokenRequests, 4)
+        XCTAssertGreaterThan(report.peakResidentBytes, 0)
+    }
+
+    func testConfigurationFromEnvironment() {
+        let configuration = OktaOidcLoadGenerator.Configuration(environment: [
+            "OKTA_LOAD_SESSIONS": "5000",
+            "OKTA_LOAD_WORKERS": "64",
+            "OKTA_LOAD_DURATION": "30",
+            "OKTA_LOAD_EXPIRY_WINDOW": "10",
+            "OKTA_LOAD_LATENCY_MS": "5"
+        ])
+
+        XCTAssertEqual(configuration.sessionCount, 5000)
+        XCTAssertEqual(configuration.workerCount, 64)
+        XCTAssertEqual(configuration.duration, 30)
+        XCTAssertEqual(configuration.expiryWindow, 10)
+        XCTAssertEqual(configuration.injectedLatency, 0.005, accuracy: 0.0001)
+    }
+}
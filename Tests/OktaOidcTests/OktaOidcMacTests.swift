@@ -221,6 +221,35 @@ class OktaOidcMacTests: XCTestCase {
         XCTAssertNil(oidc.currentUserSessionTask)
     }
 
+    func testConcurrentBrowserTasks() {
+        guard let oidc = try? OktaOidc(configuration: createTestConfig()) else {
+            XCTFail("Failed to create oidc object")
+            return
+        }
+
+        let completionExpectation = expectation(description: "Completion should be called!")
+        completionExpectation.expectedFulfillmentCount = 3
+        for _ in 0 ..< 2 {
+            let browserTaskMock = OktaOidcBrowserTaskMACUnitMock(config: createTestConfig()!, oktaAPI: OktaOidcApiMock())
+            oidc.signInWithBrowserTask(browserTaskMock) { stateManager, error in
+                XCTAssertNil(error)
+                XCTAssertNotNil(stateManager)
+                completionExpectation.fulfill()
+            }
+        }
+        let signOutTaskMock = OktaOidcBrowserTaskMACUnitMock(config: createTestConfig()!, oktaAPI: OktaOidcApiMock())
+        oidc.signOutWithBrowserTask(signOutTaskMock, idToken: "id_token") { error in
+            XCTAssertNil(error)
+            completionExpectation.fulfill()
+        }
+
+        XCTAssertEqual(oidc.userSessionTasks.count, 3)
+        XCTAssertTrue(oidc.hasActiveBrowserSession())
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertTrue(oidc.userSessionTasks.isEmpty)
+        XCTAssertFalse(oidc.hasActiveBrowserSession())
+    }
+
     func testCancelBrowserSessionMethod() {
         guard let oidc = try? OktaOidc(configuration: createTestConfig()) else {
             XCTFail("Failed to create oidc object")
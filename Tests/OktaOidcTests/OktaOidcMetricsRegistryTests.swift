@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcMetricsRegistryTests: XCTestCase {
+
+    var sessionMock: URLSessionMock!
+    let metrics = OKTMetricsRegistry.shared()
+
+    override func setUp() {
+        super.setUp()
+
+        sessionMock = URLSessionMock()
+        sessionMock.defersCompletion = true
+        OKTURLSessionProvider.setSession(sessionMock)
+        metrics.reset()
+    }
+
+    override func tearDown() {
+        metrics.reset()
+        super.tearDown()
+    }
+
+    func testFreshTokenCountsCacheHit() {
+        let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: 300)
+
+        let actionExpectation = expectation(description: "Action performed!")
+        authState.performAction { _, _, error in
+            XCTAssertNil(error)
+            actionExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        let snapshot = metrics.snapshot()
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricTokenCacheHits), 1)
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricTokenCacheMisses), 0)
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricTokenRefreshes), 0)
+    }
+
+    func testRefreshIsCountedAndTimed() {
+        sessionMock.responses = [.init(statusCode: 200, data: refreshResponse())]
+        let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: -10)
+
+        let actionsExpectation = expectation(description: "Actions performed!")
+        actionsExpectation.expectedFulfillmentCount = 2
+        for _ in 0 ..< 2 {
+            authState.performAction { _, _, error in
+                XCTAssertNil(error)
+                actionsExpectation.fulfill()
+            }
+        }
+        sessionMock.completePendingTasks()
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        let snapshot = metrics.snapshot()
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricTokenCacheMisses), 2)
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricCoalescedRefreshWaiters), 1)
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricTokenRefreshes), 1)
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricTokenRefreshFailures), 0)
+        XCTAssertEqual(snapshot.latencies[OKTMetricOperationTokenRefresh]?.count, 1)
+    }
+
+    func testRefreshSharedByStatesIsCountedOnce() {
+        sessionMock.responses = [.init(statusCode: 400, data: "{\"error\":\"invalid_grant\"}".data(using: .utf8)!)]
+        let authStates = (0 ..< 3).map { _ in
+            TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: -10)
+        }
+
+        let actionsExpectation = expectation(description: "Actions performed!")
+        actionsExpectation.expectedFulfillmentCount = authStates.count
+        for authState in authStates {
+            authState.performAction { _, _, error in
+                XCTAssertNotNil(error)
+                actionsExpectation.fulfill()
+            }
+        }
+        sessionMock.completePendingTasks()
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        let snapshot = metrics.snapshot()
+        XCTAssertEqual(sessionMock.requestCount, 1)
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricTokenRefreshes), 1)
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricCoalescedRefreshWaiters), 2)
+        XCTAssertEqual(snapshot.value(ofCounter: OKTMetricTokenRefreshFailures), 1)
+        XCTAssertEqual(snapshot.latencies[OKTMetricOperationTokenRefresh]?.count, 1)
+    }
+
+    func testRefreshFailureIsCounted() {
+        sessionMock.responses = [.init(statusCode: 400, data: "{\"error\":\"invalid_grant\"}".data(using: .utf8)!)]
+        let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: -10)
+
+        let actionExpectation = expectation(description: "Action performed!")
+        authState.performAction { _, _, error in
+            XCTAssertNotNil(error)
+            actionExpectation.fulfill()
+        }
+        sessionMock.completePendingTasks()
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        XCTAssertEqual(metrics.snapshot().value(ofCounter: OKTMetricTokenRefreshFailures), 1)
+    }
+
+    func testRestApiRecordsLatencyPerOperation() {
+        sessionMock.responses = [.init(statusCode: 200, data: "{\"sub\":\"user\"}".data(using: .utf8)!)]
+        let request = OKTNetworkMetricsCollector.shared().request(
+            URLRequest(url: URL(string: TestUtils.mockIssuer + "/v1/userinfo")!),
+            taggedWithOperation: OKTNetworkOperationUserInfo,
+            delegate: nil
+        )
+
+        let requestCompleteExpectation = expectation(description: "Request completed!")
+        OktaOidcRestApi().fireRequest(request, onSuccess: { _ in
+            requestCompleteExpectation.fulfill()
+        }, onError: { error in
+            XCTFail("Unexpected error: \(error)")
+        })
+        sessionMock.completePendingTasks()
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        let snapshot = metrics.snapshot()
+        XCTAssertEqual(snapshot.latencies[OKTNetworkOperationUserInfo]?.count, 1)
+        XCTAssertTrue(snapshot.textRepresentation().contains("okta_oidc_latency_seconds_count{operation=\"userinfo\"} 1"))
+    }
+}
+
+private extension OktaOidcMetricsRegistryTests {
+
+    func refreshResponse() -> Data {
+        let json = """
+        {"access_token":"refreshedAccessToken","token_type":"Bearer","expires_in":300,"refresh_token":"rotatedRefreshToken"}
+        """
+        return json.data(using: .utf8)!
+    }
+}
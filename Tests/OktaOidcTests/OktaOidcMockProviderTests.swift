@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcMockProviderTests: XCTestCase {
+
+    var provider: OktaOidcMockProvider!
+    var oktaOidc: OktaOidc!
+
+    override func setUp() {
+        super.setUp()
+
+        provider = OktaOidcMockProvider()
+        try! provider.start()
+        oktaOidc = try! OktaOidc(configuration: provider.makeConfig())
+    }
+
+    override func tearDown() {
+        provider.stop()
+        provider = nil
+        super.tearDown()
+    }
+
+    func testSessionTokenSignInAndRenew() {
+        let stateManager = signIn()
+        XCTAssertNotNil(stateManager.accessToken)
+        XCTAssertNotNil(stateManager.idToken)
+        let refreshToken = stateManager.refreshToken
+        XCTAssertNotNil(refreshToken)
+
+        let renewExpectation = expectation(description: "Tokens renewed!")
+        stateManager.renew { renewedStateManager, error in
+            XCTAssertNil(error)
+            XCTAssertNotNil(renewedStateManager?.accessToken)
+            renewExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        XCTAssertNotEqual(stateManager.refreshToken, refreshToken)
+        XCTAssertEqual(provider.requestCount(for: .discovery), 1)
+        XCTAssertEqual(provider.requestCount(for: .authorize), 1)
+        XCTAssertEqual(provider.requestCount(for: .token), 2)
+    }
+
+    func testUserInfoIntrospectAndRevoke() {
+        let stateManager = signIn()
+        let accessToken = stateManager.accessToken
+
+        let userInfoExpectation = expectation(description: "User info received!")
+        stateManager.getUser { payload, error in
+            XCTAssertNil(error)
+            XCTAssertEqual(payload?["sub"] as? String, OktaOidcMockProvider.subject)
+            userInfoExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        let revokeExpectation = expectation(description: "Token revoked!")
+        stateManager.revoke(accessToken) { isRevoked, error in
+            XCTAssertNil(error)
+            XCTAssertTrue(isRevoked)
+            revokeExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        let introspectExpectation = expectation(description: "Token introspected!")
+        stateManager.introspect(token: accessToken) { payload, error in
+            XCTAssertNil(error)
+            XCTAssertEqual(payload?["active"] as? Bool, false)
+            introspectExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+    }
+
+    func testCompactSessionSignInRenewAndGetUser() {
+        oktaOidc.configuration.compactsSessions = true
+        let stateManager = signIn()
+        XCTAssertTrue(stateManager.authState.compactsResponses)
+        XCTAssertNil(stateManager.authState.lastAuthorizationResponse.authorizationCode)
+        XCTAssertNil(stateManager.authState.lastTokenResponse?.additionalParameters)
+        XCTAssertNotNil(stateManager.idToken)
+        let refreshToken = stateManager.refreshToken
+        XCTAssertNotNil(refreshToken)
+
+        let renewExpectation = expectation(description: "Tokens renewed!")
+        stateManager.renew { renewedStateManager, error in
+            XCTAssertNil(error)
+            XCTAssertNotNil(renewedStateManager?.accessToken)
+            renewExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertNotEqual(stateManager.refreshToken, refreshToken)
+        XCTAssertNil(stateManager.authState.lastTokenResponse?.request.refreshToken)
+
+        let userInfoExpectation = expectation(description: "User info received!")
+        stateManager.getUser { payload, error in
+            XCTAssertNil(error)
+            XCTAssertEqual(payload?["sub"] as? String, OktaOidcMockProvider.subject)
+            userInfoExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        let otherStateManager = signIn()
+        XCTAssertTrue(otherStateManager.authState.lastAuthorizationResponse.request.configuration
+                      === stateManager.authState.lastAuthorizationResponse.request.configuration)
+    }
+
+    func testInjectedErrorFailsSignIn() {
+        provider.injectError(statusCode: 503, for: .token)
+
+        let signInExpectation = expectation(description: "Sign in failed!")
+        oktaOidc.authenticate(withSessionToken: "sessionToken") { stateManager, error in
+            XCTAssertNil(stateManager)
+            XCTAssertNotNil(error)
+            signInExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        // The injected error is used up.
+        XCTAssertNotNil(signIn().accessToken)
+    }
+
+    func testInjectedLatency() {
+        provider.setLatency(0.2, for: .discovery)
+
+        let start = Date()
+        _ = signIn()
+        XCTAssertGreaterThanOrEqual(Date().timeIntervalSince(start), 0.2)
+    }
+}
+
+private extension OktaOidcMockProviderTests {
+
+    func signIn() -> OktaOidcStateManager {
+        var result: OktaOidcStateManager?
+        let signInExpectation = expectation(description: "Signed in!")
+        oktaOidc.authenticate(withSessionToken: "sessionToken") { stateManager, error in
+            XCTAssertNil(error)
+            result = stateManager
+            signInExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+        return result!
+    }
+}
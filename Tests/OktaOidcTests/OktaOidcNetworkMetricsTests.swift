@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcNetworkMetricsTests: XCTestCase {
+
+    func testStateManagerRequestsAreTaggedWithOperation() {
+        let apiMock = OktaOidcApiMock()
+        apiMock.configure(response: ["sub": "user"])
+        let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId)
+        let stateManager = OktaOidcStateManager(authState: authState)
+        stateManager.restAPI = apiMock
+
+        let requestCompleteExpectation = expectation(description: "Request completed!")
+        stateManager.getUser { _, _ in
+            requestCompleteExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        XCTAssertEqual(OKTNetworkMetricsCollector.operation(of: apiMock.lastRequest!), OKTNetworkOperationUserInfo)
+    }
+
+    func testCustomizedRequestKeepsOperation() {
+        let sessionMock = URLSessionMock()
+        OKTURLSessionProvider.setSession(sessionMock)
+        let delegate = OktaNetworkRequestCustomizationDelegateMock()
+        delegate.customizedRequest = URLRequest(url: URL(string: TestUtils.mockIssuer + "/v1/revoke")!)
+        let restApi = OktaOidcRestApi()
+        restApi.requestCustomizationDelegate = delegate
+
+        let request = OKTNetworkMetricsCollector.shared().request(
+            URLRequest(url: URL(string: TestUtils.mockIssuer + "/v1/revoke")!),
+            taggedWithOperation: OKTNetworkOperationRevoke,
+            delegate: nil
+        )
+        let requestCompleteExpectation = expectation(description: "Request completed!")
+        restApi.fireRequest(request, onSuccess: { _ in
+            requestCompleteExpectation.fulfill()
+        }, onError: { _ in
+            requestCompleteExpectation.fulfill()
+        })
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        XCTAssertEqual(OKTNetworkMetricsCollector.operation(of: sessionMock.request!), OKTNetworkOperationRevoke)
+    }
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcRequestCoalescerTests: XCTestCase {
+
+    var sessionMock: URLSessionMock!
+    let coalescer = OktaOidcRequestCoalescer.shared
+
+    override func setUp() {
+        super.setUp()
+
+        sessionMock = URLSessionMock()
+        sessionMock.defersCompletion = true
+        OKTURLSessionProvider.setSession(sessionMock)
+        coalescer.isEnabled = true
+        coalescer.resetCounters()
+    }
+
+    override func tearDown() {
+        coalescer.isEnabled = false
+        coalescer.resetCounters()
+        super.tearDown()
+    }
+
+    func testIdenticalRequestsShareOneCall() {
+        sessionMock.responses = [.init(statusCode: 200, data: "{\"sub\":\"user\"}".data(using: .utf8)!)]
+        let delegates = (0 ..< 3).map { _ -> OktaNetworkRequestCustomizationDelegateMock in
+            let delegate = OktaNetworkRequestCustomizationDelegateMock()
+            delegate.customizedRequest = nil
+            return delegate
+        }
+
+        let requestsCompleteExpectation = expectation(description: "Requests completed!")
+        requestsCompleteExpectation.expectedFulfillmentCount = delegates.count
+        for delegate in delegates {
+            let restApi = OktaOidcRestApi()
+            restApi.requestCustomizationDelegate = delegate
+            restApi.fireRequest(
+                userInfoRequest(token: "token"),
+                onSuccess: { response in
+                    XCTAssertEqual(response?["sub"] as? String, "user")
+                    requestsCompleteExpectation.fulfill()
+                },
+                onError: { error in
+                    XCTFail("Unexpected error: \(error)")
+                }
+            )
+        }
+        sessionMock.completePendingTasks()
+
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, 1)
+        XCTAssertEqual(coalescer.issuedRequestCount, 1)
+        XCTAssertEqual(coalescer.coalescedRequestCount, 2)
+        XCTAssertTrue(delegates.allSatisfy { $0.didReceiveCalled })
+    }
+
+    func testSharedResponseHasNoMutableContainers() {
+        sessionMock.responses = [.init(statusCode: 200, data: "{\"address\":{\"country\":\"US\"},\"groups\":[\"a\"]}".data(using: .utf8)!)]
+
+        let requestsCompleteExpectation = expectation(description: "Requests completed!")
+        requestsCompleteExpectation.expectedFulfillmentCount = 2
+        for _ in 0 ..< 2 {
+            OktaOidcRestApi().fireRequest(
+                userInfoRequest(token: "token"),
+                onSuccess: { response in
+                    XCTAssertFalse(response?["address"] is NSMutableDictionary)
+                    XCTAssertFalse(response?["groups"] is NSMutableArray)
+                    requestsCompleteExpectation.fulfill()
+                },
+                onError: { error in
+                    XCTFail("Unexpected error: \(error)")
+                }
+            )
+        }
+        sessionMock.completePendingTasks()
+
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, 1)
+    }
+
+    func testErrorIsDeliveredToAllCallers() {
+        sessionMock.responses = [.init(statusCode: 503)]
+
+        let requestsCompleteExpectation = expectation(description: "Requests completed!")
+        requestsCompleteExpectation.expectedFulfillmentCount = 2
+        for _ in 0 ..< 2 {
+            OktaOidcRestApi().fireRequest(
+                userInfoRequest(token: "token"),
+                onSuccess: { _ in
+                    XCTFail("Request should fail")
+                },
+                onError: { _ in
+                    requestsCompleteExpectation.fulfill()
+                }
+            )
+        }
+        sessionMock.completePendingTasks()
+
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, 1)
+    }
+
+    func testDifferentRequestsAreNotCoalesced() {
+        var postRequest = userInfoRequest(token: "token")
+        postRequest.httpMethod = "POST"
+        postRequest.httpBody = "token=a".data(using: .utf8)
+        var otherBodyRequest = postRequest
+        otherBodyRequest.httpBody = "token=b".data(using: .utf8)
+        let requests = [userInfoRequest(token: "token"),
+                        userInfoRequest(token: "other_token"),
+                        postRequest,
+                        otherBodyRequest]
+
+        let requestsCompleteExpectation = expectation(description: "Requests completed!")
+        requestsCompleteExpectation.expectedFulfillmentCount = requests.count
+        for request in requests {
+            OktaOidcRestApi().fireRequest(
+                request,
+                onSuccess: { _ in
+                    requestsCompleteExpectation.fulfill()
+                },
+                onError: { _ in
+                    requestsCompleteExpectation.fulfill()
+                }
+            )
+        }
+        sessionMock.completePendingTasks()
+
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, requests.count)
+        XCTAssertEqual(coalescer.issuedRequestCount, requests.count)
+        XCTAssertEqual(coalescer.coalescedRequestCount, 0)
+    }
+
+    func testCompletedRequestIsIssuedAgain() {
+        fireAndComplete(userInfoRequest(token: "token"))
+        fireAndComplete(userInfoRequest(token: "token"))
+
+        XCTAssertEqual(sessionMock.requestCount, 2)
+        XCTAssertEqual(coalescer.coalescedRequestCount, 0)
+    }
+
+    func testDisabledByDefault() {
+        coalescer.isEnabled = false
+
+        let requestsCompleteExpectation = expectation(description: "Requests completed!")
+        requestsCompleteExpectation.expectedFulfillmentCount = 2
+        for _ in 0 ..< 2 {
+            OktaOidcRestApi().fireRequest(
+                userInfoRequest(token: "token"),
+                onSuccess: { _ in
+                    requestsCompleteExpectation.fulfill()
+                },
+                onError: { _ in
+                    requestsCompleteExpectation.fulfill()
+                }
+            )
+        }
+        sessionMock.completePendingTasks()
+
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, 2)
+        XCTAssertEqual(coalescer.issuedRequestCount, 0)
+    }
+}
+
+private extension OktaOidcRequestCoalescerTests {
+
+    func userInfoRequest(token: String) -> URLRequest {
+        var request = URLRequest(url: URL(string: TestUtils.mockIssuer + "/v1/userinfo")!)
+        request.setValue("Bearer \(token)", forHTTPHeaderField: "Authorization")
+        return request
+    }
+
+    func fireAndComplete(_ request: URLRequest) {
+        let requestCompleteExpectation = expectation(description: "Request completed!")
+        OktaOidcRestApi().fireRequest(
+            request,
+            onSuccess: { _ in
+                requestCompleteExpectation.fulfill()
+            },
+            onError: { _ in
+                requestCompleteExpectation.fulfill()
+            }
+        )
+        sessionMock.completePendingTasks()
+        waitForExpectations(timeout: 5.0, handler: nil)
+    }
+}
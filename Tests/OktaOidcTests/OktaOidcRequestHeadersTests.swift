@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcRequestHeadersTests: XCTestCase {
+
+    override func tearDown() {
+        OktaUserAgent.setUserAgentValue("")
+        super.tearDown()
+    }
+
+    func testTemplateIsReusedUntilUserAgentChanges() {
+        OktaUserAgent.setUserAgentValue("")
+        let template = OktaOidcRequestHeaders.current
+        XCTAssertTrue(template === OktaOidcRequestHeaders.current)
+        XCTAssertEqual(template.fields["User-Agent"], OktaUserAgent.userAgentHeaderValue())
+
+        OktaOidcConfig.setUserAgent(value: "custom user agent")
+        let updatedTemplate = OktaOidcRequestHeaders.current
+        XCTAssertFalse(template === updatedTemplate)
+        XCTAssertEqual(updatedTemplate.fields["User-Agent"], "custom user agent")
+    }
+
+    func testDefaultUserAgentIsComputedOnce() {
+        OktaUserAgent.setUserAgentValue("")
+        XCTAssertTrue(OktaUserAgent.userAgentHeaderValue() as NSString === OktaUserAgent.userAgentHeaderValue() as NSString)
+        XCTAssertTrue(OktaUserAgent.userAgentHeaderValue().hasPrefix("okta-oidc-ios/"))
+    }
+
+    func testMergeOverridesTemplateFields() {
+        let template = OktaOidcRequestHeaders(userAgent: "agent", customHeaders: ["X-Custom": "1"])
+        let fields = template.fields(merging: OktaOidcRequestHeaders.formPost.merging(["X-Custom": "2"]) { _, new in new })
+
+        XCTAssertEqual(fields["User-Agent"], "agent")
+        XCTAssertEqual(fields["X-Custom"], "2")
+        XCTAssertEqual(fields["Accept"], "application/json")
+        XCTAssertEqual(template.fields(merging: nil), template.fields)
+    }
+
+    func testSetupRequestAppliesTemplate() {
+        OktaUserAgent.setUserAgentValue("request user agent")
+        let request = OktaOidcRestApi().setupRequest(URL(string: TestUtils.mockIssuer)!,
+                                                     method: "POST",
+                                                     headers: OktaOidcRequestHeaders.formPost)
+
+        XCTAssertEqual(request.value(forHTTPHeaderField: "User-Agent"), "request user agent")
+        XCTAssertEqual(request.value(forHTTPHeaderField: "Content-Type"), "application/x-www-form-urlencoded")
+    }
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcRetryPolicyTests: XCTestCase {
+
+    var sessionMock: URLSessionMock!
+
+    override func setUp() {
+        super.setUp()
+
+        sessionMock = URLSessionMock()
+        OKTURLSessionProvider.setSession(sessionMock)
+        OktaOidcConfig.setRetryPolicy(OKTRetryPolicy(maximumAttempts: 3, baseDelay: 0.01, maximumDelay: 0.05, deadline: 5))
+    }
+
+    override func tearDown() {
+        OktaOidcConfig.setRetryPolicy(.noRetryPolicy())
+        super.tearDown()
+    }
+
+    func testNoRetriesByDefault() {
+        OktaOidcConfig.setRetryPolicy(.noRetryPolicy())
+        sessionMock.responses = [.init(statusCode: 503), .init(statusCode: 200)]
+
+        XCTAssertNotNil(fireRequest(method: "GET"))
+        XCTAssertEqual(sessionMock.requestCount, 1)
+    }
+
+    func testFireRequest_IdempotentRequestRetriedOnServerError() {
+        sessionMock.responses = [.init(statusCode: 500), .init(statusCode: 502), .init(statusCode: 200)]
+
+        XCTAssertNil(fireRequest(method: "GET"))
+        XCTAssertEqual(sessionMock.requestCount, 3)
+    }
+
+    func testFireRequest_IdempotentRequestRetriedOnTimeout() {
+        sessionMock.responses = [.init(error: URLError(.timedOut)), .init(statusCode: 200)]
+
+        XCTAssertNil(fireRequest(method: "GET"))
+        XCTAssertEqual(sessionMock.requestCount, 2)
+    }
+
+    func testFireRequest_StopsAfterMaximumAttempts() {
+        sessionMock.responses = [.init(statusCode: 503), .init(statusCode: 503), .init(statusCode: 503), .init(statusCode: 200)]
+
+        XCTAssertNotNil(fireRequest(method: "GET"))
+        XCTAssertEqual(sessionMock.requestCount, 3)
+    }
+
+    func testFireRequest_PostNotRetriedOnAmbiguousFailure() {
+        sessionMock.responses = [.init(statusCode: 500), .init(statusCode: 200)]
+        XCTAssertNotNil(fireRequest(method: "POST"))
+        XCTAssertEqual(sessionMock.requestCount, 1)
+
+        sessionMock.requestCount = 0
+        sessionMock.responses = [.init(error: URLError(.networkConnectionLost)), .init(statusCode: 200)]
+        XCTAssertNotNil(fireRequest(method: "POST"))
+        XCTAssertEqual(sessionMock.requestCount, 1)
+    }
+
+    func testFireRequest_PostRetriedWhenNotProcessed() {
+        sessionMock.responses = [.init(error: URLError(.cannotConnectToHost)),
+                                 .init(statusCode: 429, headerFields: ["Retry-After": "0"]),
+                                 .init(statusCode: 200)]
+
+        XCTAssertNil(fireRequest(method: "POST"))
+        XCTAssertEqual(sessionMock.requestCount, 3)
+    }
+
+    func testFireRequest_RetryAfterBeyondDeadlineNotRetried() {
+        sessionMock.responses = [.init(statusCode: 503, headerFields: ["Retry-After": "120"]), .init(statusCode: 200)]
+
+        XCTAssertNotNil(fireRequest(method: "GET"))
+        XCTAssertEqual(sessionMock.requestCount, 1)
+    }
+
+    func testFireRequest_RetryAfterBeyondMaximumDelayNotRetried() {
+        OktaOidcConfig.setRetryPolicy(OKTRetryPolicy(maximumAttempts: 3, baseDelay: 0.01, maximumDelay: 0.05, deadline: 3600))
+        sessionMock.responses = [.init(statusCode: 429, headerFields: ["Retry-After": "2"]), .init(statusCode: 200)]
+
+        XCTAssertNotNil(fireRequest(method: "GET"))
+        XCTAssertEqual(sessionMock.requestCount, 1)
+    }
+
+    func testTokenRefresh_RetriedWhenNotProcessed() {
+        sessionMock.responses = [.init(error: URLError(.notConnectedToInternet)),
+                                 .init(statusCode: 503, headerFields: ["Retry-After": "0"]),
+                                 .init(statusCode: 400, data: "{\"error\":\"invalid_grant\"}".data(using: .utf8)!)]
+
+        let error = performTokenRequest()
+        XCTAssertEqual((error as NSError?)?.domain, OKTOAuthTokenErrorDomain)
+        XCTAssertEqual(sessionMock.requestCount, 3)
+    }
+
+    func testTokenRefresh_NotRetriedWhenResponseMayHaveBeenLost() {
+        // The server may have rotated the refresh token, so the request must not be replayed.
+        sessionMock.responses = [.init(error: URLError(.timedOut)), .init(statusCode: 200)]
+
+        let error = performTokenRequest()
+        XCTAssertEqual((error as NSError?)?.code, OKTErrorCode.networkError.rawValue)
+        XCTAssertEqual(sessionMock.requestCount, 1)
+
+        sessionMock.requestCount = 0
+        sessionMock.responses = [.init(statusCode: 502), .init(statusCode: 200)]
+        XCTAssertEqual((performTokenRequest() as NSError?)?.code, OKTErrorCode.serverError.rawValue)
+        XCTAssertEqual(sessionMock.requestCount, 1)
+    }
+}
+
+private extension OktaOidcRetryPolicyTests {
+
+    var testUrl: URL {
+        return URL(string: TestUtils.mockIssuer)!
+    }
+
+    func fireRequest(method: String) -> OktaOidcError? {
+        var request = URLRequest(url: testUrl)
+        request.httpMethod = method
+
+        var result: OktaOidcError?
+        let requestCompleteExpectation = expectation(description: "Request completed!")
+        OktaOidcRestApi().fireRequest(
+            request,
+            onSuccess: { _ in
+                requestCompleteExpectation.fulfill()
+            },
+            onError: { error in
+                result = error
+                requestCompleteExpectation.fulfill()
+            }
+        )
+        waitForExpectations(timeout: 5.0, handler: nil)
+        return result
+    }
+
+    func performTokenRequest() -> Error? {
+        let configuration = OKTServiceConfiguration(authorizationEndpoint: testUrl, tokenEndpoint: testUrl, issuer: testUrl)
+        let request = OKTTokenRequest(
+            configuration: configuration,
+            grantType: OKTGrantTypeRefreshToken,
+            authorizationCode: nil,
+            redirectURL: testUrl,
+            clientID: TestUtils.mockClientId,
+            clientSecret: nil,
+            scope: nil,
+            refreshToken: "refresh_token",
+            codeVerifier: nil,
+            additionalParameters: nil
+        )
+
+        var result: Error?
+        let requestCompleteExpectation = expectation(description: "Request completed!")
+        OKTAuthorizationService.perform(request, delegate: nil) { _, error in
+            result = error
+            requestCompleteExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+        return result
+    }
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcTokenRefreshCoordinatorTests: XCTestCase {
+
+    var sessionMock: URLSessionMock!
+
+    override func setUp() {
+        super.setUp()
+
+        sessionMock = URLSessionMock()
+        sessionMock.defersCompletion = true
+        OKTURLSessionProvider.setSession(sessionMock)
+    }
+
+    func testSameRefreshTokenSharesOneRequest() {
+        sessionMock.responses = [.init(statusCode: 200, data: refreshResponse(accessToken: "refreshedAccessToken"))]
+        let authStates = (0 ..< 3).map { _ in
+            TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: -10)
+        }
+
+        let actionsExpectation = expectation(description: "Actions performed!")
+        actionsExpectation.expectedFulfillmentCount = authStates.count
+        for authState in authStates {
+            authState.performAction { accessToken, _, error in
+                XCTAssertNil(error)
+                XCTAssertEqual(accessToken, "refreshedAccessToken")
+                actionsExpectation.fulfill()
+            }
+        }
+        XCTAssertEqual(OKTTokenRefreshCoordinator.shared().inFlightRefreshCount, 1)
+        sessionMock.completePendingTasks()
+
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, 1)
+        XCTAssertEqual(OKTTokenRefreshCoordinator.shared().inFlightRefreshCount, 0)
+        for authState in authStates {
+            XCTAssertEqual(authState.refreshToken, "rotatedRefreshToken")
+        }
+    }
+
+    func testErrorIsDeliveredToAllInstances() {
+        sessionMock.responses = [.init(statusCode: 400, data: "{\"error\":\"invalid_grant\"}".data(using: .utf8)!)]
+        let authStates = (0 ..< 2).map { _ in
+            TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: -10)
+        }
+
+        let actionsExpectation = expectation(description: "Actions performed!")
+        actionsExpectation.expectedFulfillmentCount = authStates.count
+        for authState in authStates {
+            authState.performAction { _, _, error in
+                XCTAssertEqual((error as NSError?)?.domain, OKTOAuthTokenErrorDomain)
+                actionsExpectation.fulfill()
+            }
+        }
+        sessionMock.completePendingTasks()
+
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, 1)
+    }
+
+    func testDifferentRefreshTokensAreNotCoalesced() {
+        sessionMock.responses = [.init(statusCode: 200, data: refreshResponse(accessToken: "first")),
+                                 .init(statusCode: 200, data: refreshResponse(accessToken: "second"))]
+        let authStates = ["refreshTokenA", "refreshTokenB"].map {
+            TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: -10, refreshToken: $0)
+        }
+
+        let actionsExpectation = expectation(description: "Actions performed!")
+        actionsExpectation.expectedFulfillmentCount = authStates.count
+        for authState in authStates {
+            authState.performAction { _, _, error in
+                XCTAssertNil(error)
+                actionsExpectation.fulfill()
+            }
+        }
+        XCTAssertEqual(OKTTokenRefreshCoordinator.shared().inFlightRefreshCount, 2)
+        sessionMock.completePendingTasks()
+
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, 2)
+    }
+
+    func testDelegatesOfAllCallersReceiveResponse() {
+        sessionMock.responses = [.init(statusCode: 200, data: refreshResponse(accessToken: "refreshedAccessToken"))]
+        let delegates = (0 ..< 3).map { _ in OktaNetworkRequestCustomizationDelegateMock() }
+        let authStates = delegates.map { delegate -> OKTAuthState in
+            let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: -10)
+            authState.delegate = delegate
+            return authState
+        }
+
+        let actionsExpectation = expectation(description: "Actions performed!")
+        actionsExpectation.expectedFulfillmentCount = authStates.count
+        for authState in authStates {
+            authState.performAction { _, _, error in
+                XCTAssertNil(error)
+                actionsExpectation.fulfill()
+            }
+        }
+        sessionMock.completePendingTasks()
+
+        waitForExpectations(timeout: 5.0, handler: nil)
+        XCTAssertEqual(sessionMock.requestCount, 1)
+        XCTAssertTrue(delegates.allSatisfy { $0.didReceiveCalled })
+    }
+
+    func testDifferentAdditionalParametersAreNotCoalesced() {
+        sessionMock.responses = [.init(statusCode: 200, data: refreshResponse(accessToken: "first")),
+                                 .init(statusCode: 200, data: refreshResponse(accessToken: "second"))]
+        let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: -10)
+        let requests = [authState.tokenRefreshRequest(withAdditionalParameters: ["device_id": "a"])!,
+                        authState.tokenRefreshRequest(withAdditionalParameters: ["device_id": "b"])!]
+
+        performRefreshes(requests.map { ($0, OKTDefaultTokenValidator()) })
+        XCTAssertEqual(sessionMock.requestCount, 2)
+    }
+
+    func testDifferentValidatorsAreNotCoalesced() {
+        sessionMock.responses = [.init(statusCode: 200, data: refreshResponse(accessToken: "first")),
+                                 .init(statusCode: 200, data: refreshResponse(accessToken: "second")),
+                                 .init(statusCode: 200, data: refreshResponse(accessToken: "third"))]
+        let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId, expiresIn: -10)
+        let request = authState.tokenRefreshRequest()!
+        let customValidator = CustomTokenValidator()
+
+        // Default validators are interchangeable; the custom one is not.
+        performRefreshes([(request, OKTDefaultTokenValidator()),
+                          (request, OKTDefaultTokenValidator()),
+                          (request, customValidator),
+                          (request, CustomTokenValidator())])
+        XCTAssertEqual(sessionMock.requestCount, 3)
+    }
+}
+
+private extension OktaOidcTokenRefreshCoordinatorTests {
+
+    final class CustomTokenValidator: OKTDefaultTokenValidator {}
+
+    func performRefreshes(_ refreshes: [(OKTTokenRequest, OKTTokenValidator)]) {
+        let refreshesExpectation = expectation(description: "Refreshes completed!")
+        refreshesExpectation.expectedFulfillmentCount = refreshes.count
+        for (request, validator) in refreshes {
+            OKTTokenRefreshCoordinator.shared().performTokenRefreshRequest(request,
+                                                                           originalAuthorizationResponse: nil,
+                                                                           delegate: nil,
+                                                                           validator: validator) { _, _ in
+                refreshesExpectation.fulfill()
+            }
+        }
+        sessionMock.completePendingTasks()
+        waitForExpectations(timeout: 5.0, handler: nil)
+    }
+
+    func refreshResponse(accessToken: String) -> Data {
+        let json = """
+        {"access_token":"\(accessToken)","token_type":"Bearer","expires_in":300,"refresh_token":"rotatedRefreshToken"}
+        """
+        return json.data(using: .utf8)!
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// swiftlint:disable force_try
+// swiftlint:disable force_cast
+// swiftlint:disable force_unwrapping
+
+@testable import OktaOidc
+import XCTest
+
+#if SWIFT_PACKAGE
+@testable import TestCommon
+#endif
+
+class OktaOidcTracingTests: XCTestCase {
+
+    var tracer: OKTInMemoryTracer!
+    var apiMock: OktaOidcApiMock!
+
+    override func setUp() {
+        super.setUp()
+
+        tracer = OKTInMemoryTracer()
+        OKTTracing.setTracer(tracer)
+        apiMock = OktaOidcApiMock()
+    }
+
+    override func tearDown() {
+        OKTTracing.setTracer(nil)
+        tracer = nil
+        apiMock = nil
+        super.tearDown()
+    }
+
+    func testNoSpansWithoutTracer() {
+        OKTTracing.setTracer(nil)
+        XCTAssertNil(OKTTracing.tracer())
+        XCTAssertNil(OKTTracing.beginSpan(OKTTraceSpanDiscovery))
+    }
+
+    func testRecordedSpan() {
+        let span = OKTTracing.beginSpan(OKTTraceSpanTokenRequest)
+        span?.setAttribute("refresh_token", forKey: "grant_type")
+        span?.end(error: OktaOidcError.noBearerToken as NSError)
+
+        let recordedSpan = tracer.spans(named: OKTTraceSpanTokenRequest).first
+        XCTAssertEqual(recordedSpan?.attributes, ["grant_type": "refresh_token"])
+        XCTAssertTrue(recordedSpan?.isEnded ?? false)
+        XCTAssertNotNil(recordedSpan?.error)
+        XCTAssertGreaterThanOrEqual(recordedSpan?.duration ?? -1, 0)
+    }
+
+    func testDiscoverySpan() {
+        apiMock.configure(error: OktaOidcError.api(message: "Test Error", underlyingError: nil))
+
+        let discoveryExpectation = expectation(description: "Discovery completed!")
+        OktaOidcTask(config: validConfig, oktaAPI: apiMock).downloadOidcConfiguration { _, error in
+            XCTAssertNotNil(error)
+            discoveryExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        XCTAssertEqual(tracer.endedSpanNames, [OKTTraceSpanDiscovery])
+        XCTAssertNotNil(tracer.spans(named: OKTTraceSpanDiscovery).first?.error)
+    }
+
+    func testEndpointRequestAndPersistenceSpans() {
+        apiMock.configure(response: ["sub": "user"])
+        let stateManager = OktaOidcStateManager(
+            authState: TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer, clientId: TestUtils.mockClientId)
+        )
+        stateManager.restAPI = apiMock
+
+        let userInfoExpectation = expectation(description: "User info completed!")
+        stateManager.getUser { _, error in
+            XCTAssertNil(error)
+            userInfoExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        let requestSpan = tracer.spans(named: OKTTraceSpanEndpointRequest).first
+        XCTAssertEqual(requestSpan?.attributes["endpoint"], "userInfo")
+        XCTAssertTrue(requestSpan?.isEnded ?? false)
+        XCTAssertNil(requestSpan?.error)
+
+        stateManager.writeToSecureStorage()
+        XCTAssertEqual(tracer.spans(named: OKTTraceSpanPersistence).count, 1)
+        try? stateManager.removeFromSecureStorage()
+    }
+
+    func testRefreshSpans() {
+        let sessionMock = URLSessionMock()
+        sessionMock.responses = [.init(statusCode: 200, data: refreshResponse)]
+        OKTURLSessionProvider.setSession(sessionMock)
+        let authState = TestUtils.setupMockAuthState(issuer: TestUtils.mockIssuer,
+                                                     clientId: TestUtils.mockClientId,
+                                                     expiresIn: -10)
+
+        let actionExpectation = expectation(description: "Action performed!")
+        authState.performAction { _, _, error in
+            XCTAssertNil(error)
+            actionExpectation.fulfill()
+        }
+        waitForExpectations(timeout: 5.0, handler: nil)
+
+        XCTAssertEqual(tracer.endedSpanNames, [OKTTraceSpanTokenRequest, OKTTraceSpanTokenRefresh])
+        XCTAssertEqual(tracer.spans(named: OKTTraceSpanTokenRequest).first?.attributes["grant_type"],
+                       OKTGrantTypeRefreshToken)
+    }
+}
+
+private extension OktaOidcTracingTests {
+
+    var validConfig: OktaOidcConfig {
+        return try! OktaOidcConfig(with: [
+            "issuer": "http://test.issuer.com/oauth2/default",
+            "clientId": "test_client",
+            "scopes": "test",
+            "redirectUri": "test:/callback"
+        ])
+    }
+
+    var refreshResponse: Data {
+        let json = """
+        {"access_token":"refreshedAccessToken","token_type":"Bearer","expires_in":300}
+        """
+        return json.data(using: .utf8)!
+    }
+}
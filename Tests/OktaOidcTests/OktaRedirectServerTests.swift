@@ -61,8 +61,65 @@ class OktaRedirectServerTests: XCTestCase {
         XCTAssert(mockedRedirectHTTPHandler(for: server).cancelCalled)
     }
 
-    func createRedirectServer(successURL: URL?, port: UInt16 = 0) -> OktaRedirectServer {
-        let server = OktaRedirectServer(successURL: nil, port: port)
+    func testStartListenerOnFallbackPort() {
+        let occupyingServer = createRedirectServer(successURL: nil, port: 60140)
+        XCTAssertNotNil(try? occupyingServer.startListener())
+
+        let server = createRedirectServer(successURL: nil, port: 60140, fallbackPorts: 60141 ... 60149)
+        let url = try? server.startListener()
+        XCTAssertNotNil(url)
+        XCTAssertNotEqual(url?.port, 60140)
+        XCTAssertTrue((60141 ... 60149).contains(UInt16(url?.port ?? 0)))
+
+        server.stopListener()
+        occupyingServer.stopListener()
+    }
+
+    func testPersistentListenerBindsOnce() {
+        let server = createRedirectServer(successURL: nil, port: 60150)
+        let url = try? server.startPersistentListener()
+        XCTAssertEqual(url?.absoluteString, "http://127.0.0.1:60150/")
+        XCTAssertEqual(try? server.startPersistentListener(), url)
+        XCTAssertEqual(server.redirectHandler.listenerURL, url)
+        XCTAssertTrue(server.redirectHandler.router === OKTRedirectRouter.shared())
+        XCTAssertEqual(mockedRedirectHTTPHandler(for: server).persistentStartCount, 2)
+        XCTAssertFalse(mockedRedirectHTTPHandler(for: server).startCalled)
+
+        server.stopListener()
+        XCTAssertNil(server.redirectHandler.listenerURL)
+    }
+
+    func testPersistentListenerKeepsRunningForOtherDomain() {
+        let server = createRedirectServer(successURL: nil, port: 60156)
+        let url = try? server.startPersistentListener()
+        server.redirectHandler.currentAuthorizationFlow = OKTExternalUserAgentSessionMock(signCallback: nil, signOutCallback: nil)
+
+        XCTAssertEqual(try? server.startPersistentListener(with: "localhost"), URL(string: "http://localhost:60156/"))
+        XCTAssertEqual(server.redirectHandler.listenerURL, url)
+        // Restarting the listener would have cancelled the waiting flow.
+        XCTAssertNotNil(server.redirectHandler.currentAuthorizationFlow)
+
+        server.stopListener()
+    }
+
+    func testPersistentServerIsShared() {
+        let configuration = OktaRedirectServerConfiguration(successRedirectURL: nil, port: 60151, domainName: nil)
+        configuration.isPersistent = true
+        let otherConfiguration = OktaRedirectServerConfiguration(successRedirectURL: nil, port: 60152, domainName: nil)
+        otherConfiguration.isPersistent = true
+
+        let server = OktaRedirectServer.persistentServer(for: configuration)
+        XCTAssertTrue(OktaRedirectServer.persistentServer(for: configuration) === server)
+        XCTAssertFalse(OktaRedirectServer.persistentServer(for: otherConfiguration) === server)
+
+        let fallbackConfiguration = OktaRedirectServerConfiguration(successRedirectURL: nil, port: 60151, domainName: nil)
+        fallbackConfiguration.isPersistent = true
+        fallbackConfiguration.fallbackPorts = 60153 ... 60155
+        XCTAssertFalse(OktaRedirectServer.persistentServer(for: fallbackConfiguration) === server)
+    }
+
+    func createRedirectServer(successURL: URL?, port: UInt16 = 0, fallbackPorts: ClosedRange<UInt16>? = nil) -> OktaRedirectServer {
+        let server = OktaRedirectServer(successURL: nil, port: port, fallbackPorts: fallbackPorts)
         server.redirectHandler = OKTRedirectHTTPHandlerMock()
         return server
     }
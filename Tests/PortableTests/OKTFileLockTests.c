@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2024-Present, Okta, Inc. and/or its affiliates. All rights reserved.
+ * The Okta software accompanied by this notice is provided pursuant to the Apache License, Version 2.0 (the "License.")
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0.
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ */
+
+// Tests OKTFileLock across real processes with fork(2). Plain C, so that it runs on Linux as well as
+// on Apple platforms; see scripts/portable_tests.sh.
+
+#include "OKTFileLock.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+#define EXPECT(condition)                                                       \
+  do {                                                                          \
+    if (!(condition)) {                                                         \
+      fprintf(stderr, "%s:%d: %s: expected %s\n", __FILE__, __LINE__, __func__, \
+              #condition);                                                      \
+      failures++;                                                               \
+    }                                                                           \
+  } while (0)
+
+static char lockPath[256];
+
+/*! @brief Runs @c body in a child process and returns its exit status, or -1 if it did not exit.
+ */
+static int runInChild(int (*body)(void)) {
+  pid_t pid = fork();
+  if (pid == 0) {
+    _exit(body());
+  }
+  int status;
+  if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) {
+    return -1;
+  }
+  return WEXITSTATUS(status);
+}
+
+/*! @brief Exits with 0 if the lock could be taken without waiting, 1 if it is held elsewhere.
+ */
+static int childTryLock(void) {
+  int fileDescriptor = OKTFileLockAcquire(lockPath, false);
+  if (fileDescriptor < 0) {
+    return errno == EWOULDBLOCK ? 1 : 2;
+  }
+  OKTFileLockRelease(fileDescriptor);
+  return 0;
+}
+
+/*! @brief Takes the lock and exits without releasing it.
+ */
+static int childLockAndExit(void) {
+  return OKTFileLockAcquire(lockPath, false) < 0 ? 1 : 0;
+}
+
+static void testExcludesOtherDescriptorsInProcess(void) {
+  int holder = OKTFileLockAcquire(lockPath, false);
+  EXPECT(holder >= 0);
+  errno = 0;
+  EXPECT(OKTFileLockAcquire(lockPath, false) == -1);
+  EXPECT(errno == EWOULDBLOCK);
+  OKTFileLockRelease(holder);
+
+  int next = OKTFileLockAcquire(lockPath, false);
+  EXPECT(next >= 0);
+  OKTFileLockRelease(next);
+}
+
+static void testExcludesOtherProcesses(void) {
+  int holder = OKTFileLockAcquire(lockPath, true);
+  EXPECT(holder >= 0);
+  EXPECT(runInChild(childTryLock) == 1);
+  OKTFileLockRelease(holder);
+  EXPECT(runInChild(childTryLock) == 0);
+}
+
+static void testReleasedWhenHolderExits(void) {
+  EXPECT(runInChild(childLockAndExit) == 0);
+  int fileDescriptor = OKTFileLockAcquire(lockPath, false);
+  EXPECT(fileDescriptor >= 0);
+  OKTFileLockRelease(fileDescriptor);
+}
+
+static void testBlockingWaitsForRelease(void) {
+  int holder = OKTFileLockAcquire(lockPath, true);
+  EXPECT(holder >= 0);
+  int reported[2];
+  EXPECT(pipe(reported) == 0);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(reported[0]);
+    int fileDescriptor = OKTFileLockAcquire(lockPath, true);
+    char acquired = fileDescriptor >= 0 ? 'y' : 'n';
+    _exit(write(reported[1], &acquired, 1) == 1 ? 0 : 1);
+  }
+  close(reported[1]);
+
+  // the child must still be waiting while the lock is held
+  struct pollfd waiting = {.fd = reported[0], .events = POLLIN};
+  EXPECT(poll(&waiting, 1, 200) == 0);
+
+  OKTFileLockRelease(holder);
+  char acquired = 0;
+  EXPECT(read(reported[0], &acquired, 1) == 1);
+  EXPECT(acquired == 'y');
+  close(reported[0]);
+  int status;
+  EXPECT(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+static void testFailsForUnwritableLocation(void) {
+  errno = 0;
+  EXPECT(OKTFileLockAcquire("/nonexistent-directory/refresh.lock", false) == -1);
+  EXPECT(errno == ENOENT);
+}
+
+int main(void) {
+  const char *directory = getenv("TMPDIR");
+  snprintf(lockPath, sizeof(lockPath), "%s/OKTFileLockTests.%d.lock",
+           directory && *directory ? directory : "/tmp", (int)getpid());
+
+  testExcludesOtherDescriptorsInProcess();
+  testExcludesOtherProcesses();
+  testReleasedWhenHolderExits();
+  testBlockingWaitsForRelease();
+  testFailsForUnwritableLocation();
+
+  unlink(lockPath);
+  if (failures > 0) {
+    fprintf(stderr, "OKTFileLockTests: %d failure(s)\n", failures);
+    return EXIT_FAILURE;
+  }
+  printf("OKTFileLockTests: passed\n");
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Builds and runs the tests of the plain C modules of AppAuth, which do not need Foundation and
+# therefore also run on Linux.
+
+set -euo pipefail
+
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+CC="${CC:-cc}"
+BUILD="$(mktemp -d)"
+trap 'rm -rf "${BUILD}"' EXIT
+
+"${CC}" -std=c11 -D_DEFAULT_SOURCE -Wall -Wextra -Werror \
+  -I "${ROOT}/Sources/AppAuth/include" \
+  "${ROOT}/Sources/AppAuth/OKTFileLock.c" \
+  "${ROOT}/Tests/PortableTests/OKTFileLockTests.c" \
+  -o "${BUILD}/OKTFileLockTests"
+"${BUILD}/OKTFileLockTests"